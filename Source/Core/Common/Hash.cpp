@@ -22,6 +22,7 @@
 namespace Common
 {
 static u64 (*ptrHashFunction)(const u8* src, u32 len, u32 samples) = nullptr;
+static u64 (*ptrFullHashFunction)(const u8* src, u32 len) = nullptr;
 
 // uint32_t
 // WARNING - may read one more byte!
@@ -505,14 +506,251 @@ static u64 GetMurmurHash3(const u8* src, u32 len, u32 samples)
 }
 #endif
 
+// Full-coverage hash with the same structure as XXH3 (the vendored xxhash predates it): each
+// 64-byte stripe is accumulated into eight 64-bit lanes using one 32x32->64 multiply per lane,
+// which maps directly onto SSE2 and AVX2. The lanes are scrambled after every block of stripes
+// and mixed down to 64 bits at the end. All implementations produce the same results.
+constexpr u32 FULL_HASH_STRIPE_SIZE = 64;
+constexpr u32 FULL_HASH_STRIPES_PER_BLOCK = 16;
+constexpr u64 FULL_HASH_PRIME32_1 = 0x9E3779B1;
+constexpr u64 FULL_HASH_PRIME64_1 = 0x9E3779B185EBCA87;
+
+// Stripe n of a block uses keys [n, n + 8). The last eight keys are also used for scrambling.
+alignas(32) static const u64 s_full_hash_keys[FULL_HASH_STRIPES_PER_BLOCK + 8] = {
+    0xDEFA5C925A1A2F51, 0x4042350EA114E7B7, 0x378DBA2FCC08FE92, 0xAD89F2F771FCD44B,
+    0xA4EAD0D19124CBA8, 0xA689ECAFB202AB69, 0xFD1B3834AC0C83F8, 0xDCDAD3DE595F00C4,
+    0xCEE93B5B3713CFCF, 0xA9D9196438620ED5, 0x285D193953AC253C, 0xBAC6231B10C5D14C,
+    0x681D0A3DF03E6A8A, 0x8AAF05AF30125914, 0xD76CABB80E67C3D0, 0xB9ED1AAE94BB6037,
+    0xDDFEDA467E23D7C6, 0x23EBAE1D443B4AE5, 0x30CA6604C2C8F61B, 0xF8D9C58F764520CD,
+    0x24501FA816D0925F, 0x09F72744304BB8A8, 0xC52F75B7B3838E78, 0x26E602F64C76BB60,
+};
+static const u64* const s_full_hash_scramble_keys = &s_full_hash_keys[FULL_HASH_STRIPES_PER_BLOCK];
+
+alignas(32) static const u64 s_full_hash_initial_lanes[8] = {
+    0x00000000C2B2AE3D, 0x9E3779B185EBCA87, 0xC2B2AE3D27D4EB4F, 0x165667B19E3779F9,
+    0x85EBCA77C2B2AE63, 0x0000000085EBCA77, 0x27D4EB2F165667C5, 0x000000009E3779B1,
+};
+
+static u64 FinalizeFullHash(const u64* lanes, u32 len)
+{
+  u64 h = len * FULL_HASH_PRIME64_1;
+  for (u32 i = 0; i < 8; ++i)
+  {
+    const u64 lane = lanes[i] ^ s_full_hash_keys[i];
+    h = (h ^ (lane ^ (lane >> 29))) * FULL_HASH_PRIME64_1;
+    h = Common::RotateLeft(h, 31);
+  }
+
+  h ^= h >> 37;
+  h *= 0x165667919E3779F9;
+  h ^= h >> 32;
+  return h;
+}
+
+static void AccumulateStripeGeneric(u64* lanes, const u8* stripe, const u64* keys)
+{
+  for (u32 i = 0; i < 8; ++i)
+  {
+    u64 data;
+    std::memcpy(&data, stripe + i * sizeof(u64), sizeof(u64));
+    const u64 keyed = data ^ keys[i];
+    lanes[i ^ 1] += data;
+    lanes[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+  }
+}
+
+static void ScrambleLanesGeneric(u64* lanes)
+{
+  for (u32 i = 0; i < 8; ++i)
+  {
+    lanes[i] ^= lanes[i] >> 47;
+    lanes[i] ^= s_full_hash_scramble_keys[i];
+    lanes[i] *= FULL_HASH_PRIME32_1;
+  }
+}
+
+u64 GetFullHashGeneric(const u8* src, u32 len)
+{
+  u64 lanes[8];
+  std::memcpy(lanes, s_full_hash_initial_lanes, sizeof(lanes));
+
+  const u32 num_stripes = len / FULL_HASH_STRIPE_SIZE;
+  u32 stripe_in_block = 0;
+  for (u32 i = 0; i < num_stripes; ++i)
+  {
+    AccumulateStripeGeneric(lanes, src + i * FULL_HASH_STRIPE_SIZE,
+                            &s_full_hash_keys[stripe_in_block]);
+    if (++stripe_in_block == FULL_HASH_STRIPES_PER_BLOCK)
+    {
+      ScrambleLanesGeneric(lanes);
+      stripe_in_block = 0;
+    }
+  }
+
+  if (len % FULL_HASH_STRIPE_SIZE != 0)
+  {
+    u8 tail[FULL_HASH_STRIPE_SIZE] = {};
+    std::memcpy(tail, src + num_stripes * FULL_HASH_STRIPE_SIZE, len % FULL_HASH_STRIPE_SIZE);
+    AccumulateStripeGeneric(lanes, tail, &s_full_hash_keys[stripe_in_block]);
+  }
+
+  return FinalizeFullHash(lanes, len);
+}
+
+#ifdef _M_X86
+
+static inline void AccumulateStripeSSE2(__m128i* lanes, const u8* stripe, const u64* keys)
+{
+  for (u32 i = 0; i < 4; ++i)
+  {
+    const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe) + i);
+    const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys) + i);
+    const __m128i keyed = _mm_xor_si128(data, key);
+    const __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+    const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+  }
+}
+
+static inline void ScrambleLanesSSE2(__m128i* lanes)
+{
+  const __m128i prime = _mm_set1_epi64x(FULL_HASH_PRIME32_1);
+  for (u32 i = 0; i < 4; ++i)
+  {
+    const __m128i key =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(s_full_hash_scramble_keys) + i);
+    __m128i lane = _mm_xor_si128(lanes[i], _mm_srli_epi64(lanes[i], 47));
+    lane = _mm_xor_si128(lane, key);
+    const __m128i low = _mm_mul_epu32(lane, prime);
+    const __m128i high = _mm_mul_epu32(_mm_srli_epi64(lane, 32), prime);
+    lanes[i] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+  }
+}
+
+u64 GetFullHashSSE2(const u8* src, u32 len)
+{
+  __m128i lanes[4];
+  for (u32 i = 0; i < 4; ++i)
+    lanes[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(s_full_hash_initial_lanes) + i);
+
+  const u32 num_stripes = len / FULL_HASH_STRIPE_SIZE;
+  u32 stripe_in_block = 0;
+  for (u32 i = 0; i < num_stripes; ++i)
+  {
+    AccumulateStripeSSE2(lanes, src + i * FULL_HASH_STRIPE_SIZE,
+                         &s_full_hash_keys[stripe_in_block]);
+    if (++stripe_in_block == FULL_HASH_STRIPES_PER_BLOCK)
+    {
+      ScrambleLanesSSE2(lanes);
+      stripe_in_block = 0;
+    }
+  }
+
+  if (len % FULL_HASH_STRIPE_SIZE != 0)
+  {
+    alignas(16) u8 tail[FULL_HASH_STRIPE_SIZE] = {};
+    std::memcpy(tail, src + num_stripes * FULL_HASH_STRIPE_SIZE, len % FULL_HASH_STRIPE_SIZE);
+    AccumulateStripeSSE2(lanes, tail, &s_full_hash_keys[stripe_in_block]);
+  }
+
+  alignas(16) u64 result[8];
+  for (u32 i = 0; i < 4; ++i)
+    _mm_store_si128(reinterpret_cast<__m128i*>(result) + i, lanes[i]);
+  return FinalizeFullHash(result, len);
+}
+
+FUNCTION_TARGET_AVX2
+static inline void AccumulateStripeAVX2(__m256i* lanes, const u8* stripe, const u64* keys)
+{
+  for (u32 i = 0; i < 2; ++i)
+  {
+    const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe) + i);
+    const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys) + i);
+    const __m256i keyed = _mm256_xor_si256(data, key);
+    const __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+    const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static inline void ScrambleLanesAVX2(__m256i* lanes)
+{
+  const __m256i prime = _mm256_set1_epi64x(FULL_HASH_PRIME32_1);
+  for (u32 i = 0; i < 2; ++i)
+  {
+    const __m256i key =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(s_full_hash_scramble_keys) + i);
+    __m256i lane = _mm256_xor_si256(lanes[i], _mm256_srli_epi64(lanes[i], 47));
+    lane = _mm256_xor_si256(lane, key);
+    const __m256i low = _mm256_mul_epu32(lane, prime);
+    const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(lane, 32), prime);
+    lanes[i] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+  }
+}
+
+FUNCTION_TARGET_AVX2
+u64 GetFullHashAVX2(const u8* src, u32 len)
+{
+  __m256i lanes[2];
+  for (u32 i = 0; i < 2; ++i)
+    lanes[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(s_full_hash_initial_lanes) + i);
+
+  const u32 num_stripes = len / FULL_HASH_STRIPE_SIZE;
+  u32 stripe_in_block = 0;
+  for (u32 i = 0; i < num_stripes; ++i)
+  {
+    AccumulateStripeAVX2(lanes, src + i * FULL_HASH_STRIPE_SIZE,
+                         &s_full_hash_keys[stripe_in_block]);
+    if (++stripe_in_block == FULL_HASH_STRIPES_PER_BLOCK)
+    {
+      ScrambleLanesAVX2(lanes);
+      stripe_in_block = 0;
+    }
+  }
+
+  if (len % FULL_HASH_STRIPE_SIZE != 0)
+  {
+    alignas(32) u8 tail[FULL_HASH_STRIPE_SIZE] = {};
+    std::memcpy(tail, src + num_stripes * FULL_HASH_STRIPE_SIZE, len % FULL_HASH_STRIPE_SIZE);
+    AccumulateStripeAVX2(lanes, tail, &s_full_hash_keys[stripe_in_block]);
+  }
+
+  alignas(32) u64 result[8];
+  for (u32 i = 0; i < 2; ++i)
+    _mm256_store_si256(reinterpret_cast<__m256i*>(result) + i, lanes[i]);
+  return FinalizeFullHash(result, len);
+}
+
+#endif
+
 u64 GetHash64(const u8* src, u32 len, u32 samples)
 {
+  // Once the samples cover every 8-byte word, the sampling hashes read all of the data anyway,
+  // and the full-coverage hash is faster at that.
+  if (samples == 0 || u64(samples) * 8 >= len)
+    return ptrFullHashFunction(src, len);
+
   return ptrHashFunction(src, len, samples);
 }
 
+u64 GetFullHash64(const u8* src, u32 len)
+{
+  return ptrFullHashFunction(src, len);
+}
+
 // sets the hash function used for the texture cache
 void SetHash64Function()
 {
+#ifdef _M_X86
+  if (cpu_info.bAVX2)
+    ptrFullHashFunction = &GetFullHashAVX2;
+  else
+    ptrFullHashFunction = &GetFullHashSSE2;
+#else
+  ptrFullHashFunction = &GetFullHashGeneric;
+#endif
+
 #if defined(_M_X86_64) || defined(_M_X86)
   if (cpu_info.bSSE4_2)  // sse crc32 version
   {
@@ -13,6 +13,17 @@ namespace Common
 u32 HashFletcher(const u8* data_u8, size_t length);  // FAST. Length & 1 == 0.
 u32 HashAdler32(const u8* data, size_t len);         // Fairly accurate, slightly slower
 u32 HashEctor(const u8* ptr, int length);            // JUNK. DO NOT USE FOR NEW THINGS
+// Hashes the data, or only a number of samples from it if samples is non-zero.
+// SetHash64Function must have been called first.
 u64 GetHash64(const u8* src, u32 len, u32 samples);
+// Hashes all of the data. Much faster than sampling with GetHash64 unless the data is large.
+u64 GetFullHash64(const u8* src, u32 len);
+// The implementations that GetFullHash64 picks from, which all give the same results. Only the
+// ones that the CPU supports can be called.
+u64 GetFullHashGeneric(const u8* src, u32 len);
+#ifdef _M_X86
+u64 GetFullHashSSE2(const u8* src, u32 len);
+u64 GetFullHashAVX2(const u8* src, u32 len);
+#endif
 void SetHash64Function();
 }  // namespace Common
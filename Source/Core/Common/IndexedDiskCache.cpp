@@ -0,0 +1,525 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/IndexedDiskCache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include "Common/Hash.h"
+#include "Common/Logging/Log.h"
+#include "Common/Random.h"
+#include "Common/Version.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace Common
+{
+namespace
+{
+constexpr u32 DATA_FILE_MAGIC = 0x43444944;   // DIDC
+constexpr u32 INDEX_FILE_MAGIC = 0x58444944;  // DIDX
+constexpr u32 FORMAT_VERSION = 1;
+
+struct DataFileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 key_size;
+  u32 reserved;
+  u64 file_id;
+  char scm_rev[40];
+};
+static_assert(sizeof(DataFileHeader) == 64);
+
+struct RecordHeader
+{
+  u32 value_size;
+  u32 checksum;
+};
+
+struct IndexFileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 key_size;
+  u32 num_entries;
+  u64 file_id;
+  u64 data_size;
+  u64 unused_size;
+};
+
+void GetSCMRev(char (&scm_rev)[40])
+{
+  // Null-terminator is intentionally not copied.
+  std::memset(scm_rev, 0, sizeof(scm_rev));
+  std::memcpy(scm_rev, scm_rev_git_str.c_str(), std::min(scm_rev_git_str.size(), sizeof(scm_rev)));
+}
+}  // Anonymous namespace
+
+IndexedDiskCacheFile::IndexedDiskCacheFile(u32 key_size) : m_key_size(key_size)
+{
+}
+
+IndexedDiskCacheFile::~IndexedDiskCacheFile()
+{
+  Close();
+}
+
+bool IndexedDiskCacheFile::Open(const std::string& filename)
+{
+  Close();
+
+  std::lock_guard lk(m_mutex);
+  m_filename = filename;
+  if (!OpenDataFile())
+    return false;
+
+  ScanRecords(LoadIndex());
+  Map();
+  return true;
+}
+
+void IndexedDiskCacheFile::Close()
+{
+  std::lock_guard lk(m_mutex);
+  if (!m_file.IsOpen())
+    return;
+
+  if (m_unused_size > m_data_size / 4)
+    Compact();
+
+  m_file.Flush();
+  WriteIndex();
+
+  Unmap();
+  m_file.Close();
+  m_index.clear();
+  m_data_size = 0;
+  m_unused_size = 0;
+}
+
+bool IndexedDiskCacheFile::IsOpen() const
+{
+  std::lock_guard lk(m_mutex);
+  return m_file.IsOpen();
+}
+
+size_t IndexedDiskCacheFile::GetEntryCount() const
+{
+  std::lock_guard lk(m_mutex);
+  return m_index.size();
+}
+
+bool IndexedDiskCacheFile::Contains(const void* key) const
+{
+  std::lock_guard lk(m_mutex);
+  return m_index.count(std::string(static_cast<const char*>(key), m_key_size)) != 0;
+}
+
+bool IndexedDiskCacheFile::Lookup(const void* key, std::vector<u8>* value)
+{
+  std::lock_guard lk(m_mutex);
+  const auto it = m_index.find(std::string(static_cast<const char*>(key), m_key_size));
+  if (it == m_index.end())
+    return false;
+
+  std::vector<u8> record;
+  if (!ReadRecord(it->second, &record))
+  {
+    WARN_LOG(COMMON, "Discarding corrupted record at offset %" PRIu64 " of %s", it->second.offset,
+             m_filename.c_str());
+    RemoveEntry(it);
+    return false;
+  }
+
+  const auto value_start = record.begin() + sizeof(RecordHeader) + m_key_size;
+  value->assign(value_start, record.end());
+  return true;
+}
+
+void IndexedDiskCacheFile::Append(const void* key, const u8* value, u32 value_size)
+{
+  std::lock_guard lk(m_mutex);
+  if (!m_file.IsOpen())
+    return;
+
+  // The record is written in a single call, so that a crash can only leave a torn record at the
+  // end of the file.
+  std::vector<u8> record(GetRecordSize(value_size));
+  u8* const key_and_value = record.data() + sizeof(RecordHeader);
+  std::memcpy(key_and_value, key, m_key_size);
+  std::copy_n(value, value_size, key_and_value + m_key_size);
+  const RecordHeader header{value_size, HashAdler32(key_and_value, m_key_size + value_size)};
+  std::memcpy(record.data(), &header, sizeof(header));
+
+  if (!m_file.Seek(m_data_size, SEEK_SET) || !m_file.WriteBytes(record.data(), record.size()))
+  {
+    WARN_LOG(COMMON, "Failed to append to %s", m_filename.c_str());
+    m_file.Clear();
+    return;
+  }
+
+  AddEntry(std::string(static_cast<const char*>(key), m_key_size), {m_data_size, value_size});
+  m_data_size += record.size();
+}
+
+void IndexedDiskCacheFile::Remove(const void* key)
+{
+  std::lock_guard lk(m_mutex);
+  const auto it = m_index.find(std::string(static_cast<const char*>(key), m_key_size));
+  if (it != m_index.end())
+    RemoveEntry(it);
+}
+
+void IndexedDiskCacheFile::Clear()
+{
+  std::lock_guard lk(m_mutex);
+  if (!m_file.IsOpen())
+    return;
+
+  Unmap();
+  m_file.Close();
+  File::Delete(GetIndexFilename());
+  CreateDataFile();
+}
+
+bool IndexedDiskCacheFile::OpenDataFile()
+{
+  if (m_file.Open(m_filename, "rb+"))
+  {
+    DataFileHeader header;
+    DataFileHeader expected_header;
+    GetSCMRev(expected_header.scm_rev);
+    if (m_file.ReadBytes(&header, sizeof(header)) && header.magic == DATA_FILE_MAGIC &&
+        header.version == FORMAT_VERSION && header.key_size == m_key_size &&
+        std::memcmp(header.scm_rev, expected_header.scm_rev, sizeof(header.scm_rev)) == 0)
+    {
+      m_file_id = header.file_id;
+      m_data_size = sizeof(header);
+      return true;
+    }
+
+    m_file.Close();
+  }
+
+  return CreateDataFile();
+}
+
+bool IndexedDiskCacheFile::CreateDataFile()
+{
+  m_index.clear();
+  m_data_size = 0;
+  m_unused_size = 0;
+
+  DataFileHeader header = {};
+  header.magic = DATA_FILE_MAGIC;
+  header.version = FORMAT_VERSION;
+  header.key_size = m_key_size;
+  header.file_id = Random::GenerateValue<u64>();
+  GetSCMRev(header.scm_rev);
+  if (!m_file.Open(m_filename, "wb+") || !m_file.WriteBytes(&header, sizeof(header)))
+  {
+    ERROR_LOG(COMMON, "Failed to create %s", m_filename.c_str());
+    m_file.Close();
+    return false;
+  }
+
+  m_file_id = header.file_id;
+  m_data_size = sizeof(header);
+  return true;
+}
+
+u64 IndexedDiskCacheFile::LoadIndex()
+{
+  File::IOFile index_file(GetIndexFilename(), "rb");
+  const u64 file_size = m_file.GetSize();
+  IndexFileHeader header;
+  if (!index_file.ReadBytes(&header, sizeof(header)) || header.magic != INDEX_FILE_MAGIC ||
+      header.version != FORMAT_VERSION || header.key_size != m_key_size ||
+      header.file_id != m_file_id || header.data_size < m_data_size ||
+      header.data_size > file_size)
+  {
+    return m_data_size;
+  }
+
+  const size_t entry_size = m_key_size + sizeof(u64) + sizeof(u32);
+  std::vector<u8> entries(entry_size * header.num_entries);
+  if (!index_file.ReadBytes(entries.data(), entries.size()))
+    return m_data_size;
+
+  m_index.reserve(header.num_entries);
+  for (u32 i = 0; i < header.num_entries; ++i)
+  {
+    const u8* const entry_data = entries.data() + i * entry_size;
+    Entry entry;
+    std::memcpy(&entry.offset, entry_data + m_key_size, sizeof(entry.offset));
+    std::memcpy(&entry.value_size, entry_data + m_key_size + sizeof(u64), sizeof(entry.value_size));
+    if (entry.offset < m_data_size ||
+        entry.offset + GetRecordSize(entry.value_size) > header.data_size)
+    {
+      WARN_LOG(COMMON, "Invalid index for %s, reading all records", m_filename.c_str());
+      m_index.clear();
+      return m_data_size;
+    }
+
+    m_index.emplace(std::string(reinterpret_cast<const char*>(entry_data), m_key_size), entry);
+  }
+
+  m_unused_size = header.unused_size;
+  return header.data_size;
+}
+
+void IndexedDiskCacheFile::ScanRecords(u64 offset)
+{
+  // These are the records that were appended after the index was written, which is usually none,
+  // unless Dolphin crashed. So the checksums are verified right away, to find where they end.
+  const u64 file_size = m_file.GetSize();
+  std::vector<u8> key_and_value;
+  while (offset + sizeof(RecordHeader) + m_key_size <= file_size)
+  {
+    RecordHeader header;
+    if (!m_file.Seek(offset, SEEK_SET) || !m_file.ReadBytes(&header, sizeof(header)))
+      break;
+
+    const u64 record_size = GetRecordSize(header.value_size);
+    if (offset + record_size > file_size)
+      break;
+
+    key_and_value.resize(m_key_size + header.value_size);
+    if (!m_file.ReadBytes(key_and_value.data(), key_and_value.size()) ||
+        HashAdler32(key_and_value.data(), key_and_value.size()) != header.checksum)
+    {
+      break;
+    }
+
+    AddEntry(std::string(key_and_value.begin(), key_and_value.begin() + m_key_size),
+             {offset, header.value_size});
+    offset += record_size;
+  }
+
+  m_file.Clear();
+  m_data_size = offset;
+  if (offset != file_size)
+  {
+    WARN_LOG(COMMON, "Discarding %" PRIu64 " bytes of incomplete records at the end of %s",
+             file_size - offset, m_filename.c_str());
+    m_file.Resize(offset);
+  }
+}
+
+void IndexedDiskCacheFile::WriteIndex()
+{
+  IndexFileHeader header = {};
+  header.magic = INDEX_FILE_MAGIC;
+  header.version = FORMAT_VERSION;
+  header.key_size = m_key_size;
+  header.num_entries = static_cast<u32>(m_index.size());
+  header.file_id = m_file_id;
+  header.data_size = m_data_size;
+  header.unused_size = m_unused_size;
+
+  const size_t entry_size = m_key_size + sizeof(u64) + sizeof(u32);
+  std::vector<u8> data(sizeof(header) + entry_size * m_index.size());
+  std::memcpy(data.data(), &header, sizeof(header));
+  u8* entry_data = data.data() + sizeof(header);
+  for (const auto& [key, entry] : m_index)
+  {
+    std::memcpy(entry_data, key.data(), m_key_size);
+    std::memcpy(entry_data + m_key_size, &entry.offset, sizeof(entry.offset));
+    std::memcpy(entry_data + m_key_size + sizeof(u64), &entry.value_size, sizeof(entry.value_size));
+    entry_data += entry_size;
+  }
+
+  // Readers either see the previous index or the new one, both of which are consistent with the
+  // data file.
+  const std::string filename = GetIndexFilename();
+  const std::string temp_filename = File::GetTempFilenameForAtomicWrite(filename);
+  File::IOFile index_file(temp_filename, "wb");
+  if (!index_file.WriteBytes(data.data(), data.size()) || !index_file.Close() ||
+      !File::Rename(temp_filename, filename))
+  {
+    WARN_LOG(COMMON, "Failed to write %s", filename.c_str());
+    File::Delete(temp_filename);
+  }
+}
+
+void IndexedDiskCacheFile::Compact()
+{
+  // Copy the records that are still in use to a new file, in the same order.
+  using EntryIterator = std::unordered_map<std::string, Entry>::iterator;
+  std::vector<EntryIterator> entries;
+  entries.reserve(m_index.size());
+  for (auto it = m_index.begin(); it != m_index.end(); ++it)
+    entries.push_back(it);
+  std::sort(entries.begin(), entries.end(), [](EntryIterator a, EntryIterator b) {
+    return a->second.offset < b->second.offset;
+  });
+
+  DataFileHeader header = {};
+  header.magic = DATA_FILE_MAGIC;
+  header.version = FORMAT_VERSION;
+  header.key_size = m_key_size;
+  header.file_id = Random::GenerateValue<u64>();
+  GetSCMRev(header.scm_rev);
+
+  const std::string temp_filename = File::GetTempFilenameForAtomicWrite(m_filename);
+  File::IOFile temp_file(temp_filename, "wb");
+  bool success = temp_file.WriteBytes(&header, sizeof(header));
+
+  std::vector<Entry*> kept_entries;
+  std::vector<u64> new_offsets;
+  kept_entries.reserve(entries.size());
+  new_offsets.reserve(entries.size());
+  u64 offset = sizeof(header);
+  std::vector<u8> record;
+  for (const EntryIterator it : entries)
+  {
+    if (!success)
+      break;
+
+    // Corrupted records are dropped from the index and aren't copied, like in Lookup.
+    if (!ReadRecord(it->second, &record))
+    {
+      WARN_LOG(COMMON, "Discarding corrupted record at offset %" PRIu64 " of %s",
+               it->second.offset, m_filename.c_str());
+      RemoveEntry(it);
+      continue;
+    }
+
+    success = temp_file.WriteBytes(record.data(), record.size());
+    kept_entries.push_back(&it->second);
+    new_offsets.push_back(offset);
+    offset += record.size();
+  }
+  success &= temp_file.Close();
+
+  Unmap();
+  if (!success)
+  {
+    WARN_LOG(COMMON, "Failed to compact %s", m_filename.c_str());
+    File::Delete(temp_filename);
+    return;
+  }
+
+  m_file.Close();
+  if (!File::Rename(temp_filename, m_filename))
+  {
+    File::Delete(temp_filename);
+    m_file.Open(m_filename, "rb+");
+    return;
+  }
+
+  m_file.Open(m_filename, "rb+");
+  for (size_t i = 0; i < kept_entries.size(); ++i)
+    kept_entries[i]->offset = new_offsets[i];
+  INFO_LOG(COMMON, "Compacted %s from %" PRIu64 " to %" PRIu64 " bytes", m_filename.c_str(),
+           m_data_size, offset);
+  m_file_id = header.file_id;
+  m_data_size = offset;
+  m_unused_size = 0;
+}
+
+bool IndexedDiskCacheFile::ReadRecord(const Entry& entry, std::vector<u8>* record)
+{
+  record->resize(GetRecordSize(entry.value_size));
+  if (entry.offset + record->size() <= m_mapped_size)
+  {
+    std::copy_n(m_mapped_data + entry.offset, record->size(), record->data());
+  }
+  else if (!m_file.Seek(entry.offset, SEEK_SET) ||
+           !m_file.ReadBytes(record->data(), record->size()))
+  {
+    m_file.Clear();
+    return false;
+  }
+
+  RecordHeader header;
+  std::memcpy(&header, record->data(), sizeof(header));
+  const u8* const key_and_value = record->data() + sizeof(header);
+  return header.value_size == entry.value_size &&
+         header.checksum == HashAdler32(key_and_value, m_key_size + entry.value_size);
+}
+
+void IndexedDiskCacheFile::AddEntry(std::string key, const Entry& entry)
+{
+  const auto [it, inserted] = m_index.try_emplace(std::move(key), entry);
+  if (!inserted)
+  {
+    m_unused_size += GetRecordSize(it->second.value_size);
+    it->second = entry;
+  }
+}
+
+void IndexedDiskCacheFile::RemoveEntry(std::unordered_map<std::string, Entry>::iterator it)
+{
+  m_unused_size += GetRecordSize(it->second.value_size);
+  m_index.erase(it);
+}
+
+u64 IndexedDiskCacheFile::GetRecordSize(u32 value_size) const
+{
+  return sizeof(RecordHeader) + m_key_size + value_size;
+}
+
+std::string IndexedDiskCacheFile::GetIndexFilename() const
+{
+  return m_filename + ".idx";
+}
+
+void IndexedDiskCacheFile::Map()
+{
+  Unmap();
+  if (!m_file.Flush() || m_data_size == 0)
+    return;
+
+#ifdef _WIN32
+  const HANDLE file_handle =
+      reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file.GetHandle())));
+  const HANDLE mapping = CreateFileMapping(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping)
+    return;
+
+  void* const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(m_data_size));
+  if (!data)
+  {
+    CloseHandle(mapping);
+    return;
+  }
+  m_mapping_handle = mapping;
+#else
+  void* const data = mmap(nullptr, static_cast<size_t>(m_data_size), PROT_READ, MAP_SHARED,
+                          fileno(m_file.GetHandle()), 0);
+  if (data == MAP_FAILED)
+    return;
+#endif
+
+  m_mapped_data = static_cast<const u8*>(data);
+  m_mapped_size = m_data_size;
+}
+
+void IndexedDiskCacheFile::Unmap()
+{
+  if (!m_mapped_data)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_mapped_data);
+  CloseHandle(m_mapping_handle);
+  m_mapping_handle = nullptr;
+#else
+  munmap(const_cast<u8*>(m_mapped_data), static_cast<size_t>(m_mapped_size));
+#endif
+
+  m_mapped_data = nullptr;
+  m_mapped_size = 0;
+}
+}  // namespace Common
@@ -0,0 +1,190 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/LinearDiskCache.h"
+
+// On disk format:
+//
+// Data file:
+// header{
+// u32 'DIDC';
+// u32 version;
+// u32 key_size;
+// u32 reserved;
+// u64 file_id;  // random, changes whenever the file is recreated
+// char scm_rev[40];
+//}
+// record{
+// u32 value_size;
+// u32 checksum;  // Adler-32 of the key and value
+// u8 key[key_size];
+// u8 value[value_size];
+//}
+//
+// Index file (<filename>.idx):
+// header{
+// u32 'DIDX';
+// u32 version;
+// u32 key_size;
+// u32 num_entries;
+// u64 file_id;
+// u64 data_size;  // size of the part of the data file that the index covers
+// u64 unused_size;
+//}
+// entry{
+// u8 key[key_size];
+// u64 record_offset;
+// u32 value_size;
+//}
+
+namespace Common
+{
+// Key-value store for caching shader and pipeline binaries between executions. Unlike
+// LinearDiskCache, opening it doesn't read the values. The keys are loaded into a hash index from
+// the index file that was written when the cache was last closed. Only the records appended after
+// that are read from the data file. The data file is mapped into memory, and values are only read
+// from it when they are looked up.
+//
+// Records are only ever appended to the data file. Each one has a checksum, so if Dolphin crashes,
+// the torn record at the end is discarded and everything before it is kept. The index file is
+// replaced atomically. Replaced and removed records leave unused space in the data file. It is
+// compacted when the cache is closed once more than a quarter of it is unused.
+//
+// Keys and values are untyped here, see IndexedDiskCache below. All methods are thread-safe.
+class IndexedDiskCacheFile
+{
+public:
+  explicit IndexedDiskCacheFile(u32 key_size);
+  ~IndexedDiskCacheFile();
+
+  IndexedDiskCacheFile(const IndexedDiskCacheFile&) = delete;
+  IndexedDiskCacheFile& operator=(const IndexedDiskCacheFile&) = delete;
+
+  // Opens or creates the cache. Files written by other versions of Dolphin are discarded.
+  bool Open(const std::string& filename);
+  // Compacts the data file if necessary, and writes the index file.
+  void Close();
+  bool IsOpen() const;
+
+  size_t GetEntryCount() const;
+  bool Contains(const void* key) const;
+  // Copies the value of a key. Returns false if the key isn't in the cache, or if its record is
+  // corrupted, in which case it is removed.
+  bool Lookup(const void* key, std::vector<u8>* value);
+  // Adds an entry, replacing any previous value of the key.
+  void Append(const void* key, const u8* value, u32 value_size);
+  void Remove(const void* key);
+  // Removes every entry, and truncates the files.
+  void Clear();
+
+private:
+  struct Entry
+  {
+    u64 offset;
+    u32 value_size;
+  };
+
+  bool OpenDataFile();
+  bool CreateDataFile();
+  u64 LoadIndex();
+  void ScanRecords(u64 offset);
+  void WriteIndex();
+  void Compact();
+  bool ReadRecord(const Entry& entry, std::vector<u8>* record);
+  void AddEntry(std::string key, const Entry& entry);
+  void RemoveEntry(std::unordered_map<std::string, Entry>::iterator it);
+  u64 GetRecordSize(u32 value_size) const;
+  std::string GetIndexFilename() const;
+
+  void Map();
+  void Unmap();
+
+  const u32 m_key_size;
+  std::string m_filename;
+  File::IOFile m_file;
+  u64 m_file_id = 0;
+  // End of the last record.
+  u64 m_data_size = 0;
+  // Size of the replaced and removed records.
+  u64 m_unused_size = 0;
+  std::unordered_map<std::string, Entry> m_index;
+
+  // Records appended since the file was mapped are read through m_file.
+  const u8* m_mapped_data = nullptr;
+  u64 m_mapped_size = 0;
+#ifdef _WIN32
+  void* m_mapping_handle = nullptr;
+#endif
+
+  mutable std::mutex m_mutex;
+};
+
+// K is a trivially copyable key type, whose bytes are stored in the cache.
+template <typename K>
+class IndexedDiskCache
+{
+public:
+  static_assert(std::is_trivially_copyable_v<K>, "K must be a trivially copyable type");
+
+  IndexedDiskCache() : m_file(sizeof(K)) {}
+
+  bool Open(const std::string& filename) { return m_file.Open(filename); }
+  void Close() { m_file.Close(); }
+  bool IsOpen() const { return m_file.IsOpen(); }
+
+  size_t GetEntryCount() const { return m_file.GetEntryCount(); }
+  bool Contains(const K& key) const { return m_file.Contains(&key); }
+  bool Lookup(const K& key, std::vector<u8>* value) { return m_file.Lookup(&key, value); }
+  void Append(const K& key, const u8* value, u32 value_size)
+  {
+    m_file.Append(&key, value, value_size);
+  }
+  void Remove(const K& key) { m_file.Remove(&key); }
+  void Clear() { m_file.Clear(); }
+
+  // Adds the entries of a LinearDiskCache<K, u8> file that aren't in this cache yet, then deletes
+  // the old file. Returns the number of entries in the old file.
+  u32 ImportLinearDiskCache(const std::string& filename)
+  {
+    if (!File::Exists(filename))
+      return 0;
+
+    class Importer : public LinearDiskCacheReader<K, u8>
+    {
+    public:
+      explicit Importer(IndexedDiskCache& cache_) : cache(cache_) {}
+      void Read(const K& key, const u8* value, u32 value_size) override
+      {
+        if (!cache.Contains(key))
+          cache.Append(key, value, value_size);
+      }
+
+    private:
+      IndexedDiskCache& cache;
+    };
+
+    LinearDiskCache<K, u8> linear_cache;
+    Importer importer(*this);
+    const u32 count = linear_cache.OpenAndRead(filename, importer);
+    linear_cache.Close();
+    File::Delete(filename);
+    return count;
+  }
+
+private:
+  IndexedDiskCacheFile m_file;
+};
+}  // namespace Common
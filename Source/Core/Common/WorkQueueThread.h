@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <functional>
+#include <mutex>
 #include <queue>
 #include <thread>
 
@@ -40,6 +42,13 @@ public:
     m_wakeup.Set();
   }
 
+  // Blocks until every item that has been placed into the queue has been processed
+  void WaitForCompletion()
+  {
+    std::unique_lock lg(m_lock);
+    m_idle.wait(lg, [this] { return m_items.empty() && !m_busy; });
+  }
+
 private:
   void Shutdown()
   {
@@ -64,9 +73,15 @@ private:
           break;
         T item{std::move(m_items.front())};
         m_items.pop();
+        m_busy = true;
         lg.unlock();
 
         m_function(std::move(item));
+
+        lg.lock();
+        m_busy = false;
+        if (m_items.empty())
+          m_idle.notify_all();
       }
 
       if (m_shutdown.IsSet())
@@ -79,7 +94,9 @@ private:
   Common::Event m_wakeup;
   Common::Flag m_shutdown;
   std::mutex m_lock;
+  std::condition_variable m_idle;
   std::queue<T> m_items;
+  bool m_busy = false;
 };
 
 }  // namespace Common
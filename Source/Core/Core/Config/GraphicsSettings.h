@@ -37,6 +37,7 @@ extern const ConfigInfo<bool> GFX_OVERLAY_PROJ_STATS;
 extern const ConfigInfo<bool> GFX_DUMP_TEXTURES;
 extern const ConfigInfo<bool> GFX_HIRES_TEXTURES;
 extern const ConfigInfo<bool> GFX_CACHE_HIRES_TEXTURES;
+extern const ConfigInfo<int> GFX_HIRES_TEXTURES_MEMORY_BUDGET;
 extern const ConfigInfo<bool> GFX_DUMP_EFB_TARGET;
 extern const ConfigInfo<bool> GFX_DUMP_XFB_TARGET;
 extern const ConfigInfo<bool> GFX_DUMP_FRAMES_AS_IMAGES;
@@ -67,6 +68,7 @@ extern const ConfigInfo<bool> GFX_WAIT_FOR_SHADERS_BEFORE_STARTING;
 extern const ConfigInfo<ShaderCompilationMode> GFX_SHADER_COMPILATION_MODE;
 extern const ConfigInfo<int> GFX_SHADER_COMPILER_THREADS;
 extern const ConfigInfo<int> GFX_SHADER_PRECOMPILER_THREADS;
+extern const ConfigInfo<int> GFX_SHADER_PRECOMPILE_COVERAGE;
 extern const ConfigInfo<bool> GFX_SAVE_TEXTURE_CACHE_TO_STATE;
 
 extern const ConfigInfo<bool> GFX_SW_ZCOMPLOC;
@@ -76,6 +78,7 @@ extern const ConfigInfo<bool> GFX_SW_DUMP_TEV_STAGES;
 extern const ConfigInfo<bool> GFX_SW_DUMP_TEV_TEX_FETCHES;
 extern const ConfigInfo<int> GFX_SW_DRAW_START;
 extern const ConfigInfo<int> GFX_SW_DRAW_END;
+extern const ConfigInfo<int> GFX_SW_RASTERIZER_THREADS;
 
 extern const ConfigInfo<bool> GFX_PREFER_GLES;
 
@@ -119,6 +122,9 @@ extern const ConfigInfo<bool> GFX_HACK_SKIP_DUPLICATE_XFBS;
 extern const ConfigInfo<bool> GFX_HACK_COPY_EFB_SCALED;
 extern const ConfigInfo<bool> GFX_HACK_EFB_EMULATE_FORMAT_CHANGES;
 extern const ConfigInfo<bool> GFX_HACK_VERTEX_ROUDING;
+extern const ConfigInfo<bool> GFX_HACK_WRITE_TRACKED_TEXTURE_CACHE;
+extern const ConfigInfo<bool> GFX_HACK_DISPLAY_LIST_CACHE;
+extern const ConfigInfo<bool> GFX_HACK_MERGE_DRAWS;
 
 // Graphics.GameSpecific
 
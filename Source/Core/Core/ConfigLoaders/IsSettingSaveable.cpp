@@ -28,13 +28,14 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       return true;
   }
 
-  static constexpr std::array<const Config::ConfigLocation*, 93> s_setting_saveable = {
+  static constexpr std::array<const Config::ConfigLocation*, 100> s_setting_saveable = {
       // Main.Core
 
       &Config::MAIN_DEFAULT_ISO.location,
       &Config::MAIN_MEMCARD_A_PATH.location,
       &Config::MAIN_MEMCARD_B_PATH.location,
       &Config::MAIN_AUTO_DISC_CHANGE.location,
+      &Config::MAIN_DVD_PREFETCH.location,
       &Config::MAIN_DPL2_DECODER.location,
       &Config::MAIN_DPL2_QUALITY.location,
 
@@ -66,6 +67,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       &Config::GFX_DUMP_TEXTURES.location,
       &Config::GFX_HIRES_TEXTURES.location,
       &Config::GFX_CACHE_HIRES_TEXTURES.location,
+      &Config::GFX_HIRES_TEXTURES_MEMORY_BUDGET.location,
       &Config::GFX_DUMP_EFB_TARGET.location,
       &Config::GFX_DUMP_FRAMES_AS_IMAGES.location,
       &Config::GFX_FREE_LOOK.location,
@@ -95,6 +97,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       &Config::GFX_SHADER_COMPILATION_MODE.location,
       &Config::GFX_SHADER_COMPILER_THREADS.location,
       &Config::GFX_SHADER_PRECOMPILER_THREADS.location,
+      &Config::GFX_SHADER_PRECOMPILE_COVERAGE.location,
       &Config::GFX_SAVE_TEXTURE_CACHE_TO_STATE.location,
 
       &Config::GFX_SW_ZCOMPLOC.location,
@@ -104,6 +107,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       &Config::GFX_SW_DUMP_TEV_TEX_FETCHES.location,
       &Config::GFX_SW_DRAW_START.location,
       &Config::GFX_SW_DRAW_END.location,
+      &Config::GFX_SW_RASTERIZER_THREADS.location,
 
       // Graphics.Enhancements
 
@@ -140,6 +144,9 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       &Config::GFX_HACK_COPY_EFB_SCALED.location,
       &Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES.location,
       &Config::GFX_HACK_VERTEX_ROUDING.location,
+      &Config::GFX_HACK_WRITE_TRACKED_TEXTURE_CACHE.location,
+      &Config::GFX_HACK_DISPLAY_LIST_CACHE.location,
+      &Config::GFX_HACK_MERGE_DRAWS.location,
 
       // Graphics.GameSpecific
 
@@ -290,6 +290,8 @@ void SConfig::SaveFifoPlayerSettings(IniFile& ini)
   IniFile::Section* fifoplayer = ini.GetOrCreateSection("FifoPlayer");
 
   fifoplayer->Set("LoopReplay", bLoopFifoReplay);
+  fifoplayer->Set("TurboReplay", bFifoTurboReplay);
+  fifoplayer->Set("TurboReplayLoops", iFifoTurboReplayLoops);
 }
 
 void SConfig::SaveNetworkSettings(IniFile& ini)
@@ -581,6 +583,8 @@ void SConfig::LoadFifoPlayerSettings(IniFile& ini)
   IniFile::Section* fifoplayer = ini.GetOrCreateSection("FifoPlayer");
 
   fifoplayer->Get("LoopReplay", &bLoopFifoReplay, true);
+  fifoplayer->Get("TurboReplay", &bFifoTurboReplay, false);
+  fifoplayer->Get("TurboReplayLoops", &iFifoTurboReplayLoops, 1);
 }
 
 void SConfig::LoadNetworkSettings(IniFile& ini)
@@ -795,6 +799,8 @@ void SConfig::LoadDefaults()
   m_analytics_permission_asked = false;
 
   bLoopFifoReplay = true;
+  bFifoTurboReplay = false;
+  iFifoTurboReplayLoops = 1;
 
   bJITOff = false;  // debugger only settings
   bJITLoadStoreOff = false;
@@ -170,6 +170,10 @@ struct SConfig
 
   // Fifo Player related settings
   bool bLoopFifoReplay = true;
+  // Decodes the frames right away instead of writing them to the emulated FIFO, for benchmarking.
+  bool bFifoTurboReplay = false;
+  // How often the frame range is replayed in turbo mode before the emulation stops, 0 for no limit.
+  int iFifoTurboReplayLoops = 1;
 
   // Custom RTC
   bool bEnableCustomRTC;
@@ -50,6 +50,7 @@
 #include "Core/HW/GCKeyboard.h"
 #include "Core/HW/GCPad.h"
 #include "Core/HW/HW.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/Wiimote.h"
@@ -328,7 +329,11 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
   DolphinAnalytics::Instance().ReportGameStart();
 
   if (_CoreParameter.bFastmem)
+  {
     EMM::InstallExceptionHandler();  // Let's run under memory watch
+    if (EMM::HandlesFaultsOnAllThreads())
+      Memory::SetWriteTrackingAvailable(true);
+  }
 
 #ifdef USE_MEMORYWATCHER
   s_memory_watcher = std::make_unique<MemoryWatcher>();
@@ -371,7 +376,10 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
   s_is_started = false;
 
   if (_CoreParameter.bFastmem)
+  {
+    Memory::SetWriteTrackingAvailable(false);
     EMM::UninstallExceptionHandler();
+  }
 }
 
 static void FifoPlayerThread(const std::optional<std::string>& savestate_path,
@@ -5,18 +5,24 @@
 #include "Core/FifoPlayer/FifoDataFile.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <mbedtls/sha1.h>
+#include <zlib.h>
+
 #include "Common/File.h"
+#include "Common/Logging/Log.h"
 
 enum
 {
   FILE_ID = 0x0d01f1f0,
-  VERSION_NUMBER = 4,
-  MIN_LOADER_VERSION = 1,
+  VERSION_NUMBER = 5,
+  MIN_LOADER_VERSION = 5,
 };
 
 #pragma pack(push, 1)
@@ -39,10 +45,15 @@ struct FileHeader
   u32 flags;
   u64 texMemOffset;
   u32 texMemSize;
-  u8 reserved[40];
+  // Added in version 5
+  u64 memoryBlobListOffset;
+  u32 memoryBlobCount;
+  u8 reserved[28];
 };
 static_assert(sizeof(FileHeader) == 128, "FileHeader should be 128 bytes");
 
+// Since version 5, fifoDataOffset points to a zlib compressed chunk that holds the FIFO data
+// followed by the FileMemoryUpdate list, and memoryUpdatesOffset is unused.
 struct FileFrameInfo
 {
   u64 fifoDataOffset;
@@ -51,10 +62,14 @@ struct FileFrameInfo
   u32 fifoEnd;
   u64 memoryUpdatesOffset;
   u32 numMemoryUpdates;
-  u8 reserved[32];
+  // Added in version 5
+  u32 compressedSize;
+  u64 memoryDataSize;
+  u8 reserved[20];
 };
 static_assert(sizeof(FileFrameInfo) == 64, "FileFrameInfo should be 64 bytes");
 
+// Since version 5, dataOffset is the index of a FileMemoryBlob.
 struct FileMemoryUpdate
 {
   u32 fifoPosition;
@@ -66,8 +81,61 @@ struct FileMemoryUpdate
 };
 static_assert(sizeof(FileMemoryUpdate) == 24, "FileMemoryUpdate should be 24 bytes");
 
+// Added in version 5. The zlib compressed data of the memory updates, stored once for all of the
+// updates with the same data.
+struct FileMemoryBlob
+{
+  u64 offset;
+  u32 compressedSize;
+  u32 size;
+};
+static_assert(sizeof(FileMemoryBlob) == 16, "FileMemoryBlob should be 16 bytes");
+
 #pragma pack(pop)
 
+// Returns an empty vector on failure.
+static std::vector<u8> Compress(const u8* data, size_t size)
+{
+  uLongf compressedSize = compressBound(static_cast<uLong>(size));
+  std::vector<u8> compressed(compressedSize);
+  if (compress2(compressed.data(), &compressedSize, data, static_cast<uLong>(size),
+                Z_DEFAULT_COMPRESSION) != Z_OK)
+  {
+    return {};
+  }
+
+  compressed.resize(compressedSize);
+  return compressed;
+}
+
+// Decompresses the start of a zlib stream, until the output is full.
+static bool Decompress(std::vector<u8>& compressed, u8* out, size_t outSize)
+{
+  z_stream stream = {};
+  if (inflateInit(&stream) != Z_OK)
+    return false;
+
+  stream.next_in = compressed.data();
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  stream.next_out = out;
+  stream.avail_out = static_cast<uInt>(outSize);
+
+  int status = Z_OK;
+  while (stream.avail_out != 0 && status == Z_OK)
+    status = inflate(&stream, Z_NO_FLUSH);
+
+  inflateEnd(&stream);
+  return stream.avail_out == 0;
+}
+
+static size_t GetFrameBytes(const FifoFrameInfo& frame)
+{
+  size_t size = frame.fifoData.size();
+  for (const MemoryUpdate& update : frame.memoryUpdates)
+    size += update.data.size();
+  return size;
+}
+
 FifoDataFile::FifoDataFile() = default;
 
 FifoDataFile::~FifoDataFile() = default;
@@ -94,7 +162,55 @@ bool FifoDataFile::GetIsWii() const
 
 void FifoDataFile::AddFrame(const FifoFrameInfo& frameInfo)
 {
-  m_Frames.push_back(frameInfo);
+  m_Frames.push_back(std::make_shared<FifoFrameInfo>(frameInfo));
+  const size_t fifoBytes = frameInfo.fifoData.size();
+  m_FrameSizes.push_back({static_cast<u32>(fifoBytes), GetFrameBytes(frameInfo) - fifoBytes});
+}
+
+std::shared_ptr<const FifoFrameInfo> FifoDataFile::GetFrame(u32 frame)
+{
+  std::lock_guard<std::mutex> lk(m_FileMutex);
+  if (m_Frames[frame])
+    return m_Frames[frame];
+
+  std::shared_ptr<const FifoFrameInfo> frameInfo = ReadFrame(frame);
+  if (!frameInfo)
+  {
+    ERROR_LOG(VIDEO, "Failed to read frame %u of the FIFO log", frame);
+    return nullptr;
+  }
+
+  m_Frames[frame] = frameInfo;
+  m_LoadedFrames.push_back(frame);
+  m_LoadedFrameBytes += GetFrameBytes(*frameInfo);
+
+  // Drop the frames that were read first, whoever still uses them keeps their own reference.
+  while (m_LoadedFrameBytes > MAX_LOADED_FRAME_BYTES && m_LoadedFrames.size() > 1)
+  {
+    const u32 oldest = m_LoadedFrames.front();
+    m_LoadedFrames.pop_front();
+    m_LoadedFrameBytes -= GetFrameBytes(*m_Frames[oldest]);
+    m_Frames[oldest].reset();
+  }
+
+  return frameInfo;
+}
+
+std::vector<u8> FifoDataFile::GetFrameFifoData(u32 frame)
+{
+  std::lock_guard<std::mutex> lk(m_FileMutex);
+  if (m_Frames[frame])
+    return m_Frames[frame]->fifoData;
+
+  const FrameLocation& location = m_FrameLocations[frame];
+  std::vector<u8> fifoData;
+  if (!ReadFrameChunk(location, location.fifoDataSize, &fifoData))
+  {
+    ERROR_LOG(VIDEO, "Failed to read frame %u of the FIFO log", frame);
+    fifoData.clear();
+  }
+
+  return fifoData;
 }
 
 bool FifoDataFile::Save(const std::string& filename)
@@ -125,8 +241,68 @@ bool FifoDataFile::Save(const std::string& filename)
   u64 texMemOffset = file.Tell();
   file.WriteArray(m_TexMem, TEX_MEM_SIZE);
 
+  // Write frames. Memory updates often upload the same data again, e.g. the textures and vertices
+  // of every frame, so each distinct piece of data is only written once.
+  std::vector<FileFrameInfo> frameList(m_Frames.size());
+  std::vector<FileMemoryBlob> memoryBlobs;
+  std::map<std::array<u8, 20>, u32> memoryBlobIndices;
+  for (u32 i = 0; i < m_Frames.size(); ++i)
+  {
+    const std::shared_ptr<const FifoFrameInfo> srcFrame = GetFrame(i);
+    if (!srcFrame)
+      return false;
+
+    std::vector<u8> chunk(srcFrame->fifoData);
+    chunk.reserve(chunk.size() + srcFrame->memoryUpdates.size() * sizeof(FileMemoryUpdate));
+    for (const MemoryUpdate& srcUpdate : srcFrame->memoryUpdates)
+    {
+      std::array<u8, 20> hash;
+      mbedtls_sha1_ret(srcUpdate.data.data(), srcUpdate.data.size(), hash.data());
+      const auto blob = memoryBlobIndices.try_emplace(hash, static_cast<u32>(memoryBlobs.size()));
+      if (blob.second)
+      {
+        const std::vector<u8> compressed = Compress(srcUpdate.data.data(), srcUpdate.data.size());
+        if (compressed.empty())
+          return false;
+
+        FileMemoryBlob& dstBlob = memoryBlobs.emplace_back();
+        dstBlob.offset = file.Tell();
+        dstBlob.compressedSize = static_cast<u32>(compressed.size());
+        dstBlob.size = static_cast<u32>(srcUpdate.data.size());
+        file.WriteBytes(compressed.data(), compressed.size());
+      }
+
+      FileMemoryUpdate dstUpdate = {};
+      dstUpdate.address = srcUpdate.address;
+      dstUpdate.dataOffset = blob.first->second;
+      dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
+      dstUpdate.fifoPosition = srcUpdate.fifoPosition;
+      dstUpdate.type = srcUpdate.type;
+
+      const u8* dstUpdateBytes = reinterpret_cast<const u8*>(&dstUpdate);
+      chunk.insert(chunk.end(), dstUpdateBytes, dstUpdateBytes + sizeof(FileMemoryUpdate));
+    }
+
+    const std::vector<u8> compressed = Compress(chunk.data(), chunk.size());
+    if (compressed.empty())
+      return false;
+
+    FileFrameInfo& dstFrame = frameList[i];
+    dstFrame.fifoDataSize = static_cast<u32>(srcFrame->fifoData.size());
+    dstFrame.memoryDataSize = m_FrameSizes[i].memoryBytes;
+    dstFrame.fifoDataOffset = file.Tell();
+    dstFrame.compressedSize = static_cast<u32>(compressed.size());
+    dstFrame.fifoStart = srcFrame->fifoStart;
+    dstFrame.fifoEnd = srcFrame->fifoEnd;
+    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame->memoryUpdates.size());
+    file.WriteBytes(compressed.data(), compressed.size());
+  }
+
+  u64 memoryBlobListOffset = file.Tell();
+  file.WriteArray(memoryBlobs.data(), memoryBlobs.size());
+
   // Write header
-  FileHeader header;
+  FileHeader header = {};
   header.fileId = FILE_ID;
   header.file_version = VERSION_NUMBER;
   header.min_loader_version = MIN_LOADER_VERSION;
@@ -149,36 +325,17 @@ bool FifoDataFile::Save(const std::string& filename)
   header.frameListOffset = frameListOffset;
   header.frameCount = (u32)m_Frames.size();
 
+  header.memoryBlobListOffset = memoryBlobListOffset;
+  header.memoryBlobCount = (u32)memoryBlobs.size();
+
   header.flags = m_Flags;
 
   file.Seek(0, SEEK_SET);
   file.WriteBytes(&header, sizeof(FileHeader));
 
   // Write frames list
-  for (unsigned int i = 0; i < m_Frames.size(); ++i)
-  {
-    const FifoFrameInfo& srcFrame = m_Frames[i];
-
-    // Write FIFO data
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcFrame.fifoData.data(), srcFrame.fifoData.size());
-
-    u64 memoryUpdatesOffset = WriteMemoryUpdates(srcFrame.memoryUpdates, file);
-
-    FileFrameInfo dstFrame;
-    dstFrame.fifoDataSize = static_cast<u32>(srcFrame.fifoData.size());
-    dstFrame.fifoDataOffset = dataOffset;
-    dstFrame.fifoStart = srcFrame.fifoStart;
-    dstFrame.fifoEnd = srcFrame.fifoEnd;
-    dstFrame.memoryUpdatesOffset = memoryUpdatesOffset;
-    dstFrame.numMemoryUpdates = static_cast<u32>(srcFrame.memoryUpdates.size());
-
-    // Write frame info
-    u64 frameOffset = frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, SEEK_SET);
-    file.WriteBytes(&dstFrame, sizeof(FileFrameInfo));
-  }
+  file.Seek(frameListOffset, SEEK_SET);
+  file.WriteArray(frameList.data(), frameList.size());
 
   if (!file.Close())
     return false;
@@ -188,22 +345,21 @@ bool FifoDataFile::Save(const std::string& filename)
 
 std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bool flagsOnly)
 {
-  File::IOFile file;
+  auto dataFile = std::make_unique<FifoDataFile>();
+
+  // The file stays open to read the frames from when they are needed.
+  File::IOFile& file = dataFile->m_File;
   file.Open(filename, "rb");
   if (!file)
     return nullptr;
 
   FileHeader header;
-  file.ReadBytes(&header, sizeof(header));
-
-  if (header.fileId != FILE_ID || header.min_loader_version > VERSION_NUMBER)
+  if (!file.ReadBytes(&header, sizeof(header)) || header.fileId != FILE_ID ||
+      header.min_loader_version > VERSION_NUMBER)
   {
-    file.Close();
     return nullptr;
   }
 
-  auto dataFile = std::make_unique<FifoDataFile>();
-
   dataFile->m_Flags = header.flags;
   dataFile->m_Version = header.file_version;
 
@@ -238,29 +394,55 @@ std::unique_ptr<FifoDataFile> FifoDataFile::Load(const std::string& filename, bo
     file.ReadArray(dataFile->m_TexMem, size);
   }
 
-  // Read frames
-  for (u32 i = 0; i < header.frameCount; ++i)
-  {
-    u64 frameOffset = header.frameListOffset + (i * sizeof(FileFrameInfo));
-    file.Seek(frameOffset, SEEK_SET);
-    FileFrameInfo srcFrame;
-    file.ReadBytes(&srcFrame, sizeof(FileFrameInfo));
+  // Read frame list, the frames themselves are read by GetFrame
+  std::vector<FileFrameInfo> frameList(header.frameCount);
+  file.Seek(header.frameListOffset, SEEK_SET);
+  if (!file.ReadArray(frameList.data(), frameList.size()))
+    return nullptr;
 
-    FifoFrameInfo dstFrame;
-    dstFrame.fifoData.resize(srcFrame.fifoDataSize);
+  dataFile->m_FrameLocations.reserve(frameList.size());
+  dataFile->m_FrameSizes.reserve(frameList.size());
+  std::vector<FileMemoryUpdate> memoryUpdates;
+  for (const FileFrameInfo& srcFrame : frameList)
+  {
+    // Before version 5, the size of the memory updates is only in their uncompressed list.
+    u64 memoryDataSize = srcFrame.memoryDataSize;
+    if (dataFile->m_Version < 5)
+    {
+      memoryUpdates.resize(srcFrame.numMemoryUpdates);
+      file.Seek(srcFrame.memoryUpdatesOffset, SEEK_SET);
+      if (!file.ReadArray(memoryUpdates.data(), memoryUpdates.size()))
+        return nullptr;
+
+      memoryDataSize = 0;
+      for (const FileMemoryUpdate& update : memoryUpdates)
+        memoryDataSize += update.dataSize;
+    }
+    dataFile->m_FrameSizes.push_back({srcFrame.fifoDataSize, memoryDataSize});
+
+    FrameLocation& dstFrame = dataFile->m_FrameLocations.emplace_back();
+    dstFrame.fifoDataOffset = srcFrame.fifoDataOffset;
+    dstFrame.fifoDataSize = srcFrame.fifoDataSize;
+    dstFrame.compressedSize = dataFile->m_Version >= 5 ? srcFrame.compressedSize : 0;
+    dstFrame.memoryUpdatesOffset = srcFrame.memoryUpdatesOffset;
+    dstFrame.numMemoryUpdates = srcFrame.numMemoryUpdates;
     dstFrame.fifoStart = srcFrame.fifoStart;
     dstFrame.fifoEnd = srcFrame.fifoEnd;
-
-    file.Seek(srcFrame.fifoDataOffset, SEEK_SET);
-    file.ReadBytes(dstFrame.fifoData.data(), srcFrame.fifoDataSize);
-
-    ReadMemoryUpdates(srcFrame.memoryUpdatesOffset, srcFrame.numMemoryUpdates,
-                      dstFrame.memoryUpdates, file);
-
-    dataFile->AddFrame(dstFrame);
   }
+  dataFile->m_Frames.resize(frameList.size());
 
-  file.Close();
+  // Compressed memory updates were added in version 5.
+  if (dataFile->m_Version >= 5)
+  {
+    std::vector<FileMemoryBlob> memoryBlobs(header.memoryBlobCount);
+    file.Seek(header.memoryBlobListOffset, SEEK_SET);
+    if (!file.ReadArray(memoryBlobs.data(), memoryBlobs.size()))
+      return nullptr;
+
+    dataFile->m_MemoryBlobs.reserve(memoryBlobs.size());
+    for (const FileMemoryBlob& srcBlob : memoryBlobs)
+      dataFile->m_MemoryBlobs.push_back({srcBlob.offset, srcBlob.compressedSize, srcBlob.size});
+  }
 
   return dataFile;
 }
@@ -284,56 +466,97 @@ bool FifoDataFile::GetFlag(u32 flag) const
   return !!(m_Flags & flag);
 }
 
-u64 FifoDataFile::WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates,
-                                     File::IOFile& file)
+std::unique_ptr<FifoFrameInfo> FifoDataFile::ReadFrame(u32 frame)
 {
-  // Add space for memory update list
-  u64 updateListOffset = file.Tell();
-  PadFile(memUpdates.size() * sizeof(FileMemoryUpdate), file);
+  const FrameLocation& location = m_FrameLocations[frame];
+  const size_t updatesSize = location.numMemoryUpdates * sizeof(FileMemoryUpdate);
 
-  for (unsigned int i = 0; i < memUpdates.size(); ++i)
-  {
-    const MemoryUpdate& srcUpdate = memUpdates[i];
+  auto frameInfo = std::make_unique<FifoFrameInfo>();
+  frameInfo->fifoStart = location.fifoStart;
+  frameInfo->fifoEnd = location.fifoEnd;
 
-    // Write memory
-    file.Seek(0, SEEK_END);
-    u64 dataOffset = file.Tell();
-    file.WriteBytes(srcUpdate.data.data(), srcUpdate.data.size());
+  std::vector<u8> fileUpdates;
+  if (location.compressedSize != 0)
+  {
+    std::vector<u8> chunk;
+    if (!ReadFrameChunk(location, location.fifoDataSize + updatesSize, &chunk))
+      return nullptr;
 
-    FileMemoryUpdate dstUpdate;
-    dstUpdate.address = srcUpdate.address;
-    dstUpdate.dataOffset = dataOffset;
-    dstUpdate.dataSize = static_cast<u32>(srcUpdate.data.size());
-    dstUpdate.fifoPosition = srcUpdate.fifoPosition;
-    dstUpdate.type = srcUpdate.type;
+    frameInfo->fifoData.assign(chunk.begin(), chunk.begin() + location.fifoDataSize);
+    fileUpdates.assign(chunk.begin() + location.fifoDataSize, chunk.end());
+  }
+  else
+  {
+    if (!ReadFrameChunk(location, location.fifoDataSize, &frameInfo->fifoData))
+      return nullptr;
 
-    u64 updateOffset = updateListOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, SEEK_SET);
-    file.WriteBytes(&dstUpdate, sizeof(FileMemoryUpdate));
+    fileUpdates.resize(updatesSize);
+    m_File.Seek(location.memoryUpdatesOffset, SEEK_SET);
+    if (!m_File.ReadBytes(fileUpdates.data(), fileUpdates.size()))
+      return nullptr;
   }
 
-  return updateListOffset;
+  if (!ReadMemoryUpdates(fileUpdates.data(), location.numMemoryUpdates, frameInfo->memoryUpdates))
+    return nullptr;
+
+  return frameInfo;
 }
 
-void FifoDataFile::ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
-                                     std::vector<MemoryUpdate>& memUpdates, File::IOFile& file)
+bool FifoDataFile::ReadFrameChunk(const FrameLocation& location, size_t size,
+                                  std::vector<u8>* chunk)
+{
+  // Don't let a frame that failed to read fail the others.
+  m_File.Clear();
+
+  chunk->resize(size);
+  m_File.Seek(location.fifoDataOffset, SEEK_SET);
+  if (location.compressedSize == 0)
+    return m_File.ReadBytes(chunk->data(), size);
+
+  // Only the requested start of the chunk is decompressed.
+  std::vector<u8> compressed(location.compressedSize);
+  return m_File.ReadBytes(compressed.data(), compressed.size()) &&
+         Decompress(compressed, chunk->data(), size);
+}
+
+bool FifoDataFile::ReadMemoryUpdates(const u8* fileUpdates, u32 numUpdates,
+                                     std::vector<MemoryUpdate>& memUpdates)
 {
   memUpdates.resize(numUpdates);
 
+  std::vector<u8> compressed;
   for (u32 i = 0; i < numUpdates; ++i)
   {
-    u64 updateOffset = fileOffset + (i * sizeof(FileMemoryUpdate));
-    file.Seek(updateOffset, SEEK_SET);
     FileMemoryUpdate srcUpdate;
-    file.ReadBytes(&srcUpdate, sizeof(FileMemoryUpdate));
+    std::memcpy(&srcUpdate, fileUpdates + i * sizeof(FileMemoryUpdate), sizeof(FileMemoryUpdate));
 
     MemoryUpdate& dstUpdate = memUpdates[i];
     dstUpdate.address = srcUpdate.address;
     dstUpdate.fifoPosition = srcUpdate.fifoPosition;
-    dstUpdate.data.resize(srcUpdate.dataSize);
     dstUpdate.type = static_cast<MemoryUpdate::Type>(srcUpdate.type);
 
-    file.Seek(srcUpdate.dataOffset, SEEK_SET);
-    file.ReadBytes(dstUpdate.data.data(), srcUpdate.dataSize);
+    if (m_Version < 5)
+    {
+      dstUpdate.data.resize(srcUpdate.dataSize);
+      m_File.Seek(srcUpdate.dataOffset, SEEK_SET);
+      if (!m_File.ReadBytes(dstUpdate.data.data(), srcUpdate.dataSize))
+        return false;
+      continue;
+    }
+
+    if (srcUpdate.dataOffset >= m_MemoryBlobs.size())
+      return false;
+
+    const MemoryBlob& blob = m_MemoryBlobs[srcUpdate.dataOffset];
+    compressed.resize(blob.compressedSize);
+    dstUpdate.data.resize(blob.size);
+    m_File.Seek(blob.offset, SEEK_SET);
+    if (!m_File.ReadBytes(compressed.data(), compressed.size()) ||
+        !Decompress(compressed, dstUpdate.data.data(), dstUpdate.data.size()))
+    {
+      return false;
+    }
   }
+
+  return true;
 }
@@ -4,18 +4,16 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/File.h"
 #include "VideoCommon/XFMemory.h"
 
-namespace File
-{
-class IOFile;
-}
-
 struct MemoryUpdate
 {
   enum Type
@@ -56,6 +54,13 @@ public:
   };
   static_assert((XF_MEM_SIZE + XF_REGS_SIZE) * sizeof(u32) == sizeof(XFMemory));
 
+  // The amount of data in a frame, which is known without reading the frame from the file.
+  struct FrameSize
+  {
+    u32 fifoBytes;
+    u64 memoryBytes;
+  };
+
   FifoDataFile();
   ~FifoDataFile();
 
@@ -70,8 +75,14 @@ public:
   u32* GetXFRegs() { return m_XFRegs; }
   u8* GetTexMem() { return m_TexMem; }
   void AddFrame(const FifoFrameInfo& frameInfo);
-  const FifoFrameInfo& GetFrame(u32 frame) const { return m_Frames[frame]; }
+  // The frames of a loaded file are only read from it when they are needed. The most recently
+  // read ones are kept in memory, up to MAX_LOADED_FRAME_BYTES. Returns nullptr if the frame
+  // couldn't be read.
+  std::shared_ptr<const FifoFrameInfo> GetFrame(u32 frame);
+  // Reads the FIFO data of a frame without its memory updates, which are usually much larger.
+  std::vector<u8> GetFrameFifoData(u32 frame);
   u32 GetFrameCount() const { return static_cast<u32>(m_Frames.size()); }
+  const FrameSize& GetFrameSize(u32 frame) const { return m_FrameSizes[frame]; }
   bool Save(const std::string& filename);
 
   static std::unique_ptr<FifoDataFile> Load(const std::string& filename, bool flagsOnly);
@@ -82,14 +93,46 @@ private:
     FLAG_IS_WII = 1
   };
 
+  static constexpr size_t MAX_LOADED_FRAME_BYTES = 256 * 1024 * 1024;
+
+  // Where a frame of a loaded file is stored.
+  struct FrameLocation
+  {
+    u64 fifoDataOffset;
+    u32 fifoDataSize;
+    // Size of the compressed chunk with the FIFO data and memory update list, 0 before version 5.
+    u32 compressedSize;
+    u64 memoryUpdatesOffset;
+    u32 numMemoryUpdates;
+    u32 fifoStart;
+    u32 fifoEnd;
+  };
+
+  // Since version 5, memory updates with the same data share a compressed blob.
+  struct MemoryBlob
+  {
+    u64 offset;
+    u32 compressedSize;
+    u32 size;
+  };
+
   void PadFile(size_t numBytes, File::IOFile& file);
 
   void SetFlag(u32 flag, bool set);
   bool GetFlag(u32 flag) const;
 
-  u64 WriteMemoryUpdates(const std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
-  static void ReadMemoryUpdates(u64 fileOffset, u32 numUpdates,
-                                std::vector<MemoryUpdate>& memUpdates, File::IOFile& file);
+  std::unique_ptr<FifoFrameInfo> ReadFrame(u32 frame);
+  bool ReadFrameChunk(const FrameLocation& location, size_t size, std::vector<u8>* chunk);
+  bool ReadMemoryUpdates(const u8* fileUpdates, u32 numUpdates,
+                         std::vector<MemoryUpdate>& memUpdates);
+
+  File::IOFile m_File;
+  std::mutex m_FileMutex;
+  std::vector<FrameLocation> m_FrameLocations;
+  std::vector<MemoryBlob> m_MemoryBlobs;
+  // Frames that were read from the file, in the order they were read.
+  std::deque<u32> m_LoadedFrames;
+  size_t m_LoadedFrameBytes = 0;
 
   u32 m_BPMem[BP_MEM_SIZE];
   u32 m_CPMem[CP_MEM_SIZE];
@@ -100,5 +143,7 @@ private:
   u32 m_Flags = 0;
   u32 m_Version = 0;
 
-  std::vector<FifoFrameInfo> m_Frames;
+  // Null for the frames that are only in the file.
+  std::vector<std::shared_ptr<const FifoFrameInfo>> m_Frames;
+  std::vector<FrameSize> m_FrameSizes;
 };
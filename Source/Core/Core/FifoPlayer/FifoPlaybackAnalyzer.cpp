@@ -40,37 +40,29 @@ void FifoPlaybackAnalyzer::AnalyzeFrames(FifoDataFile* file,
 
   for (u32 frameIdx = 0; frameIdx < file->GetFrameCount(); ++frameIdx)
   {
-    const FifoFrameInfo& frame = file->GetFrame(frameIdx);
+    // Only the FIFO data is needed, which avoids reading the memory updates of every frame.
+    const std::vector<u8> fifoData = file->GetFrameFifoData(frameIdx);
     AnalyzedFrameInfo& analyzed = frameInfo[frameIdx];
 
     s_DrawingObject = false;
 
     u32 cmdStart = 0;
-    u32 nextMemUpdate = 0;
 
 #if LOG_FIFO_CMDS
     // Debugging
     std::vector<CmdData> prevCmds;
 #endif
 
-    while (cmdStart < frame.fifoData.size())
+    while (cmdStart < fifoData.size())
     {
-      // Add memory updates that have occurred before this point in the frame
-      while (nextMemUpdate < frame.memoryUpdates.size() &&
-             frame.memoryUpdates[nextMemUpdate].fifoPosition <= cmdStart)
-      {
-        analyzed.memoryUpdates.push_back(frame.memoryUpdates[nextMemUpdate]);
-        ++nextMemUpdate;
-      }
-
       const bool wasDrawing = s_DrawingObject;
       const u32 cmdSize =
-          FifoAnalyzer::AnalyzeCommand(&frame.fifoData[cmdStart], DecodeMode::Playback);
+          FifoAnalyzer::AnalyzeCommand(&fifoData[cmdStart], DecodeMode::Playback);
 
 #if LOG_FIFO_CMDS
       CmdData cmdData;
       cmdData.offset = cmdStart;
-      cmdData.ptr = &frame.fifoData[cmdStart];
+      cmdData.ptr = &fifoData[cmdStart];
       cmdData.size = cmdSize;
       prevCmds.push_back(cmdData);
 #endif
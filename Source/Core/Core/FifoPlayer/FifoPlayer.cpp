@@ -7,8 +7,13 @@
 #include <algorithm>
 #include <mutex>
 
+#include <fmt/format.h>
+
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
+#include "Common/FPURoundMode.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -26,6 +31,8 @@
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/OpcodeDecoding.h"
 
 // We need to include TextureDecoder.h for the texMem array.
 // TODO: Move texMem somewhere else so this isn't an issue.
@@ -87,9 +94,14 @@ public:
 
     m_parent->m_CurrentFrame = m_parent->m_FrameRangeStart;
     m_parent->LoadMemory();
+    m_parent->StartTurboReplay();
   }
 
-  void Shutdown() override { IsPlayingBackFifologWithBrokenEFBCopies = false; }
+  void Shutdown() override
+  {
+    m_parent->StopTurboReplay();
+    IsPlayingBackFifologWithBrokenEFBCopies = false;
+  }
   void ClearCache() override
   {
     // Nothing to clear.
@@ -133,8 +145,23 @@ CPU::State FifoPlayer::AdvanceFrame()
 {
   if (m_CurrentFrame >= m_FrameRangeEnd)
   {
-    if (!m_Loop)
+    if (m_TurboReplay)
+    {
+      const u32 num_frames = m_FrameRangeEnd - m_FrameRangeStart;
+      const double frame_ms =
+          std::chrono::duration<double, std::milli>(m_TurboReplayLoopTime).count() /
+          std::max(num_frames, 1u);
+      NOTICE_LOG(VIDEO, "FIFO turbo replay loop %u: %u frames, %.3f ms per frame",
+                 m_TurboReplayLoop, num_frames, frame_ms);
+
+      m_TurboReplayLoopTime = {};
+      if (++m_TurboReplayLoop == m_TurboReplayLoops)
+        return CPU::State::PowerDown;
+    }
+    else if (!m_Loop)
+    {
       return CPU::State::PowerDown;
+    }
     // If there are zero frames in the range then sleep instead of busy spinning
     if (m_FrameRangeStart >= m_FrameRangeEnd)
       return CPU::State::Stepping;
@@ -151,15 +178,96 @@ CPU::State FifoPlayer::AdvanceFrame()
   if (m_FrameWrittenCb)
     m_FrameWrittenCb();
 
+  // Read the frame before timing it, it may have to be decompressed from the file.
+  const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(m_CurrentFrame);
+  if (!frame)
+    return CPU::State::PowerDown;
+
+  // The registers are loaded through the emulated FIFO even in turbo mode.
+  if (m_TurboReplay)
+    WaitForGPUIdle();
+
+  const auto start = std::chrono::steady_clock::now();
+  const GPUThreadProfiler::Times start_times = GPUThreadProfiler::GetTimes();
+
   if (m_EarlyMemoryUpdates && m_CurrentFrame == m_FrameRangeStart)
     WriteAllMemoryUpdates();
 
-  WriteFrame(m_File->GetFrame(m_CurrentFrame), m_FrameInfo[m_CurrentFrame]);
+  WriteFrame(*frame, m_FrameInfo[m_CurrentFrame]);
+
+  if (m_TurboReplay)
+    WriteTurboFrameTimes(start, start_times);
 
   ++m_CurrentFrame;
   return CPU::State::Running;
 }
 
+void FifoPlayer::StartTurboReplay()
+{
+  const SConfig& config = SConfig::GetInstance();
+  m_TurboReplay = false;
+  if (!config.bFifoTurboReplay)
+    return;
+
+  // Decoding on the CPU thread would race with the GPU thread.
+  if (config.bCPUThread)
+  {
+    WARN_LOG(VIDEO, "FIFO turbo replay needs single core mode, replaying normally");
+    Core::DisplayMessage("FIFO turbo replay is disabled in dual core mode", 5000);
+    return;
+  }
+
+  m_TurboReplay = true;
+  m_TurboReplayLoops = static_cast<u32>(std::max(config.iFifoTurboReplayLoops, 0));
+  m_TurboReplayLoop = 0;
+  m_TurboReplayLoopTime = {};
+  m_TurboFrameEndEvent = CoreTiming::RegisterEvent(
+      "FifoPlayerTurboFrameEnd", [](u64, s64) { GetInstance().m_TurboFrameEnded = true; });
+
+  // Nothing is gained from replaying faster than real time if the frame limiter waits afterwards.
+  Core::SetIsThrottlerTempDisabled(true);
+  GPUThreadProfiler::SetEnabled(true);
+
+  // The Logs directory is only created once something is logged to a file.
+  const std::string times_path = File::GetUserPath(D_LOGS_IDX) + "fifo_turbo_replay.csv";
+  File::CreateFullPath(times_path);
+  File::OpenFStream(m_TurboReplayTimesFile, times_path, std::ios_base::out);
+  if (!m_TurboReplayTimesFile.is_open())
+    ERROR_LOG(VIDEO, "Failed to open %s for the turbo replay frame times", times_path.c_str());
+  m_TurboReplayTimesFile << "loop,frame,total_us,opcode_decoding_us,vertex_loading_us,"
+                            "texture_loading_us,flush_us\n";
+}
+
+void FifoPlayer::StopTurboReplay()
+{
+  if (!m_TurboReplay)
+    return;
+
+  m_TurboReplay = false;
+  m_TurboReplayTimesFile.close();
+  GPUThreadProfiler::SetEnabled(false);
+  Core::SetIsThrottlerTempDisabled(false);
+}
+
+void FifoPlayer::WriteTurboFrameTimes(std::chrono::steady_clock::time_point start,
+                                      const GPUThreadProfiler::Times& start_times)
+{
+  using GPUThreadProfiler::Section;
+  const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+  const GPUThreadProfiler::Times times = GPUThreadProfiler::GetTimes();
+  const auto get_us = [&](Section section) {
+    const size_t index = static_cast<size_t>(section);
+    return std::chrono::duration<double, std::micro>(times[index] - start_times[index]).count();
+  };
+
+  m_TurboReplayLoopTime += elapsed;
+  m_TurboReplayTimesFile << fmt::format(
+      "{},{},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f}\n", m_TurboReplayLoop, m_CurrentFrame,
+      std::chrono::duration<double, std::micro>(elapsed).count(),
+      get_us(Section::OpcodeDecoding), get_us(Section::VertexLoading),
+      get_us(Section::TextureLoading), get_us(Section::Flush));
+}
+
 std::unique_ptr<CPUCoreBase> FifoPlayer::GetCPUCore()
 {
   if (!m_File || m_File->GetFrameCount() == 0)
@@ -245,6 +353,8 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
   m_CyclesPerFrame = SystemTimers::GetTicksPerSecond() / VideoInterface::GetTargetRefreshRate();
   m_ElapsedCycles = 0;
   m_FrameFifoSize = static_cast<u32>(frame.fifoData.size());
+  m_DecodedFifoPosition = 0;
+  m_DecodedFifoEnd = 0;
 
   // Determine start and end objects
   u32 numObjects = (u32)(info.objectStarts.size());
@@ -267,7 +377,7 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
     // Write fifo data skipping objects before the draw range
     while (objectNum < drawStart)
     {
-      WriteFramePart(position, info.objectStarts[objectNum], memoryUpdate, frame, info);
+      WriteFramePart(position, info.objectStarts[objectNum], memoryUpdate, frame);
 
       position = info.objectEnds[objectNum];
       ++objectNum;
@@ -277,7 +387,7 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
     if (objectNum < numObjects && drawStart <= drawEnd)
     {
       objectNum = drawEnd;
-      WriteFramePart(position, info.objectEnds[objectNum], memoryUpdate, frame, info);
+      WriteFramePart(position, info.objectEnds[objectNum], memoryUpdate, frame);
       position = info.objectEnds[objectNum];
       ++objectNum;
     }
@@ -285,7 +395,7 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
     // Write fifo data skipping objects after the draw range
     while (objectNum < numObjects)
     {
-      WriteFramePart(position, info.objectStarts[objectNum], memoryUpdate, frame, info);
+      WriteFramePart(position, info.objectStarts[objectNum], memoryUpdate, frame);
 
       position = info.objectEnds[objectNum];
       ++objectNum;
@@ -293,26 +403,33 @@ void FifoPlayer::WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo&
   }
 
   // Write data after the last object
-  WriteFramePart(position, static_cast<u32>(frame.fifoData.size()), memoryUpdate, frame, info);
+  WriteFramePart(position, static_cast<u32>(frame.fifoData.size()), memoryUpdate, frame);
 
-  FlushWGP();
-
-  // Sleep while the GPU is active
-  while (!IsIdleSet() && CPU::GetState() != CPU::State::PowerDown)
+  if (m_TurboReplay)
   {
-    CoreTiming::Idle();
-    CoreTiming::Advance();
+    // Let the emulated time of the whole frame pass at once, so that its XFB copies are presented.
+    m_TurboFrameEnded = false;
+    CoreTiming::ScheduleEvent(m_CyclesPerFrame, m_TurboFrameEndEvent);
+    while (!m_TurboFrameEnded)
+    {
+      CoreTiming::Idle();
+      CoreTiming::Advance();
+    }
+    return;
   }
+
+  FlushWGP();
+  WaitForGPUIdle();
 }
 
 void FifoPlayer::WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate,
-                                const FifoFrameInfo& frame, const AnalyzedFrameInfo& info)
+                                const FifoFrameInfo& frame)
 {
   const u8* const data = frame.fifoData.data();
 
   while (nextMemUpdate < frame.memoryUpdates.size() && dataStart < dataEnd)
   {
-    const MemoryUpdate& memUpdate = info.memoryUpdates[nextMemUpdate];
+    const MemoryUpdate& memUpdate = frame.memoryUpdates[nextMemUpdate];
 
     if (memUpdate.fifoPosition < dataEnd)
     {
@@ -343,8 +460,11 @@ void FifoPlayer::WriteAllMemoryUpdates()
 
   for (u32 frameNum = 0; frameNum < m_File->GetFrameCount(); ++frameNum)
   {
-    const FifoFrameInfo& frame = m_File->GetFrame(frameNum);
-    for (auto& update : frame.memoryUpdates)
+    const std::shared_ptr<const FifoFrameInfo> frame = m_File->GetFrame(frameNum);
+    if (!frame)
+      continue;
+
+    for (auto& update : frame->memoryUpdates)
     {
       WriteMemory(update);
     }
@@ -363,8 +483,30 @@ void FifoPlayer::WriteMemory(const MemoryUpdate& memUpdate)
   std::copy(memUpdate.data.begin(), memUpdate.data.end(), mem);
 }
 
+void FifoPlayer::DecodeFifo(const u8* data, u32 start, u32 end)
+{
+  // Drop the start of a command that was cut off by skipping objects.
+  if (m_DecodedFifoEnd != start)
+    m_DecodedFifoPosition = start;
+  m_DecodedFifoEnd = end;
+
+  FPURoundMode::SaveSIMDState();
+  FPURoundMode::LoadDefaultSIMDState();
+  u8* const fifo_data = const_cast<u8*>(data);
+  const u8* const decoded_end = OpcodeDecoder::Run(
+      DataReader(fifo_data + m_DecodedFifoPosition, fifo_data + end), nullptr, false);
+  m_DecodedFifoPosition = static_cast<u32>(decoded_end - data);
+  FPURoundMode::LoadSIMDState();
+}
+
 void FifoPlayer::WriteFifo(const u8* data, u32 start, u32 end)
 {
+  if (m_TurboReplay)
+  {
+    DecodeFifo(data, start, end);
+    return;
+  }
+
   u32 written = start;
   u32 lastBurstEnd = end - 1;
 
@@ -399,7 +541,10 @@ void FifoPlayer::SetupFifo()
   WriteCP(CommandProcessor::CTRL_REGISTER, 0);   // disable read, BP, interrupts
   WriteCP(CommandProcessor::CLEAR_REGISTER, 7);  // clear overflow, underflow, metrics
 
-  const FifoFrameInfo& frame = m_File->GetFrame(m_CurrentFrame);
+  const std::shared_ptr<const FifoFrameInfo> frame_info = m_File->GetFrame(m_CurrentFrame);
+  if (!frame_info)
+    return;
+  const FifoFrameInfo& frame = *frame_info;
 
   // Set fifo bounds
   WriteCP(CommandProcessor::FIFO_BASE_LO, frame.fifoStart);
@@ -576,6 +721,16 @@ bool FifoPlayer::IsIdleSet()
   return status.CommandIdle;
 }
 
+void FifoPlayer::WaitForGPUIdle()
+{
+  // Sleep while the GPU is active
+  while (!IsIdleSet() && CPU::GetState() != CPU::State::PowerDown)
+  {
+    CoreTiming::Idle();
+    CoreTiming::Advance();
+  }
+}
+
 bool FifoPlayer::IsHighWatermarkSet()
 {
   CommandProcessor::UCPStatusReg status =
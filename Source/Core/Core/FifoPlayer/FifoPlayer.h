@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <fstream>
 #include <functional>
 #include <memory>
 #include <string>
@@ -12,11 +14,17 @@
 #include "Core/FifoPlayer/FifoDataFile.h"
 #include "Core/FifoPlayer/FifoPlaybackAnalyzer.h"
 #include "Core/PowerPC/CPUCoreBase.h"
+#include "VideoCommon/GPUThreadProfiler.h"
 
 class FifoDataFile;
 struct MemoryUpdate;
 struct AnalyzedFrameInfo;
 
+namespace CoreTiming
+{
+struct EventType;
+}
+
 namespace CPU
 {
 enum class State;
@@ -106,9 +114,16 @@ private:
 
   CPU::State AdvanceFrame();
 
+  // Turbo replay decodes the FIFO data of the frames directly on the CPU thread, skipping the
+  // emulated FIFO and its timing. The time spent on each frame is written to a file.
+  void StartTurboReplay();
+  void StopTurboReplay();
+  void WriteTurboFrameTimes(std::chrono::steady_clock::time_point start,
+                            const GPUThreadProfiler::Times& start_times);
+  void DecodeFifo(const u8* data, u32 start, u32 end);
+
   void WriteFrame(const FifoFrameInfo& frame, const AnalyzedFrameInfo& info);
-  void WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate, const FifoFrameInfo& frame,
-                      const AnalyzedFrameInfo& info);
+  void WriteFramePart(u32 dataStart, u32 dataEnd, u32& nextMemUpdate, const FifoFrameInfo& frame);
 
   void WriteAllMemoryUpdates();
   void WriteMemory(const MemoryUpdate& memUpdate);
@@ -137,9 +152,25 @@ private:
 
   static bool IsIdleSet();
   static bool IsHighWatermarkSet();
+  static void WaitForGPUIdle();
 
   bool m_Loop;
 
+  bool m_TurboReplay = false;
+  u32 m_TurboReplayLoops = 0;
+  u32 m_TurboReplayLoop = 0;
+  std::chrono::nanoseconds m_TurboReplayLoopTime{};
+  // Scheduled at the end of the emulated time of a turbo frame, which passes in idle CoreTiming
+  // slices after the frame was decoded
+  CoreTiming::EventType* m_TurboFrameEndEvent = nullptr;
+  bool m_TurboFrameEnded = false;
+  // Position in the frame's FIFO data up to which the commands were decoded, and the end of the
+  // data that was given to the decoder. A command that is split by a memory update is decoded
+  // once the rest of it is written.
+  u32 m_DecodedFifoPosition = 0;
+  u32 m_DecodedFifoEnd = 0;
+  std::ofstream m_TurboReplayTimesFile;
+
   u32 m_CurrentFrame = 0;
   u32 m_FrameRangeStart = 0;
   u32 m_FrameRangeEnd = 0;
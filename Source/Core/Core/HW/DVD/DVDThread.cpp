@@ -4,7 +4,10 @@
 
 #include "Core/HW/DVD/DVDThread.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -23,6 +26,7 @@
 #include "Common/Thread.h"
 #include "Common/Timer.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
@@ -63,6 +67,24 @@ struct ReadRequest
 
 using ReadResult = std::pair<ReadRequest, std::vector<u8>>;
 
+// Data that the DVD thread has read speculatively because it expects the emulated software
+// to request it soon. Prefetching only affects how quickly the host can service a request.
+// The emulated timing is computed by DVDInterface (using DVDMath) before a request reaches
+// this file and is scheduled through CoreTiming, so it stays deterministic either way.
+struct PrefetchEntry
+{
+  DiscIO::Partition partition;
+  u64 dvd_offset;
+  std::vector<u8> data;
+};
+
+// Upper bound for how much a single prefetched chunk may contain
+constexpr u32 PREFETCH_MAX_CHUNK_SIZE = 0x100000;
+// Upper bound for the total size of all prefetched chunks
+constexpr size_t PREFETCH_CACHE_SIZE = 0x800000;
+// How many chunks ahead of the last request the DVD thread reads
+constexpr u32 PREFETCH_DEPTH = 2;
+
 static void StartDVDThread();
 static void StopDVDThread();
 
@@ -73,6 +95,11 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
                               const DiscIO::Partition& partition,
                               DVDInterface::ReplyType reply_type, s64 ticks_until_completion);
 
+static bool ReadFromPrefetchCache(const ReadRequest& request, std::vector<u8>* buffer);
+static void UpdateAccessPattern(const ReadRequest& request);
+static void Prefetch();
+static void ClearPrefetchCache();
+
 static void FinishRead(u64 id, s64 cycles_late);
 static CoreTiming::EventType* s_finish_read;
 
@@ -89,6 +116,20 @@ static std::map<u64, ReadResult> s_result_map;
 
 static std::unique_ptr<DiscIO::Volume> s_disc;
 
+// Only accessed by the DVD thread, or while the DVD thread is stopped
+static bool s_prefetch_enabled;
+static std::list<PrefetchEntry> s_prefetch_cache;  // Most recently used first
+static size_t s_prefetch_cache_size = 0;
+static DiscIO::Partition s_last_partition;
+static u64 s_last_offset = 0;
+static u32 s_last_length = 0;
+static s64 s_prefetch_stride = 0;
+static u64 s_predicted_offset = 0;
+static bool s_access_pattern_detected = false;
+
+static std::atomic<u64> s_prefetch_hits{0};
+static std::atomic<u64> s_prefetch_misses{0};
+
 void Start()
 {
   s_finish_read = CoreTiming::RegisterEvent("FinishReadDVDThread", FinishRead);
@@ -102,6 +143,11 @@ void Start()
   // much, because this will never get exposed to the emulated game.
   s_next_id = 0;
 
+  s_prefetch_enabled = Config::Get(Config::MAIN_DVD_PREFETCH);
+  ClearPrefetchCache();
+  s_prefetch_hits = 0;
+  s_prefetch_misses = 0;
+
   StartDVDThread();
 }
 
@@ -116,6 +162,18 @@ void Stop()
 {
   StopDVDThread();
   s_disc.reset();
+  ClearPrefetchCache();
+
+  if (s_prefetch_enabled)
+  {
+    INFO_LOG(DVDINTERFACE, "Read-ahead cache: %" PRIu64 " hits, %" PRIu64 " misses",
+             s_prefetch_hits.load(), s_prefetch_misses.load());
+  }
+}
+
+PrefetchStats GetPrefetchStats()
+{
+  return {s_prefetch_hits.load(), s_prefetch_misses.load()};
 }
 
 static void StopDVDThread()
@@ -179,6 +237,7 @@ void SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
   s_disc = std::move(disc);
+  ClearPrefetchCache();
 }
 
 bool HasDisc()
@@ -374,23 +433,140 @@ static void DVDThread()
     if (s_dvd_thread_exiting.IsSet())
       return;
 
+    bool handled_request = false;
     ReadRequest request;
     while (s_request_queue.Pop(request))
     {
+      handled_request = true;
+
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
 
       std::vector<u8> buffer(request.length);
-      if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
+      if (!ReadFromPrefetchCache(request, &buffer))
+      {
+        if (!s_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+          buffer.resize(0);
+      }
 
       request.realtime_done_us = Common::Timer::GetTimeUs();
 
+      if (s_prefetch_enabled)
+        UpdateAccessPattern(request);
+
       s_result_queue.Push(ReadResult(std::move(request), std::move(buffer)));
       s_result_queue_expanded.Set();
 
       if (s_dvd_thread_exiting.IsSet())
         return;
     }
+
+    // Only read ahead when there is nothing else to do, so that prefetching
+    // never delays a request that the emulated software actually has made.
+    // Spurious wakeups (e.g. right after WaitUntilIdle restarts this thread)
+    // must not prefetch, since the CPU thread may be changing the disc then.
+    if (s_prefetch_enabled && handled_request)
+      Prefetch();
   }
 }
+
+static bool ReadFromPrefetchCache(const ReadRequest& request, std::vector<u8>* buffer)
+{
+  if (!s_prefetch_enabled)
+    return false;
+
+  const u64 request_end = request.dvd_offset + request.length;
+  for (auto it = s_prefetch_cache.begin(); it != s_prefetch_cache.end(); ++it)
+  {
+    if (it->partition != request.partition || it->dvd_offset > request.dvd_offset ||
+        it->dvd_offset + it->data.size() < request_end)
+    {
+      continue;
+    }
+
+    std::copy_n(it->data.begin() + (request.dvd_offset - it->dvd_offset), request.length,
+                buffer->begin());
+    s_prefetch_cache.splice(s_prefetch_cache.begin(), s_prefetch_cache, it);
+    ++s_prefetch_hits;
+    return true;
+  }
+
+  ++s_prefetch_misses;
+  return false;
+}
+
+static void UpdateAccessPattern(const ReadRequest& request)
+{
+  // A pattern is considered detected once a request lands exactly where the previous
+  // request predicted it would. Both sequential reads (each request starting where the
+  // previous one ended) and constant strides (such as interleaved streams) are recognized.
+  const bool same_partition = request.partition == s_last_partition;
+  s_access_pattern_detected = same_partition && request.dvd_offset == s_predicted_offset;
+
+  if (same_partition && request.dvd_offset == s_last_offset + s_last_length)
+    s_prefetch_stride = request.length;
+  else if (same_partition)
+    s_prefetch_stride = static_cast<s64>(request.dvd_offset - s_last_offset);
+  else
+    s_prefetch_stride = 0;
+
+  s_last_partition = request.partition;
+  s_last_offset = request.dvd_offset;
+  s_last_length = request.length;
+  s_predicted_offset = request.dvd_offset + s_prefetch_stride;
+}
+
+static void Prefetch()
+{
+  if (!s_access_pattern_detected || s_prefetch_stride == 0 || !s_disc)
+    return;
+
+  const u32 length = std::min(s_last_length, PREFETCH_MAX_CHUNK_SIZE);
+  if (length == 0)
+    return;
+
+  u64 offset = s_last_offset;
+  for (u32 i = 0; i < PREFETCH_DEPTH; ++i)
+  {
+    if (!s_request_queue.Empty() || s_dvd_thread_exiting.IsSet())
+      return;
+
+    // Guard against strides that would make the offset wrap around
+    if (s_prefetch_stride < 0 && offset < static_cast<u64>(-s_prefetch_stride))
+      return;
+    offset += s_prefetch_stride;
+
+    const bool already_cached =
+        std::any_of(s_prefetch_cache.begin(), s_prefetch_cache.end(), [&](const auto& entry) {
+          return entry.partition == s_last_partition && entry.dvd_offset <= offset &&
+                 entry.dvd_offset + entry.data.size() >= offset + length;
+        });
+    if (already_cached)
+      continue;
+
+    PrefetchEntry entry{s_last_partition, offset, std::vector<u8>(length)};
+    if (!s_disc->Read(offset, length, entry.data.data(), s_last_partition))
+      return;
+
+    s_prefetch_cache_size += length;
+    s_prefetch_cache.push_front(std::move(entry));
+
+    while (s_prefetch_cache_size > PREFETCH_CACHE_SIZE)
+    {
+      s_prefetch_cache_size -= s_prefetch_cache.back().data.size();
+      s_prefetch_cache.pop_back();
+    }
+  }
+}
+
+static void ClearPrefetchCache()
+{
+  s_prefetch_cache.clear();
+  s_prefetch_cache_size = 0;
+  s_last_partition = DiscIO::Partition();
+  s_last_offset = 0;
+  s_last_length = 0;
+  s_prefetch_stride = 0;
+  s_predicted_offset = 0;
+  s_access_pattern_detected = false;
+}
 }  // namespace DVDThread
@@ -39,6 +39,14 @@ void Start();
 void Stop();
 void DoState(PointerWrap& p);
 
+struct PrefetchStats
+{
+  u64 hits;
+  u64 misses;
+};
+// Returns how many requests have been served from the read-ahead cache since Start()
+PrefetchStats GetPrefetchStats();
+
 void SetDisc(std::unique_ptr<DiscIO::Volume> disc);
 bool HasDisc();
 
@@ -10,8 +10,21 @@
 #include "Core/HW/Memmap.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -114,6 +127,8 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  const PhysicalMemoryRegion* physical_region;
+  u32 region_offset;
 };
 
 // Dolphin allocates memory to represent four regions:
@@ -166,6 +181,36 @@ static PhysicalMemoryRegion physical_regions[] = {
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
 
+// Write tracking state. Every tracked page has an atomic state, so that the exception handler can
+// update it without taking a lock. Everything else that changes the protection of tracked pages
+// (including changes to logical_mapped_entries while tracking is enabled) is guarded by
+// s_write_tracking_lock.
+constexpr u32 WRITE_TRACKING_PAGE_SIZE = 0x1000;
+
+// The state of a tracked page is the value of s_write_tracking_counter when the page was last
+// written (or untracked), shifted left by PAGE_STAMP_SHIFT, combined with these flags.
+constexpr u64 PAGE_PROTECTED = 1;
+// Set while a thread changes the protection of the page. Only that thread may call mprotect on
+// the page until it clears the flag, so the protection and the state always agree.
+constexpr u64 PAGE_BUSY = 2;
+constexpr int PAGE_STAMP_SHIFT = 2;
+
+// These aren't allocated when tracking is enabled so that the exception handler never sees them
+// change. Being static, they start out as unprotected pages with a stamp of 0.
+static std::array<std::atomic<u64>, RAM_SIZE / WRITE_TRACKING_PAGE_SIZE> s_ram_page_states;
+static std::array<std::atomic<u64>, EXRAM_SIZE / WRITE_TRACKING_PAGE_SIZE> s_exram_page_states;
+
+static std::mutex s_write_tracking_lock;
+static std::atomic<bool> s_write_tracking_enabled{false};
+static bool s_write_tracking_available = false;
+static bool s_write_tracking_requested = false;
+static std::atomic<u64> s_write_tracking_counter{0};
+
+// The exception handler reads logical_mapped_entries without taking s_write_tracking_lock, so
+// changes to them also set s_logical_views_changing and wait for the handlers reading them.
+static std::atomic<bool> s_logical_views_changing{false};
+static std::atomic<u32> s_logical_view_readers{0};
+
 static u32 GetFlags()
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -257,11 +302,32 @@ bool InitFastmemArena()
   return true;
 }
 
+static void UnprotectAllTrackedPages();
+
+// Must be called with s_write_tracking_lock held.
+static void BeginLogicalViewChange()
+{
+  s_logical_views_changing.store(true);
+  while (s_logical_view_readers.load() != 0)
+    std::this_thread::yield();
+}
+
+static void EndLogicalViewChange()
+{
+  s_logical_views_changing.store(false);
+}
+
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
   if (!is_fastmem_arena_initialized)
     return;
 
+  // The new views would be writable, so stop tracking everything rather than trying to carry the
+  // protection over.
+  std::lock_guard<std::mutex> guard(s_write_tracking_lock);
+  UnprotectAllTrackedPages();
+  BeginLogicalViewChange();
+
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -294,11 +360,14 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
             PanicAlert("MemoryMap_Setup: Failed finding a memory base.");
             exit(0);
           }
-          logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+          logical_mapped_entries.push_back({mapped_pointer, mapped_size, &physical_region,
+                                            intersection_start - mapping_address});
         }
       }
     }
   }
+
+  EndLogicalViewChange();
 }
 
 void DoState(PointerWrap& p)
@@ -317,6 +386,7 @@ void DoState(PointerWrap& p)
 
 void Shutdown()
 {
+  SetWriteTrackingAvailable(false);
   ShutdownFastmemArena();
 
   m_IsInitialized = false;
@@ -338,6 +408,9 @@ void ShutdownFastmemArena()
   if (!is_fastmem_arena_initialized)
     return;
 
+  std::lock_guard<std::mutex> guard(s_write_tracking_lock);
+  UnprotectAllTrackedPages();
+
   u32 flags = GetFlags();
   for (PhysicalMemoryRegion& region : physical_regions)
   {
@@ -348,11 +421,13 @@ void ShutdownFastmemArena()
     g_arena.ReleaseView(base, region.size);
   }
 
+  BeginLogicalViewChange();
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
   }
   logical_mapped_entries.clear();
+  EndLogicalViewChange();
 
   physical_base = nullptr;
   logical_base = nullptr;
@@ -372,6 +447,405 @@ void Clear()
     memset(m_pEXRAM, 0, EXRAM_SIZE);
 }
 
+static size_t GetHostPageSize()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Unlike Common::WriteProtectMemory, this doesn't show a panic alert on failure, so it can be
+// called from the exception handler.
+static bool SetHostWriteProtection(u8* pointer, u32 size, bool write_protect)
+{
+#ifdef _WIN32
+  DWORD old_protect;
+  return VirtualProtect(pointer, size, write_protect ? PAGE_READONLY : PAGE_READWRITE,
+                        &old_protect) != 0;
+#else
+  return mprotect(pointer, size, write_protect ? PROT_READ : PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+// Calls f(pointer, size) for the part of every view that maps [offset, offset + size) of a region,
+// until it returns false. Returns false if f did.
+template <typename F>
+static bool ForEachViewOfRange(const PhysicalMemoryRegion& region, u32 offset, u32 size, F f)
+{
+  if (!f(*region.out_pointer + offset, size))
+    return false;
+  if (is_fastmem_arena_initialized && !f(physical_base + region.physical_address + offset, size))
+    return false;
+
+  for (const LogicalMemoryView& view : logical_mapped_entries)
+  {
+    if (view.physical_region != &region)
+      continue;
+
+    const u32 start = std::max(offset, view.region_offset);
+    const u32 end = std::min(offset + size, view.region_offset + view.mapped_size);
+    if (start < end &&
+        !f(static_cast<u8*>(view.mapped_pointer) + start - view.region_offset, end - start))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Applies or removes write protection for a range of tracked pages in every view that maps them.
+// If that fails for any view, the views that were already changed are restored, so the pages keep
+// the protection that their state records. The caller must have set PAGE_BUSY on the pages, and
+// must either hold s_write_tracking_lock or be counted in s_logical_view_readers.
+static bool SetWriteProtection(size_t region_index, u32 first_page, u32 num_pages,
+                               bool write_protect)
+{
+  const PhysicalMemoryRegion& region = physical_regions[region_index];
+  const u32 offset = first_page * WRITE_TRACKING_PAGE_SIZE;
+  const u32 size = num_pages * WRITE_TRACKING_PAGE_SIZE;
+
+  size_t num_changed = 0;
+  if (ForEachViewOfRange(region, offset, size, [&](u8* pointer, u32 view_size) {
+        if (!SetHostWriteProtection(pointer, view_size, write_protect))
+          return false;
+        ++num_changed;
+        return true;
+      }))
+  {
+    return true;
+  }
+
+  ForEachViewOfRange(region, offset, size, [&](u8* pointer, u32 view_size) {
+    if (num_changed == 0)
+      return false;
+    --num_changed;
+    SetHostWriteProtection(pointer, view_size, !write_protect);
+    return true;
+  });
+  return false;
+}
+
+// Returns the page states of a region, or nullptr if the region isn't tracked.
+static std::atomic<u64>* GetPageStates(const PhysicalMemoryRegion& region)
+{
+  if (!*region.out_pointer)
+    return nullptr;
+  if (region.out_pointer == &m_pRAM)
+    return s_ram_page_states.data();
+  if (region.out_pointer == &m_pEXRAM)
+    return s_exram_page_states.data();
+  return nullptr;
+}
+
+// Sets PAGE_BUSY on a page whose protection doesn't match write_protect yet, waiting for any other
+// thread that is changing it. Returns false if the page already has the requested protection.
+static bool LockPageForProtectionChange(std::atomic<u64>& state, bool write_protect)
+{
+  u64 value = state.load(std::memory_order_acquire);
+  while (true)
+  {
+    if (value & PAGE_BUSY)
+    {
+      // The exception handler of another thread is unprotecting the page. That doesn't take long.
+      std::this_thread::yield();
+      value = state.load(std::memory_order_acquire);
+    }
+    else if (((value & PAGE_PROTECTED) != 0) == write_protect)
+    {
+      return false;
+    }
+    else if (state.compare_exchange_weak(value, value | PAGE_BUSY, std::memory_order_acquire))
+    {
+      return true;
+    }
+  }
+}
+
+// Applies or removes write protection for the pages in [first_page, end_page) that don't have it
+// yet, with a single call for each run of pages. Must be called with s_write_tracking_lock held.
+static void ChangeWriteProtection(size_t region_index, u32 first_page, u32 end_page,
+                                  bool write_protect)
+{
+  std::atomic<u64>* states = GetPageStates(physical_regions[region_index]);
+  for (u32 page = first_page; page < end_page; ++page)
+  {
+    if (!LockPageForProtectionChange(states[page], write_protect))
+      continue;
+
+    u32 end = page + 1;
+    while (end < end_page && LockPageForProtectionChange(states[end], write_protect))
+      ++end;
+
+    // On failure, SetWriteProtection has restored the views, so the pages keep their state.
+    const bool success = SetWriteProtection(region_index, page, end - page, write_protect);
+    if (!success)
+      ERROR_LOG(MEMMAP, "Failed to change the protection of pages %u-%u", page, end - 1);
+
+    for (; page < end; ++page)
+    {
+      const u64 value = states[page].load(std::memory_order_relaxed) & ~PAGE_BUSY;
+      if (!success)
+        states[page].store(value, std::memory_order_release);
+      else if (write_protect)
+        states[page].store(value | PAGE_PROTECTED, std::memory_order_release);
+      else
+      {
+        states[page].store(++s_write_tracking_counter << PAGE_STAMP_SHIFT,
+                           std::memory_order_release);
+      }
+    }
+  }
+}
+
+static void UnprotectAllTrackedPages()
+{
+  for (size_t i = 0; i < std::size(physical_regions); ++i)
+  {
+    if (GetPageStates(physical_regions[i]))
+      ChangeWriteProtection(i, 0, physical_regions[i].size / WRITE_TRACKING_PAGE_SIZE, false);
+  }
+}
+
+// Translates a range of physical addresses (using the same rules as GetPointer) to a range of
+// tracked pages, clamped to the end of the region. Returns false if it isn't in a tracked region.
+static bool GetTrackedPages(u32 address, u32 size, size_t* region_index, u32* first_page,
+                            u32* end_page, bool* is_clamped)
+{
+  if (size == 0)
+    return false;
+
+  address &= 0x3FFFFFFF;
+  for (size_t i = 0; i < std::size(physical_regions); ++i)
+  {
+    const PhysicalMemoryRegion& region = physical_regions[i];
+    if (!GetPageStates(region) || address < region.physical_address ||
+        address - region.physical_address >= region.size)
+    {
+      continue;
+    }
+
+    const u32 offset = address - region.physical_address;
+    const u32 end = static_cast<u32>(std::min<u64>(u64(offset) + size, region.size));
+    *region_index = i;
+    *first_page = offset / WRITE_TRACKING_PAGE_SIZE;
+    *end_page = (end + WRITE_TRACKING_PAGE_SIZE - 1) / WRITE_TRACKING_PAGE_SIZE;
+    *is_clamped = end - offset != size;
+    return true;
+  }
+
+  return false;
+}
+
+// Must be called with s_write_tracking_lock held.
+static void UpdateWriteTracking()
+{
+  const bool enable = s_write_tracking_available && s_write_tracking_requested;
+  if (enable == s_write_tracking_enabled)
+    return;
+
+  // Unprotecting gives every page a new stamp, so stamps from before tracking was disabled never
+  // match again if it's enabled later.
+  if (!enable)
+    UnprotectAllTrackedPages();
+  s_write_tracking_enabled = enable;
+}
+
+void SetWriteTrackingAvailable(bool available)
+{
+  std::lock_guard<std::mutex> guard(s_write_tracking_lock);
+  if (available && !s_write_tracking_available)
+  {
+    const size_t host_page_size = GetHostPageSize();
+    if (host_page_size > WRITE_TRACKING_PAGE_SIZE)
+    {
+      INFO_LOG(MEMMAP, "Write tracking is unavailable with a host page size of %zu bytes",
+               host_page_size);
+      return;
+    }
+  }
+
+  s_write_tracking_available = available;
+  UpdateWriteTracking();
+}
+
+void SetWriteTrackingRequested(bool requested)
+{
+  std::lock_guard<std::mutex> guard(s_write_tracking_lock);
+  s_write_tracking_requested = requested;
+  UpdateWriteTracking();
+}
+
+bool IsWriteTrackingEnabled()
+{
+  return s_write_tracking_enabled.load(std::memory_order_relaxed);
+}
+
+std::optional<u64> TrackWrites(u32 address, u32 size)
+{
+  if (!IsWriteTrackingEnabled())
+    return std::nullopt;
+
+  std::lock_guard<std::mutex> guard(s_write_tracking_lock);
+  size_t region_index;
+  u32 first_page, end_page;
+  bool is_clamped;
+  if (!s_write_tracking_enabled ||
+      !GetTrackedPages(address, size, &region_index, &first_page, &end_page, &is_clamped) ||
+      is_clamped)
+  {
+    return std::nullopt;
+  }
+
+  ChangeWriteProtection(region_index, first_page, end_page, true);
+
+  // Any write after this point increments the counter, so it will be newer than the stamp.
+  return s_write_tracking_counter.load();
+}
+
+bool IsUnmodifiedSince(u32 address, u32 size, u64 stamp)
+{
+  if (!IsWriteTrackingEnabled())
+    return false;
+
+  size_t region_index;
+  u32 first_page, end_page;
+  bool is_clamped;
+  if (!GetTrackedPages(address, size, &region_index, &first_page, &end_page, &is_clamped) ||
+      is_clamped)
+  {
+    return false;
+  }
+
+  // A busy page that is protected is being unprotected by the exception handler, which means
+  // that it's being written to.
+  const std::atomic<u64>* states = GetPageStates(physical_regions[region_index]);
+  return std::all_of(states + first_page, states + end_page,
+                     [stamp](const std::atomic<u64>& state) {
+                       const u64 value = state.load(std::memory_order_acquire);
+                       return (value & (PAGE_PROTECTED | PAGE_BUSY)) == PAGE_PROTECTED &&
+                              value >> PAGE_STAMP_SHIFT <= stamp;
+                     });
+}
+
+// Finds the tracked page that a host address belongs to, in any of the views of the region.
+// The caller must be counted in s_logical_view_readers.
+static bool GetTrackedPageForHostAddress(uintptr_t host_address, size_t* region_index, u32* page)
+{
+  const auto contains = [host_address](const void* base, u32 size) {
+    return base && host_address >= reinterpret_cast<uintptr_t>(base) &&
+           host_address - reinterpret_cast<uintptr_t>(base) < size;
+  };
+
+  for (size_t i = 0; i < std::size(physical_regions); ++i)
+  {
+    const PhysicalMemoryRegion& region = physical_regions[i];
+    if (!GetPageStates(region))
+      continue;
+
+    u8* views[] = {*region.out_pointer, nullptr};
+    if (is_fastmem_arena_initialized)
+      views[1] = physical_base + region.physical_address;
+    for (u8* view : views)
+    {
+      if (contains(view, region.size))
+      {
+        *region_index = i;
+        *page = static_cast<u32>(host_address - reinterpret_cast<uintptr_t>(view)) /
+                WRITE_TRACKING_PAGE_SIZE;
+        return true;
+      }
+    }
+  }
+
+  for (const LogicalMemoryView& view : logical_mapped_entries)
+  {
+    const size_t i = view.physical_region - physical_regions;
+    if (!GetPageStates(*view.physical_region) || !contains(view.mapped_pointer, view.mapped_size))
+      continue;
+
+    *region_index = i;
+    *page = (static_cast<u32>(host_address - reinterpret_cast<uintptr_t>(view.mapped_pointer)) +
+             view.region_offset) /
+            WRITE_TRACKING_PAGE_SIZE;
+    return true;
+  }
+
+  return false;
+}
+
+bool HandleWriteTrackingFault(uintptr_t fault_address)
+{
+  // The faulting thread might hold s_write_tracking_lock (or any other lock) already, so this only
+  // uses atomics and mprotect. It doesn't check s_write_tracking_enabled either, since a fault on
+  // a page that was protected can still be in flight while tracking is being disabled.
+  // While the logical views are being changed, their pages are unprotected, so retrying the
+  // access once that's done either succeeds or faults with views that can be searched.
+  ++s_logical_view_readers;
+  if (s_logical_views_changing.load())
+  {
+    --s_logical_view_readers;
+    return true;
+  }
+
+  const bool handled = [fault_address] {
+    size_t region_index;
+    u32 page;
+    if (!GetTrackedPageForHostAddress(fault_address, &region_index, &page))
+      return false;
+
+    // If the page is busy, another thread is changing its protection, and retrying the access
+    // will succeed or fault again once the page is in a stable state.
+    std::atomic<u64>& state = GetPageStates(physical_regions[region_index])[page];
+    u64 value = state.load(std::memory_order_acquire);
+    if ((value & PAGE_BUSY) ||
+        !state.compare_exchange_strong(value, value | PAGE_BUSY, std::memory_order_acquire))
+    {
+      return true;
+    }
+
+    // A page that isn't protected anymore has usually been unprotected by the handler of another
+    // thread that wrote to it at the same time. Removing the protection again is harmless then,
+    // and it repairs views that were left protected. If it fails, the fault isn't handled, so
+    // the access crashes instead of faulting forever.
+    if (!SetWriteProtection(region_index, page, 1, false))
+    {
+      state.store(value, std::memory_order_release);
+      return false;
+    }
+
+    if (value & PAGE_PROTECTED)
+      value = ++s_write_tracking_counter << PAGE_STAMP_SHIFT;
+    state.store(value, std::memory_order_release);
+    return true;
+  }();
+
+  --s_logical_view_readers;
+  return handled;
+}
+
+// Removes write tracking protection from a range that the host is about to write to, so that a
+// large copy doesn't fault on every page. The range is reported as modified afterwards.
+static void UnprotectForHostWrite(u32 address, size_t size)
+{
+  if (!IsWriteTrackingEnabled())
+    return;
+
+  std::lock_guard<std::mutex> guard(s_write_tracking_lock);
+  size_t region_index;
+  u32 first_page, end_page;
+  bool is_clamped;
+  if (GetTrackedPages(address, static_cast<u32>(size), &region_index, &first_page, &end_page,
+                      &is_clamped))
+  {
+    ChangeWriteProtection(region_index, first_page, end_page, false);
+  }
+}
+
 static inline u8* GetPointerForRange(u32 address, size_t size)
 {
   // Make sure we don't have a range spanning 2 separate banks
@@ -411,6 +885,7 @@ void CopyToEmu(u32 address, const void* data, size_t size)
     PanicAlert("Invalid range in CopyToEmu. %zx bytes to 0x%08x", size, address);
     return;
   }
+  UnprotectForHostWrite(address, size);
   memcpy(pointer, data, size);
 }
 
@@ -425,6 +900,7 @@ void Memset(u32 address, u8 value, size_t size)
     PanicAlert("Invalid range in Memset. %zx bytes at 0x%08x", size, address);
     return;
   }
+  UnprotectForHostWrite(address, size);
   memset(pointer, value, size);
 }
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "Common/CommonTypes.h"
@@ -70,6 +71,33 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
 void Clear();
 
+// Write tracking for RAM and EXRAM, used by the video thread to avoid rehashing memory that
+// hasn't changed. Tracked pages are write-protected in every view that maps them, and the first
+// write to one of them is caught by the exception handler, which records the write and removes
+// the protection again. This can only be enabled while an exception handler that sees faults
+// from all threads is installed (see EMM::HandlesFaultsOnAllThreads). System calls fail on
+// write-protected pages instead of faulting, so the host must never let the OS write to guest
+// memory directly (e.g. by reading a file into it); read into a host buffer and use CopyToEmu,
+// which removes the protection from the range before copying.
+//
+// Tracking is only enabled while it is both available and requested, so that pages aren't
+// protected (and writes to them don't fault) unless something actually uses the stamps.
+// Available: such an exception handler is installed.
+void SetWriteTrackingAvailable(bool available);
+// Requested: a video setting that relies on write tracking is enabled.
+void SetWriteTrackingRequested(bool requested);
+bool IsWriteTrackingEnabled();
+
+// Starts tracking writes to [address, address + size). The returned stamp can be passed to
+// IsUnmodifiedSince for the same range. Returns std::nullopt if the range can't be tracked.
+std::optional<u64> TrackWrites(u32 address, u32 size);
+// Returns true if nothing in [address, address + size) has been written since TrackWrites
+// returned the stamp.
+bool IsUnmodifiedSince(u32 address, u32 size, u64 stamp);
+// Called by the exception handler. Returns true if the fault was caused by write tracking and
+// the faulting instruction can be retried.
+bool HandleWriteTrackingFault(uintptr_t fault_address);
+
 // Routines to access physically addressed memory, designed for use by
 // emulated hardware outside the CPU. Use "Device_" prefix.
 std::string GetString(u32 em_address, size_t size = 0);
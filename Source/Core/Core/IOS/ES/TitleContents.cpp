@@ -109,7 +109,12 @@ IPCCommandResult ES::ReadContent(u32 uid, const IOCtlVRequest& request)
   const u32 size = request.io_vectors[0].size;
   const u32 addr = request.io_vectors[0].address;
 
-  return GetDefaultReply(ReadContent(cfd, Memory::GetPointer(addr), size, uid));
+  // Guest memory may be write-protected for write tracking, which makes the host file read fail.
+  std::vector<u8> buffer(size);
+  const s32 result = ReadContent(cfd, buffer.data(), size, uid);
+  if (result > 0)
+    Memory::CopyToEmu(addr, buffer.data(), result);
+  return GetDefaultReply(result);
 }
 
 ReturnCode ES::CloseContent(u32 cfd, u32 uid)
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cstring>
 #include <string_view>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -237,12 +238,16 @@ IPCCommandResult FS::Read(const ReadWriteRequest& request)
   // Simulate the FS read logic to estimate ticks. Note: this must be done before reading.
   const u64 ticks = EstimateTicksForReadWrite(handle, request);
 
-  const Result<u32> result = m_ios.GetFS()->ReadBytesFromFile(
-      handle.fs_fd, Memory::GetPointer(request.buffer), request.size);
+  // The host can't read files straight into guest memory that is write-protected for write
+  // tracking (see Memory::TrackWrites), so read into a buffer and copy it over.
+  std::vector<u8> buffer(request.size);
+  const Result<u32> result =
+      m_ios.GetFS()->ReadBytesFromFile(handle.fs_fd, buffer.data(), request.size);
   LogResult(result, "Read({}, 0x{:08x}, {})", handle.name.data(), request.buffer, request.size);
   if (!result)
     return GetFSReply(ConvertResult(result.Error()));
 
+  Memory::CopyToEmu(request.buffer, buffer.data(), *result);
   return GetFSReply(*result, ticks);
 }
 
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <mbedtls/error.h>
+#include <vector>
 #ifndef _WIN32
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -553,9 +554,14 @@ void WiiSocket::Update(bool read, bool write, bool except)
           }
 #endif
           socklen_t addrlen = sizeof(sockaddr_in);
-          int ret = recvfrom(fd, data, data_len, flags,
+          // recvfrom fails instead of faulting on pages that are write-protected for write
+          // tracking, so receive into a host buffer.
+          std::vector<char> buffer(data_len);
+          int ret = recvfrom(fd, buffer.data(), data_len, flags,
                              BufferOutSize2 ? (struct sockaddr*)&local_name : nullptr,
                              BufferOutSize2 ? &addrlen : nullptr);
+          if (ret > 0)
+            Memory::CopyToEmu(BufferOut, buffer.data(), ret);
           ReturnValue =
               WiiSockMan::GetNetErrorCode(ret, BufferOutSize2 ? "SO_RECVFROM" : "SO_RECV", true);
 
@@ -252,8 +252,12 @@ s32 SDIOSlot0::ExecuteCommand(const Request& request, u32 buffer_in, u32 buffer_
       if (!m_card.Seek(address, SEEK_SET))
         ERROR_LOG(IOS_SD, "Seek failed WTF");
 
-      if (m_card.ReadBytes(Memory::GetPointer(req.addr), size))
+      // Reading into a host buffer first avoids failing on pages that are write-protected for
+      // write tracking.
+      std::vector<u8> buffer(size);
+      if (m_card.ReadBytes(buffer.data(), size))
       {
+        Memory::CopyToEmu(req.addr, buffer.data(), size);
         DEBUG_LOG(IOS_SD, "Outbuffer size %i got %i", rw_buffer_size, size);
       }
       else
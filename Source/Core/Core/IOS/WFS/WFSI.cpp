@@ -516,7 +516,12 @@ IPCCommandResult WFSI::IOCtl(const IOCtlRequest& request)
     }
     else
     {
-      fp.ReadBytes(Memory::GetPointer(dol_addr), max_dol_size);
+      // Read into a host buffer, since the read fails on guest pages that are write-protected
+      // for write tracking.
+      std::vector<u8> buffer(max_dol_size);
+      size_t read_bytes = 0;
+      fp.ReadArray(buffer.data(), max_dol_size, &read_bytes);
+      Memory::CopyToEmu(dol_addr, buffer.data(), read_bytes);
     }
     Memory::Write_U32(real_dol_size, request.buffer_out);
     break;
@@ -563,7 +568,9 @@ u32 WFSI::GetTmd(u16 group_id, u32 title_id, u64 subtitle_id, u32 address, u32*
   }
   if (address)
   {
-    fp.ReadBytes(Memory::GetPointer(address), fp.GetSize());
+    std::vector<u8> tmd(fp.GetSize());
+    if (fp.ReadBytes(tmd.data(), tmd.size()))
+      Memory::CopyToEmu(address, tmd.data(), tmd.size());
   }
   *size = fp.GetSize();
   return IPC_SUCCESS;
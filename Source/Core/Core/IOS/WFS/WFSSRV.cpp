@@ -295,8 +295,12 @@ IPCCommandResult WFSSRV::IOCtl(const IOCtlRequest& request)
     {
       fd_obj->file.Seek(position, SEEK_SET);
     }
-    size_t read_bytes;
-    fd_obj->file.ReadArray(Memory::GetPointer(addr), size, &read_bytes);
+    // The file is read into a host buffer because reading directly into guest memory fails on
+    // pages that are write-protected for write tracking.
+    std::vector<u8> buffer(size);
+    size_t read_bytes = 0;
+    fd_obj->file.ReadArray(buffer.data(), size, &read_bytes);
+    Memory::CopyToEmu(addr, buffer.data(), read_bytes);
     // TODO(wfs): Handle read errors.
     if (absolute)
     {
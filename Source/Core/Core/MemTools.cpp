@@ -14,6 +14,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 
+#include "Core/HW/Memmap.h"
 #include "Core/MachineContext.h"
 #include "Core/PowerPC/JitInterface.h"
 
@@ -44,6 +45,11 @@ static LONG NTAPI Handler(PEXCEPTION_POINTERS pPtrs)
     uintptr_t badAddress = (uintptr_t)pPtrs->ExceptionRecord->ExceptionInformation[1];
     CONTEXT* ctx = pPtrs->ContextRecord;
 
+    if (Memory::HandleWriteTrackingFault(badAddress))
+    {
+      return (DWORD)EXCEPTION_CONTINUE_EXECUTION;
+    }
+
     if (JitInterface::HandleFault(badAddress, ctx))
     {
       return (DWORD)EXCEPTION_CONTINUE_EXECUTION;
@@ -98,6 +104,11 @@ void UninstallExceptionHandler()
 {
 }
 
+bool HandlesFaultsOnAllThreads()
+{
+  return true;
+}
+
 #elif defined(__APPLE__) && !defined(USE_SIGACTION_ON_APPLE)
 
 static void CheckKR(const char* name, kern_return_t kr)
@@ -230,6 +241,12 @@ void UninstallExceptionHandler()
 {
 }
 
+bool HandlesFaultsOnAllThreads()
+{
+  // The exception port is only set for the thread that installed the handler.
+  return false;
+}
+
 #elif defined(_POSIX_VERSION) && !defined(_M_GENERIC)
 
 static struct sigaction old_sa_segv;
@@ -251,6 +268,9 @@ static void sigsegv_handler(int sig, siginfo_t* info, void* raw_context)
   }
   uintptr_t bad_address = (uintptr_t)info->si_addr;
 
+  if (Memory::HandleWriteTrackingFault(bad_address))
+    return;
+
 // Get all the information we can out of the context.
 #ifdef __OpenBSD__
   ucontext_t* ctx = context;
@@ -338,6 +358,11 @@ void UninstallExceptionHandler()
   sigaction(SIGBUS, &old_sa_bus, nullptr);
 #endif
 }
+
+bool HandlesFaultsOnAllThreads()
+{
+  return true;
+}
 #else  // _M_GENERIC or unsupported platform
 
 void InstallExceptionHandler()
@@ -347,6 +372,11 @@ void UninstallExceptionHandler()
 {
 }
 
+bool HandlesFaultsOnAllThreads()
+{
+  return false;
+}
+
 #endif
 
 }  // namespace EMM
@@ -8,4 +8,8 @@ namespace EMM
 {
 void InstallExceptionHandler();
 void UninstallExceptionHandler();
+
+// Returns true if faults raised on any thread (not just the one that installed the handler) are
+// passed to the handler. Memory write tracking depends on this.
+bool HandlesFaultsOnAllThreads();
 }  // namespace EMM
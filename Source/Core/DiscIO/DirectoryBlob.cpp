@@ -56,10 +56,33 @@ constexpr u32 INVALID_REGION = 0xFF;
 
 constexpr u32 PARTITION_DATA_OFFSET = 0x20000;
 
+// The maximum number of host files that HostFileCache keeps open at the same time
+constexpr size_t MAX_OPEN_HOST_FILES = 64;
+
 constexpr u8 ENTRY_SIZE = 0x0c;
 constexpr u8 FILE_ENTRY = 0;
 constexpr u8 DIRECTORY_ENTRY = 1;
 
+File::IOFile* HostFileCache::Open(const std::string& path)
+{
+  auto it = std::find_if(m_files.begin(), m_files.end(),
+                         [&path](const auto& entry) { return entry.first == path; });
+  if (it != m_files.end())
+  {
+    m_files.splice(m_files.begin(), m_files, it);
+    return &m_files.front().second;
+  }
+
+  File::IOFile file(path, "rb");
+  if (!file)
+    return nullptr;
+
+  if (m_files.size() >= MAX_OPEN_HOST_FILES)
+    m_files.pop_back();
+  m_files.emplace_front(path, std::move(file));
+  return &m_files.front().second;
+}
+
 DiscContent::DiscContent(u64 offset, u64 size, const std::string& path)
     : m_offset(offset), m_size(size), m_content_source(path)
 {
@@ -89,7 +112,7 @@ u64 DiscContent::GetSize() const
   return m_size;
 }
 
-bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
+bool DiscContent::Read(u64* offset, u64* length, u8** buffer, HostFileCache* file_cache) const
 {
   if (m_size == 0)
     return true;
@@ -103,9 +126,12 @@ bool DiscContent::Read(u64* offset, u64* length, u8** buffer) const
 
     if (std::holds_alternative<std::string>(m_content_source))
     {
-      File::IOFile file(std::get<std::string>(m_content_source), "rb");
-      if (!file.Seek(offset_in_content, SEEK_SET) || !file.ReadBytes(*buffer, bytes_to_read))
+      File::IOFile* file = file_cache->Open(std::get<std::string>(m_content_source));
+      if (!file || !file->Seek(offset_in_content, SEEK_SET) ||
+          !file->ReadBytes(*buffer, bytes_to_read))
+      {
         return false;
+      }
     }
     else
     {
@@ -147,17 +173,20 @@ u64 DiscContentContainer::CheckSizeAndAdd(u64 offset, u64 max_size, const std::s
   return size;
 }
 
-bool DiscContentContainer::Read(u64 offset, u64 length, u8* buffer) const
+bool DiscContentContainer::Read(u64 offset, u64 length, u8* buffer,
+                                HostFileCache* file_cache) const
 {
   // Determine which DiscContent the offset refers to
   std::set<DiscContent>::const_iterator it = m_contents.upper_bound(DiscContent(offset));
 
+  // Each host file is read separately. A vectored read can only fill buffers from one file, so it
+  // can't combine the reads of adjacent files; file_cache keeps them open between reads instead.
   while (it != m_contents.end() && length > 0)
   {
     // Zero fill to start of DiscContent data
     PadToAddress(it->GetOffset(), &offset, &length, &buffer);
 
-    if (!it->Read(&offset, &length, &buffer))
+    if (!it->Read(&offset, &length, &buffer, file_cache))
       return false;
 
     ++it;
@@ -379,7 +408,7 @@ bool DirectoryBlobReader::Read(u64 offset, u64 length, u8* buffer)
 
   // TODO: We don't handle raw access to the encrypted area of Wii discs correctly.
   return (m_is_wii ? m_nonpartition_contents : m_gamecube_pseudopartition.GetContents())
-      .Read(offset, length, buffer);
+      .Read(offset, length, buffer, &m_file_cache);
 }
 
 bool DirectoryBlobReader::SupportsReadWiiDecrypted() const
@@ -399,7 +428,7 @@ bool DirectoryBlobReader::ReadWiiDecrypted(u64 offset, u64 size, u8* buffer, u64
   if (offset + size > it->second.GetDataSize())
     return false;
 
-  return it->second.GetContents().Read(offset, size, buffer);
+  return it->second.GetContents().Read(offset, size, buffer, &m_file_cache);
 }
 
 BlobType DirectoryBlobReader::GetBlobType() const
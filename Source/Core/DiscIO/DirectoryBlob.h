@@ -5,22 +5,24 @@
 #pragma once
 
 #include <cstddef>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "DiscIO/Blob.h"
 
 namespace File
 {
 struct FSTEntry;
-class IOFile;
 }  // namespace File
 
 namespace DiscIO
@@ -30,6 +32,18 @@ enum class PartitionType : u32;
 // Returns true if the path is inside a DirectoryBlob and doesn't represent the DirectoryBlob itself
 bool ShouldHideFromGameList(const std::string& volume_path);
 
+// Keeps the most recently used host files open, so that reads which touch many small files
+// don't have to open and close each one of them, and so that the number of open files is bounded.
+class HostFileCache
+{
+public:
+  // Returns nullptr if the file couldn't be opened
+  File::IOFile* Open(const std::string& path);
+
+private:
+  std::list<std::pair<std::string, File::IOFile>> m_files;  // Most recently used first
+};
+
 class DiscContent
 {
 public:
@@ -44,7 +58,7 @@ public:
   u64 GetOffset() const;
   u64 GetEndOffset() const;
   u64 GetSize() const;
-  bool Read(u64* offset, u64* length, u8** buffer) const;
+  bool Read(u64* offset, u64* length, u8** buffer, HostFileCache* file_cache) const;
 
   bool operator==(const DiscContent& other) const { return GetEndOffset() == other.GetEndOffset(); }
   bool operator!=(const DiscContent& other) const { return !(*this == other); }
@@ -72,7 +86,7 @@ public:
   u64 CheckSizeAndAdd(u64 offset, const std::string& path);
   u64 CheckSizeAndAdd(u64 offset, u64 max_size, const std::string& path);
 
-  bool Read(u64 offset, u64 length, u8* buffer) const;
+  bool Read(u64 offset, u64 length, u8* buffer, HostFileCache* file_cache) const;
 
 private:
   std::set<DiscContent> m_contents;
@@ -183,6 +197,8 @@ private:
   std::vector<u8> m_wii_region_data;
   std::vector<std::vector<u8>> m_partition_headers;
 
+  HostFileCache m_file_cache;
+
   u64 m_data_size;
 };
 
@@ -5,20 +5,224 @@
 #include "DiscIO/DiscExtractor.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <locale>
+#include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
+#include "Common/Semaphore.h"
 #include "Common/StringUtil.h"
+#include "Common/WorkQueueThread.h"
 #include "DiscIO/Enums.h"
 #include "DiscIO/Filesystem.h"
 #include "DiscIO/Volume.h"
 
 namespace DiscIO
 {
+namespace
+{
+// Files that are closer to each other on the disc than this are read in a single operation,
+// even though the data in between them gets read without being used.
+constexpr u64 EXPORT_MAX_GAP = 0x20000;
+// The size of the buffers that data is read into. Files that are larger are streamed.
+constexpr u64 EXPORT_BUFFER_SIZE = 0x2000000;
+// How many buffers may be waiting to be written at the same time
+constexpr int EXPORT_MAX_PENDING_BUFFERS = 3;
+
+struct ExportJob
+{
+  u64 offset;
+  u64 size;
+  std::string filesystem_path;  // Only used for reporting progress
+  std::string export_filename;
+};
+
+// A range of a buffer that has been read from the disc and should be written to a file.
+// For each job, writes arrive in order, with the first one having is_first_write set.
+struct PendingWrite
+{
+  const ExportJob* job;
+  size_t buffer_offset;
+  size_t size;
+  bool is_first_write;
+};
+
+struct PendingBuffer
+{
+  std::unique_ptr<u8[]> data;
+  std::vector<PendingWrite> writes;
+};
+}  // Anonymous namespace
+
+// Extracts the given files from the disc. Jobs are processed in order of disc offset so that
+// the disc is read sequentially, and neighbouring files are read in one operation so that
+// each Wii cluster only gets decrypted once. The data is fanned out to the output files on a
+// separate thread, so writing one buffer overlaps with reading the next one.
+// If update_progress is set, it's called once before each job is started, and returning true
+// from it cancels the extraction. Returns false if any file couldn't be extracted.
+static bool ExportFiles(const Volume& volume, const Partition& partition,
+                        std::vector<ExportJob> jobs,
+                        const std::function<bool(const std::string& path)>& update_progress = {})
+{
+  std::stable_sort(jobs.begin(), jobs.end(),
+                   [](const ExportJob& a, const ExportJob& b) { return a.offset < b.offset; });
+
+  std::atomic<bool> success{true};
+  Common::Semaphore free_buffers(EXPORT_MAX_PENDING_BUFFERS, EXPORT_MAX_PENDING_BUFFERS);
+
+  // The writer thread finishes all pending writes when it's destroyed at the end of this scope
+  {
+    // Only accessed by the writer thread
+    File::IOFile file;
+    const ExportJob* failed_job = nullptr;
+
+    Common::WorkQueueThread<PendingBuffer> writer([&](PendingBuffer buffer) {
+      for (const PendingWrite& write : buffer.writes)
+      {
+        if (write.is_first_write)
+          file.Open(write.job->export_filename, "wb");
+
+        if (write.job == failed_job)
+          continue;
+
+        if (!file || !file.WriteBytes(buffer.data.get() + write.buffer_offset, write.size))
+        {
+          ERROR_LOG(DISCIO, "Could not export %s", write.job->export_filename.c_str());
+          failed_job = write.job;
+          success = false;
+        }
+      }
+      free_buffers.Post();
+    });
+
+    const auto report_read_failure = [&](const ExportJob& job) {
+      ERROR_LOG(DISCIO, "Could not read %s from the disc", job.export_filename.c_str());
+      success = false;
+    };
+
+    bool cancelled = false;
+    size_t i = 0;
+    while (i < jobs.size() && !cancelled)
+    {
+      // Find a group of jobs that can be read into a single buffer
+      const u64 span_start = jobs[i].offset;
+      u64 span_end = jobs[i].offset + jobs[i].size;
+      size_t j = i + 1;
+      while (j < jobs.size() && jobs[j].offset <= span_end + EXPORT_MAX_GAP &&
+             std::max(span_end, jobs[j].offset + jobs[j].size) - span_start <= EXPORT_BUFFER_SIZE)
+      {
+        span_end = std::max(span_end, jobs[j].offset + jobs[j].size);
+        ++j;
+      }
+
+      if (span_end - span_start <= EXPORT_BUFFER_SIZE)
+      {
+        PendingBuffer buffer;
+        for (size_t k = i; k < j; ++k)
+        {
+          if (update_progress && update_progress(jobs[k].filesystem_path))
+          {
+            cancelled = true;
+            break;
+          }
+          buffer.writes.push_back({&jobs[k], static_cast<size_t>(jobs[k].offset - span_start),
+                                   static_cast<size_t>(jobs[k].size), true});
+        }
+
+        if (cancelled)
+          break;
+
+        free_buffers.Wait();
+        const size_t span_size = static_cast<size_t>(span_end - span_start);
+        buffer.data = std::make_unique<u8[]>(span_size);
+        if (span_size != 0 && !volume.Read(span_start, span_size, buffer.data.get(), partition))
+        {
+          std::for_each(jobs.begin() + i, jobs.begin() + j, report_read_failure);
+          free_buffers.Post();
+        }
+        else
+        {
+          writer.EmplaceItem(std::move(buffer));
+        }
+      }
+      else
+      {
+        // A single file that is too large for one buffer. Stream it.
+        const ExportJob& job = jobs[i];
+        if (update_progress && update_progress(job.filesystem_path))
+          break;
+
+        for (u64 position = 0; position < job.size; position += EXPORT_BUFFER_SIZE)
+        {
+          const size_t read_size =
+              static_cast<size_t>(std::min(job.size - position, EXPORT_BUFFER_SIZE));
+
+          free_buffers.Wait();
+          PendingBuffer buffer{std::make_unique<u8[]>(read_size),
+                               {{&job, 0, read_size, position == 0}}};
+          if (!volume.Read(job.offset + position, read_size, buffer.data.get(), partition))
+          {
+            report_read_failure(job);
+            free_buffers.Post();
+            break;
+          }
+          writer.EmplaceItem(std::move(buffer));
+        }
+      }
+
+      i = j;
+    }
+  }
+
+  return success;
+}
+
+// Collects the files in directory for ExportFiles, creating the output directories as it goes.
+// update_progress is called for each directory. Returns false if the export was cancelled.
+static bool CollectExportJobs(const FileInfo& directory, bool recursive,
+                              const std::string& filesystem_path, const std::string& export_folder,
+                              const std::function<bool(const std::string& path)>& update_progress,
+                              std::vector<ExportJob>* jobs)
+{
+  File::CreateFullPath(export_folder + '/');
+
+  for (const FileInfo& file_info : directory)
+  {
+    const std::string name = file_info.GetName() + (file_info.IsDirectory() ? "/" : "");
+    const std::string path = filesystem_path + name;
+    const std::string export_path = export_folder + '/' + name;
+
+    DEBUG_LOG(DISCIO, "%s", export_path.c_str());
+
+    if (!file_info.IsDirectory())
+    {
+      if (File::Exists(export_path))
+        NOTICE_LOG(DISCIO, "%s already exists", export_path.c_str());
+      else
+        jobs->push_back({file_info.GetOffset(), file_info.GetSize(), path, export_path});
+    }
+    else
+    {
+      if (update_progress(path))
+        return false;
+
+      if (recursive)
+      {
+        if (!CollectExportJobs(file_info, recursive, path, export_path, update_progress, jobs))
+          return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 std::string NameForPartitionType(u32 partition_type, bool include_prefix)
 {
   switch (partition_type)
@@ -83,28 +287,7 @@ u64 ReadFile(const Volume& volume, const Partition& partition, std::string_view
 bool ExportData(const Volume& volume, const Partition& partition, u64 offset, u64 size,
                 const std::string& export_filename)
 {
-  File::IOFile f(export_filename, "wb");
-  if (!f)
-    return false;
-
-  while (size)
-  {
-    // Limit read size to 128 MB
-    const size_t read_size = static_cast<size_t>(std::min<u64>(size, 0x08000000));
-
-    std::vector<u8> buffer(read_size);
-
-    if (!volume.Read(offset, read_size, buffer.data(), partition))
-      return false;
-
-    if (!f.WriteBytes(buffer.data(), read_size))
-      return false;
-
-    size -= read_size;
-    offset += read_size;
-  }
-
-  return true;
+  return ExportFiles(volume, partition, {{offset, size, export_filename, export_filename}});
 }
 
 bool ExportFile(const Volume& volume, const Partition& partition, const FileInfo* file_info,
@@ -132,30 +315,11 @@ void ExportDirectory(const Volume& volume, const Partition& partition, const Fil
                      const std::string& export_folder,
                      const std::function<bool(const std::string& path)>& update_progress)
 {
-  File::CreateFullPath(export_folder + '/');
-
-  for (const FileInfo& file_info : directory)
+  std::vector<ExportJob> jobs;
+  if (CollectExportJobs(directory, recursive, filesystem_path, export_folder, update_progress,
+                        &jobs))
   {
-    const std::string name = file_info.GetName() + (file_info.IsDirectory() ? "/" : "");
-    const std::string path = filesystem_path + name;
-    const std::string export_path = export_folder + '/' + name;
-
-    if (update_progress(path))
-      return;
-
-    DEBUG_LOG(DISCIO, "%s", export_path.c_str());
-
-    if (!file_info.IsDirectory())
-    {
-      if (File::Exists(export_path))
-        NOTICE_LOG(DISCIO, "%s already exists", export_path.c_str());
-      else if (!ExportFile(volume, partition, &file_info, export_path))
-        ERROR_LOG(DISCIO, "Could not export %s", export_path.c_str());
-    }
-    else if (recursive)
-    {
-      ExportDirectory(volume, partition, file_info, recursive, path, export_path, update_progress);
-    }
+    ExportFiles(volume, partition, std::move(jobs), update_progress);
   }
 }
 
@@ -115,7 +115,11 @@ public:
   virtual Platform GetVolumeType() const = 0;
   virtual bool SupportsIntegrityCheck() const { return false; }
   virtual bool CheckH3TableIntegrity(const Partition& partition) const { return false; }
-  virtual bool CheckBlockIntegrity(u64 block_index, const std::vector<u8>& encrypted_data,
+  // CheckBlockIntegrity can only be called from several threads at once for a partition after
+  // this has been called for it
+  virtual void PrepareBlockIntegrityCheck(const Partition& partition) const {}
+  // encrypted_data must point to a whole block (VolumeWii::BLOCK_TOTAL_SIZE bytes)
+  virtual bool CheckBlockIntegrity(u64 block_index, const u8* encrypted_data,
                                    const Partition& partition) const
   {
     return false;
@@ -14,6 +14,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_set>
 
 #include <mbedtls/md5.h>
@@ -361,6 +362,8 @@ constexpr u64 DL_DVD_SIZE = 8511160320;    // Wii retail
 constexpr u64 DL_DVD_R_SIZE = 8543666176;  // Wii RVT-R
 
 constexpr u64 BLOCK_SIZE = 0x20000;
+// How many consecutive Wii blocks get read and checked at once
+constexpr size_t BLOCKS_PER_CHUNK = 64;
 
 VolumeVerifier::VolumeVerifier(const Volume& volume, bool redump_verification,
                                Hashes<bool> hashes_to_calculate)
@@ -368,13 +371,17 @@ VolumeVerifier::VolumeVerifier(const Volume& volume, bool redump_verification,
       m_hashes_to_calculate(hashes_to_calculate),
       m_calculating_any_hash(hashes_to_calculate.crc32 || hashes_to_calculate.md5 ||
                              hashes_to_calculate.sha1),
-      m_max_progress(volume.GetSize())
+      m_free_chunks(MAX_CHUNKS_IN_FLIGHT, MAX_CHUNKS_IN_FLIGHT), m_max_progress(volume.GetSize())
 {
   if (!m_calculating_any_hash)
     m_redump_verification = false;
 }
 
-VolumeVerifier::~VolumeVerifier() = default;
+VolumeVerifier::~VolumeVerifier()
+{
+  // The threads use members that are destroyed before them.
+  WaitForAsyncOperations();
+}
 
 void VolumeVerifier::Start()
 {
@@ -1037,48 +1044,161 @@ void VolumeVerifier::SetUpHashing()
   std::sort(m_blocks.begin(), m_blocks.end(),
             [](const BlockToVerify& b1, const BlockToVerify& b2) { return b1.offset < b2.offset; });
 
+  // Each hash is advanced on a dedicated thread, which receives the chunks in disc order
+
   if (m_hashes_to_calculate.crc32)
+  {
     m_crc32_context = crc32(0, nullptr, 0);
+    m_crc32_thread.Reset([this](Chunk chunk) {
+      // It would be nice to use crc32_z here instead of crc32, but it isn't available on Android
+      m_crc32_context =
+          crc32(m_crc32_context, chunk->data(), static_cast<unsigned int>(chunk->size()));
+    });
+  }
 
   if (m_hashes_to_calculate.md5)
   {
     mbedtls_md5_init(&m_md5_context);
     mbedtls_md5_starts_ret(&m_md5_context);
+    m_md5_thread.Reset([this](Chunk chunk) {
+      mbedtls_md5_update_ret(&m_md5_context, chunk->data(), chunk->size());
+    });
   }
 
   if (m_hashes_to_calculate.sha1)
   {
     mbedtls_sha1_init(&m_sha1_context);
     mbedtls_sha1_starts_ret(&m_sha1_context);
+    m_sha1_thread.Reset([this](Chunk chunk) {
+      mbedtls_sha1_update_ret(&m_sha1_context, chunk->data(), chunk->size());
+    });
+  }
+
+  if (!m_content_offsets.empty())
+    m_content_thread.Reset([this](ContentToCheck item) { CheckContent(item); });
+
+  if (!m_blocks.empty())
+  {
+    m_block_thread.Reset([this](BlocksToCheck blocks) { CheckBlocks(blocks); });
+    m_block_check_threads.clear();
+    for (u32 i = 1; i < std::thread::hardware_concurrency(); ++i)
+    {
+      m_block_check_threads.push_back(
+          std::make_unique<Common::WorkQueueThread<std::function<void()>>>(
+              [](std::function<void()> function) { function(); }));
+    }
   }
 }
 
-void VolumeVerifier::WaitForAsyncOperations() const
+void VolumeVerifier::WaitForAsyncOperations()
 {
-  if (m_crc32_future.valid())
-    m_crc32_future.wait();
-  if (m_md5_future.valid())
-    m_md5_future.wait();
-  if (m_sha1_future.valid())
-    m_sha1_future.wait();
-  if (m_content_future.valid())
-    m_content_future.wait();
-  if (m_block_future.valid())
-    m_block_future.wait();
+  if (m_hashes_to_calculate.crc32)
+    m_crc32_thread.WaitForCompletion();
+  if (m_hashes_to_calculate.md5)
+    m_md5_thread.WaitForCompletion();
+  if (m_hashes_to_calculate.sha1)
+    m_sha1_thread.WaitForCompletion();
+  m_content_thread.WaitForCompletion();
+  m_block_thread.WaitForCompletion();
 }
 
-bool VolumeVerifier::ReadChunkAndWaitForAsyncOperations(u64 bytes_to_read)
+VolumeVerifier::Chunk VolumeVerifier::ReadChunk(u64 bytes_to_read)
 {
-  std::vector<u8> data(bytes_to_read);
+  // Wait until one of the previously read chunks has been fully processed. The hash threads and
+  // the block and content checks each release the chunk as soon as they are done with it, and
+  // the deleter signals this once the last of them has.
+  m_free_chunks.Wait();
+  auto chunk = std::shared_ptr<std::vector<u8>>(new std::vector<u8>(bytes_to_read),
+                                                [this](std::vector<u8>* data) {
+                                                  delete data;
+                                                  m_free_chunks.Post();
+                                                });
+
+  std::lock_guard lk(m_volume_mutex);
+  if (!m_volume.Read(m_progress, bytes_to_read, chunk->data(), PARTITION_NONE))
+    return nullptr;
+
+  return chunk;
+}
+
+void VolumeVerifier::CheckContent(const ContentToCheck& item)
+{
+  if (!item.chunk || !m_volume.CheckContentIntegrity(item.content, *item.chunk, m_ticket))
   {
-    std::lock_guard lk(m_volume_mutex);
-    if (!m_volume.Read(m_progress, bytes_to_read, data.data(), PARTITION_NONE))
-      return false;
+    AddProblem(
+        Severity::High,
+        StringFromFormat(Common::GetStringT("Content %08x is corrupt.").c_str(), item.content.id));
   }
+}
 
-  WaitForAsyncOperations();
-  m_data = std::move(data);
-  return true;
+void VolumeVerifier::CheckBlocks(const BlocksToCheck& blocks)
+{
+  const Chunk& chunk = blocks.chunk;
+  const size_t first_block = blocks.first_block;
+  const size_t end_block = blocks.end_block;
+
+  // CheckBlockIntegrity loads data of the partition the first time it's called for it, which
+  // isn't thread-safe, so that is done here before the blocks are checked in parallel
+  for (size_t i = first_block; i < end_block; ++i)
+  {
+    if (i == first_block || m_blocks[i].partition != m_blocks[i - 1].partition)
+      m_volume.PrepareBlockIntegrityCheck(m_blocks[i].partition);
+  }
+
+  // Blocks are independent of each other, so they are checked in parallel batches
+  std::vector<u8> results(end_block - first_block);
+  const auto check_blocks = [&](size_t begin, size_t end, size_t step) {
+    for (size_t i = begin; i < end; i += step)
+    {
+      const BlockToVerify& block = m_blocks[i];
+      if (chunk && block.offset >= blocks.chunk_offset &&
+          block.offset + VolumeWii::BLOCK_TOTAL_SIZE <= blocks.chunk_offset + chunk->size())
+      {
+        results[i - first_block] = m_volume.CheckBlockIntegrity(
+            block.block_index, chunk->data() + (block.offset - blocks.chunk_offset),
+            block.partition);
+      }
+      else
+      {
+        std::lock_guard lk(m_volume_mutex);
+        results[i - first_block] = m_volume.CheckBlockIntegrity(block.block_index, block.partition);
+      }
+    }
+  };
+
+  const size_t thread_count =
+      std::min(m_block_check_threads.size() + 1, end_block - first_block);
+  for (size_t i = 1; i < thread_count; ++i)
+  {
+    m_block_check_threads[i - 1]->EmplaceItem(
+        [&, i] { check_blocks(first_block + i, end_block, thread_count); });
+  }
+  check_blocks(first_block, end_block, thread_count);
+  for (size_t i = 1; i < thread_count; ++i)
+    m_block_check_threads[i - 1]->WaitForCompletion();
+
+  for (size_t i = first_block; i < end_block; ++i)
+  {
+    const u64 offset = m_blocks[i].offset;
+    if (results[i - first_block])
+    {
+      m_biggest_verified_offset =
+          std::max(m_biggest_verified_offset, offset + VolumeWii::BLOCK_TOTAL_SIZE);
+    }
+    else
+    {
+      if (m_scrubber.CanBlockBeScrubbed(offset))
+      {
+        WARN_LOG(DISCIO, "Integrity check failed for unused block at 0x%" PRIx64, offset);
+        m_unused_block_errors[m_blocks[i].partition]++;
+      }
+      else
+      {
+        WARN_LOG(DISCIO, "Integrity check failed for block at 0x%" PRIx64, offset);
+        m_block_errors[m_blocks[i].partition]++;
+      }
+    }
+  }
 }
 
 void VolumeVerifier::Process()
@@ -1107,7 +1227,15 @@ void VolumeVerifier::Process()
   }
   else if (m_block_index < m_blocks.size() && m_blocks[m_block_index].offset == m_progress)
   {
-    bytes_to_read = VolumeWii::BLOCK_TOTAL_SIZE;
+    // Read as many consecutive blocks as possible, so they can be checked in parallel
+    size_t block_count = 1;
+    while (block_count < BLOCKS_PER_CHUNK && m_block_index + block_count < m_blocks.size() &&
+           m_blocks[m_block_index + block_count].offset ==
+               m_progress + block_count * VolumeWii::BLOCK_TOTAL_SIZE)
+    {
+      block_count++;
+    }
+    bytes_to_read = block_count * VolumeWii::BLOCK_TOTAL_SIZE;
     block_read = true;
   }
   else if (m_block_index < m_blocks.size() && m_blocks[m_block_index].offset > m_progress)
@@ -1116,8 +1244,11 @@ void VolumeVerifier::Process()
   }
   bytes_to_read = std::min(bytes_to_read, m_max_progress - m_progress);
 
+  // Reading this chunk overlaps with the processing of previous chunks, which happens
+  // on other threads. Only the block and content checks have to be started in order.
   const bool is_data_needed = m_calculating_any_hash || content_read || block_read;
-  const bool read_succeeded = is_data_needed && ReadChunkAndWaitForAsyncOperations(bytes_to_read);
+  const Chunk chunk = is_data_needed ? ReadChunk(bytes_to_read) : nullptr;
+  const bool read_succeeded = chunk != nullptr;
 
   if (!read_succeeded)
   {
@@ -1131,95 +1262,31 @@ void VolumeVerifier::Process()
   if (m_calculating_any_hash)
   {
     if (m_hashes_to_calculate.crc32)
-    {
-      m_crc32_future = std::async(std::launch::async, [this] {
-        // It would be nice to use crc32_z here instead of crc32, but it isn't available on Android
-        m_crc32_context =
-            crc32(m_crc32_context, m_data.data(), static_cast<unsigned int>(m_data.size()));
-      });
-    }
-
+      m_crc32_thread.EmplaceItem(chunk);
     if (m_hashes_to_calculate.md5)
-    {
-      m_md5_future = std::async(std::launch::async, [this] {
-        mbedtls_md5_update_ret(&m_md5_context, m_data.data(), m_data.size());
-      });
-    }
-
+      m_md5_thread.EmplaceItem(chunk);
     if (m_hashes_to_calculate.sha1)
-    {
-      m_sha1_future = std::async(std::launch::async, [this] {
-        mbedtls_sha1_update_ret(&m_sha1_context, m_data.data(), m_data.size());
-      });
-    }
+      m_sha1_thread.EmplaceItem(chunk);
   }
 
   if (content_read)
   {
-    m_content_future = std::async(std::launch::async, [this, read_succeeded, content] {
-      if (!read_succeeded || !m_volume.CheckContentIntegrity(content, m_data, m_ticket))
-      {
-        AddProblem(
-            Severity::High,
-            StringFromFormat(Common::GetStringT("Content %08x is corrupt.").c_str(), content.id));
-      }
-    });
-
+    m_content_thread.EmplaceItem(ContentToCheck{chunk, content});
     m_content_index++;
   }
 
   if (m_block_index < m_blocks.size() &&
       m_blocks[m_block_index].offset < m_progress + bytes_to_read)
   {
-    m_block_future = std::async(
-        std::launch::async,
-        [this, read_succeeded, bytes_to_read](size_t block_index, u64 progress) {
-          while (block_index < m_blocks.size() &&
-                 m_blocks[block_index].offset < progress + bytes_to_read)
-          {
-            bool success;
-            if (m_blocks[block_index].offset == progress)
-            {
-              success = read_succeeded &&
-                        m_volume.CheckBlockIntegrity(m_blocks[block_index].block_index, m_data,
-                                                     m_blocks[block_index].partition);
-            }
-            else
-            {
-              std::lock_guard lk(m_volume_mutex);
-              success = m_volume.CheckBlockIntegrity(m_blocks[block_index].block_index,
-                                                     m_blocks[block_index].partition);
-            }
-
-            const u64 offset = m_blocks[block_index].offset;
-            if (success)
-            {
-              m_biggest_verified_offset =
-                  std::max(m_biggest_verified_offset, offset + VolumeWii::BLOCK_TOTAL_SIZE);
-            }
-            else
-            {
-              if (m_scrubber.CanBlockBeScrubbed(offset))
-              {
-                WARN_LOG(DISCIO, "Integrity check failed for unused block at 0x%" PRIx64, offset);
-                m_unused_block_errors[m_blocks[block_index].partition]++;
-              }
-              else
-              {
-                WARN_LOG(DISCIO, "Integrity check failed for block at 0x%" PRIx64, offset);
-                m_block_errors[m_blocks[block_index].partition]++;
-              }
-            }
-            block_index++;
-          }
-        },
-        m_block_index, m_progress);
-
+    const size_t first_block = m_block_index;
     while (m_block_index < m_blocks.size() &&
            m_blocks[m_block_index].offset < m_progress + bytes_to_read)
     {
       m_block_index++;
     }
+
+    // The block thread checks one batch at a time, so the results are tallied in order
+    m_block_thread.EmplaceItem(BlocksToCheck{chunk, m_progress, first_block, m_block_index});
   }
 
   m_progress += bytes_to_read;
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <functional>
 #include <future>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
@@ -15,6 +17,8 @@
 #include <mbedtls/sha1.h>
 
 #include "Common/CommonTypes.h"
+#include "Common/Semaphore.h"
+#include "Common/WorkQueueThread.h"
 #include "Core/IOS/ES/Formats.h"
 #include "DiscIO/DiscScrubber.h"
 #include "DiscIO/Volume.h"
@@ -145,6 +149,28 @@ private:
     u64 block_index;
   };
 
+  // Data read from the disc is shared by the threads that process it, and freed once they have
+  // all processed it. At most MAX_CHUNKS_IN_FLIGHT chunks exist at a time, so reading can run
+  // ahead of the processing of earlier chunks without using an unbounded amount of memory.
+  using Chunk = std::shared_ptr<const std::vector<u8>>;
+  static constexpr int MAX_CHUNKS_IN_FLIGHT = 3;
+
+  struct ContentToCheck
+  {
+    Chunk chunk;
+    IOS::ES::Content content;
+  };
+
+  // The blocks [first_block, end_block) of m_blocks, of which the ones in chunk don't need to be
+  // read again
+  struct BlocksToCheck
+  {
+    Chunk chunk;
+    u64 chunk_offset;
+    size_t first_block;
+    size_t end_block;
+  };
+
   std::vector<Partition> CheckPartitions();
   bool CheckPartition(const Partition& partition);  // Returns false if partition should be ignored
   std::string GetPartitionName(std::optional<u32> type) const;
@@ -160,8 +186,10 @@ private:
   void CheckMisc();
   void CheckSuperPaperMario();
   void SetUpHashing();
-  void WaitForAsyncOperations() const;
-  bool ReadChunkAndWaitForAsyncOperations(u64 bytes_to_read);
+  void WaitForAsyncOperations();
+  Chunk ReadChunk(u64 bytes_to_read);
+  void CheckContent(const ContentToCheck& item);
+  void CheckBlocks(const BlocksToCheck& blocks);
 
   void AddProblem(Severity severity, std::string text);
 
@@ -182,13 +210,17 @@ private:
   mbedtls_md5_context m_md5_context;
   mbedtls_sha1_context m_sha1_context;
 
-  std::vector<u8> m_data;
+  Common::Semaphore m_free_chunks;
   std::mutex m_volume_mutex;
-  std::future<void> m_crc32_future;
-  std::future<void> m_md5_future;
-  std::future<void> m_sha1_future;
-  std::future<void> m_content_future;
-  std::future<void> m_block_future;
+  Common::WorkQueueThread<Chunk> m_crc32_thread;
+  Common::WorkQueueThread<Chunk> m_md5_thread;
+  Common::WorkQueueThread<Chunk> m_sha1_thread;
+  // The content and block checks run on threads that last for the whole verification, and the
+  // block thread checks each batch in parallel with the block check threads.
+  std::vector<std::unique_ptr<Common::WorkQueueThread<std::function<void()>>>>
+      m_block_check_threads;
+  Common::WorkQueueThread<ContentToCheck> m_content_thread;
+  Common::WorkQueueThread<BlocksToCheck> m_block_thread;
 
   DiscScrubber m_scrubber;
   IOS::ES::TicketReader m_ticket;
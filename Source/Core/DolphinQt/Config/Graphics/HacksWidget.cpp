@@ -66,6 +66,8 @@ void HacksWidget::CreateWidgets()
   m_accuracy->setTickPosition(QSlider::TicksBelow);
   m_gpu_texture_decoding =
       new GraphicsBool(tr("GPU Texture Decoding"), Config::GFX_ENABLE_GPU_TEXTURE_DECODING);
+  m_write_tracked_texture_cache = new GraphicsBool(tr("Track Writes to Textures"),
+                                                   Config::GFX_HACK_WRITE_TRACKED_TEXTURE_CACHE);
 
   auto* safe_label = new QLabel(tr("Safe"));
   safe_label->setAlignment(Qt::AlignRight);
@@ -77,6 +79,7 @@ void HacksWidget::CreateWidgets()
   texture_cache_layout->addWidget(m_accuracy, 0, 2);
   texture_cache_layout->addWidget(new QLabel(tr("Fast")), 0, 3);
   texture_cache_layout->addWidget(m_gpu_texture_decoding, 1, 0);
+  texture_cache_layout->addWidget(m_write_tracked_texture_cache, 1, 1, 1, -1);
 
   // XFB
   auto* xfb_box = new QGroupBox(tr("External Frame Buffer (XFB)"));
@@ -103,6 +106,9 @@ void HacksWidget::CreateWidgets()
   m_disable_bounding_box =
       new GraphicsBool(tr("Disable Bounding Box"), Config::GFX_HACK_BBOX_ENABLE, true);
   m_vertex_rounding = new GraphicsBool(tr("Vertex Rounding"), Config::GFX_HACK_VERTEX_ROUDING);
+  m_display_list_cache =
+      new GraphicsBool(tr("Cache Display Lists"), Config::GFX_HACK_DISPLAY_LIST_CACHE);
+  m_merge_draws = new GraphicsBool(tr("Merge Draws"), Config::GFX_HACK_MERGE_DRAWS);
   m_save_texture_cache_state =
       new GraphicsBool(tr("Save Texture Cache to State"), Config::GFX_SAVE_TEXTURE_CACHE_TO_STATE);
 
@@ -110,6 +116,8 @@ void HacksWidget::CreateWidgets()
   other_layout->addWidget(m_disable_bounding_box, 0, 1);
   other_layout->addWidget(m_vertex_rounding, 1, 0);
   other_layout->addWidget(m_save_texture_cache_state, 1, 1);
+  other_layout->addWidget(m_display_list_cache, 2, 0);
+  other_layout->addWidget(m_merge_draws, 2, 1);
 
   main_layout->addWidget(efb_box);
   main_layout->addWidget(texture_cache_box);
@@ -252,6 +260,12 @@ void HacksWidget::AddDescriptions()
                  "performance gains in some scenarios, or on systems where the CPU is the "
                  "bottleneck.\n\nIf unsure, leave this unchecked.");
 
+  static const char TR_WRITE_TRACKED_TEXTURE_CACHE_DESCRIPTION[] = QT_TR_NOOP(
+      "Watches the emulated memory that textures are loaded from, and only rehashes a texture "
+      "when that memory was written to. This reduces the cost of the texture cache on the GPU "
+      "thread, especially at the Safe accuracy setting.\n\nOnly has an effect when fastmem is "
+      "enabled.\n\nIf unsure, leave this unchecked.");
+
   static const char TR_FAST_DEPTH_CALC_DESCRIPTION[] = QT_TR_NOOP(
       "Uses a less accurate algorithm to calculate depth values.\n\nCauses issues in a few "
       "games, but can result in a decent speed increase depending on the game and/or "
@@ -268,6 +282,18 @@ void HacksWidget::AddDescriptions()
                  "higher internal resolutions. This setting has no effect when native internal "
                  "resolution is used.\n\nIf unsure, leave this unchecked.");
 
+  static const char TR_DISPLAY_LIST_CACHE_DESCRIPTION[] = QT_TR_NOOP(
+      "Remembers the commands of display lists that games call repeatedly, so that they don't "
+      "have to be parsed again, and reuses their converted vertices where possible. Display "
+      "lists are rehashed on every call unless fastmem is enabled, in which case only writes to "
+      "them are watched.\n\nHas no effect with deterministic dual core.\n\nIf unsure, leave "
+      "this unchecked.");
+  static const char TR_MERGE_DRAWS_DESCRIPTION[] = QT_TR_NOOP(
+      "Gives every draw its own copy of its position and normal matrices, so that draws which "
+      "only differ in these matrices are submitted to the GPU together.\n\nReduces the number "
+      "of draw calls in many games, but uses more memory bandwidth for the uniforms of each "
+      "batch. Has no effect in the software renderer.\n\nIf unsure, leave this unchecked.");
+
   AddDescription(m_skip_efb_cpu, TR_SKIP_EFB_CPU_ACCESS_DESCRIPTION);
   AddDescription(m_ignore_format_changes, TR_IGNORE_FORMAT_CHANGE_DESCRIPTION);
   AddDescription(m_store_efb_copies, TR_STORE_EFB_TO_TEXTURE_DESCRIPTION);
@@ -277,10 +303,13 @@ void HacksWidget::AddDescriptions()
   AddDescription(m_immediate_xfb, TR_IMMEDIATE_XFB_DESCRIPTION);
   AddDescription(m_skip_duplicate_xfbs, TR_SKIP_DUPLICATE_XFBS_DESCRIPTION);
   AddDescription(m_gpu_texture_decoding, TR_GPU_DECODING_DESCRIPTION);
+  AddDescription(m_write_tracked_texture_cache, TR_WRITE_TRACKED_TEXTURE_CACHE_DESCRIPTION);
   AddDescription(m_fast_depth_calculation, TR_FAST_DEPTH_CALC_DESCRIPTION);
   AddDescription(m_disable_bounding_box, TR_DISABLE_BOUNDINGBOX_DESCRIPTION);
   AddDescription(m_save_texture_cache_state, TR_SAVE_TEXTURE_CACHE_TO_STATE_DESCRIPTION);
   AddDescription(m_vertex_rounding, TR_VERTEX_ROUNDING_DESCRIPTION);
+  AddDescription(m_display_list_cache, TR_DISPLAY_LIST_CACHE_DESCRIPTION);
+  AddDescription(m_merge_draws, TR_MERGE_DRAWS_DESCRIPTION);
 }
 
 void HacksWidget::UpdateDeferEFBCopiesEnabled()
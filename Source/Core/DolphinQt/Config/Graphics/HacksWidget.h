@@ -33,6 +33,7 @@ private:
   QLabel* m_accuracy_label;
   QSlider* m_accuracy;
   QCheckBox* m_gpu_texture_decoding;
+  QCheckBox* m_write_tracked_texture_cache;
 
   // External Framebuffer
   QCheckBox* m_store_xfb_copies;
@@ -44,6 +45,8 @@ private:
   QCheckBox* m_disable_bounding_box;
   QCheckBox* m_vertex_rounding;
   QCheckBox* m_save_texture_cache_state;
+  QCheckBox* m_display_list_cache;
+  QCheckBox* m_merge_draws;
   QCheckBox* m_defer_efb_copies;
 
   void CreateWidgets();
@@ -268,14 +268,14 @@ void FIFOPlayerWindow::UpdateInfo()
   if (FifoRecorder::GetInstance().IsRecordingDone())
   {
     FifoDataFile* file = FifoRecorder::GetInstance().GetRecordedFile();
-    size_t fifo_bytes = 0;
-    size_t mem_bytes = 0;
+    u64 fifo_bytes = 0;
+    u64 mem_bytes = 0;
 
     for (u32 i = 0; i < file->GetFrameCount(); ++i)
     {
-      fifo_bytes += file->GetFrame(i).fifoData.size();
-      for (const auto& mem_update : file->GetFrame(i).memoryUpdates)
-        mem_bytes += mem_update.data.size();
+      const FifoDataFile::FrameSize& frame_size = file->GetFrameSize(i);
+      fifo_bytes += frame_size.fifoBytes;
+      mem_bytes += frame_size.memoryBytes;
     }
 
     m_info_label->setText(tr("%1 FIFO bytes\n%2 memory bytes\n%3 frames")
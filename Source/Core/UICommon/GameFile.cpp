@@ -97,6 +97,12 @@ GameFile::GameFile() = default;
 
 GameFile::GameFile(std::string path) : m_file_path(std::move(path))
 {
+  {
+    const File::FileInfo info(m_file_path);
+    m_host_file_size = info.GetSize();
+    m_host_last_modified = info.GetLastModified();
+  }
+
   m_file_name = PathToFileName(m_file_path);
 
   {
@@ -296,6 +302,8 @@ void GameFile::DoState(PointerWrap& p)
 
   p.Do(m_file_size);
   p.Do(m_volume_size);
+  p.Do(m_host_file_size);
+  p.Do(m_host_last_modified);
 
   p.Do(m_short_names);
   p.Do(m_long_names);
@@ -325,6 +333,12 @@ void GameFile::DoState(PointerWrap& p)
   m_custom_cover.DoState(p);
 }
 
+bool GameFile::IsOutdated() const
+{
+  const File::FileInfo info(m_file_path);
+  return info.GetSize() != m_host_file_size || info.GetLastModified() != m_host_last_modified;
+}
+
 bool GameFile::IsElfOrDol() const
 {
   if (m_file_path.size() < 4)
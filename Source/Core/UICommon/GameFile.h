@@ -89,6 +89,9 @@ public:
   const std::string& GetApploaderDate() const { return m_apploader_date; }
   u64 GetFileSize() const { return m_file_size; }
   u64 GetVolumeSize() const { return m_volume_size; }
+  // Returns true if the file on disk no longer has the size and modification time
+  // that it had when this GameFile was created.
+  bool IsOutdated() const;
   const GameBanner& GetBannerImage() const;
   const GameCover& GetCoverImage() const;
   void DoState(PointerWrap& p);
@@ -124,6 +127,8 @@ private:
 
   u64 m_file_size{};
   u64 m_volume_size{};
+  u64 m_host_file_size{};
+  u64 m_host_last_modified{};
 
   std::map<DiscIO::Language, std::string> m_short_names;
   std::map<DiscIO::Language, std::string> m_long_names;
@@ -5,12 +5,14 @@
 #include "UICommon/GameFileCache.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -27,7 +29,11 @@
 
 namespace UICommon
 {
-static constexpr u32 CACHE_REVISION = 16;  // Last changed in PR 8313
+static constexpr u32 CACHE_REVISION = 17;  // Last changed when adding host file timestamps
+
+// Scanning is mostly bound by I/O latency (especially on network storage),
+// so it's worth using more threads than there are cores on small machines.
+static constexpr unsigned int MIN_SCAN_THREADS = 4;
 
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan)
@@ -39,6 +45,42 @@ std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& direct
   return Common::DoFileSearch(directories_to_scan, search_extensions, recursive_scan);
 }
 
+// Constructs GameFiles for all of the given paths using a pool of worker threads.
+// The returned vector has the same order as the input, with invalid files set to nullptr.
+static std::vector<std::shared_ptr<GameFile>>
+CreateGameFilesInParallel(const std::vector<std::string>& paths)
+{
+  std::vector<std::shared_ptr<GameFile>> result(paths.size());
+
+  std::atomic<size_t> next_index{0};
+  const auto worker = [&] {
+    size_t i;
+    while ((i = next_index++) < paths.size())
+    {
+      auto file = std::make_shared<GameFile>(paths[i]);
+      if (file->IsValid())
+        result[i] = std::move(file);
+    }
+  };
+
+  const size_t thread_count =
+      std::min<size_t>(std::max(std::thread::hardware_concurrency(), MIN_SCAN_THREADS),
+                       paths.size());
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+
+  // The calling thread does its share of the work too
+  worker();
+
+  for (std::thread& thread : threads)
+    thread.join();
+
+  return result;
+}
+
 GameFileCache::GameFileCache() : m_path(File::GetUserPath(D_CACHE_IDX) + "gamelist.cache")
 {
 }
@@ -72,7 +114,14 @@ std::shared_ptr<const GameFile> GameFileCache::AddOrGet(const std::string& path,
   auto it = std::find_if(
       m_cached_files.begin(), m_cached_files.end(),
       [&path](const std::shared_ptr<GameFile>& file) { return file->GetFilePath() == path; });
-  const bool found = it != m_cached_files.cend();
+  bool found = it != m_cached_files.cend();
+  if (found && (*it)->IsOutdated())
+  {
+    *it = std::move(m_cached_files.back());
+    m_cached_files.pop_back();
+    found = false;
+    *cache_changed = true;
+  }
   if (!found)
   {
     std::shared_ptr<UICommon::GameFile> game = std::make_shared<GameFile>(path);
@@ -107,14 +156,18 @@ bool GameFileCache::Update(
 
   // Delete paths that aren't in game_paths from m_cached_files,
   // while simultaneously deleting paths that are in m_cached_files from game_paths.
+  // Cached files whose size and modification time are unchanged are reused without
+  // opening the volume. Outdated ones are deleted, but stay in game_paths to be re-added.
   // For the sake of speed, we don't care about maintaining the order of m_cached_files.
   {
     auto it = m_cached_files.begin();
     auto end = m_cached_files.end();
     while (it != end)
     {
-      if (game_paths.erase((*it)->GetFilePath()))
+      const auto path_it = game_paths.find((*it)->GetFilePath());
+      if (path_it != game_paths.end() && !(*it)->IsOutdated())
       {
+        game_paths.erase(path_it);
         ++it;
       }
       else
@@ -132,10 +185,10 @@ bool GameFileCache::Update(
 
   // Now that the previous loop has run, game_paths only contains paths that
   // aren't in m_cached_files, so we simply add all of them to m_cached_files.
-  for (const std::string& path : game_paths)
+  const std::vector<std::string> new_paths(game_paths.begin(), game_paths.end());
+  for (std::shared_ptr<GameFile>& file : CreateGameFilesInParallel(new_paths))
   {
-    auto file = std::make_shared<GameFile>(path);
-    if (file->IsValid())
+    if (file)
     {
       if (game_added_to_cache)
         game_added_to_cache(file);
@@ -263,7 +263,7 @@ void VertexManager::UploadUniforms()
   if (VertexShaderManager::dirty)
   {
     UpdateConstantBuffer(m_vertex_constant_buffer.Get(), &VertexShaderManager::constants,
-                         sizeof(VertexShaderConstants));
+                         VertexShaderManager::GetConstantsSize());
     VertexShaderManager::dirty = false;
   }
   if (GeometryShaderManager::dirty)
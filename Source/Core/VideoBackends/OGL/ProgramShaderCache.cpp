@@ -224,7 +224,7 @@ void ProgramShaderCache::UploadConstants()
     memcpy(buffer.first, &PixelShaderManager::constants, sizeof(PixelShaderConstants));
 
     memcpy(buffer.first + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align),
-           &VertexShaderManager::constants, sizeof(VertexShaderConstants));
+           &VertexShaderManager::constants, VertexShaderManager::GetConstantsSize());
 
     memcpy(buffer.first + Common::AlignUp(sizeof(PixelShaderConstants), s_ubo_align) +
                Common::AlignUp(sizeof(VertexShaderConstants), s_ubo_align),
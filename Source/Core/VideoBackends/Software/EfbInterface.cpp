@@ -8,6 +8,7 @@
 #include <array>
 #include <cstddef>
 #include <cstring>
+#include <functional>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -23,7 +24,9 @@ namespace EfbInterface
 {
 static std::array<u8, EFB_WIDTH * EFB_HEIGHT * 6> efb;
 
-static std::array<u32, PQ_NUM_MEMBERS> perf_values;
+// Number of pixels counted by each perf counter, and the numbers when the query was reset.
+static std::array<u64, PQ_NUM_MEMBERS> perf_pixels;
+static std::array<u64, PQ_NUM_MEMBERS> perf_reset_pixels;
 
 static inline u32 GetColorOffset(u16 x, u16 y)
 {
@@ -444,6 +447,151 @@ void BlendTev(u16 x, u16 y, u8* color)
   }
 }
 
+bool CanDrawQuad()
+{
+  // RGB565 isn't supported correctly yet, and logic ops are left to BlendTev.
+  switch (bpmem.zcontrol.pixel_format)
+  {
+  case PEControl::RGB8_Z24:
+  case PEControl::RGBA6_Z24:
+  case PEControl::Z24:
+    return bpmem.blendmode.blendenable || !bpmem.blendmode.logicopenable;
+  default:
+    return false;
+  }
+}
+
+// Gets the blend factors of the pixels of a quad, like GetSourceFactor and GetDestinationFactor.
+static void GetQuadBlendFactors(BlendMode::BlendFactor mode, bool is_source,
+                                const u8 srcClr[4][QUAD_LANES], const u8 dstClr[4][QUAD_LANES],
+                                u8 factor[4][QUAD_LANES])
+{
+  // The color factors are the color of the other side.
+  const u8(*const otherClr)[QUAD_LANES] = is_source ? dstClr : srcClr;
+  for (int i = 0; i < 4; i++)
+  {
+    for (int lane = 0; lane < QUAD_LANES; lane++)
+    {
+      switch (mode)
+      {
+      case BlendMode::ZERO:
+        factor[i][lane] = 0;
+        break;
+      case BlendMode::ONE:
+        factor[i][lane] = 0xff;
+        break;
+      case BlendMode::SRCCLR:
+        factor[i][lane] = otherClr[i][lane];
+        break;
+      case BlendMode::INVSRCCLR:
+        factor[i][lane] = 0xff - otherClr[i][lane];
+        break;
+      case BlendMode::SRCALPHA:
+        factor[i][lane] = srcClr[ALP_C][lane];
+        break;
+      case BlendMode::INVSRCALPHA:
+        factor[i][lane] = 0xff - srcClr[ALP_C][lane];
+        break;
+      case BlendMode::DSTALPHA:
+        factor[i][lane] = dstClr[ALP_C][lane];
+        break;
+      case BlendMode::INVDSTALPHA:
+        factor[i][lane] = 0xff - dstClr[ALP_C][lane];
+        break;
+      }
+    }
+  }
+}
+
+void BlendTevQuad(const u16 x[QUAD_LANES], const u16 y[QUAD_LANES],
+                  const u8 color[4][QUAD_LANES], u32 mask)
+{
+  u32 offsets[QUAD_LANES];
+  for (int lane = 0; lane < QUAD_LANES; lane++)
+    offsets[lane] = GetColorOffset(x[lane], y[lane]);
+
+  u8 result[4][QUAD_LANES];
+  if (bpmem.blendmode.blendenable)
+  {
+    u8 dstClr[4][QUAD_LANES];
+    for (int lane = 0; lane < QUAD_LANES; lane++)
+    {
+      const u32 dst = (mask & (1 << lane)) ? GetPixelColor(offsets[lane]) : 0;
+      for (int i = 0; i < 4; i++)
+        dstClr[i][lane] = static_cast<u8>(dst >> (i * 8));
+    }
+
+    if (bpmem.blendmode.subtract)
+    {
+      for (int i = 0; i < 4; i++)
+      {
+        for (int lane = 0; lane < QUAD_LANES; lane++)
+          result[i][lane] = static_cast<u8>(std::max(dstClr[i][lane] - color[i][lane], 0));
+      }
+    }
+    else
+    {
+      u8 srcFactor[4][QUAD_LANES];
+      u8 dstFactor[4][QUAD_LANES];
+      GetQuadBlendFactors(bpmem.blendmode.srcfactor, true, color, dstClr, srcFactor);
+      GetQuadBlendFactors(bpmem.blendmode.dstfactor, false, color, dstClr, dstFactor);
+
+      for (int i = 0; i < 4; i++)
+      {
+        for (int lane = 0; lane < QUAD_LANES; lane++)
+        {
+          // add MSB of factors to make their range 0 -> 256
+          const u32 sf = srcFactor[i][lane] + (srcFactor[i][lane] >> 7);
+          const u32 df = dstFactor[i][lane] + (dstFactor[i][lane] >> 7);
+          const u32 blended = (color[i][lane] * sf + dstClr[i][lane] * df) >> 8;
+          result[i][lane] = static_cast<u8>(std::min<u32>(blended, 255));
+        }
+      }
+    }
+  }
+  else
+  {
+    std::memcpy(result, color, sizeof(result));
+  }
+
+  if (bpmem.dstalpha.enable)
+    std::fill_n(result[ALP_C], QUAD_LANES, static_cast<u8>(bpmem.dstalpha.alpha));
+
+  if (bpmem.blendmode.colorupdate && bpmem.blendmode.dither &&
+      bpmem.zcontrol.pixel_format == PEControl::PixelFormat::RGBA6_Z24)
+  {
+    static const u8 dither[2][2] = {{0, 2}, {3, 1}};
+    for (int i = BLU_C; i <= RED_C; i++)
+    {
+      for (int lane = 0; lane < QUAD_LANES; lane++)
+      {
+        const u8 c = result[i][lane];
+        result[i][lane] = ((c - (c >> 6)) + dither[y[lane] & 1][x[lane] & 1]) & 0xfc;
+      }
+    }
+  }
+
+  for (int lane = 0; lane < QUAD_LANES; lane++)
+  {
+    if (!(mask & (1 << lane)))
+      continue;
+
+    u8 pixel[4] = {result[ALP_C][lane], result[BLU_C][lane], result[GRN_C][lane],
+                   result[RED_C][lane]};
+    if (bpmem.blendmode.colorupdate)
+    {
+      if (bpmem.blendmode.alphaupdate)
+        SetPixelAlphaColor(offsets[lane], pixel);
+      else
+        SetPixelColorOnly(offsets[lane], pixel);
+    }
+    else if (bpmem.blendmode.alphaupdate)
+    {
+      SetPixelAlphaOnly(offsets[lane], pixel[ALP_C]);
+    }
+  }
+}
+
 void SetColor(u16 x, u16 y, u8* color)
 {
   u32 offset = GetColorOffset(x, y);
@@ -688,26 +836,85 @@ bool ZCompare(u16 x, u16 y, u32 z)
   return pass;
 }
 
-u32 GetPerfQueryResult(PerfQueryType type)
+u32 ZCompareQuad(const u16 x[QUAD_LANES], const u16 y[QUAD_LANES], const u32 z[QUAD_LANES],
+                 u32 mask)
 {
-  return perf_values[type];
-}
+  u32 offsets[QUAD_LANES];
+  u32 depth[QUAD_LANES];
+  for (int lane = 0; lane < QUAD_LANES; lane++)
+  {
+    offsets[lane] = GetDepthOffset(x[lane], y[lane]);
+    depth[lane] = (mask & (1 << lane)) ? GetPixelDepth(offsets[lane]) : 0;
+  }
 
-void ResetPerfQuery()
-{
-  perf_values = {};
+  const auto compare = [&](auto pass) {
+    u32 result = 0;
+    for (int lane = 0; lane < QUAD_LANES; lane++)
+      result |= u32{pass(z[lane], depth[lane])} << lane;
+    return result;
+  };
+
+  u32 pass;
+  switch (bpmem.zmode.func)
+  {
+  case ZMode::NEVER:
+    pass = 0;
+    break;
+  case ZMode::LESS:
+    pass = compare(std::less<u32>());
+    break;
+  case ZMode::EQUAL:
+    pass = compare(std::equal_to<u32>());
+    break;
+  case ZMode::LEQUAL:
+    pass = compare(std::less_equal<u32>());
+    break;
+  case ZMode::GREATER:
+    pass = compare(std::greater<u32>());
+    break;
+  case ZMode::NEQUAL:
+    pass = compare(std::not_equal_to<u32>());
+    break;
+  case ZMode::GEQUAL:
+    pass = compare(std::greater_equal<u32>());
+    break;
+  case ZMode::ALWAYS:
+    pass = mask;
+    break;
+  default:
+    pass = 0;
+    ERROR_LOG(VIDEO, "Bad Z compare mode %i", (int)bpmem.zmode.func);
+  }
+  pass &= mask;
+
+  if (bpmem.zmode.updateenable)
+  {
+    for (int lane = 0; lane < QUAD_LANES; lane++)
+    {
+      if (pass & (1 << lane))
+        SetPixelDepth(offsets[lane], z[lane]);
+    }
+  }
+
+  return pass;
 }
 
-void IncPerfCounterQuadCount(PerfQueryType type)
+u32 GetPerfQueryResult(PerfQueryType type)
 {
   // NOTE: hardware doesn't process individual pixels but quads instead.
   // Current software renderer architecture works on pixels though, so
   // we have this "quad" hack here to only increment the registers on
   // every fourth rendered pixel
-  static u32 quad[PQ_NUM_MEMBERS];
-  if (++quad[type] != 3)
-    return;
-  quad[type] = 0;
-  ++perf_values[type];
+  return static_cast<u32>(perf_pixels[type] / 3 - perf_reset_pixels[type] / 3);
+}
+
+void ResetPerfQuery()
+{
+  perf_reset_pixels = perf_pixels;
+}
+
+void AddPerfCounterPixels(PerfQueryType type, u32 count)
+{
+  perf_pixels[type] += count;
 }
 }  // namespace EfbInterface
@@ -45,6 +45,21 @@ void BlendTev(u16 x, u16 y, u8* color);
 // returns result of compare.
 bool ZCompare(u16 x, u16 y, u32 z);
 
+// The pixels of a 2x2 block are drawn together by Tev::DrawQuad, with one lane for each pixel. The
+// quad functions only touch the pixels whose bits are set in mask.
+constexpr int QUAD_LANES = 4;
+
+// Returns true if the quad functions support the current pixel format and blend mode.
+bool CanDrawQuad();
+
+// Does ZCompare for the pixels of a quad, and returns the mask of the pixels that pass.
+u32 ZCompareQuad(const u16 x[QUAD_LANES], const u16 y[QUAD_LANES], const u32 z[QUAD_LANES],
+                 u32 mask);
+
+// Does BlendTev for the pixels of a quad. The color components are in ABGR order like BlendTev.
+void BlendTevQuad(const u16 x[QUAD_LANES], const u16 y[QUAD_LANES],
+                  const u8 color[4][QUAD_LANES], u32 mask);
+
 // sets the color and alpha
 void SetColor(u16 x, u16 y, u8* color);
 void SetDepth(u16 x, u16 y, u32 depth);
@@ -59,5 +74,5 @@ void EncodeXFB(u8* xfb_in_ram, u32 memory_stride, const MathUtil::Rectangle<int>
 
 u32 GetPerfQueryResult(PerfQueryType type);
 void ResetPerfQuery();
-void IncPerfCounterQuadCount(PerfQueryType type);
+void AddPerfCounterPixels(PerfQueryType type, u32 count);
 }  // namespace EfbInterface
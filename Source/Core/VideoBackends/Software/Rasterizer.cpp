@@ -5,9 +5,18 @@
 #include "VideoBackends/Software/Rasterizer.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfenv>
+#include <condition_variable>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Thread.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/NativeVertexFormat.h"
 #include "VideoBackends/Software/Tev.h"
@@ -17,26 +26,103 @@
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
+#ifdef _M_X86
+#include "VideoBackends/Software/TevX64.h"
+#endif
+
 namespace Rasterizer
 {
 static constexpr int BLOCK_SIZE = 2;
 
-static Slope ZSlope;
-static Slope WSlope;
-static Slope ColorSlopes[2][4];
-static Slope TexSlopes[8][3];
+// With several threads, the EFB is split into tiles that are drawn in parallel. Each thread draws
+// all of the triangles of a tile in order, and every block is in one tile, so the result is the
+// same as with one thread.
+static constexpr s32 TILE_SIZE = 32;
+static constexpr s32 TILES_X = (EFB_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr s32 TILES_Y = (EFB_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+static constexpr u32 NUM_TILES = TILES_X * TILES_Y;
+static_assert(TILE_SIZE % BLOCK_SIZE == 0, "Blocks must not cross tiles");
+
+// Batches with bounding boxes smaller than this are drawn on the GPU thread, waking up the other
+// threads would take longer.
+static constexpr u64 MIN_THREADED_BATCH_PIXELS = 64 * 64;
+
+// Everything that is needed to draw a triangle.
+struct Triangle
+{
+  Slope ZSlope;
+  Slope WSlope;
+  Slope ColorSlopes[2][4];
+  Slope TexSlopes[8][3];
+
+  s32 vertex0X;
+  s32 vertex0Y;
+  float vertexOffsetX;
+  float vertexOffsetY;
+
+  // Half-edge constants and deltas, in 28.4 fixed point
+  s32 C1, C2, C3;
+  s32 DX12, DX23, DX31;
+  s32 DY12, DY23, DY31;
+
+  // Bounding rectangle after scissoring, minx and miny are aligned to the block size
+  s32 minx, maxx, miny, maxy;
+};
+
+// The state of a thread that draws pixels.
+struct DrawContext
+{
+  Tev tev;
+  RasterBlock rasterBlock;
+  u32 rasterizedPixels = 0;
 
-static s32 vertex0X;
-static s32 vertex0Y;
-static float vertexOffsetX;
-static float vertexOffsetY;
+  // Whether the pixels of each block are drawn together, which the TEV dumps don't support.
+  bool drawQuads = false;
+};
 
-static Tev tev;
-static RasterBlock rasterBlock;
+// The z slope of the last triangle, which is used for the next ones when zfreeze is enabled.
+static Slope ZSlope;
+
+// The triangles of the current batch, which are drawn by Flush.
+static std::vector<Triangle> triangles;
+static std::array<std::vector<u32>, NUM_TILES> tileTriangles;
+static u64 batchPixels = 0;
+
+// The first context is used by the GPU thread, the others by the worker threads.
+static std::vector<std::unique_ptr<DrawContext>> drawContexts;
+static std::vector<std::thread> workerThreads;
+static std::mutex workerMutex;
+static std::condition_variable workAvailable;
+static std::condition_variable workDone;
+static u32 batchNumber = 0;
+static u32 busyWorkers = 0;
+static bool exitWorkers = false;
+static std::atomic<u32> nextTile;
+// The floating point environment of the GPU thread, which the worker threads use for the batch so
+// that the slopes and texture coordinates are rounded the same way.
+static std::fenv_t batchFloatEnvironment;
+
+#ifdef _M_X86
+// Only used on the GPU thread, between batches.
+static std::unique_ptr<TevX64> tevCompiler;
+#endif
+
+static void WorkerThread(DrawContext* context);
 
 void Init()
 {
-  tev.Init();
+  const u32 numWorkers = std::min(g_ActiveConfig.GetSWRasterizerThreads(), NUM_TILES - 1);
+  for (u32 i = 0; i <= numWorkers; i++)
+  {
+    drawContexts.push_back(std::make_unique<DrawContext>());
+    drawContexts.back()->tev.Init();
+    if (i != 0)
+      workerThreads.emplace_back(WorkerThread, drawContexts.back().get());
+  }
+
+#ifdef _M_X86
+  tevCompiler = std::make_unique<TevX64>();
+#endif
 
   // Set initial z reference plane in the unlikely case that zfreeze is enabled when drawing the
   // first primitive.
@@ -45,6 +131,25 @@ void Init()
   ZSlope.f0 = 1.f;
 }
 
+void Shutdown()
+{
+  {
+    std::lock_guard<std::mutex> lk(workerMutex);
+    exitWorkers = true;
+  }
+  workAvailable.notify_all();
+  for (std::thread& thread : workerThreads)
+    thread.join();
+
+  workerThreads.clear();
+  drawContexts.clear();
+  triangles.clear();
+#ifdef _M_X86
+  tevCompiler.reset();
+#endif
+  exitWorkers = false;
+}
+
 // Returns approximation of log2(f) in s28.4
 // results are close enough to use for LOD
 static s32 FixedLog2(float f)
@@ -69,31 +174,35 @@ static inline int iround(float x)
 
 void SetTevReg(int reg, int comp, s16 color)
 {
-  tev.SetRegColor(reg, comp, color);
+  for (auto& context : drawContexts)
+    context->tev.SetRegColor(reg, comp, color);
 }
 
-static void Draw(s32 x, s32 y, s32 xi, s32 yi)
+static void Draw(DrawContext& context, const Triangle& tri, s32 x, s32 y, s32 xi, s32 yi)
 {
-  INCSTAT(g_stats.this_frame.rasterized_pixels);
+  context.rasterizedPixels++;
 
-  float dx = vertexOffsetX + (float)(x - vertex0X);
-  float dy = vertexOffsetY + (float)(y - vertex0Y);
+  float dx = tri.vertexOffsetX + (float)(x - tri.vertex0X);
+  float dy = tri.vertexOffsetY + (float)(y - tri.vertex0Y);
 
-  s32 z = (s32)std::clamp<float>(ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
+  s32 z = (s32)std::clamp<float>(tri.ZSlope.GetValue(dx, dy), 0.0f, 16777215.0f);
+
+  Tev& tev = context.tev;
 
   if (bpmem.UseEarlyDepthTest() && g_ActiveConfig.bZComploc)
   {
     // TODO: Test if perf regs are incremented even if test is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
+    tev.IncPerfCounterQuadCount(PQ_ZCOMP_INPUT_ZCOMPLOC);
     if (bpmem.zmode.testenable)
     {
       // early z
       if (!EfbInterface::ZCompare(x, y, z))
         return;
     }
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
+    tev.IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT_ZCOMPLOC);
   }
 
+  RasterBlock& rasterBlock = context.rasterBlock;
   RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
   tev.Position[0] = x;
@@ -105,7 +214,7 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
   {
     for (int comp = 0; comp < 4; comp++)
     {
-      u16 color = (u16)ColorSlopes[i][comp].GetValue(dx, dy);
+      u16 color = (u16)tri.ColorSlopes[i][comp].GetValue(dx, dy);
 
       // clamp color value to 0
       u16 mask = ~(color >> 8);
@@ -134,19 +243,22 @@ static void Draw(s32 x, s32 y, s32 xi, s32 yi)
     tev.TextureLinear[i] = rasterBlock.TextureLinear[i];
   }
 
-  tev.Draw();
+  if (context.drawQuads)
+    tev.AddQuadPixel();
+  else
+    tev.Draw();
 }
 
-static void InitTriangle(float X1, float Y1, s32 xi, s32 yi)
+static void InitTriangle(Triangle* tri, float X1, float Y1, s32 xi, s32 yi)
 {
-  vertex0X = xi;
-  vertex0Y = yi;
+  tri->vertex0X = xi;
+  tri->vertex0Y = yi;
 
   // adjust a little less than 0.5
   const float adjust = 0.495f;
 
-  vertexOffsetX = ((float)xi - X1) + adjust;
-  vertexOffsetY = ((float)yi - Y1) + adjust;
+  tri->vertexOffsetX = ((float)xi - X1) + adjust;
+  tri->vertexOffsetY = ((float)yi - Y1) + adjust;
 }
 
 static void InitSlope(Slope* slope, float f1, float f2, float f3, float DX31, float DX12,
@@ -162,7 +274,8 @@ static void InitSlope(Slope* slope, float f1, float f2, float f3, float DX31, fl
   slope->f0 = f1;
 }
 
-static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoord)
+static inline void CalculateLOD(const RasterBlock& rasterBlock, s32* lodp, bool* linear,
+                                u32 texmap, u32 texcoord)
 {
   const FourTexUnits& texUnit = bpmem.tex[(texmap >> 2) & 1];
   const u8 subTexmap = texmap & 3;
@@ -175,17 +288,17 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   float sDelta, tDelta;
   if (tm0.diag_lod)
   {
-    float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float* uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
+    const float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float* uv1 = rasterBlock.Pixel[1][1].Uv[texcoord];
 
     sDelta = fabsf(uv0[0] - uv1[0]);
     tDelta = fabsf(uv0[1] - uv1[1]);
   }
   else
   {
-    float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
-    float* uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
-    float* uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
+    const float* uv0 = rasterBlock.Pixel[0][0].Uv[texcoord];
+    const float* uv1 = rasterBlock.Pixel[1][0].Uv[texcoord];
+    const float* uv2 = rasterBlock.Pixel[0][1].Uv[texcoord];
 
     sDelta = std::max(fabsf(uv0[0] - uv1[0]), fabsf(uv0[0] - uv2[0]));
     tDelta = std::max(fabsf(uv0[1] - uv1[1]), fabsf(uv0[1] - uv2[1]));
@@ -210,18 +323,20 @@ static inline void CalculateLOD(s32* lodp, bool* linear, u32 texmap, u32 texcoor
   *lodp = lod;
 }
 
-static void BuildBlock(s32 blockX, s32 blockY)
+static void BuildBlock(DrawContext& context, const Triangle& tri, s32 blockX, s32 blockY)
 {
+  RasterBlock& rasterBlock = context.rasterBlock;
+
   for (s32 yi = 0; yi < BLOCK_SIZE; yi++)
   {
     for (s32 xi = 0; xi < BLOCK_SIZE; xi++)
     {
       RasterBlockPixel& pixel = rasterBlock.Pixel[xi][yi];
 
-      float dx = vertexOffsetX + (float)(xi + blockX - vertex0X);
-      float dy = vertexOffsetY + (float)(yi + blockY - vertex0Y);
+      float dx = tri.vertexOffsetX + (float)(xi + blockX - tri.vertex0X);
+      float dy = tri.vertexOffsetY + (float)(yi + blockY - tri.vertex0Y);
 
-      float invW = 1.0f / WSlope.GetValue(dx, dy);
+      float invW = 1.0f / tri.WSlope.GetValue(dx, dy);
       pixel.InvW = invW;
 
       // tex coords
@@ -230,13 +345,13 @@ static void BuildBlock(s32 blockX, s32 blockY)
         float projection = invW;
         if (xfmem.texMtxInfo[i].projection)
         {
-          float q = TexSlopes[i][2].GetValue(dx, dy) * invW;
+          float q = tri.TexSlopes[i][2].GetValue(dx, dy) * invW;
           if (q != 0.0f)
             projection = invW / q;
         }
 
-        pixel.Uv[i][0] = TexSlopes[i][0].GetValue(dx, dy) * projection;
-        pixel.Uv[i][1] = TexSlopes[i][1].GetValue(dx, dy) * projection;
+        pixel.Uv[i][0] = tri.TexSlopes[i][0].GetValue(dx, dy) * projection;
+        pixel.Uv[i][1] = tri.TexSlopes[i][1].GetValue(dx, dy) * projection;
       }
     }
   }
@@ -249,7 +364,8 @@ static void BuildBlock(s32 blockX, s32 blockY)
     u32 texcoord = indref & 3;
     indref >>= 3;
 
-    CalculateLOD(&rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap, texcoord);
+    CalculateLOD(rasterBlock, &rasterBlock.IndirectLod[i], &rasterBlock.IndirectLinear[i], texmap,
+                 texcoord);
   }
 
   for (unsigned int i = 0; i <= bpmem.genMode.numtevstages; i++)
@@ -261,7 +377,121 @@ static void BuildBlock(s32 blockX, s32 blockY)
       u32 texmap = order.getTexMap(stageOdd);
       u32 texcoord = order.getTexCoord(stageOdd);
 
-      CalculateLOD(&rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap, texcoord);
+      CalculateLOD(rasterBlock, &rasterBlock.TextureLod[i], &rasterBlock.TextureLinear[i], texmap,
+                   texcoord);
+    }
+  }
+}
+
+// Draws the blocks of a triangle that are within a rectangle aligned to the block size.
+static void DrawTriangle(DrawContext& context, const Triangle& tri, s32 left, s32 top, s32 right,
+                         s32 bottom)
+{
+  const s32 DX12 = tri.DX12;
+  const s32 DX23 = tri.DX23;
+  const s32 DX31 = tri.DX31;
+
+  const s32 DY12 = tri.DY12;
+  const s32 DY23 = tri.DY23;
+  const s32 DY31 = tri.DY31;
+
+  // Fixed-pos32 deltas
+  const s32 FDX12 = DX12 * 16;
+  const s32 FDX23 = DX23 * 16;
+  const s32 FDX31 = DX31 * 16;
+
+  const s32 FDY12 = DY12 * 16;
+  const s32 FDY23 = DY23 * 16;
+  const s32 FDY31 = DY31 * 16;
+
+  const s32 C1 = tri.C1;
+  const s32 C2 = tri.C2;
+  const s32 C3 = tri.C3;
+
+  const s32 minx = std::max(tri.minx, left);
+  const s32 maxx = std::min(tri.maxx, right);
+  const s32 miny = std::max(tri.miny, top);
+  const s32 maxy = std::min(tri.maxy, bottom);
+
+  // Loop through blocks
+  for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
+  {
+    for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
+    {
+      // Corners of block
+      s32 x0 = x << 4;
+      s32 x1 = (x + BLOCK_SIZE - 1) << 4;
+      s32 y0 = y << 4;
+      s32 y1 = (y + BLOCK_SIZE - 1) << 4;
+
+      // Evaluate half-space functions
+      bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
+      bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
+      bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
+      bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
+      int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
+
+      bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
+      bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
+      bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
+      bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
+      int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
+
+      bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
+      bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
+      bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
+      bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
+      int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
+
+      // Skip block when outside an edge
+      if (a == 0x0 || b == 0x0 || c == 0x0)
+        continue;
+
+      BuildBlock(context, tri, x, y);
+
+      // Accept whole block when totally covered
+      if (a == 0xF && b == 0xF && c == 0xF)
+      {
+        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+        {
+          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+          {
+            Draw(context, tri, x + ix, y + iy, ix, iy);
+          }
+        }
+      }
+      else  // Partially covered block
+      {
+        s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
+        s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
+        s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
+
+        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
+        {
+          s32 CX1 = CY1;
+          s32 CX2 = CY2;
+          s32 CX3 = CY3;
+
+          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
+          {
+            if (CX1 > 0 && CX2 > 0 && CX3 > 0)
+            {
+              Draw(context, tri, x + ix, y + iy, ix, iy);
+            }
+
+            CX1 -= FDY12;
+            CX2 -= FDY23;
+            CX3 -= FDY31;
+          }
+
+          CY1 += FDX12;
+          CY2 += FDX23;
+          CY3 += FDX31;
+        }
+      }
+
+      if (context.drawQuads)
+        context.tev.DrawQuad();
     }
   }
 }
@@ -292,15 +522,6 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   const s32 DY23 = Y2 - Y3;
   const s32 DY31 = Y3 - Y1;
 
-  // Fixed-pos32 deltas
-  const s32 FDX12 = DX12 * 16;
-  const s32 FDX23 = DX23 * 16;
-  const s32 FDX31 = DX31 * 16;
-
-  const s32 FDY12 = DY12 * 16;
-  const s32 FDY23 = DY23 * 16;
-  const s32 FDY31 = DY31 * 16;
-
   // Bounding rectangle
   s32 minx = (std::min(std::min(X1, X2), X3) + 0xF) >> 4;
   s32 maxx = (std::max(std::max(X1, X2), X3) + 0xF) >> 4;
@@ -335,6 +556,8 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (minx >= maxx || miny >= maxy)
     return;
 
+  Triangle& tri = triangles.emplace_back();
+
   // Setup slopes
   float fltx1 = v0->screenPosition.x;
   float flty1 = v0->screenPosition.y;
@@ -343,11 +566,11 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   float fltdy12 = flty1 - v1->screenPosition.y;
   float fltdy31 = v2->screenPosition.y - flty1;
 
-  InitTriangle(fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
+  InitTriangle(&tri, fltx1, flty1, (X1 + 0xF) >> 4, (Y1 + 0xF) >> 4);
 
   float w[3] = {1.0f / v0->projectedPosition.w, 1.0f / v1->projectedPosition.w,
                 1.0f / v2->projectedPosition.w};
-  InitSlope(&WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+  InitSlope(&tri.WSlope, w[0], w[1], w[2], fltdx31, fltdx12, fltdy12, fltdy31);
 
   // TODO: The zfreeze emulation is not quite correct, yet!
   // Many things might prevent us from reaching this line (culling, clipping, scissoring).
@@ -358,19 +581,21 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (!bpmem.genMode.zfreeze || !g_ActiveConfig.bZFreeze)
     InitSlope(&ZSlope, v0->screenPosition[2], v1->screenPosition[2], v2->screenPosition[2], fltdx31,
               fltdx12, fltdy12, fltdy31);
+  tri.ZSlope = ZSlope;
 
   for (unsigned int i = 0; i < bpmem.genMode.numcolchans; i++)
   {
     for (int comp = 0; comp < 4; comp++)
-      InitSlope(&ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp], v2->color[i][comp],
-                fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&tri.ColorSlopes[i][comp], v0->color[i][comp], v1->color[i][comp],
+                v2->color[i][comp], fltdx31, fltdx12, fltdy12, fltdy31);
   }
 
   for (unsigned int i = 0; i < bpmem.genMode.numtexgens; i++)
   {
     for (int comp = 0; comp < 3; comp++)
-      InitSlope(&TexSlopes[i][comp], v0->texCoords[i][comp] * w[0], v1->texCoords[i][comp] * w[1],
-                v2->texCoords[i][comp] * w[2], fltdx31, fltdx12, fltdy12, fltdy31);
+      InitSlope(&tri.TexSlopes[i][comp], v0->texCoords[i][comp] * w[0],
+                v1->texCoords[i][comp] * w[1], v2->texCoords[i][comp] * w[2], fltdx31, fltdx12,
+                fltdy12, fltdy31);
   }
 
   // Half-edge constants
@@ -386,87 +611,132 @@ void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v
   if (DY31 < 0 || (DY31 == 0 && DX31 > 0))
     C3++;
 
+  tri.C1 = C1;
+  tri.C2 = C2;
+  tri.C3 = C3;
+  tri.DX12 = DX12;
+  tri.DX23 = DX23;
+  tri.DX31 = DX31;
+  tri.DY12 = DY12;
+  tri.DY23 = DY23;
+  tri.DY31 = DY31;
+
   // Start in corner of 8x8 block
-  minx &= ~(BLOCK_SIZE - 1);
-  miny &= ~(BLOCK_SIZE - 1);
+  tri.minx = minx & ~(BLOCK_SIZE - 1);
+  tri.miny = miny & ~(BLOCK_SIZE - 1);
+  tri.maxx = maxx;
+  tri.maxy = maxy;
 
-  // Loop through blocks
-  for (s32 y = miny; y < maxy; y += BLOCK_SIZE)
-  {
-    for (s32 x = minx; x < maxx; x += BLOCK_SIZE)
-    {
-      // Corners of block
-      s32 x0 = x << 4;
-      s32 x1 = (x + BLOCK_SIZE - 1) << 4;
-      s32 y0 = y << 4;
-      s32 y1 = (y + BLOCK_SIZE - 1) << 4;
+  batchPixels += static_cast<u64>(maxx - tri.minx) * static_cast<u64>(maxy - tri.miny);
+}
 
-      // Evaluate half-space functions
-      bool a00 = C1 + DX12 * y0 - DY12 * x0 > 0;
-      bool a10 = C1 + DX12 * y0 - DY12 * x1 > 0;
-      bool a01 = C1 + DX12 * y1 - DY12 * x0 > 0;
-      bool a11 = C1 + DX12 * y1 - DY12 * x1 > 0;
-      int a = (a00 << 0) | (a10 << 1) | (a01 << 2) | (a11 << 3);
+// Draws the tiles that no other thread took yet.
+static void DrawTiles(DrawContext& context)
+{
+  for (u32 tile = nextTile++; tile < NUM_TILES; tile = nextTile++)
+  {
+    const s32 left = static_cast<s32>(tile % TILES_X) * TILE_SIZE;
+    const s32 top = static_cast<s32>(tile / TILES_X) * TILE_SIZE;
+    for (u32 index : tileTriangles[tile])
+      DrawTriangle(context, triangles[index], left, top, left + TILE_SIZE, top + TILE_SIZE);
+  }
+}
 
-      bool b00 = C2 + DX23 * y0 - DY23 * x0 > 0;
-      bool b10 = C2 + DX23 * y0 - DY23 * x1 > 0;
-      bool b01 = C2 + DX23 * y1 - DY23 * x0 > 0;
-      bool b11 = C2 + DX23 * y1 - DY23 * x1 > 0;
-      int b = (b00 << 0) | (b10 << 1) | (b01 << 2) | (b11 << 3);
+static void WorkerThread(DrawContext* context)
+{
+  Common::SetCurrentThreadName("Software rasterizer");
 
-      bool c00 = C3 + DX31 * y0 - DY31 * x0 > 0;
-      bool c10 = C3 + DX31 * y0 - DY31 * x1 > 0;
-      bool c01 = C3 + DX31 * y1 - DY31 * x0 > 0;
-      bool c11 = C3 + DX31 * y1 - DY31 * x1 > 0;
-      int c = (c00 << 0) | (c10 << 1) | (c01 << 2) | (c11 << 3);
+  u32 lastBatch = 0;
+  std::unique_lock<std::mutex> lk(workerMutex);
+  while (true)
+  {
+    workAvailable.wait(lk, [&] { return exitWorkers || batchNumber != lastBatch; });
+    if (exitWorkers)
+      return;
+
+    lastBatch = batchNumber;
+    lk.unlock();
+    std::fesetenv(&batchFloatEnvironment);
+    DrawTiles(*context);
+    lk.lock();
+
+    if (--busyWorkers == 0)
+      workDone.notify_one();
+  }
+}
 
-      // Skip block when outside an edge
-      if (a == 0x0 || b == 0x0 || c == 0x0)
-        continue;
+void Flush()
+{
+  if (triangles.empty())
+    return;
 
-      BuildBlock(x, y);
+  // The TEV dumps are written to shared buffers for each pixel.
+  const bool dumpTev = g_ActiveConfig.bDumpTevStages || g_ActiveConfig.bDumpTevTextureFetches;
+  const bool threaded =
+      !workerThreads.empty() && batchPixels >= MIN_THREADED_BATCH_PIXELS && !dumpTev;
+
+  // The combiners of all contexts use the same state, so the function is only looked up once.
+  Tev::CombineQuadFunction combineQuad = nullptr;
+#ifdef _M_X86
+  if (!dumpTev)
+    combineQuad = tevCompiler->GetCombineQuadFunction(drawContexts[0]->tev);
+#endif
+  for (auto& context : drawContexts)
+  {
+    context->drawQuads = !dumpTev;
+    context->tev.SetCombineQuadFunction(combineQuad);
+    context->tev.ResetUnusedInputs();
+  }
 
-      // Accept whole block when totally covered
-      if (a == 0xF && b == 0xF && c == 0xF)
+  if (!threaded)
+  {
+    for (const Triangle& tri : triangles)
+      DrawTriangle(*drawContexts[0], tri, 0, 0, EFB_WIDTH, EFB_HEIGHT);
+  }
+  else
+  {
+    for (u32 i = 0; i < triangles.size(); i++)
+    {
+      const Triangle& tri = triangles[i];
+      const s32 tileLeft = tri.minx / TILE_SIZE;
+      const s32 tileRight = (tri.maxx - 1) / TILE_SIZE;
+      const s32 tileTop = tri.miny / TILE_SIZE;
+      const s32 tileBottom = (tri.maxy - 1) / TILE_SIZE;
+      for (s32 tileY = tileTop; tileY <= tileBottom; tileY++)
       {
-        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-        {
-          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-          {
-            Draw(x + ix, y + iy, ix, iy);
-          }
-        }
+        for (s32 tileX = tileLeft; tileX <= tileRight; tileX++)
+          tileTriangles[tileY * TILES_X + tileX].push_back(i);
       }
-      else  // Partially covered block
-      {
-        s32 CY1 = C1 + DX12 * y0 - DY12 * x0;
-        s32 CY2 = C2 + DX23 * y0 - DY23 * x0;
-        s32 CY3 = C3 + DX31 * y0 - DY31 * x0;
-
-        for (s32 iy = 0; iy < BLOCK_SIZE; iy++)
-        {
-          s32 CX1 = CY1;
-          s32 CX2 = CY2;
-          s32 CX3 = CY3;
+    }
 
-          for (s32 ix = 0; ix < BLOCK_SIZE; ix++)
-          {
-            if (CX1 > 0 && CX2 > 0 && CX3 > 0)
-            {
-              Draw(x + ix, y + iy, ix, iy);
-            }
+    {
+      std::lock_guard<std::mutex> lk(workerMutex);
+      std::fegetenv(&batchFloatEnvironment);
+      nextTile = 0;
+      busyWorkers = static_cast<u32>(workerThreads.size());
+      batchNumber++;
+    }
+    workAvailable.notify_all();
 
-            CX1 -= FDY12;
-            CX2 -= FDY23;
-            CX3 -= FDY31;
-          }
+    DrawTiles(*drawContexts[0]);
 
-          CY1 += FDX12;
-          CY2 += FDX23;
-          CY3 += FDX31;
-        }
-      }
+    {
+      std::unique_lock<std::mutex> lk(workerMutex);
+      workDone.wait(lk, [] { return busyWorkers == 0; });
     }
+
+    for (std::vector<u32>& tile : tileTriangles)
+      tile.clear();
+  }
+
+  for (auto& context : drawContexts)
+  {
+    ADDSTAT(g_stats.this_frame.rasterized_pixels, context->rasterizedPixels);
+    context->rasterizedPixels = 0;
+    context->tev.CommitCounters();
   }
+
+  triangles.clear();
+  batchPixels = 0;
 }
 }  // namespace Rasterizer
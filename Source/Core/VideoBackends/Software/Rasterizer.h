@@ -11,9 +11,12 @@ struct OutputVertexData;
 namespace Rasterizer
 {
 void Init();
+void Shutdown();
 
+// The triangles are drawn when the batch is flushed, by several threads if enabled.
 void DrawTriangleFrontFace(const OutputVertexData* v0, const OutputVertexData* v1,
                            const OutputVertexData* v2);
+void Flush();
 
 void SetTevReg(int reg, int comp, s16 color);
 
@@ -6,9 +6,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <iterator>
 
+#include "Common/BitSet.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "VideoBackends/Software/DebugUtil.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/TextureSampler.h"
@@ -160,6 +164,38 @@ void Tev::Init()
   m_ScaleRShiftLUT[1] = 0;
   m_ScaleRShiftLUT[2] = 0;
   m_ScaleRShiftLUT[3] = 1;
+
+  for (int lane = 0; lane < QUAD_LANES; lane++)
+  {
+    QuadFixedConstants[0][lane] = FixedConstants[0];
+    QuadFixedConstants[1][lane] = FixedConstants[4];
+    QuadFixedConstants[2][lane] = FixedConstants[8];
+  }
+
+  // same inputs as m_ColorInputLUT and m_AlphaInputLUT
+  for (int i = 0; i < 3; i++)
+  {
+    for (int reg = 0; reg < 4; reg++)
+    {
+      m_QuadColorInputLUT[reg * 2][i] = QuadReg[reg][BLU_C + i];
+      m_QuadColorInputLUT[reg * 2 + 1][i] = QuadReg[reg][ALP_C];
+    }
+    m_QuadColorInputLUT[8][i] = QuadTexColor[BLU_C + i];
+    m_QuadColorInputLUT[9][i] = QuadTexColor[ALP_C];
+    m_QuadColorInputLUT[10][i] = QuadRasColor[BLU_C + i];
+    m_QuadColorInputLUT[11][i] = QuadRasColor[ALP_C];
+    m_QuadColorInputLUT[12][i] = QuadFixedConstants[2];
+    m_QuadColorInputLUT[13][i] = QuadFixedConstants[1];
+    m_QuadColorInputLUT[14][i] = QuadStageKonst[BLU_C + i];
+    m_QuadColorInputLUT[15][i] = QuadFixedConstants[0];
+  }
+
+  for (int reg = 0; reg < 4; reg++)
+    m_QuadAlphaInputLUT[reg] = QuadReg[reg][ALP_C];
+  m_QuadAlphaInputLUT[4] = QuadTexColor[ALP_C];
+  m_QuadAlphaInputLUT[5] = QuadRasColor[ALP_C];
+  m_QuadAlphaInputLUT[6] = QuadStageKonst[ALP_C];
+  m_QuadAlphaInputLUT[7] = QuadFixedConstants[0];
 }
 
 static inline s16 Clamp255(s16 in)
@@ -377,6 +413,149 @@ void Tev::DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const Inpu
   }
 }
 
+// Computes d + lerp(a, b, c) with the bias and scale of a regular combiner for each lane. The color
+// and alpha combiners round and negate the lerp differently.
+static void CombineQuadRegular(const s16* a, const s16* b, const s16* c, const s16* d, s32 bias,
+                               u8 lshift, u8 rshift, s32 round, bool negateBeforeShift,
+                               bool negateAfterShift, s16* result)
+{
+#ifdef _M_X86
+  // Each lane of a and b is paired with 256 - c and c, so that one multiply-add computes the lerp.
+  const __m128i lshiftCount = _mm_cvtsi32_si128(lshift);
+  const __m128i rshiftCount = _mm_cvtsi32_si128(rshift);
+  const __m128i inputA = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a));
+  const __m128i inputB = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(b));
+  __m128i inputC = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(c));
+  const __m128i inputD = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(d));
+
+  inputC = _mm_add_epi16(inputC, _mm_srli_epi16(inputC, 7));
+  const __m128i factors = _mm_unpacklo_epi16(_mm_sub_epi16(_mm_set1_epi16(256), inputC), inputC);
+  __m128i temp = _mm_madd_epi16(_mm_unpacklo_epi16(inputA, inputB), factors);
+  temp = _mm_add_epi32(_mm_sll_epi32(temp, lshiftCount), _mm_set1_epi32(round));
+  if (negateBeforeShift)
+    temp = _mm_sub_epi32(_mm_setzero_si128(), temp);
+  temp = _mm_srai_epi32(temp, 8);
+  if (negateAfterShift)
+    temp = _mm_sub_epi32(_mm_setzero_si128(), temp);
+
+  // sign extend d to 32 bits
+  __m128i sum = _mm_srai_epi32(_mm_unpacklo_epi16(inputD, inputD), 16);
+  sum = _mm_sll_epi32(_mm_add_epi32(sum, _mm_set1_epi32(bias)), lshiftCount);
+  sum = _mm_sra_epi32(_mm_add_epi32(sum, temp), rshiftCount);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(result), _mm_packs_epi32(sum, sum));
+#else
+  for (int lane = 0; lane < Tev::QUAD_LANES; lane++)
+  {
+    const u16 factor = c[lane] + (c[lane] >> 7);
+
+    s32 temp = a[lane] * (256 - factor) + (b[lane] * factor);
+    temp = (temp << lshift) + round;
+    temp = (negateBeforeShift ? -temp : temp) >> 8;
+    temp = negateAfterShift ? -temp : temp;
+
+    result[lane] = (((d[lane] + bias) << lshift) + temp) >> rshift;
+  }
+#endif
+}
+
+// Returns whether a compare mode passes for a component of a lane. Except for the RGB8 and A8
+// modes, the result is the same for all components.
+static bool QuadCompare(int mode, const s16 a[][Tev::QUAD_LANES], const s16 b[][Tev::QUAD_LANES],
+                        int comp, int lane)
+{
+  const int R = Tev::RED_C;
+  const int G = Tev::GRN_C;
+  const int B = Tev::BLU_C;
+
+  switch (mode)
+  {
+  case TEVCMP_R8_GT:
+    return a[R][lane] > b[R][lane];
+  case TEVCMP_R8_EQ:
+    return a[R][lane] == b[R][lane];
+  case TEVCMP_GR16_GT:
+  case TEVCMP_GR16_EQ:
+  {
+    const u32 valueA = (a[G][lane] << 8) | a[R][lane];
+    const u32 valueB = (b[G][lane] << 8) | b[R][lane];
+    return mode == TEVCMP_GR16_GT ? valueA > valueB : valueA == valueB;
+  }
+  case TEVCMP_BGR24_GT:
+  case TEVCMP_BGR24_EQ:
+  {
+    const u32 valueA = (a[B][lane] << 16) | (a[G][lane] << 8) | a[R][lane];
+    const u32 valueB = (b[B][lane] << 16) | (b[G][lane] << 8) | b[R][lane];
+    return mode == TEVCMP_BGR24_GT ? valueA > valueB : valueA == valueB;
+  }
+  case TEVCMP_RGB8_GT:
+    return a[comp][lane] > b[comp][lane];
+  case TEVCMP_RGB8_EQ:
+    return a[comp][lane] == b[comp][lane];
+  default:
+    return false;
+  }
+}
+
+static void ClampQuad(s16* lanes, bool clamp)
+{
+  const s16 min = clamp ? 0 : -1024;
+  const s16 max = clamp ? 255 : 1023;
+#ifdef _M_X86
+  __m128i values = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(lanes));
+  values = _mm_max_epi16(_mm_min_epi16(values, _mm_set1_epi16(max)), _mm_set1_epi16(min));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(lanes), values);
+#else
+  for (int lane = 0; lane < Tev::QUAD_LANES; lane++)
+    lanes[lane] = std::clamp(lanes[lane], min, max);
+#endif
+}
+
+void Tev::DrawQuadColorRegular(const TevStageCombiner::ColorCombiner& cc,
+                               const QuadInputType& inputs)
+{
+  const s32 round = (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    CombineQuadRegular(inputs.a[i], inputs.b[i], inputs.c[i], inputs.d[i], m_BiasLUT[cc.bias],
+                       m_ScaleLShiftLUT[cc.shift], m_ScaleRShiftLUT[cc.shift], round, false,
+                       cc.op != 0, QuadReg[cc.dest][i]);
+  }
+}
+
+void Tev::DrawQuadColorCompare(const TevStageCombiner::ColorCombiner& cc,
+                               const QuadInputType& inputs)
+{
+  const int mode = (cc.shift << 1) | cc.op | 8;  // encoded compare mode
+  for (int i = BLU_C; i <= RED_C; i++)
+  {
+    for (int lane = 0; lane < QUAD_LANES; lane++)
+    {
+      const bool pass = QuadCompare(mode, inputs.a, inputs.b, i, lane);
+      QuadReg[cc.dest][i][lane] = inputs.d[i][lane] + (pass ? inputs.c[i][lane] : 0);
+    }
+  }
+}
+
+void Tev::DrawQuadAlphaRegular(const TevStageCombiner::AlphaCombiner& ac,
+                               const QuadInputType& inputs)
+{
+  const s32 round = (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
+  CombineQuadRegular(inputs.a[ALP_C], inputs.b[ALP_C], inputs.c[ALP_C], inputs.d[ALP_C],
+                     m_BiasLUT[ac.bias], m_ScaleLShiftLUT[ac.shift], m_ScaleRShiftLUT[ac.shift],
+                     round, ac.op != 0, false, QuadReg[ac.dest][ALP_C]);
+}
+
+void Tev::DrawQuadAlphaCompare(const TevStageCombiner::AlphaCombiner& ac,
+                               const QuadInputType& inputs)
+{
+  const int mode = (ac.shift << 1) | ac.op | 8;  // encoded compare mode
+  for (int lane = 0; lane < QUAD_LANES; lane++)
+  {
+    const bool pass = QuadCompare(mode, inputs.a, inputs.b, ALP_C, lane);
+    QuadReg[ac.dest][ALP_C][lane] = inputs.d[ALP_C][lane] + (pass ? inputs.c[ALP_C][lane] : 0);
+  }
+}
+
 static bool AlphaCompare(int alpha, int ref, AlphaTest::CompareMode comp)
 {
   switch (comp)
@@ -422,6 +601,35 @@ static bool TevAlphaTest(int alpha)
   }
 }
 
+// Returns a mask of the lanes whose alpha passes the alpha test.
+static_assert(Tev::QUAD_LANES == EfbInterface::QUAD_LANES, "Quads must have the same lanes");
+
+static u32 QuadAlphaTest(const u8 alpha[Tev::QUAD_LANES])
+{
+  u32 comp0 = 0;
+  u32 comp1 = 0;
+  for (int lane = 0; lane < Tev::QUAD_LANES; lane++)
+  {
+    comp0 |= u32{AlphaCompare(alpha[lane], bpmem.alpha_test.ref0, bpmem.alpha_test.comp0)} << lane;
+    comp1 |= u32{AlphaCompare(alpha[lane], bpmem.alpha_test.ref1, bpmem.alpha_test.comp1)} << lane;
+  }
+
+  const u32 allLanes = (1 << Tev::QUAD_LANES) - 1;
+  switch (bpmem.alpha_test.logic)
+  {
+  case 0:
+    return comp0 & comp1;  // and
+  case 1:
+    return comp0 | comp1;  // or
+  case 2:
+    return comp0 ^ comp1;  // xor
+  case 3:
+    return ~(comp0 ^ comp1) & allLanes;  // xnor
+  default:
+    return allLanes;
+  }
+}
+
 static inline s32 WrapIndirectCoord(s32 coord, int wrapMode)
 {
   switch (wrapMode)
@@ -565,22 +773,8 @@ void Tev::Indirect(unsigned int stageNum, s32 s, s32 t)
   }
 }
 
-void Tev::Draw()
+void Tev::SampleIndirectTextures()
 {
-  ASSERT(Position[0] >= 0 && Position[0] < EFB_WIDTH);
-  ASSERT(Position[1] >= 0 && Position[1] < EFB_HEIGHT);
-
-  INCSTAT(g_stats.this_frame.tev_pixels_in);
-
-  // initial color values
-  for (int i = 0; i < 4; i++)
-  {
-    Reg[i][RED_C] = PixelShaderManager::constants.colors[i][0];
-    Reg[i][GRN_C] = PixelShaderManager::constants.colors[i][1];
-    Reg[i][BLU_C] = PixelShaderManager::constants.colors[i][2];
-    Reg[i][ALP_C] = PixelShaderManager::constants.colors[i][3];
-  }
-
   for (unsigned int stageNum = 0; stageNum < bpmem.genMode.numindstages; stageNum++)
   {
     const int stageNum2 = stageNum >> 1;
@@ -607,45 +801,80 @@ void Tev::Draw()
     }
 #endif
   }
+}
+
+void Tev::FetchStage(unsigned int stageNum)
+{
+  const int stageNum2 = stageNum >> 1;
+  const int stageOdd = stageNum & 1;
+  const TwoTevStageOrders& order = bpmem.tevorders[stageNum2];
+  const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
+
+  const int texcoordSel = order.getTexCoord(stageOdd);
+  const int texmap = order.getTexMap(stageOdd);
+
+  Indirect(stageNum, Uv[texcoordSel].s, Uv[texcoordSel].t);
+
+  // sample texture
+  if (order.getEnable(stageOdd))
+  {
+    // RGBA
+    u8 texel[4];
+
+    TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum], TextureLinear[stageNum],
+                           texmap, texel);
+
+#if ALLOW_TEV_DUMPS
+    if (g_ActiveConfig.bDumpTevTextureFetches)
+      DebugUtil::DrawTempBuffer(texel, DIRECT_TFETCH + stageNum);
+#endif
+
+    int swaptable = ac.tswap * 2;
+
+    TexColor[RED_C] = texel[bpmem.tevksel[swaptable].swap1];
+    TexColor[GRN_C] = texel[bpmem.tevksel[swaptable].swap2];
+    swaptable++;
+    TexColor[BLU_C] = texel[bpmem.tevksel[swaptable].swap1];
+    TexColor[ALP_C] = texel[bpmem.tevksel[swaptable].swap2];
+  }
+
+  // set color
+  SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
+}
+
+void Tev::Draw()
+{
+  ASSERT(Position[0] >= 0 && Position[0] < EFB_WIDTH);
+  ASSERT(Position[1] >= 0 && Position[1] < EFB_HEIGHT);
+
+  ++m_PixelsIn;
+
+  // Stages without a texture keep the texture color of the stage before them, which starts at zero
+  // for each pixel like in the generated pixel shaders.
+  std::fill(std::begin(TexColor), std::end(TexColor), 0);
+
+  // initial color values
+  for (int i = 0; i < 4; i++)
+  {
+    Reg[i][RED_C] = PixelShaderManager::constants.colors[i][0];
+    Reg[i][GRN_C] = PixelShaderManager::constants.colors[i][1];
+    Reg[i][BLU_C] = PixelShaderManager::constants.colors[i][2];
+    Reg[i][ALP_C] = PixelShaderManager::constants.colors[i][3];
+  }
+
+  SampleIndirectTextures();
 
   for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
   {
     const int stageNum2 = stageNum >> 1;
     const int stageOdd = stageNum & 1;
-    const TwoTevStageOrders& order = bpmem.tevorders[stageNum2];
     const TevKSel& kSel = bpmem.tevksel[stageNum2];
 
     // stage combiners
     const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
     const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
 
-    const int texcoordSel = order.getTexCoord(stageOdd);
-    const int texmap = order.getTexMap(stageOdd);
-
-    Indirect(stageNum, Uv[texcoordSel].s, Uv[texcoordSel].t);
-
-    // sample texture
-    if (order.getEnable(stageOdd))
-    {
-      // RGBA
-      u8 texel[4];
-
-      TextureSampler::Sample(TexCoord.s, TexCoord.t, TextureLod[stageNum], TextureLinear[stageNum],
-                             texmap, texel);
-
-#if ALLOW_TEV_DUMPS
-      if (g_ActiveConfig.bDumpTevTextureFetches)
-        DebugUtil::DrawTempBuffer(texel, DIRECT_TFETCH + stageNum);
-#endif
-
-      int swaptable = ac.tswap * 2;
-
-      TexColor[RED_C] = texel[bpmem.tevksel[swaptable].swap1];
-      TexColor[GRN_C] = texel[bpmem.tevksel[swaptable].swap2];
-      swaptable++;
-      TexColor[BLU_C] = texel[bpmem.tevksel[swaptable].swap1];
-      TexColor[ALP_C] = texel[bpmem.tevksel[swaptable].swap2];
-    }
+    FetchStage(stageNum);
 
     // set konst for this stage
     const int kc = kSel.getKC(stageOdd);
@@ -655,9 +884,6 @@ void Tev::Draw()
     StageKonst[BLU_C] = *(m_KonstLUT[kc][BLU_C]);
     StageKonst[ALP_C] = *(m_KonstLUT[ka][ALP_C]);
 
-    // set color
-    SetRasColor(order.getColorChan(stageOdd), ac.rswap * 2);
-
     // combine inputs
     InputRegType inputs[4];
     for (int i = 0; i < 3; i++)
@@ -720,6 +946,195 @@ void Tev::Draw()
   if (!TevAlphaTest(output[ALP_C]))
     return;
 
+  WritePixel(Position[0], Position[1], Position[2], TexColor, output);
+}
+
+void Tev::AddQuadPixel()
+{
+  ASSERT(Position[0] >= 0 && Position[0] < static_cast<s32>(EFB_WIDTH));
+  ASSERT(Position[1] >= 0 && Position[1] < static_cast<s32>(EFB_HEIGHT));
+  ASSERT(m_QuadPixels < static_cast<u32>(QUAD_LANES));
+
+  ++m_PixelsIn;
+
+  // The texture and rasterized colors don't depend on the results of the combiners, so they are
+  // fetched for each pixel like Draw does.
+  const u32 lane = m_QuadPixels++;
+  std::copy(std::begin(Position), std::end(Position), m_QuadPosition[lane]);
+  std::fill(std::begin(TexColor), std::end(TexColor), 0);
+
+  SampleIndirectTextures();
+
+  for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
+  {
+    FetchStage(stageNum);
+
+    for (int comp = 0; comp < 4; comp++)
+    {
+      m_QuadStageTexColor[stageNum][comp][lane] = TexColor[comp];
+      m_QuadStageRasColor[stageNum][comp][lane] = RasColor[comp];
+    }
+  }
+
+  std::copy(std::begin(TexColor), std::end(TexColor), m_QuadLastTexColor[lane]);
+}
+
+void Tev::CombineQuadStages()
+{
+  for (unsigned int stageNum = 0; stageNum <= bpmem.genMode.numtevstages; stageNum++)
+  {
+    const int stageNum2 = stageNum >> 1;
+    const int stageOdd = stageNum & 1;
+    const TevKSel& kSel = bpmem.tevksel[stageNum2];
+
+    // stage combiners
+    const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[stageNum].colorC;
+    const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[stageNum].alphaC;
+
+    std::memcpy(QuadTexColor, m_QuadStageTexColor[stageNum], sizeof(QuadTexColor));
+    std::memcpy(QuadRasColor, m_QuadStageRasColor[stageNum], sizeof(QuadRasColor));
+
+    // set konst for this stage
+    const int kc = kSel.getKC(stageOdd);
+    const int ka = kSel.getKA(stageOdd);
+    std::fill_n(QuadStageKonst[RED_C], QUAD_LANES, *(m_KonstLUT[kc][RED_C]));
+    std::fill_n(QuadStageKonst[GRN_C], QUAD_LANES, *(m_KonstLUT[kc][GRN_C]));
+    std::fill_n(QuadStageKonst[BLU_C], QUAD_LANES, *(m_KonstLUT[kc][BLU_C]));
+    std::fill_n(QuadStageKonst[ALP_C], QUAD_LANES, *(m_KonstLUT[ka][ALP_C]));
+
+    // combine inputs, truncated like the fields of InputRegType
+    QuadInputType inputs;
+    const auto load = [&inputs](int comp, const s16* a, const s16* b, const s16* c, const s16* d) {
+      for (int lane = 0; lane < QUAD_LANES; lane++)
+      {
+        inputs.a[comp][lane] = a[lane] & 0xff;
+        inputs.b[comp][lane] = b[lane] & 0xff;
+        inputs.c[comp][lane] = c[lane] & 0xff;
+        inputs.d[comp][lane] = static_cast<s16>(static_cast<u16>(d[lane]) << 5) >> 5;
+      }
+    };
+    for (int i = 0; i < 3; i++)
+    {
+      load(BLU_C + i, m_QuadColorInputLUT[cc.a][i], m_QuadColorInputLUT[cc.b][i],
+           m_QuadColorInputLUT[cc.c][i], m_QuadColorInputLUT[cc.d][i]);
+    }
+    load(ALP_C, m_QuadAlphaInputLUT[ac.a], m_QuadAlphaInputLUT[ac.b], m_QuadAlphaInputLUT[ac.c],
+         m_QuadAlphaInputLUT[ac.d]);
+
+    if (cc.bias != 3)
+      DrawQuadColorRegular(cc, inputs);
+    else
+      DrawQuadColorCompare(cc, inputs);
+
+    ClampQuad(QuadReg[cc.dest][RED_C], cc.clamp);
+    ClampQuad(QuadReg[cc.dest][GRN_C], cc.clamp);
+    ClampQuad(QuadReg[cc.dest][BLU_C], cc.clamp);
+
+    if (ac.bias != 3)
+      DrawQuadAlphaRegular(ac, inputs);
+    else
+      DrawQuadAlphaCompare(ac, inputs);
+
+    ClampQuad(QuadReg[ac.dest][ALP_C], ac.clamp);
+  }
+}
+
+void Tev::DrawQuad()
+{
+  if (m_QuadPixels == 0)
+    return;
+
+  // initial color values
+  for (int i = 0; i < 4; i++)
+  {
+    std::fill_n(QuadReg[i][RED_C], QUAD_LANES, PixelShaderManager::constants.colors[i][0]);
+    std::fill_n(QuadReg[i][GRN_C], QUAD_LANES, PixelShaderManager::constants.colors[i][1]);
+    std::fill_n(QuadReg[i][BLU_C], QUAD_LANES, PixelShaderManager::constants.colors[i][2]);
+    std::fill_n(QuadReg[i][ALP_C], QUAD_LANES, PixelShaderManager::constants.colors[i][3]);
+  }
+
+  if (m_CombineQuad)
+    m_CombineQuad(this);
+  else
+    CombineQuadStages();
+
+  // convert to 8 bits per component
+  const u32 color_index = bpmem.combiners[bpmem.genMode.numtevstages].colorC.dest;
+  const u32 alpha_index = bpmem.combiners[bpmem.genMode.numtevstages].alphaC.dest;
+  u8 alpha[QUAD_LANES];
+  for (int lane = 0; lane < QUAD_LANES; lane++)
+    alpha[lane] = (u8)QuadReg[alpha_index][ALP_C][lane];
+
+  // only the lanes of the pixels that were added are written
+  u32 mask = QuadAlphaTest(alpha) & ((1 << m_QuadPixels) - 1);
+
+  // Z textures, fog, logic ops and the formats that EfbInterface can't draw quads with are handled
+  // by WritePixel, one pixel at a time.
+  if (bpmem.ztex2.op != ZTEXTURE_DISABLE || bpmem.fog.c_proj_fsel.fsel != 0 ||
+      !EfbInterface::CanDrawQuad())
+  {
+    for (u32 lane = 0; lane < m_QuadPixels; lane++)
+    {
+      if (!(mask & (1 << lane)))
+        continue;
+
+      u8 output[4] = {alpha[lane], (u8)QuadReg[color_index][BLU_C][lane],
+                      (u8)QuadReg[color_index][GRN_C][lane],
+                      (u8)QuadReg[color_index][RED_C][lane]};
+      WritePixel(m_QuadPosition[lane][0], m_QuadPosition[lane][1], m_QuadPosition[lane][2],
+                 m_QuadLastTexColor[lane], output);
+    }
+
+    m_QuadPixels = 0;
+    return;
+  }
+
+  u16 x[QUAD_LANES];
+  u16 y[QUAD_LANES];
+  u32 z[QUAD_LANES];
+  u8 output[4][QUAD_LANES];
+  for (int lane = 0; lane < QUAD_LANES; lane++)
+  {
+    x[lane] = static_cast<u16>(m_QuadPosition[lane][0]);
+    y[lane] = static_cast<u16>(m_QuadPosition[lane][1]);
+    z[lane] = static_cast<u32>(m_QuadPosition[lane][2]);
+    output[ALP_C][lane] = alpha[lane];
+    output[BLU_C][lane] = (u8)QuadReg[color_index][BLU_C][lane];
+    output[GRN_C][lane] = (u8)QuadReg[color_index][GRN_C][lane];
+    output[RED_C][lane] = (u8)QuadReg[color_index][RED_C][lane];
+  }
+
+  // The pixels of a quad never overlap, so testing and blending all of them at once gives the same
+  // result as WritePixel.
+  const bool late_ztest = !bpmem.zcontrol.early_ztest || !g_ActiveConfig.bZComploc;
+  if (late_ztest && bpmem.zmode.testenable)
+  {
+    m_PerfPixels[PQ_ZCOMP_INPUT] += Common::CountSetBits(mask);
+    mask = EfbInterface::ZCompareQuad(x, y, z, mask);
+    m_PerfPixels[PQ_ZCOMP_OUTPUT] += Common::CountSetBits(mask);
+  }
+
+  for (int lane = 0; lane < QUAD_LANES; lane++)
+  {
+    if (!(mask & (1 << lane)))
+      continue;
+
+    m_BBoxLeft = std::min(m_BBoxLeft, x[lane]);
+    m_BBoxRight = std::max(m_BBoxRight, x[lane]);
+    m_BBoxTop = std::min(m_BBoxTop, y[lane]);
+    m_BBoxBottom = std::max(m_BBoxBottom, y[lane]);
+  }
+
+  m_PixelsOut += Common::CountSetBits(mask);
+  m_PerfPixels[PQ_BLEND_INPUT] += Common::CountSetBits(mask);
+
+  EfbInterface::BlendTevQuad(x, y, output, mask);
+
+  m_QuadPixels = 0;
+}
+
+void Tev::WritePixel(s32 x, s32 y, s32 z, const s16 texColor[4], u8 output[4])
+{
   // z texture
   if (bpmem.ztex2.op)
   {
@@ -727,20 +1142,20 @@ void Tev::Draw()
     switch (bpmem.ztex2.type)
     {
     case 0:  // 8 bit
-      ztex += TexColor[ALP_C];
+      ztex += texColor[ALP_C];
       break;
     case 1:  // 16 bit
-      ztex += TexColor[ALP_C] << 8 | TexColor[RED_C];
+      ztex += texColor[ALP_C] << 8 | texColor[RED_C];
       break;
     case 2:  // 24 bit
-      ztex += TexColor[RED_C] << 16 | TexColor[GRN_C] << 8 | TexColor[BLU_C];
+      ztex += texColor[RED_C] << 16 | texColor[GRN_C] << 8 | texColor[BLU_C];
       break;
     }
 
     if (bpmem.ztex2.op == ZTEXTURE_ADD)
-      ztex += Position[2];
+      ztex += z;
 
-    Position[2] = ztex & 0x00ffffff;
+    z = ztex & 0x00ffffff;
   }
 
   // fog
@@ -752,7 +1167,7 @@ void Tev::Draw()
     {
       // perspective
       // ze = A/(B - (Zs >> B_SHF))
-      const s32 denom = bpmem.fog.b_magnitude - (Position[2] >> bpmem.fog.b_shift);
+      const s32 denom = bpmem.fog.b_magnitude - (z >> bpmem.fog.b_shift);
       // in addition downscale magnitude and zs to 0.24 bits
       ze = (bpmem.fog.GetA() * 16777215.0f) / static_cast<float>(denom);
     }
@@ -761,7 +1176,7 @@ void Tev::Draw()
       // orthographic
       // ze = a*Zs
       // in addition downscale zs to 0.24 bits
-      ze = bpmem.fog.GetA() * (static_cast<float>(Position[2]) / 16777215.0f);
+      ze = bpmem.fog.GetA() * (static_cast<float>(z) / 16777215.0f);
     }
 
     if (bpmem.fogRange.Base.Enabled)
@@ -773,7 +1188,7 @@ void Tev::Draw()
 
       // First, calculate the offset from the viewport center (normalized to 0..1)
       const float offset =
-          (Position[0] - (static_cast<s32>(bpmem.fogRange.Base.Center.Value()) - 342)) /
+          (x - (static_cast<s32>(bpmem.fogRange.Base.Center.Value()) - 342)) /
           static_cast<float>(xfmem.viewport.wd);
 
       // Based on that, choose the index such that points which are far away from the z-axis use the
@@ -833,24 +1248,26 @@ void Tev::Draw()
   if (late_ztest && bpmem.zmode.testenable)
   {
     // TODO: Check against hw if these values get incremented even if depth testing is disabled
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
+    IncPerfCounterQuadCount(PQ_ZCOMP_INPUT);
 
-    if (!EfbInterface::ZCompare(Position[0], Position[1], Position[2]))
+    if (!EfbInterface::ZCompare(x, y, z))
       return;
 
-    EfbInterface::IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
+    IncPerfCounterQuadCount(PQ_ZCOMP_OUTPUT);
   }
 
-  BoundingBox::Update(static_cast<u16>(Position[0]), static_cast<u16>(Position[0]),
-                      static_cast<u16>(Position[1]), static_cast<u16>(Position[1]));
+  m_BBoxLeft = std::min(m_BBoxLeft, static_cast<u16>(x));
+  m_BBoxRight = std::max(m_BBoxRight, static_cast<u16>(x));
+  m_BBoxTop = std::min(m_BBoxTop, static_cast<u16>(y));
+  m_BBoxBottom = std::max(m_BBoxBottom, static_cast<u16>(y));
 
 #if ALLOW_TEV_DUMPS
   if (g_ActiveConfig.bDumpTevStages)
   {
     for (u32 i = 0; i < bpmem.genMode.numindstages; ++i)
-      DebugUtil::CopyTempBuffer(Position[0], Position[1], INDIRECT, i, "Indirect");
+      DebugUtil::CopyTempBuffer(x, y, INDIRECT, i, "Indirect");
     for (u32 i = 0; i <= bpmem.genMode.numtevstages; ++i)
-      DebugUtil::CopyTempBuffer(Position[0], Position[1], DIRECT, i, "Stage");
+      DebugUtil::CopyTempBuffer(x, y, DIRECT, i, "Stage");
   }
 
   if (g_ActiveConfig.bDumpTevTextureFetches)
@@ -859,18 +1276,50 @@ void Tev::Draw()
     {
       TwoTevStageOrders& order = bpmem.tevorders[i >> 1];
       if (order.getEnable(i & 1))
-        DebugUtil::CopyTempBuffer(Position[0], Position[1], DIRECT_TFETCH, i, "TFetch");
+        DebugUtil::CopyTempBuffer(x, y, DIRECT_TFETCH, i, "TFetch");
     }
   }
 #endif
 
-  INCSTAT(g_stats.this_frame.tev_pixels_out);
-  EfbInterface::IncPerfCounterQuadCount(PQ_BLEND_INPUT);
+  ++m_PixelsOut;
+  IncPerfCounterQuadCount(PQ_BLEND_INPUT);
 
-  EfbInterface::BlendTev(Position[0], Position[1], output);
+  EfbInterface::BlendTev(x, y, output);
 }
 
 void Tev::SetRegColor(int reg, int comp, s16 color)
 {
   KonstantColors[reg][comp] = color;
 }
+
+void Tev::ResetUnusedInputs()
+{
+  // Texture coordinates and colors are only set up to the number of texgens and color channels,
+  // and the indirect textures up to the number of indirect stages.
+  std::memset(Color, 0, sizeof(Color));
+  for (TextureCoordinateType& uv : Uv)
+  {
+    uv.s = 0;
+    uv.t = 0;
+  }
+  std::memset(IndirectTex, 0, sizeof(IndirectTex));
+}
+
+void Tev::CommitCounters()
+{
+  ADDSTAT(g_stats.this_frame.tev_pixels_in, m_PixelsIn);
+  ADDSTAT(g_stats.this_frame.tev_pixels_out, m_PixelsOut);
+  m_PixelsIn = 0;
+  m_PixelsOut = 0;
+
+  for (size_t i = 0; i < m_PerfPixels.size(); ++i)
+    EfbInterface::AddPerfCounterPixels(static_cast<PerfQueryType>(i), m_PerfPixels[i]);
+  m_PerfPixels = {};
+
+  if (m_BBoxLeft <= m_BBoxRight)
+    BoundingBox::Update(m_BBoxLeft, m_BBoxRight, m_BBoxTop, m_BBoxBottom);
+  m_BBoxLeft = 0xffff;
+  m_BBoxRight = 0;
+  m_BBoxTop = 0xffff;
+  m_BBoxBottom = 0;
+}
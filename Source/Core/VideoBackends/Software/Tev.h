@@ -4,10 +4,27 @@
 
 #pragma once
 
+#include <array>
+
+#include "Common/CommonTypes.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PerfQueryBase.h"
 
 class Tev
 {
+public:
+  // The pixels of a quad are combined together, with one lane for each pixel.
+  enum
+  {
+    QUAD_LANES = 4
+  };
+
+  // Combines the TEV stages of a quad for a fixed configuration, see TevX64.
+  using CombineQuadFunction = void (*)(Tev* tev);
+
+private:
+  friend class TevX64;
+
   struct InputRegType
   {
     unsigned a : 8;
@@ -57,6 +74,36 @@ class Tev
     INDIRECT = 32
   };
 
+  // Combiner inputs of the pixels of a quad, truncated like the fields of InputRegType.
+  struct QuadInputType
+  {
+    s16 a[4][QUAD_LANES];
+    s16 b[4][QUAD_LANES];
+    s16 c[4][QUAD_LANES];
+    s16 d[4][QUAD_LANES];
+  };
+
+  // color order: ABGR
+  s16 QuadReg[4][4][QUAD_LANES]{};
+  s16 QuadTexColor[4][QUAD_LANES]{};
+  s16 QuadRasColor[4][QUAD_LANES]{};
+  s16 QuadStageKonst[4][QUAD_LANES]{};
+  s16 QuadFixedConstants[3][QUAD_LANES]{};  // zero, half, one
+
+  s16* m_QuadColorInputLUT[16][3];
+  s16* m_QuadAlphaInputLUT[8];
+
+  // The pixels that were added to the quad, with the texture and rasterized colors of each stage.
+  u32 m_QuadPixels = 0;
+  s32 m_QuadPosition[QUAD_LANES][3]{};
+  s16 m_QuadLastTexColor[QUAD_LANES][4]{};
+  s16 m_QuadStageTexColor[16][4][QUAD_LANES]{};
+  s16 m_QuadStageRasColor[16][4][QUAD_LANES]{};
+
+  CombineQuadFunction m_CombineQuad = nullptr;
+
+  void SampleIndirectTextures();
+  void FetchStage(unsigned int stageNum);
   void SetRasColor(int colorChan, int swaptable);
 
   void DrawColorRegular(const TevStageCombiner::ColorCombiner& cc, const InputRegType inputs[4]);
@@ -64,8 +111,28 @@ class Tev
   void DrawAlphaRegular(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
   void DrawAlphaCompare(const TevStageCombiner::AlphaCombiner& ac, const InputRegType inputs[4]);
 
+  void CombineQuadStages();
+  void DrawQuadColorRegular(const TevStageCombiner::ColorCombiner& cc,
+                            const QuadInputType& inputs);
+  void DrawQuadColorCompare(const TevStageCombiner::ColorCombiner& cc,
+                            const QuadInputType& inputs);
+  void DrawQuadAlphaRegular(const TevStageCombiner::AlphaCombiner& ac,
+                            const QuadInputType& inputs);
+  void DrawQuadAlphaCompare(const TevStageCombiner::AlphaCombiner& ac,
+                            const QuadInputType& inputs);
+
   void Indirect(unsigned int stageNum, s32 s, s32 t);
 
+  void WritePixel(s32 x, s32 y, s32 z, const s16 texColor[4], u8 output[4]);
+
+  u32 m_PixelsIn = 0;
+  u32 m_PixelsOut = 0;
+  std::array<u32, PQ_NUM_MEMBERS> m_PerfPixels{};
+  u16 m_BBoxLeft = 0xffff;
+  u16 m_BBoxRight = 0;
+  u16 m_BBoxTop = 0xffff;
+  u16 m_BBoxBottom = 0;
+
 public:
   s32 Position[3];
   u8 Color[2][4];  // must be RGBA for correct swap table ordering
@@ -87,5 +154,24 @@ public:
 
   void Draw();
 
+  // Draws the pixels of a 2x2 block together, which gives the same result as drawing each of them
+  // with Draw. AddQuadPixel takes the inputs of a pixel like Draw, and DrawQuad draws the pixels
+  // that were added since the last call. This can't be used while the TEV stages are dumped.
+  void AddQuadPixel();
+  void DrawQuad();
+
+  // Sets the function that combines the stages in DrawQuad instead of the interpreter, or nullptr.
+  // It must match the TEV stages in bpmem.
+  void SetCombineQuadFunction(CombineQuadFunction function) { m_CombineQuad = function; }
+
   void SetRegColor(int reg, int comp, s16 color);
+
+  // Clears the inputs that aren't set for every pixel with the current state, so that the pixels
+  // don't depend on what this Tev drew before, which is different for each drawing thread.
+  void ResetUnusedInputs();
+
+  // The statistics, perf counters and bounding box of the drawn pixels are collected by each Tev,
+  // so that several threads can draw at the same time. CommitCounters adds them to the totals.
+  void IncPerfCounterQuadCount(PerfQueryType type) { ++m_PerfPixels[type]; }
+  void CommitCounters();
 };
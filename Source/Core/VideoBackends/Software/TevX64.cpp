@@ -0,0 +1,309 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoBackends/Software/TevX64.h"
+
+#include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
+#include "Common/x64ABI.h"
+#include "Common/x64Emitter.h"
+#include "VideoCommon/BPMemory.h"
+
+using namespace Gen;
+
+static constexpr size_t CODE_SIZE = 1024 * 1024;
+// More than the code of the largest configuration
+static constexpr size_t MAX_FUNCTION_SIZE = 0x10000;
+
+static constexpr X64Reg tev_reg = ABI_PARAM1;
+
+// Builds the UID of the TEV stages in bpmem. Konst selections that no input uses are left out.
+static TevCombinerUid GetUid()
+{
+  TevCombinerUid uid;
+  tev_combiner_uid_data* const uid_data = uid.GetUidData();
+  uid_data->num_stages = bpmem.genMode.numtevstages + 1;
+  for (u32 i = 0; i < uid_data->num_stages; i++)
+  {
+    const TevStageCombiner::ColorCombiner& cc = bpmem.combiners[i].colorC;
+    const TevStageCombiner::AlphaCombiner& ac = bpmem.combiners[i].alphaC;
+    const TevKSel& ksel = bpmem.tevksel[i >> 1];
+
+    uid_data->stages[i].cc = cc.hex & 0xffffff;
+    uid_data->stages[i].ac = ac.hex & 0xfffff0;
+    if (cc.a == TEVCOLORARG_KONST || cc.b == TEVCOLORARG_KONST || cc.c == TEVCOLORARG_KONST ||
+        cc.d == TEVCOLORARG_KONST)
+    {
+      uid_data->stages[i].kc = ksel.getKC(i & 1);
+    }
+    if (ac.a == TEVALPHAARG_KONST || ac.b == TEVALPHAARG_KONST || ac.c == TEVALPHAARG_KONST ||
+        ac.d == TEVALPHAARG_KONST)
+    {
+      uid_data->stages[i].ka = ksel.getKA(i & 1);
+    }
+  }
+  return uid;
+}
+
+// Returns the offset of a member of a Tev.
+static s32 Offset(const Tev& tev, const void* member)
+{
+  return static_cast<s32>(static_cast<const u8*>(member) - reinterpret_cast<const u8*>(&tev));
+}
+
+TevX64::TevX64()
+{
+  AllocCodeSpace(CODE_SIZE);
+  ClearCodeSpace();
+  WriteConstants();
+}
+
+void TevX64::WriteConstants()
+{
+  const auto write16 = [this](u16 value) {
+    AlignCode16();
+    const u16* ptr = reinterpret_cast<const u16*>(GetCodePtr());
+    for (int i = 0; i < 8; i++)
+      Write16(value);
+    return ptr;
+  };
+  const auto write32 = [this](u32 value) {
+    AlignCode16();
+    const u32* ptr = reinterpret_cast<const u32*>(GetCodePtr());
+    for (int i = 0; i < 4; i++)
+      Write32(value);
+    return ptr;
+  };
+
+  m_const_mask_ff = write16(0xff);
+  m_const_256 = write16(256);
+  m_const_255 = write16(255);
+  m_const_128 = write16(128);
+  m_const_0 = write16(0);
+  m_const_1023 = write16(1023);
+  m_const_minus_1024 = write16(static_cast<u16>(-1024));
+  m_const_127_32 = write32(127);
+  m_const_128_32 = write32(128);
+  m_const_minus_128_32 = write32(static_cast<u32>(-128));
+}
+
+Tev::CombineQuadFunction TevX64::GetCombineQuadFunction(const Tev& tev)
+{
+  const TevCombinerUid uid = GetUid();
+  const auto iter = m_functions.find(uid);
+  if (iter != m_functions.end())
+    return iter->second;
+
+  if (GetSpaceLeft() < MAX_FUNCTION_SIZE)
+  {
+    m_functions.clear();
+    ClearCodeSpace();
+    WriteConstants();
+  }
+
+  const Tev::CombineQuadFunction function = Compile(uid, tev);
+  m_functions.emplace(uid, function);
+  return function;
+}
+
+Tev::CombineQuadFunction TevX64::Compile(const TevCombinerUid& uid, const Tev& tev)
+{
+  const tev_combiner_uid_data* const uid_data = uid.GetUidData();
+
+  // The compare modes are rare, so they are left to the interpreter.
+  for (u32 i = 0; i < uid_data->num_stages; i++)
+  {
+    TevStageCombiner::ColorCombiner cc;
+    TevStageCombiner::AlphaCombiner ac;
+    cc.hex = uid_data->stages[i].cc;
+    ac.hex = uid_data->stages[i].ac;
+    if (cc.bias == TEVBIAS_COMPARE || ac.bias == TEVBIAS_COMPARE)
+      return nullptr;
+  }
+
+  AlignCode16();
+  const u8* start = GetCodePtr();
+
+  for (u32 i = 0; i < uid_data->num_stages; i++)
+  {
+    TevStageCombiner::ColorCombiner cc;
+    TevStageCombiner::AlphaCombiner ac;
+    cc.hex = uid_data->stages[i].cc;
+    ac.hex = uid_data->stages[i].ac;
+    const u32 kc = uid_data->stages[i].kc;
+    const u32 ka = uid_data->stages[i].ka;
+
+    // The color combiner only writes the color components, and only reads the color component it
+    // computes, besides alpha. So the inputs can be loaded right before each component is computed.
+    const s32 color_round = (cc.shift == 3) ? 0 : (cc.op == 1) ? 127 : 128;
+    for (int comp = Tev::BLU_C; comp <= Tev::RED_C; comp++)
+    {
+      const Input inputs[4] = {
+          GetColorInput(tev, i, cc.a, kc, comp), GetColorInput(tev, i, cc.b, kc, comp),
+          GetColorInput(tev, i, cc.c, kc, comp), GetColorInput(tev, i, cc.d, kc, comp)};
+      CombineRegular(inputs, cc.bias, cc.shift, false, cc.op != 0, color_round, cc.clamp != 0,
+                     MDisp(tev_reg, Offset(tev, tev.QuadReg[cc.dest][comp])));
+    }
+
+    const s32 alpha_round = (ac.shift != 3) ? 0 : (ac.op == 1) ? 127 : 128;
+    const Input inputs[4] = {GetAlphaInput(tev, i, ac.a, ka), GetAlphaInput(tev, i, ac.b, ka),
+                             GetAlphaInput(tev, i, ac.c, ka), GetAlphaInput(tev, i, ac.d, ka)};
+    CombineRegular(inputs, ac.bias, ac.shift, ac.op != 0, false, alpha_round, ac.clamp != 0,
+                   MDisp(tev_reg, Offset(tev, tev.QuadReg[ac.dest][Tev::ALP_C])));
+  }
+
+  RET();
+
+  JitRegister::Register(start, GetCodePtr(), "TevX64_%u_stages", uid_data->num_stages);
+  return reinterpret_cast<Tev::CombineQuadFunction>(const_cast<u8*>(start));
+}
+
+TevX64::Input TevX64::GetColorInput(const Tev& tev, u32 stage, u32 sel, u32 kc, int comp) const
+{
+  // same inputs as Tev::m_ColorInputLUT
+  const int source_comp = (sel & 1) ? Tev::ALP_C : comp;
+  switch (sel)
+  {
+  case TEVCOLORARG_CPREV:
+  case TEVCOLORARG_APREV:
+  case TEVCOLORARG_C0:
+  case TEVCOLORARG_A0:
+  case TEVCOLORARG_C1:
+  case TEVCOLORARG_A1:
+  case TEVCOLORARG_C2:
+  case TEVCOLORARG_A2:
+    return {MDisp(tev_reg, Offset(tev, tev.QuadReg[sel >> 1][source_comp])), false, true};
+  case TEVCOLORARG_TEXC:
+  case TEVCOLORARG_TEXA:
+    return {MDisp(tev_reg, Offset(tev, tev.m_QuadStageTexColor[stage][source_comp])), false,
+            false};
+  case TEVCOLORARG_RASC:
+  case TEVCOLORARG_RASA:
+    return {MDisp(tev_reg, Offset(tev, tev.m_QuadStageRasColor[stage][source_comp])), false,
+            false};
+  case TEVCOLORARG_ONE:
+    return {M(m_const_255), false, false};
+  case TEVCOLORARG_HALF:
+    return {M(m_const_128), false, false};
+  case TEVCOLORARG_KONST:
+    return {MDisp(tev_reg, Offset(tev, tev.m_KonstLUT[kc][comp])), true, true};
+  case TEVCOLORARG_ZERO:
+  default:
+    return {M(m_const_0), false, false};
+  }
+}
+
+TevX64::Input TevX64::GetAlphaInput(const Tev& tev, u32 stage, u32 sel, u32 ka) const
+{
+  // same inputs as Tev::m_AlphaInputLUT
+  switch (sel)
+  {
+  case TEVALPHAARG_APREV:
+  case TEVALPHAARG_A0:
+  case TEVALPHAARG_A1:
+  case TEVALPHAARG_A2:
+    return {MDisp(tev_reg, Offset(tev, tev.QuadReg[sel][Tev::ALP_C])), false, true};
+  case TEVALPHAARG_TEXA:
+    return {MDisp(tev_reg, Offset(tev, tev.m_QuadStageTexColor[stage][Tev::ALP_C])), false,
+            false};
+  case TEVALPHAARG_RASA:
+    return {MDisp(tev_reg, Offset(tev, tev.m_QuadStageRasColor[stage][Tev::ALP_C])), false,
+            false};
+  case TEVALPHAARG_KONST:
+    return {MDisp(tev_reg, Offset(tev, tev.m_KonstLUT[ka][Tev::ALP_C])), true, true};
+  case TEVALPHAARG_ZERO:
+  default:
+    return {M(m_const_0), false, false};
+  }
+}
+
+// Loads the lanes of an input and truncates them like the fields of Tev::InputRegType.
+void TevX64::LoadInput(X64Reg dest, const Input& input, bool d)
+{
+  if (input.broadcast)
+  {
+    MOVZX(32, 16, RAX, input.arg);
+    MOVD_xmm(dest, R(RAX));
+    PSHUFLW(dest, R(dest), 0);
+  }
+  else
+  {
+    MOVQ_xmm(dest, input.arg);
+  }
+
+  if (!input.truncate)
+    return;
+
+  if (d)
+  {
+    PSLLW(dest, 5);
+    PSRAW(dest, 5);
+  }
+  else
+  {
+    PAND(dest, M(m_const_mask_ff));
+  }
+}
+
+// Emits the same computation as CombineQuadRegular and ClampQuad in Tev.cpp. Only XMM0-XMM4 are
+// used, which the callee doesn't have to save on any ABI.
+void TevX64::CombineRegular(const Input inputs[4], u32 bias, u32 shift, bool negateBeforeShift,
+                            bool negateAfterShift, s32 round, bool clamp, OpArg dest)
+{
+  const int lshift = shift == 1 ? 1 : shift == 2 ? 2 : 0;
+  const int rshift = shift == 3 ? 1 : 0;
+
+  LoadInput(XMM0, inputs[0], false);
+  LoadInput(XMM1, inputs[1], false);
+  LoadInput(XMM2, inputs[2], false);
+
+  // temp = a * (256 - c) + b * c, with c + (c >> 7)
+  MOVDQA(XMM4, R(XMM2));
+  PSRLW(XMM4, 7);
+  PADDW(XMM2, R(XMM4));
+  MOVDQA(XMM4, M(m_const_256));
+  PSUBW(XMM4, R(XMM2));
+  PUNPCKLWD(XMM4, R(XMM2));
+  PUNPCKLWD(XMM0, R(XMM1));
+  PMADDWD(XMM0, R(XMM4));
+
+  if (lshift != 0)
+    PSLLD(XMM0, lshift);
+  if (round == 127)
+    PADDD(XMM0, M(m_const_127_32));
+  else if (round == 128)
+    PADDD(XMM0, M(m_const_128_32));
+  if (negateBeforeShift)
+  {
+    PXOR(XMM4, R(XMM4));
+    PSUBD(XMM4, R(XMM0));
+    MOVDQA(XMM0, R(XMM4));
+  }
+  PSRAD(XMM0, 8);
+  if (negateAfterShift)
+  {
+    PXOR(XMM4, R(XMM4));
+    PSUBD(XMM4, R(XMM0));
+    MOVDQA(XMM0, R(XMM4));
+  }
+
+  // result = ((d + bias) << lshift) + temp) >> rshift, with d sign extended to 32 bits
+  LoadInput(XMM3, inputs[3], true);
+  PUNPCKLWD(XMM3, R(XMM3));
+  PSRAD(XMM3, 16);
+  if (bias == TEVBIAS_ADDHALF)
+    PADDD(XMM3, M(m_const_128_32));
+  else if (bias == TEVBIAS_SUBHALF)
+    PADDD(XMM3, M(m_const_minus_128_32));
+  if (lshift != 0)
+    PSLLD(XMM3, lshift);
+  PADDD(XMM3, R(XMM0));
+  if (rshift != 0)
+    PSRAD(XMM3, rshift);
+  PACKSSDW(XMM3, R(XMM3));
+
+  PMINSW(XMM3, M(clamp ? m_const_255 : m_const_1023));
+  PMAXSW(XMM3, M(clamp ? m_const_0 : m_const_minus_1024));
+  MOVQ_xmm(dest, XMM3);
+}
@@ -0,0 +1,75 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+
+#include "Common/CommonTypes.h"
+#include "Common/x64Emitter.h"
+#include "VideoBackends/Software/Tev.h"
+#include "VideoCommon/ShaderGenCommon.h"
+
+#pragma pack(1)
+struct tev_combiner_uid_data
+{
+  u32 num_stages;
+
+  struct
+  {
+    u32 cc;  // all fields of the color combiner
+    u32 ac;  // without the swap tables, which are only used when fetching the colors
+    u8 kc;
+    u8 ka;
+  } stages[16];
+};
+#pragma pack()
+
+using TevCombinerUid = ShaderUid<tev_combiner_uid_data>;
+
+// Compiles the TEV stages of the software renderer into functions that combine the pixels of a
+// quad, so that the combiner state is decoded once for each configuration instead of every quad.
+class TevX64 : public Gen::X64CodeBlock
+{
+public:
+  TevX64();
+
+  // Returns the function for the TEV stages in bpmem, or nullptr if the interpreter has to combine
+  // them. The functions work with any Tev, they only use the layout of the given one.
+  //
+  // A new configuration can clear the code space when it is full, which makes the functions that
+  // were returned before invalid.
+  Tev::CombineQuadFunction GetCombineQuadFunction(const Tev& tev);
+
+private:
+  // Where the lanes of a combiner input are loaded from.
+  struct Input
+  {
+    Gen::OpArg arg;
+    bool broadcast;  // a single value for all lanes
+    bool truncate;   // not known to be within 0-255
+  };
+
+  void WriteConstants();
+  Tev::CombineQuadFunction Compile(const TevCombinerUid& uid, const Tev& tev);
+  Input GetColorInput(const Tev& tev, u32 stage, u32 sel, u32 kc, int comp) const;
+  Input GetAlphaInput(const Tev& tev, u32 stage, u32 sel, u32 ka) const;
+  void LoadInput(Gen::X64Reg dest, const Input& input, bool d);
+  void CombineRegular(const Input inputs[4], u32 bias, u32 shift, bool negateBeforeShift,
+                      bool negateAfterShift, s32 round, bool clamp, Gen::OpArg dest);
+
+  std::map<TevCombinerUid, Tev::CombineQuadFunction> m_functions;
+
+  // Constants at the start of the code space, with 16 byte alignment for SSE operands.
+  const u16* m_const_mask_ff = nullptr;
+  const u16* m_const_256 = nullptr;
+  const u16* m_const_255 = nullptr;
+  const u16* m_const_128 = nullptr;
+  const u16* m_const_0 = nullptr;
+  const u16* m_const_1023 = nullptr;
+  const u16* m_const_minus_1024 = nullptr;
+  const u32* m_const_127_32 = nullptr;
+  const u32* m_const_128_32 = nullptr;
+  const u32* m_const_minus_128_32 = nullptr;
+};
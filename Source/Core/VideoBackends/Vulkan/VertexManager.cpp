@@ -208,9 +208,9 @@ void VertexManager::UpdateVertexShaderConstants()
       UBO_DESCRIPTOR_SET_BINDING_VS, m_uniform_stream_buffer->GetBuffer(),
       m_uniform_stream_buffer->GetCurrentOffset(), sizeof(VertexShaderConstants));
   std::memcpy(m_uniform_stream_buffer->GetCurrentHostPointer(), &VertexShaderManager::constants,
-              sizeof(VertexShaderConstants));
+              VertexShaderManager::GetConstantsSize());
   m_uniform_stream_buffer->CommitMemory(sizeof(VertexShaderConstants));
-  ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, sizeof(VertexShaderConstants));
+  ADDSTAT(g_stats.this_frame.bytes_uniform_streamed, VertexShaderManager::GetConstantsSize());
   VertexShaderManager::dirty = false;
 }
 
@@ -299,7 +299,7 @@ void VertexManager::UploadAllConstants()
   std::memcpy(m_uniform_stream_buffer->GetCurrentHostPointer() + pixel_constants_offset,
               &PixelShaderManager::constants, sizeof(PixelShaderConstants));
   std::memcpy(m_uniform_stream_buffer->GetCurrentHostPointer() + vertex_constants_offset,
-              &VertexShaderManager::constants, sizeof(VertexShaderConstants));
+              &VertexShaderManager::constants, VertexShaderManager::GetConstantsSize());
   std::memcpy(m_uniform_stream_buffer->GetCurrentHostPointer() + geometry_constants_offset,
               &GeometryShaderManager::constants, sizeof(GeometryShaderConstants));
 
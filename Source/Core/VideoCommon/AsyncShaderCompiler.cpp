@@ -26,14 +26,26 @@ void AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
   if (!HasWorkerThreads())
   {
     item->Compile();
+    std::lock_guard<std::mutex> guard(m_completed_work_lock);
     m_completed_work.push_back(std::move(item));
+    return;
+  }
+
+  // The counts go up first, so that they never underflow when a worker takes the item.
+  m_pending_work++;
+  m_queued_work++;
+  WorkQueue& queue = *m_work_queues[m_next_work_queue];
+  m_next_work_queue = (m_next_work_queue + 1) % m_work_queues.size();
+  {
+    std::lock_guard<std::mutex> guard(queue.lock);
+    queue.items.emplace(priority, std::move(item));
   }
-  else
+
+  // Taking the lock ensures that the worker is either waiting, or will see the item.
   {
-    std::lock_guard<std::mutex> guard(m_pending_work_lock);
-    m_pending_work.emplace(priority, std::move(item));
-    m_worker_thread_wake.notify_one();
+    std::lock_guard<std::mutex> guard(m_worker_thread_wake_lock);
   }
+  m_worker_thread_wake.notify_one();
 }
 
 void AsyncShaderCompiler::RetrieveWorkItems()
@@ -53,8 +65,7 @@ void AsyncShaderCompiler::RetrieveWorkItems()
 
 bool AsyncShaderCompiler::HasPendingWork()
 {
-  std::lock_guard<std::mutex> guard(m_pending_work_lock);
-  return !m_pending_work.empty() || m_busy_workers.load() != 0;
+  return m_pending_work.load() != 0;
 }
 
 bool AsyncShaderCompiler::HasCompletedWork()
@@ -65,57 +76,53 @@ bool AsyncShaderCompiler::HasCompletedWork()
 
 void AsyncShaderCompiler::WaitUntilCompletion()
 {
-  while (HasPendingWork())
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  std::unique_lock<std::mutex> completed_lock(m_completed_work_lock);
+  m_work_completed.wait(completed_lock, [this] { return m_pending_work.load() == 0; });
 }
 
 void AsyncShaderCompiler::WaitUntilCompletion(
     const std::function<void(size_t, size_t)>& progress_callback)
 {
-  if (!HasPendingWork())
-    return;
-
   // Wait a second before opening a progress dialog.
   // This way, if the operation completes quickly, we don't annoy the user.
-  constexpr u32 CHECK_INTERVAL_MS = 1000 / 30;
-  constexpr auto CHECK_INTERVAL = std::chrono::milliseconds(CHECK_INTERVAL_MS);
-  for (u32 i = 0; i < (1000 / CHECK_INTERVAL_MS); i++)
+  constexpr auto PROGRESS_DELAY = std::chrono::seconds(1);
+  constexpr auto CHECK_INTERVAL = std::chrono::milliseconds(1000 / 30);
+  const auto is_complete = [this] { return m_pending_work.load() == 0; };
+  size_t total_items;
   {
-    std::this_thread::sleep_for(std::chrono::milliseconds(CHECK_INTERVAL));
-    if (!HasPendingWork())
+    std::unique_lock<std::mutex> completed_lock(m_completed_work_lock);
+    if (m_work_completed.wait_for(completed_lock, PROGRESS_DELAY, is_complete))
       return;
-  }
 
-  // Grab the number of pending items. We use this to work out how many are left.
-  size_t total_items = 0;
-  {
-    // Safe to hold both locks here, since nowhere else does.
-    std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
-    std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
-    total_items = m_completed_work.size() + m_pending_work.size() + m_busy_workers.load() + 1;
+    // Grab the number of pending items. We use this to work out how many are left.
+    total_items = m_completed_work.size() + m_pending_work.load() + 1;
   }
 
-  // Update progress while the compiles complete.
+  // Update progress while the compiles complete. The waits end as soon as the last one does.
   for (;;)
   {
-    size_t remaining_items;
-    {
-      std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
-      if (m_pending_work.empty() && !m_busy_workers.load())
-        break;
-      remaining_items = m_pending_work.size();
-    }
+    progress_callback(total_items - m_pending_work.load(), total_items);
 
-    progress_callback(total_items - remaining_items, total_items);
-    std::this_thread::sleep_for(CHECK_INTERVAL);
+    std::unique_lock<std::mutex> completed_lock(m_completed_work_lock);
+    if (m_work_completed.wait_for(completed_lock, CHECK_INTERVAL, is_complete))
+      break;
   }
 }
 
+bool AsyncShaderCompiler::WaitForCompletedWork(std::chrono::milliseconds timeout)
+{
+  std::unique_lock<std::mutex> completed_lock(m_completed_work_lock);
+  return m_work_completed.wait_for(completed_lock, timeout, [this] {
+    return !m_completed_work.empty() || m_pending_work.load() == 0;
+  }) && !m_completed_work.empty();
+}
+
 bool AsyncShaderCompiler::StartWorkerThreads(u32 num_worker_threads)
 {
   if (num_worker_threads == 0)
     return true;
 
+  ResizeWorkQueues(num_worker_threads);
   for (u32 i = 0; i < num_worker_threads; i++)
   {
     void* thread_param = nullptr;
@@ -127,7 +134,8 @@ bool AsyncShaderCompiler::StartWorkerThreads(u32 num_worker_threads)
 
     m_worker_thread_start_result.store(false);
 
-    std::thread thr(&AsyncShaderCompiler::WorkerThreadEntryPoint, this, thread_param);
+    std::thread thr(&AsyncShaderCompiler::WorkerThreadEntryPoint, this, thread_param,
+                    static_cast<size_t>(i));
     m_init_event.Wait();
 
     if (!m_worker_thread_start_result.load())
@@ -162,9 +170,10 @@ void AsyncShaderCompiler::StopWorkerThreads()
   if (!HasWorkerThreads())
     return;
 
-  // Signal worker threads to stop, and wake all of them.
+  // Signal worker threads to stop, and wake all of them. They exit as soon as the item they are
+  // compiling, if any, is done, leaving the rest of the items queued.
   {
-    std::lock_guard<std::mutex> guard(m_pending_work_lock);
+    std::lock_guard<std::mutex> guard(m_worker_thread_wake_lock);
     m_exit_flag.Set();
     m_worker_thread_wake.notify_all();
   }
@@ -190,7 +199,7 @@ void AsyncShaderCompiler::WorkerThreadExit(void* param)
 {
 }
 
-void AsyncShaderCompiler::WorkerThreadEntryPoint(void* param)
+void AsyncShaderCompiler::WorkerThreadEntryPoint(void* param, size_t worker_index)
 {
   // Initialize worker thread with backend-specific method.
   if (!WorkerThreadInitWorkerThread(param))
@@ -204,34 +213,82 @@ void AsyncShaderCompiler::WorkerThreadEntryPoint(void* param)
   m_worker_thread_start_result.store(true);
   m_init_event.Set();
 
-  WorkerThreadRun();
+  WorkerThreadRun(worker_index);
 
   WorkerThreadExit(param);
 }
 
-void AsyncShaderCompiler::WorkerThreadRun()
+void AsyncShaderCompiler::WorkerThreadRun(size_t worker_index)
 {
-  std::unique_lock<std::mutex> pending_lock(m_pending_work_lock);
   while (!m_exit_flag.IsSet())
   {
-    m_worker_thread_wake.wait(pending_lock);
+    {
+      std::unique_lock<std::mutex> wake_lock(m_worker_thread_wake_lock);
+      m_worker_thread_wake.wait(wake_lock, [this] {
+        return m_exit_flag.IsSet() || m_queued_work.load() != 0;
+      });
+    }
 
-    while (!m_pending_work.empty() && !m_exit_flag.IsSet())
+    // Another worker may have taken the item in the meantime.
+    WorkItemPtr item = TakeWorkItem(worker_index);
+    if (item)
+      CompleteWorkItem(std::move(item));
+  }
+}
+
+AsyncShaderCompiler::WorkItemPtr AsyncShaderCompiler::TakeWorkItem(size_t worker_index)
+{
+  // The worker's own queue is the only one it locks while it has work. Only once that is empty does
+  // it steal from the other queues, in turn, taking the most urgent item of the first one with any.
+  const size_t num_queues = m_work_queues.size();
+  for (size_t i = 0; i < num_queues; i++)
+  {
+    WorkQueue& queue = *m_work_queues[(worker_index + i) % num_queues];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.items.empty())
+      continue;
+
+    auto iter = queue.items.begin();
+    WorkItemPtr item(std::move(iter->second));
+    queue.items.erase(iter);
+    m_queued_work--;
+    return item;
+  }
+
+  return nullptr;
+}
+
+void AsyncShaderCompiler::CompleteWorkItem(WorkItemPtr item)
+{
+  const bool compiled = item->Compile();
+  {
+    std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
+    if (compiled)
+      m_completed_work.push_back(std::move(item));
+    m_pending_work--;
+  }
+  m_work_completed.notify_all();
+}
+
+void AsyncShaderCompiler::ResizeWorkQueues(size_t num_queues)
+{
+  if (m_work_queues.size() == num_queues)
+    return;
+
+  // Only called while there are no worker threads, so the queues can be changed without locking.
+  std::vector<std::unique_ptr<WorkQueue>> old_queues;
+  old_queues.swap(m_work_queues);
+  for (size_t i = 0; i < num_queues; i++)
+    m_work_queues.push_back(std::make_unique<WorkQueue>());
+
+  // Spread the items that were left queued over the new queues.
+  m_next_work_queue = 0;
+  for (auto& old_queue : old_queues)
+  {
+    for (auto& it : old_queue->items)
     {
-      m_busy_workers++;
-      auto iter = m_pending_work.begin();
-      WorkItemPtr item(std::move(iter->second));
-      m_pending_work.erase(iter);
-      pending_lock.unlock();
-
-      if (item->Compile())
-      {
-        std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
-        m_completed_work.push_back(std::move(item));
-      }
-
-      pending_lock.lock();
-      m_busy_workers--;
+      m_work_queues[m_next_work_queue]->items.emplace(it.first, std::move(it.second));
+      m_next_work_queue = (m_next_work_queue + 1) % num_queues;
     }
   }
 }
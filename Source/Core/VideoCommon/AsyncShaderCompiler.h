@@ -5,6 +5,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <functional>
@@ -56,6 +57,10 @@ public:
   // Calls progress_callback periodically, with completed_items, and total_items.
   void WaitUntilCompletion(const std::function<void(size_t, size_t)>& progress_callback);
 
+  // Blocks until there is completed work to retrieve, there is no pending work, or the timeout
+  // expires. Returns true if there is completed work.
+  bool WaitForCompletedWork(std::chrono::milliseconds timeout);
+
   // Needed because of calling virtual methods in shutdown procedure.
   bool StartWorkerThreads(u32 num_worker_threads);
   bool ResizeWorkerThreads(u32 num_worker_threads);
@@ -68,8 +73,21 @@ protected:
   virtual void WorkerThreadExit(void* param);
 
 private:
-  void WorkerThreadEntryPoint(void* param);
-  void WorkerThreadRun();
+  // Each worker thread has its own queue. Items are queued to them in turn, and workers take the
+  // item with the lowest priority from their own queue, stealing from the others once it is empty.
+  // A multimap is used to store the work items. We can't use a priority_queue here, because
+  // there's no way to obtain a non-const reference, which we need for the unique_ptr.
+  struct WorkQueue
+  {
+    std::multimap<u32, WorkItemPtr> items;
+    std::mutex lock;
+  };
+
+  void WorkerThreadEntryPoint(void* param, size_t worker_index);
+  void WorkerThreadRun(size_t worker_index);
+  WorkItemPtr TakeWorkItem(size_t worker_index);
+  void CompleteWorkItem(WorkItemPtr item);
+  void ResizeWorkQueues(size_t num_queues);
 
   Common::Flag m_exit_flag;
   Common::Event m_init_event;
@@ -77,15 +95,18 @@ private:
   std::vector<std::thread> m_worker_threads;
   std::atomic_bool m_worker_thread_start_result{false};
 
-  // A multimap is used to store the work items. We can't use a priority_queue here, because
-  // there's no way to obtain a non-const reference, which we need for the unique_ptr.
-  std::multimap<u32, WorkItemPtr> m_pending_work;
-  std::mutex m_pending_work_lock;
+  std::vector<std::unique_ptr<WorkQueue>> m_work_queues;
+  size_t m_next_work_queue = 0;
+  // Number of items in the queues, and of items that are queued or compiling.
+  std::atomic_size_t m_queued_work{0};
+  std::atomic_size_t m_pending_work{0};
+  std::mutex m_worker_thread_wake_lock;
   std::condition_variable m_worker_thread_wake;
-  std::atomic_size_t m_busy_workers{0};
 
+  // Signalled whenever an item completes.
   std::deque<WorkItemPtr> m_completed_work;
   std::mutex m_completed_work_lock;
+  std::condition_variable m_work_completed;
 };
 
 }  // namespace VideoCommon
@@ -1105,4 +1105,8 @@ extern BPMemory bpmem;
 void LoadBPReg(u32 value0);
 void LoadBPRegPreprocess(u32 value0);
 
+// Returns true for registers whose writes do something even if they don't change the value, e.g.
+// triggering an EFB copy.
+bool BPWriteHasSideEffects(u32 address);
+
 void GetBPRegInfo(const u8* data, std::string* name, std::string* desc);
@@ -47,6 +47,16 @@ void BPInit()
   bpmem.bpMask = 0xFFFFFF;
 }
 
+bool BPWriteHasSideEffects(u32 address)
+{
+  return address == BPMEM_TRIGGER_EFB_COPY || address == BPMEM_CLEARBBOX1 ||
+         address == BPMEM_CLEARBBOX2 || address == BPMEM_SETDRAWDONE ||
+         address == BPMEM_PE_TOKEN_ID || address == BPMEM_PE_TOKEN_INT_ID ||
+         address == BPMEM_LOADTLUT0 || address == BPMEM_LOADTLUT1 ||
+         address == BPMEM_TEXINVALIDATE || address == BPMEM_PRELOAD_MODE ||
+         address == BPMEM_CLEAR_PIXEL_PERF;
+}
+
 static void BPWritten(const BPCmd& bp)
 {
   /*
@@ -70,18 +80,8 @@ static void BPWritten(const BPCmd& bp)
   ----------------------------------------------------------------------------------------------------------------
   */
 
-  if (((s32*)&bpmem)[bp.address] == bp.newvalue)
-  {
-    if (!(bp.address == BPMEM_TRIGGER_EFB_COPY || bp.address == BPMEM_CLEARBBOX1 ||
-          bp.address == BPMEM_CLEARBBOX2 || bp.address == BPMEM_SETDRAWDONE ||
-          bp.address == BPMEM_PE_TOKEN_ID || bp.address == BPMEM_PE_TOKEN_INT_ID ||
-          bp.address == BPMEM_LOADTLUT0 || bp.address == BPMEM_LOADTLUT1 ||
-          bp.address == BPMEM_TEXINVALIDATE || bp.address == BPMEM_PRELOAD_MODE ||
-          bp.address == BPMEM_CLEAR_PIXEL_PERF))
-    {
-      return;
-    }
-  }
+  if (((s32*)&bpmem)[bp.address] == bp.newvalue && !BPWriteHasSideEffects(bp.address))
+    return;
 
   FlushPipeline();
 
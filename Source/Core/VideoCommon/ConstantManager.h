@@ -53,6 +53,9 @@ struct PixelShaderConstants
   u32 blend_subtract_alpha;
 };
 
+// Number of draws with different position/normal matrices that can be merged into one batch.
+constexpr u32 NUM_DRAW_MATRICES = 32;
+
 struct VertexShaderConstants
 {
   u32 components;           // .x
@@ -82,6 +85,11 @@ struct VertexShaderConstants
 
   // .x - texMtxInfo, .y - postMtxInfo, [0..1].z = color, [0..1].w = alpha
   std::array<uint4, 8> xfmem_pack1;
+
+  // Only declared in the shaders and uploaded when draw merging is enabled. The position (rows
+  // 0-2) and normal (rows 3-5) matrices of each draw of the current batch, indexed by the draw
+  // matrix index of the vertices.
+  std::array<float4, NUM_DRAW_MATRICES * 6> drawmatrices;
 };
 
 struct GeometryShaderConstants
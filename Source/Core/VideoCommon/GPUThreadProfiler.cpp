@@ -0,0 +1,71 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/GPUThreadProfiler.h"
+
+#include <atomic>
+
+#include "Common/CommonTypes.h"
+
+namespace GPUThreadProfiler
+{
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<bool> s_enabled{false};
+static std::array<std::atomic<s64>, static_cast<size_t>(Section::NumSections)> s_times;
+
+// The sections are only entered and left on the thread that processes the commands, but that is
+// a different thread depending on the dual core setting.
+static thread_local Section tls_section = Section::None;
+static thread_local Clock::time_point tls_section_start;
+
+void SetEnabled(bool enabled)
+{
+  if (enabled && !s_enabled)
+  {
+    for (auto& time : s_times)
+      time.store(0, std::memory_order_relaxed);
+  }
+  s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsEnabled()
+{
+  return s_enabled.load(std::memory_order_relaxed);
+}
+
+Times GetTimes()
+{
+  Times times;
+  for (size_t i = 0; i < times.size(); ++i)
+    times[i] = std::chrono::nanoseconds(s_times[i].load(std::memory_order_relaxed));
+  return times;
+}
+
+// Adds the time since the current section was entered or resumed, and starts timing the next one.
+static void SwitchSection(Section section)
+{
+  const Clock::time_point now = Clock::now();
+  if (tls_section != Section::None)
+  {
+    const s64 elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - tls_section_start).count();
+    s_times[static_cast<size_t>(tls_section)].fetch_add(elapsed, std::memory_order_relaxed);
+  }
+  tls_section = section;
+  tls_section_start = now;
+}
+
+Section EnterSection(Section section)
+{
+  const Section previous = tls_section;
+  SwitchSection(section);
+  return previous;
+}
+
+void LeaveSection(Section previous)
+{
+  SwitchSection(previous);
+}
+}  // namespace GPUThreadProfiler
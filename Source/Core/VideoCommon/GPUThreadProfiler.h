@@ -0,0 +1,64 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+// Measures how much time the GPU thread spends in each part of the command processing. This is
+// meant for benchmarking, e.g. with the turbo replay of the FIFO player, so it is disabled by
+// default.
+namespace GPUThreadProfiler
+{
+enum class Section
+{
+  None,
+  OpcodeDecoding,
+  VertexLoading,
+  TextureLoading,
+  Flush,
+  NumSections
+};
+
+using Times = std::array<std::chrono::nanoseconds, static_cast<size_t>(Section::NumSections)>;
+
+void SetEnabled(bool enabled);
+bool IsEnabled();
+
+// Returns the time spent in each section since the profiler was enabled. The time of a section
+// that is entered from another one only counts towards the inner section.
+Times GetTimes();
+
+// Returns the section that was entered before.
+Section EnterSection(Section section);
+void LeaveSection(Section previous);
+
+class ScopedSection
+{
+public:
+  explicit ScopedSection(Section section)
+  {
+    if (section != Section::None && IsEnabled())
+    {
+      m_active = true;
+      m_previous = EnterSection(section);
+    }
+  }
+
+  ~ScopedSection()
+  {
+    if (m_active)
+      LeaveSection(m_previous);
+  }
+
+  ScopedSection(const ScopedSection&) = delete;
+  ScopedSection& operator=(const ScopedSection&) = delete;
+
+private:
+  bool m_active = false;
+  Section m_previous = Section::None;
+};
+}  // namespace GPUThreadProfiler
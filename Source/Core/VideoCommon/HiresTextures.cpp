@@ -5,33 +5,35 @@
 #include "VideoCommon/HiresTextures.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <queue>
 #include <string>
 #include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 #include <xxhash.h>
 
 #include <fmt/format.h>
 
+#include "Common/CPUDetect.h"
 #include "Common/CommonPaths.h"
 #include "Common/File.h"
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
-#include "Common/Flag.h"
 #include "Common/Image.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
 #include "Common/Thread.h"
-#include "Common/Timer.h"
-#include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
-#include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/VideoConfig.h"
 
 struct DiskTexture
@@ -40,14 +42,87 @@ struct DiskTexture
   bool has_arbitrary_mipmaps;
 };
 
+// A texture waiting to be loaded. The textures that the game requested are loaded first, the latest
+// request first, and the prefetched textures last.
+struct LoadRequest
+{
+  u64 priority;
+  std::string name;
+  u32 width;
+  u32 height;
+
+  bool operator<(const LoadRequest& other) const { return priority < other.priority; }
+};
+
+struct CachedTexture
+{
+  std::shared_ptr<HiresTexture> texture;
+  size_t size;
+  std::list<std::string>::iterator lru_iter;
+};
+
 constexpr std::string_view s_format_prefix{"tex1_"};
 
+constexpr u64 PREFETCH_PRIORITY = 0;
+// The priority of the textures that a loader is working on
+constexpr u64 LOADING_PRIORITY = std::numeric_limits<u64>::max();
+
 static std::unordered_map<std::string, DiskTexture> s_textureMap;
-static std::unordered_map<std::string, std::shared_ptr<HiresTexture>> s_textureCache;
+
+// The loaded textures, and the least recently used textures that are removed when the memory
+// budget is exceeded.
+static std::unordered_map<std::string, CachedTexture> s_textureCache;
+static std::list<std::string> s_textureLRU;
+static size_t s_textureCacheSize = 0;
+static size_t s_textureCacheBudget = 0;
+static std::unordered_set<std::string> s_failedTextures;
+
+// The textures in the queue, with the priority of their latest request. Queued requests with a
+// different priority are outdated and skipped.
+static std::unordered_map<std::string, u64> s_pendingTextures;
+static std::priority_queue<LoadRequest> s_loadQueue;
+static u64 s_lastRequestPriority = PREFETCH_PRIORITY;
+static bool s_stopLoaders = false;
+
+// Protects all of the above except for s_textureMap, which is only changed without loaders.
 static std::mutex s_textureCacheMutex;
-static Common::Flag s_textureCacheAbortLoading;
+static std::condition_variable s_loadQueueChanged;
+
+static std::vector<std::thread> s_loaders;
+
+static size_t GetMemoryBudget()
+{
+  if (g_ActiveConfig.iHiresTexturesMemoryBudget > 0)
+    return size_t(g_ActiveConfig.iHiresTexturesMemoryBudget) * 1024 * 1024;
+
+  const size_t sys_mem = Common::MemPhysical();
+  const size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
+  // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
+  return (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+}
+
+static void ClearTextureCache()
+{
+  s_textureCache.clear();
+  s_textureLRU.clear();
+  s_textureCacheSize = 0;
+  s_failedTextures.clear();
+}
+
+static void RemoveCachedTexture(std::unordered_map<std::string, CachedTexture>::iterator iter)
+{
+  s_textureCacheSize -= iter->second.size;
+  s_textureLRU.erase(iter->second.lru_iter);
+  s_textureCache.erase(iter);
+}
 
-static std::thread s_prefetcher;
+// Removes the least recently used textures until the cache fits into the budget. The most
+// recently used texture is kept even if it is larger, as it was loaded for the game.
+static void TrimTextureCache()
+{
+  while (s_textureCacheSize > s_textureCacheBudget && s_textureLRU.size() > 1)
+    RemoveCachedTexture(s_textureCache.find(s_textureLRU.back()));
+}
 
 void HiresTexture::Init()
 {
@@ -56,36 +131,23 @@ void HiresTexture::Init()
 
 void HiresTexture::Shutdown()
 {
-  if (s_prefetcher.joinable())
-  {
-    s_textureCacheAbortLoading.Set();
-    s_prefetcher.join();
-  }
+  StopLoaders();
 
   s_textureMap.clear();
-  s_textureCache.clear();
+  ClearTextureCache();
 }
 
 void HiresTexture::Update()
 {
-  if (s_prefetcher.joinable())
-  {
-    s_textureCacheAbortLoading.Set();
-    s_prefetcher.join();
-  }
+  StopLoaders();
 
+  s_textureMap.clear();
   if (!g_ActiveConfig.bHiresTextures)
   {
-    s_textureMap.clear();
-    s_textureCache.clear();
+    ClearTextureCache();
     return;
   }
 
-  if (!g_ActiveConfig.bCacheHiresTextures)
-  {
-    s_textureCache.clear();
-  }
-
   const std::string& game_id = SConfig::GetInstance().GetGameID();
   const std::set<std::string> texture_directories = GetTextureDirectories(game_id);
   const std::vector<std::string> extensions{".png", ".dds"};
@@ -124,90 +186,112 @@ void HiresTexture::Update()
     }
   }
 
+  // remove cached but deleted textures, and retry the ones that failed to load
+  auto iter = s_textureCache.begin();
+  while (iter != s_textureCache.end())
+  {
+    if (s_textureMap.find(iter->first) == s_textureMap.end())
+      RemoveCachedTexture(iter++);
+    else
+      iter++;
+  }
+  s_failedTextures.clear();
+
+  s_textureCacheBudget = GetMemoryBudget();
+  TrimTextureCache();
+
   if (g_ActiveConfig.bCacheHiresTextures)
   {
-    // remove cached but deleted textures
-    auto iter = s_textureCache.begin();
-    while (iter != s_textureCache.end())
+    for (const auto& entry : s_textureMap)
     {
-      if (s_textureMap.find(iter->first) == s_textureMap.end())
+      const std::string& base_filename = entry.first;
+      if (base_filename.find("_mip") == std::string::npos &&
+          s_textureCache.find(base_filename) == s_textureCache.end())
       {
-        iter = s_textureCache.erase(iter);
-      }
-      else
-      {
-        iter++;
+        s_pendingTextures.emplace(base_filename, PREFETCH_PRIORITY);
+        s_loadQueue.push({PREFETCH_PRIORITY, base_filename, 0, 0});
       }
     }
-
-    s_textureCacheAbortLoading.Clear();
-    s_prefetcher = std::thread(Prefetch);
   }
+
+  StartLoaders();
 }
 
-void HiresTexture::Prefetch()
+void HiresTexture::StartLoaders()
 {
-  Common::SetCurrentThreadName("Prefetcher");
+  // Decoding PNGs takes most of the loading time, so several textures are loaded in parallel.
+  const int num_loaders = std::clamp(cpu_info.num_cores - 2, 1, 4);
+  for (int i = 0; i < num_loaders; i++)
+    s_loaders.emplace_back(LoaderThread);
+}
 
-  size_t size_sum = 0;
-  const size_t sys_mem = Common::MemPhysical();
-  const size_t recommended_min_mem = 2 * size_t(1024 * 1024 * 1024);
-  // keep 2GB memory for system stability if system RAM is 4GB+ - use half of memory in other cases
-  const size_t max_mem =
-      (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+void HiresTexture::StopLoaders()
+{
+  {
+    std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+    s_stopLoaders = true;
+  }
+  s_loadQueueChanged.notify_all();
+  for (std::thread& loader : s_loaders)
+    loader.join();
+
+  s_loaders.clear();
+  s_loadQueue = {};
+  s_pendingTextures.clear();
+  s_stopLoaders = false;
+}
 
-  const u32 start_time = Common::Timer::GetTimeMs();
-  for (const auto& entry : s_textureMap)
+void HiresTexture::LoaderThread()
+{
+  Common::SetCurrentThreadName("Custom texture loader");
+
+  std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+  while (true)
   {
-    const std::string& base_filename = entry.first;
+    s_loadQueueChanged.wait(lk, [] { return s_stopLoaders || !s_loadQueue.empty(); });
+    if (s_stopLoaders)
+      return;
 
-    if (base_filename.find("_mip") == std::string::npos)
-    {
-      std::unique_lock<std::mutex> lk(s_textureCacheMutex);
+    const LoadRequest request = s_loadQueue.top();
+    s_loadQueue.pop();
 
-      auto iter = s_textureCache.find(base_filename);
-      if (iter == s_textureCache.end())
-      {
-        // unlock while loading a texture. This may result in a race condition where
-        // we'll load a texture twice, but it reduces the stuttering a lot.
-        lk.unlock();
-        std::unique_ptr<HiresTexture> texture = Load(base_filename, 0, 0);
-        lk.lock();
-        if (texture)
-        {
-          std::shared_ptr<HiresTexture> ptr(std::move(texture));
-          iter = s_textureCache.insert(iter, std::make_pair(base_filename, ptr));
-        }
-      }
-      if (iter != s_textureCache.end())
-      {
-        for (const Level& l : iter->second->m_levels)
-          size_sum += l.data.size();
-      }
-    }
+    const auto pending_iter = s_pendingTextures.find(request.name);
+    if (pending_iter == s_pendingTextures.end() || pending_iter->second != request.priority)
+      continue;
 
-    if (s_textureCacheAbortLoading.IsSet())
+    // Prefetching stops when the budget is used up, later textures are only loaded on request.
+    const bool prefetch = request.priority == PREFETCH_PRIORITY;
+    if (prefetch && s_textureCacheSize >= s_textureCacheBudget)
     {
-      return;
+      s_pendingTextures.erase(pending_iter);
+      continue;
     }
+    pending_iter->second = LOADING_PRIORITY;
 
-    if (size_sum > max_mem)
-    {
-      Config::SetCurrent(Config::GFX_HIRES_TEXTURES, false);
+    // unlock while loading, so that the game and the other loaders aren't blocked
+    lk.unlock();
+    std::shared_ptr<HiresTexture> texture = Load(request.name, request.width, request.height);
+    lk.lock();
 
-      OSD::AddMessage(
-          fmt::format(
-              "Custom Textures prefetching after {:.1f} MB aborted, not enough RAM available",
-              size_sum / (1024.0 * 1024.0)),
-          10000);
-      return;
+    s_pendingTextures.erase(request.name);
+    if (!texture)
+    {
+      s_failedTextures.insert(request.name);
+      continue;
     }
-  }
 
-  const u32 stop_time = Common::Timer::GetTimeMs();
-  OSD::AddMessage(fmt::format("Custom Textures loaded, {:.1f} MB in {:.1f}s",
-                              size_sum / (1024.0 * 1024.0), (stop_time - start_time) / 1000.0),
-                  10000);
+    size_t size = 0;
+    for (const Level& level : texture->m_levels)
+      size += level.data.size();
+    if (prefetch && s_textureCacheSize + size > s_textureCacheBudget)
+      continue;
+
+    s_textureLRU.push_front(request.name);
+    s_textureCache.emplace(request.name,
+                           CachedTexture{std::move(texture), size, s_textureLRU.begin()});
+    s_textureCacheSize += size;
+    TrimTextureCache();
+  }
 }
 
 std::string HiresTexture::GenBaseName(const u8* texture, size_t texture_size, const u8* tlut,
@@ -303,27 +387,43 @@ u32 HiresTexture::CalculateMipCount(u32 width, u32 height)
 std::shared_ptr<HiresTexture> HiresTexture::Search(const u8* texture, size_t texture_size,
                                                    const u8* tlut, size_t tlut_size, u32 width,
                                                    u32 height, TextureFormat format,
-                                                   bool has_mipmaps)
+                                                   bool has_mipmaps, std::string* loading_name)
 {
   std::string base_filename =
       GenBaseName(texture, texture_size, tlut, tlut_size, width, height, format, has_mipmaps);
+  if (base_filename.empty())
+    return nullptr;
 
   std::lock_guard<std::mutex> lk(s_textureCacheMutex);
 
   auto iter = s_textureCache.find(base_filename);
   if (iter != s_textureCache.end())
   {
-    return iter->second;
+    s_textureLRU.splice(s_textureLRU.begin(), s_textureLRU, iter->second.lru_iter);
+    return iter->second.texture;
   }
 
-  std::shared_ptr<HiresTexture> ptr(Load(base_filename, width, height));
+  if (s_failedTextures.find(base_filename) != s_failedTextures.end())
+    return nullptr;
 
-  if (ptr && g_ActiveConfig.bCacheHiresTextures)
+  // Queue the texture again if it was requested before, so that it is loaded sooner.
+  const u64 priority = ++s_lastRequestPriority;
+  const auto [pending_iter, inserted] = s_pendingTextures.try_emplace(base_filename, priority);
+  if (inserted || pending_iter->second != LOADING_PRIORITY)
   {
-    s_textureCache[base_filename] = ptr;
+    pending_iter->second = priority;
+    s_loadQueue.push({priority, base_filename, width, height});
+    s_loadQueueChanged.notify_one();
   }
 
-  return ptr;
+  *loading_name = std::move(base_filename);
+  return nullptr;
+}
+
+bool HiresTexture::IsLoading(const std::string& name)
+{
+  std::lock_guard<std::mutex> lk(s_textureCacheMutex);
+  return s_pendingTextures.find(name) != s_pendingTextures.end();
 }
 
 std::unique_ptr<HiresTexture> HiresTexture::Load(const std::string& base_filename, u32 width,
@@ -21,9 +21,16 @@ public:
   static void Update();
   static void Shutdown();
 
+  // Returns the custom texture for a game texture if it has been loaded. Otherwise, a custom
+  // texture that exists is queued for loading, and its name is stored in loading_name. The game
+  // texture can be used until IsLoading returns false for that name.
   static std::shared_ptr<HiresTexture> Search(const u8* texture, size_t texture_size,
                                               const u8* tlut, size_t tlut_size, u32 width,
-                                              u32 height, TextureFormat format, bool has_mipmaps);
+                                              u32 height, TextureFormat format, bool has_mipmaps,
+                                              std::string* loading_name);
+
+  // Returns whether a texture queued by Search is still waiting to be loaded or being loaded.
+  static bool IsLoading(const std::string& name);
 
   static std::string GenBaseName(const u8* texture, size_t texture_size, const u8* tlut,
                                  size_t tlut_size, u32 width, u32 height, TextureFormat format,
@@ -52,7 +59,9 @@ private:
   static bool LoadDDSTexture(HiresTexture* tex, const std::string& filename);
   static bool LoadDDSTexture(Level& level, const std::string& filename, u32 mip_level);
   static bool LoadTexture(Level& level, const std::vector<u8>& buffer);
-  static void Prefetch();
+  static void StartLoaders();
+  static void StopLoaders();
+  static void LoaderThread();
 
   static std::set<std::string> GetTextureDirectories(const std::string& game_id);
 
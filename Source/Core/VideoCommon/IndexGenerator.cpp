@@ -9,14 +9,157 @@
 #include <cstring>
 
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/Logging/Log.h"
 #include "VideoCommon/OpcodeDecoding.h"
-#include "VideoCommon/VideoConfig.h"
+
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
 
 namespace
 {
 constexpr u16 s_primitive_restart = UINT16_MAX;
 
+// Marks the first vertex of a fan in an index pattern, which every triangle of the fan uses.
+constexpr u16 s_pattern_first_vertex = UINT16_MAX - 1;
+
+// The indices of long primitives follow a pattern, which repeats with the same offsets from the
+// first vertex of each repetition. Every index but the primitive restart ones, and the first
+// vertex of a fan, is increased by the number of vertices in a repetition. The patterns fill whole
+// vectors, so that they can be written without any shuffling.
+template <size_t N>
+struct IndexPattern
+{
+  static_assert(N % 8 == 0, "Index patterns must fill whole vectors");
+
+  std::array<u16, N> offsets;
+  std::array<u16, N> steps;
+  // Zero for the primitive restart indices, which the base index isn't added to.
+  std::array<u16, N> index_mask;
+  u32 vertices;
+};
+
+// Builds a pattern from as many repetitions of the given indices as fit in N.
+template <size_t N, size_t P>
+constexpr IndexPattern<N> MakePattern(const u16 (&indices)[P], u32 vertices_per_repetition)
+{
+  static_assert(N % P == 0, "Index patterns must contain whole repetitions");
+
+  IndexPattern<N> pattern{};
+  pattern.vertices = N / P * vertices_per_repetition;
+  for (size_t i = 0; i < N; ++i)
+  {
+    const u16 index = indices[i % P];
+    if (index == s_primitive_restart)
+    {
+      pattern.offsets[i] = s_primitive_restart;
+    }
+    else if (index == s_pattern_first_vertex)
+    {
+      pattern.index_mask[i] = UINT16_MAX;
+    }
+    else
+    {
+      pattern.offsets[i] = static_cast<u16>(index + i / P * vertices_per_repetition);
+      pattern.steps[i] = static_cast<u16>(pattern.vertices);
+      pattern.index_mask[i] = UINT16_MAX;
+    }
+  }
+  return pattern;
+}
+
+constexpr u16 R = s_primitive_restart;
+constexpr u16 F = s_pattern_first_vertex;
+
+// Points, line lists and triangle strips with primitive restart.
+constexpr auto s_sequential_pattern = MakePattern<8>({0}, 1);
+// The vertices of triangle lists without primitive restart, in blocks of whole triangles.
+constexpr auto s_list_pattern = MakePattern<24>({0}, 1);
+constexpr auto s_list_pr_pattern = MakePattern<8>({0, 1, 2, R}, 3);
+constexpr auto s_strip_pattern = MakePattern<24>({0, 1, 2, 1, 3, 2}, 2);
+constexpr auto s_fan_pattern = MakePattern<24>({F, 1, 2}, 1);
+constexpr auto s_fan_pr_pattern = MakePattern<24>({1, 2, F, 3, 4, R}, 3);
+constexpr auto s_quads_pattern = MakePattern<24>({0, 1, 2, 0, 2, 3}, 4);
+constexpr auto s_quads_pr_pattern = MakePattern<40>({1, 2, 0, 3, R}, 4);
+constexpr auto s_line_strip_pattern = MakePattern<8>({0, 1}, 1);
+
+// Returns the number of times the pattern fits into the vertices from first_vertex on.
+template <size_t N>
+u32 GetRepetitions(const IndexPattern<N>& pattern, u32 num_verts, u32 first_vertex)
+{
+  return num_verts > first_vertex ? (num_verts - first_vertex) / pattern.vertices : 0;
+}
+
+// Writes the given number of repetitions of a pattern, starting with the vertex at index.
+template <size_t N>
+u16* WritePattern(u16* index_ptr, const IndexPattern<N>& pattern, u32 index, u32 repetitions)
+{
+#if defined(_M_X86)
+  constexpr size_t VECTORS = N / 8;
+  const __m128i base = _mm_set1_epi16(static_cast<s16>(index));
+  __m128i values[VECTORS];
+  __m128i steps[VECTORS];
+  for (size_t i = 0; i < VECTORS; ++i)
+  {
+    const __m128i offsets =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pattern.offsets[i * 8]));
+    const __m128i mask =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pattern.index_mask[i * 8]));
+    values[i] = _mm_add_epi16(offsets, _mm_and_si128(base, mask));
+    steps[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pattern.steps[i * 8]));
+  }
+
+  for (u32 r = 0; r < repetitions; ++r)
+  {
+    for (size_t i = 0; i < VECTORS; ++i)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(index_ptr + i * 8), values[i]);
+      values[i] = _mm_add_epi16(values[i], steps[i]);
+    }
+    index_ptr += N;
+  }
+#elif defined(_M_ARM_64)
+  constexpr size_t VECTORS = N / 8;
+  const uint16x8_t base = vdupq_n_u16(static_cast<u16>(index));
+  uint16x8_t values[VECTORS];
+  uint16x8_t steps[VECTORS];
+  for (size_t i = 0; i < VECTORS; ++i)
+  {
+    const uint16x8_t offsets = vld1q_u16(&pattern.offsets[i * 8]);
+    const uint16x8_t mask = vld1q_u16(&pattern.index_mask[i * 8]);
+    values[i] = vaddq_u16(offsets, vandq_u16(base, mask));
+    steps[i] = vld1q_u16(&pattern.steps[i * 8]);
+  }
+
+  for (u32 r = 0; r < repetitions; ++r)
+  {
+    for (size_t i = 0; i < VECTORS; ++i)
+    {
+      vst1q_u16(index_ptr + i * 8, values[i]);
+      values[i] = vaddq_u16(values[i], steps[i]);
+    }
+    index_ptr += N;
+  }
+#else
+  std::array<u16, N> values;
+  for (size_t i = 0; i < N; ++i)
+    values[i] = static_cast<u16>(pattern.offsets[i] + (index & pattern.index_mask[i]));
+
+  for (u32 r = 0; r < repetitions; ++r)
+  {
+    for (size_t i = 0; i < N; ++i)
+    {
+      index_ptr[i] = values[i];
+      values[i] += pattern.steps[i];
+    }
+    index_ptr += N;
+  }
+#endif
+
+  return index_ptr;
+}
+
 template <bool pr>
 u16* WriteTriangle(u16* index_ptr, u32 index1, u32 index2, u32 index3)
 {
@@ -31,7 +174,21 @@ u16* WriteTriangle(u16* index_ptr, u32 index1, u32 index2, u32 index3)
 template <bool pr>
 u16* AddList(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 2; i < num_verts; i += 3)
+  u32 i = 2;
+  if constexpr (pr)
+  {
+    const u32 repetitions = GetRepetitions(s_list_pr_pattern, num_verts, 0);
+    index_ptr = WritePattern(index_ptr, s_list_pr_pattern, index, repetitions);
+    i += repetitions * s_list_pr_pattern.vertices;
+  }
+  else
+  {
+    const u32 repetitions = GetRepetitions(s_list_pattern, num_verts, 0);
+    index_ptr = WritePattern(index_ptr, s_list_pattern, index, repetitions);
+    i += repetitions * s_list_pattern.vertices;
+  }
+
+  for (; i < num_verts; i += 3)
   {
     index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - 1, index + i);
   }
@@ -43,7 +200,10 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
 {
   if constexpr (pr)
   {
-    for (u32 i = 0; i < num_verts; ++i)
+    const u32 repetitions = GetRepetitions(s_sequential_pattern, num_verts, 0);
+    index_ptr = WritePattern(index_ptr, s_sequential_pattern, index, repetitions);
+
+    for (u32 i = repetitions * s_sequential_pattern.vertices; i < num_verts; ++i)
     {
       *index_ptr++ = index + i;
     }
@@ -51,8 +211,12 @@ u16* AddStrip(u16* index_ptr, u32 num_verts, u32 index)
   }
   else
   {
+    // The pattern contains an even number of triangles, so the winding starts over after it.
+    const u32 repetitions = GetRepetitions(s_strip_pattern, num_verts, 2);
+    index_ptr = WritePattern(index_ptr, s_strip_pattern, index, repetitions);
+
     bool wind = false;
-    for (u32 i = 2; i < num_verts; ++i)
+    for (u32 i = 2 + repetitions * s_strip_pattern.vertices; i < num_verts; ++i)
     {
       index_ptr = WriteTriangle<pr>(index_ptr, index + i - 2, index + i - !wind, index + i - wind);
 
@@ -88,6 +252,10 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
 
   if constexpr (pr)
   {
+    const u32 repetitions = GetRepetitions(s_fan_pr_pattern, num_verts, 2);
+    index_ptr = WritePattern(index_ptr, s_fan_pr_pattern, index, repetitions);
+    i += repetitions * s_fan_pr_pattern.vertices;
+
     for (; i + 3 <= num_verts; i += 3)
     {
       *index_ptr++ = index + i - 1;
@@ -107,6 +275,12 @@ u16* AddFan(u16* index_ptr, u32 num_verts, u32 index)
       *index_ptr++ = s_primitive_restart;
     }
   }
+  else
+  {
+    const u32 repetitions = GetRepetitions(s_fan_pattern, num_verts, 2);
+    index_ptr = WritePattern(index_ptr, s_fan_pattern, index, repetitions);
+    i += repetitions * s_fan_pattern.vertices;
+  }
 
   for (; i < num_verts; ++i)
   {
@@ -136,6 +310,19 @@ template <bool pr>
 u16* AddQuads(u16* index_ptr, u32 num_verts, u32 index)
 {
   u32 i = 3;
+  if constexpr (pr)
+  {
+    const u32 repetitions = GetRepetitions(s_quads_pr_pattern, num_verts, 0);
+    index_ptr = WritePattern(index_ptr, s_quads_pr_pattern, index, repetitions);
+    i += repetitions * s_quads_pr_pattern.vertices;
+  }
+  else
+  {
+    const u32 repetitions = GetRepetitions(s_quads_pattern, num_verts, 0);
+    index_ptr = WritePattern(index_ptr, s_quads_pattern, index, repetitions);
+    i += repetitions * s_quads_pattern.vertices;
+  }
+
   for (; i < num_verts; i += 4)
   {
     if constexpr (pr)
@@ -171,7 +358,10 @@ u16* AddQuads_nonstandard(u16* index_ptr, u32 num_verts, u32 index)
 
 u16* AddLineList(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 1; i < num_verts; i += 2)
+  const u32 repetitions = GetRepetitions(s_sequential_pattern, num_verts, 0);
+  index_ptr = WritePattern(index_ptr, s_sequential_pattern, index, repetitions);
+
+  for (u32 i = 1 + repetitions * s_sequential_pattern.vertices; i < num_verts; i += 2)
   {
     *index_ptr++ = index + i - 1;
     *index_ptr++ = index + i;
@@ -183,7 +373,10 @@ u16* AddLineList(u16* index_ptr, u32 num_verts, u32 index)
 // so converting them to lists
 u16* AddLineStrip(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 1; i < num_verts; ++i)
+  const u32 repetitions = GetRepetitions(s_line_strip_pattern, num_verts, 1);
+  index_ptr = WritePattern(index_ptr, s_line_strip_pattern, index, repetitions);
+
+  for (u32 i = 1 + repetitions * s_line_strip_pattern.vertices; i < num_verts; ++i)
   {
     *index_ptr++ = index + i - 1;
     *index_ptr++ = index + i;
@@ -193,7 +386,10 @@ u16* AddLineStrip(u16* index_ptr, u32 num_verts, u32 index)
 
 u16* AddPoints(u16* index_ptr, u32 num_verts, u32 index)
 {
-  for (u32 i = 0; i != num_verts; ++i)
+  const u32 repetitions = GetRepetitions(s_sequential_pattern, num_verts, 0);
+  index_ptr = WritePattern(index_ptr, s_sequential_pattern, index, repetitions);
+
+  for (u32 i = repetitions * s_sequential_pattern.vertices; i != num_verts; ++i)
   {
     *index_ptr++ = index + i;
   }
@@ -201,9 +397,9 @@ u16* AddPoints(u16* index_ptr, u32 num_verts, u32 index)
 }
 }  // Anonymous namespace
 
-void IndexGenerator::Init()
+void IndexGenerator::Init(bool primitive_restart)
 {
-  if (g_Config.backend_info.bSupportsPrimitiveRestart)
+  if (primitive_restart)
   {
     m_primitive_table[OpcodeDecoder::GX_DRAW_QUADS] = AddQuads<true>;
     m_primitive_table[OpcodeDecoder::GX_DRAW_QUADS_2] = AddQuads_nonstandard<true>;
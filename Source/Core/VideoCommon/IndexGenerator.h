@@ -13,7 +13,9 @@
 class IndexGenerator
 {
 public:
-  void Init();
+  // Selects the generators for backends with or without support for primitive restart. Without
+  // it, strips and fans are split into separate triangles.
+  void Init(bool primitive_restart);
   void Start(u16* index_ptr);
 
   void AddIndices(int primitive, u32 num_vertices);
@@ -13,6 +13,8 @@
 // m_components
 enum
 {
+  // The vertices have an index into the draw matrices instead of a position matrix index.
+  VB_HAS_DRAWMTXIDX = (1 << 0),
   VB_HAS_POSMTXIDX = (1 << 1),
   VB_HAS_TEXMTXIDX0 = (1 << 2),
   VB_HAS_TEXMTXIDX1 = (1 << 3),
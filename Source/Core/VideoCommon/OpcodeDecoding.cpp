@@ -15,7 +15,13 @@
 
 #include "VideoCommon/OpcodeDecoding.h"
 
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 #include "Common/CommonTypes.h"
+#include "Common/Hash.h"
 #include "Common/Logging/Log.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
 #include "Core/HW/Memmap.h"
@@ -24,16 +30,282 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/GPUThreadProfiler.h"
+#include "VideoCommon/StateWriteQueue.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
 namespace OpcodeDecoder
 {
 namespace
 {
+// Upper bounds for the display list cache, which is cleared when either of them is exceeded.
+constexpr size_t MAX_CACHED_DISPLAY_LISTS = 0x4000;
+constexpr size_t MAX_DISPLAY_LIST_CACHE_SIZE = 64 * 1024 * 1024;
+
+constexpr u32 NO_CACHED_VERTICES = UINT32_MAX;
+
+// A command of a cached display list. Commands without any effect besides taking cycles (e.g.
+// GX_NOP) are left out.
+struct DisplayListCommand
+{
+  u8 cmd_byte;
+  u8 sub_cmd;
+  u16 num_vertices;
+  // BP/CP register value, XF load command or indexed XF load.
+  u32 value;
+  // Offset of the XF data or vertices in the display list.
+  u32 data_offset;
+  // Index into CachedDisplayList::vertices, or NO_CACHED_VERTICES for draws that use indexed
+  // attributes, which depend on memory outside the display list.
+  u32 cached_vertices;
+};
+
+enum class DisplayListState
+{
+  // Called for the first time with these contents. Display lists are only recorded when they are
+  // called again, as games build many of them for a single use.
+  New,
+  Seen,
+  Recorded,
+  // Can't be replayed, because it is cut off or contains unknown opcodes.
+  Uncacheable,
+};
+
+struct CachedDisplayList
+{
+  DisplayListState state = DisplayListState::New;
+  u64 hash = 0;
+  std::optional<u64> write_stamp;
+  // The vertex formats when the display list was called. They decide the size of its vertices,
+  // and thereby how it is parsed.
+  TVtxDesc vtx_desc;
+  VAT vtx_attr[8];
+
+  u32 cycles = 0;
+  size_t memory_size = 0;
+  std::vector<DisplayListCommand> commands;
+  std::vector<VertexLoaderManager::CachedVertices> vertices;
+};
+
 bool s_is_fifo_error_seen = false;
 
+std::unordered_map<u64, CachedDisplayList> s_display_list_cache;
+size_t s_display_list_cache_size = 0;
+// The display list that Run is recording commands for, if any.
+CachedDisplayList* s_recording_display_list = nullptr;
+const u8* s_recording_start_address = nullptr;
+
+bool UseDisplayListCache()
+{
+  // The deterministic GPU thread runs display lists from copies in the FIFO aux buffer, and the
+  // FIFO recorder needs to see each command.
+  return g_ActiveConfig.bDisplayListCache && !Fifo::UseDeterministicGPUThread() &&
+         !g_record_fifo_data;
+}
+
+bool HasSameVertexFormats(const CachedDisplayList& list)
+{
+  return list.vtx_desc.Hex == g_main_cp_state.vtx_desc.Hex &&
+         std::memcmp(list.vtx_attr, g_main_cp_state.vtx_attr, sizeof(list.vtx_attr)) == 0;
+}
+
+CachedDisplayList& LookUpDisplayList(u32 address, const u8* start_address, u32 size)
+{
+  if (s_display_list_cache.size() >= MAX_CACHED_DISPLAY_LISTS ||
+      s_display_list_cache_size > MAX_DISPLAY_LIST_CACHE_SIZE)
+  {
+    ClearDisplayListCache();
+  }
+
+  CachedDisplayList& list = s_display_list_cache[(static_cast<u64>(address) << 32) | size];
+  const bool is_new = list.state == DisplayListState::New;
+  if (!is_new && HasSameVertexFormats(list) && list.write_stamp &&
+      Memory::IsUnmodifiedSince(address, size, *list.write_stamp))
+  {
+    return list;
+  }
+
+  // Start tracking before hashing, so that a write which races with the hashing is seen next time.
+  const std::optional<u64> write_stamp = Memory::TrackWrites(address, size);
+  const u64 hash = Common::GetHash64(start_address, size, 0);
+  if (!is_new && HasSameVertexFormats(list) && list.hash == hash)
+  {
+    list.write_stamp = write_stamp;
+    return list;
+  }
+
+  s_display_list_cache_size -= list.memory_size;
+  list = {};
+  list.hash = hash;
+  list.write_stamp = write_stamp;
+  list.vtx_desc = g_main_cp_state.vtx_desc;
+  std::memcpy(list.vtx_attr, g_main_cp_state.vtx_attr, sizeof(list.vtx_attr));
+  return list;
+}
+
+// Called by Run after each command of a display list that is being recorded.
+void RecordCommand(CachedDisplayList* list, u8 cmd_byte, u8* opcode_start, u8* opcode_end)
+{
+  DataReader src(opcode_start + 1, opcode_end);
+  DisplayListCommand command{cmd_byte, 0, 0, 0, 0, NO_CACHED_VERTICES};
+  switch (cmd_byte)
+  {
+  case GX_NOP:
+  case GX_UNKNOWN_RESET:
+  case GX_CMD_CALL_DL:
+  case GX_CMD_UNKNOWN_METRICS:
+  case GX_CMD_INVL_VC:
+    return;
+
+  case GX_LOAD_CP_REG:
+    command.sub_cmd = src.Read<u8>();
+    command.value = src.Read<u32>();
+    break;
+
+  case GX_LOAD_XF_REG:
+    command.value = src.Read<u32>();
+    command.data_offset = static_cast<u32>(src.GetPointer() - s_recording_start_address);
+    break;
+
+  case GX_LOAD_INDX_A:
+  case GX_LOAD_INDX_B:
+  case GX_LOAD_INDX_C:
+  case GX_LOAD_INDX_D:
+  case GX_LOAD_BP_REG:
+    command.value = src.Read<u32>();
+    break;
+
+  default:
+    if ((cmd_byte & 0xC0) != 0x80)
+    {
+      list->state = DisplayListState::Uncacheable;
+      return;
+    }
+
+    command.num_vertices = src.Read<u16>();
+    command.data_offset = static_cast<u32>(src.GetPointer() - s_recording_start_address);
+    // Run added an entry to the vertices for the draw, which is left empty if the vertices
+    // couldn't be stored.
+    if (list->vertices.back().count != 0)
+      command.cached_vertices = static_cast<u32>(list->vertices.size() - 1);
+    else
+      list->vertices.pop_back();
+    break;
+  }
+
+  list->commands.push_back(command);
+}
+
+void ReplayDisplayList(const CachedDisplayList& list, u8* start_address, u32 size)
+{
+  u8* const end_address = start_address + size;
+  for (const DisplayListCommand& command : list.commands)
+  {
+    switch (command.cmd_byte)
+    {
+    case GX_LOAD_CP_REG:
+      StateWriteQueue::Apply();
+      LoadCPReg(command.sub_cmd, command.value);
+      INCSTAT(g_stats.this_frame.num_cp_loads);
+      break;
+
+    case GX_LOAD_XF_REG:
+    {
+      const u32 transfer_size = ((command.value >> 16) & 15) + 1;
+      const u32 xf_address = command.value & 0xFFFF;
+      StateWriteQueue::PushXF(transfer_size, xf_address,
+                              DataReader(start_address + command.data_offset, end_address));
+      INCSTAT(g_stats.this_frame.num_xf_loads);
+    }
+    break;
+
+    case GX_LOAD_INDX_A:
+    case GX_LOAD_INDX_B:
+    case GX_LOAD_INDX_C:
+    case GX_LOAD_INDX_D:
+      StateWriteQueue::PushIndexedXF(command.value, (command.cmd_byte / 8) + 8);
+      break;
+
+    case GX_LOAD_BP_REG:
+      StateWriteQueue::PushBP(command.value);
+      INCSTAT(g_stats.this_frame.num_bp_loads);
+      break;
+
+    default:
+    {
+      const int vtx_attr_group = command.cmd_byte & GX_VAT_MASK;
+      const int primitive = (command.cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT;
+      StateWriteQueue::Apply();
+      if (command.cached_vertices == NO_CACHED_VERTICES ||
+          !VertexLoaderManager::RunCachedVertices(vtx_attr_group, primitive,
+                                                  list.vertices[command.cached_vertices]))
+      {
+        VertexLoaderManager::RunVertices(vtx_attr_group, primitive, command.num_vertices,
+                                         DataReader(start_address + command.data_offset,
+                                                    end_address),
+                                         false);
+      }
+    }
+    break;
+    }
+  }
+}
+
+u32 RunCachedDisplayList(u32 address, u8* start_address, u32 size)
+{
+  CachedDisplayList& list = LookUpDisplayList(address, start_address, size);
+  u32 cycles = 0;
+  switch (list.state)
+  {
+  case DisplayListState::New:
+    Run(DataReader(start_address, start_address + size), &cycles, true);
+    list.state = DisplayListState::Seen;
+    break;
+
+  case DisplayListState::Seen:
+  {
+    s_recording_display_list = &list;
+    s_recording_start_address = start_address;
+    list.state = DisplayListState::Recorded;
+    const u8* const end = Run(DataReader(start_address, start_address + size), &cycles, true);
+    s_recording_display_list = nullptr;
+
+    if (end != start_address + size)
+      list.state = DisplayListState::Uncacheable;
+
+    if (list.state == DisplayListState::Recorded)
+    {
+      list.cycles = cycles;
+      list.memory_size = list.commands.size() * sizeof(DisplayListCommand);
+      for (const VertexLoaderManager::CachedVertices& vertices : list.vertices)
+        list.memory_size += vertices.data.size();
+      s_display_list_cache_size += list.memory_size;
+    }
+    else
+    {
+      list.commands = {};
+      list.vertices = {};
+    }
+  }
+  break;
+
+  case DisplayListState::Recorded:
+    ReplayDisplayList(list, start_address, size);
+    cycles = list.cycles;
+    INCSTAT(g_stats.this_frame.num_dlists_replayed);
+    break;
+
+  case DisplayListState::Uncacheable:
+    Run(DataReader(start_address, start_address + size), &cycles, true);
+    break;
+  }
+
+  return cycles;
+}
+
 u32 InterpretDisplayList(u32 address, u32 size)
 {
   u8* start_address;
@@ -51,7 +323,17 @@ u32 InterpretDisplayList(u32 address, u32 size)
     // temporarily swap dl and non-dl (small "hack" for the stats)
     g_stats.SwapDL();
 
-    Run(DataReader(start_address, start_address + size), &cycles, true);
+    if (UseDisplayListCache())
+    {
+      cycles = RunCachedDisplayList(address, start_address, size);
+    }
+    else
+    {
+      if (!s_display_list_cache.empty() && !g_ActiveConfig.bDisplayListCache)
+        ClearDisplayListCache();
+
+      Run(DataReader(start_address, start_address + size), &cycles, true);
+    }
     INCSTAT(g_stats.this_frame.num_dlists_called);
 
     // un-swap
@@ -76,22 +358,45 @@ void InterpretDisplayListPreprocess(u32 address, u32 size)
 
 bool g_record_fifo_data = false;
 
+void ClearDisplayListCache()
+{
+  s_display_list_cache.clear();
+  s_display_list_cache_size = 0;
+}
+
 void Init()
 {
   s_is_fifo_error_seen = false;
+  ClearDisplayListCache();
+  StateWriteQueue::Init();
 }
 
 template <bool is_preprocess>
 u8* Run(DataReader src, u32* cycles, bool in_display_list)
 {
+  using GPUThreadProfiler::Section;
+  GPUThreadProfiler::ScopedSection profile_section(is_preprocess ? Section::None :
+                                                                   Section::OpcodeDecoding);
+
   u32 total_cycles = 0;
   u8* opcode_start = nullptr;
 
-  const auto finish_up = [cycles, &opcode_start, &total_cycles] {
+  const auto finish_up = [cycles, &opcode_start, &total_cycles, in_display_list] {
     if (cycles != nullptr)
     {
       *cycles = total_cycles;
     }
+
+    // Anything outside of Run may use the BP/XF state, and the vertex loaders read from the FIFO
+    // buffer, which can be overwritten once we return.
+    if constexpr (!is_preprocess)
+    {
+      if (!in_display_list)
+      {
+        StateWriteQueue::Apply();
+        VertexLoaderManager::WaitForPendingVertices();
+      }
+    }
     return opcode_start;
   };
 
@@ -123,6 +428,8 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
 
       const u8 sub_cmd = src.Read<u8>();
       const u32 value = src.Read<u32>();
+      if constexpr (!is_preprocess)
+        StateWriteQueue::Apply();
       LoadCPReg(sub_cmd, value, is_preprocess);
       if constexpr (!is_preprocess)
         INCSTAT(g_stats.this_frame.num_cp_loads);
@@ -144,7 +451,7 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
       if constexpr (!is_preprocess)
       {
         const u32 xf_address = cmd2 & 0xFFFF;
-        LoadXFReg(transfer_size, xf_address, src);
+        StateWriteQueue::PushXF(transfer_size, xf_address, src);
 
         INCSTAT(g_stats.this_frame.num_xf_loads);
       }
@@ -172,7 +479,7 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
       if constexpr (is_preprocess)
         PreprocessIndexedXF(src.Read<u32>(), ref_array);
       else
-        LoadIndexedXF(src.Read<u32>(), ref_array);
+        StateWriteQueue::PushIndexedXF(src.Read<u32>(), ref_array);
     }
     break;
 
@@ -226,7 +533,7 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
         }
         else
         {
-          LoadBPReg(bp_cmd);
+          StateWriteQueue::PushBP(bp_cmd);
           INCSTAT(g_stats.this_frame.num_bp_loads);
         }
       }
@@ -240,10 +547,19 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
         if (src.size() < 2)
           return finish_up();
 
+        VertexLoaderManager::CachedVertices* cached_vertices = nullptr;
+        if constexpr (!is_preprocess)
+        {
+          StateWriteQueue::Apply();
+          if (s_recording_display_list != nullptr)
+            cached_vertices = &s_recording_display_list->vertices.emplace_back();
+        }
+
         const u16 num_vertices = src.Read<u16>();
         const int bytes = VertexLoaderManager::RunVertices(
             cmd_byte & GX_VAT_MASK,  // Vertex loader index (0 - 7)
-            (cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT, num_vertices, src, is_preprocess);
+            (cmd_byte & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT, num_vertices, src, is_preprocess,
+            cached_vertices);
 
         if (bytes < 0)
           return finish_up();
@@ -273,6 +589,9 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
         const u8* const opcode_end = src.GetPointer();
         FifoRecorder::GetInstance().WriteGPCommand(opcode_start, u32(opcode_end - opcode_start));
       }
+
+      if (s_recording_display_list != nullptr)
+        RecordCommand(s_recording_display_list, cmd_byte, opcode_start, src.GetPointer());
     }
   }
 }
@@ -55,6 +55,10 @@ enum
 
 void Init();
 
+// Drops all cached display lists, e.g. when they were recorded with settings that affect how the
+// cached commands are replayed.
+void ClearDisplayListCache();
+
 template <bool is_preprocess = false>
 u8* Run(DataReader src, u32* cycles, bool in_display_list);
 
@@ -0,0 +1,121 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/ParallelTextureDecoder.h"
+
+#include <algorithm>
+
+#include "Common/Thread.h"
+
+// The emulated CPU and the GPU thread (which takes part in decoding) already keep two cores busy.
+static constexpr u32 RESERVED_CORES = 2;
+static constexpr u32 MAX_THREADS = 4;
+
+ParallelTextureDecoder::ParallelTextureDecoder(u32 num_threads)
+{
+  for (u32 i = 0; i < num_threads; ++i)
+    m_threads.emplace_back(&ParallelTextureDecoder::WorkerThread, this);
+}
+
+ParallelTextureDecoder::~ParallelTextureDecoder()
+{
+  {
+    std::lock_guard lk(m_mutex);
+    m_shutdown = true;
+  }
+  m_job_available.notify_all();
+
+  for (std::thread& thread : m_threads)
+    thread.join();
+}
+
+u32 ParallelTextureDecoder::GetDefaultThreadCount()
+{
+  const u32 cores = std::thread::hardware_concurrency();
+  return cores > RESERVED_CORES ? std::min(cores - RESERVED_CORES, MAX_THREADS) : 0;
+}
+
+void ParallelTextureDecoder::Decode(u8* dst, const u8* src, u32 width, u32 height,
+                                    TextureFormat format, const u8* tlut, TLUTFormat tlut_format)
+{
+  const u32 block_height = TexDecoder_GetBlockHeightInTexels(format);
+  const u32 block_rows = height / block_height;
+  const u32 num_jobs =
+      std::clamp<u32>(width * height / MIN_TEXELS_PER_JOB, 1, std::max<u32>(block_rows, 1));
+
+  {
+    std::lock_guard lk(m_mutex);
+    m_queued_textures.push_back({dst, src, tlut, width, height, format, tlut_format});
+
+    if (num_jobs == 1)
+    {
+      m_jobs.push_back({dst, src, tlut, width, height, format, tlut_format});
+    }
+    else
+    {
+      // Textures are stored as rows of blocks, so each band of block rows can be decoded on its
+      // own. The last band also gets any rows that don't divide evenly.
+      const u32 src_row_size = TexDecoder_GetTextureSizeInBytes(width, block_height, format);
+      const u32 dst_row_size = width * block_height * sizeof(u32);
+      const u32 rows_per_job = block_rows / num_jobs;
+      for (u32 i = 0; i < num_jobs; ++i)
+      {
+        const u32 first_row = i * rows_per_job;
+        const u32 job_height =
+            i + 1 == num_jobs ? height - first_row * block_height : rows_per_job * block_height;
+        m_jobs.push_back({dst + first_row * dst_row_size, src + first_row * src_row_size, tlut,
+                          width, job_height, format, tlut_format});
+      }
+    }
+  }
+
+  // Small textures are left for the flushing thread, waking up a worker isn't worth it for them.
+  if (num_jobs > 1)
+    m_job_available.notify_all();
+  else if (width * height >= MIN_TEXELS_PER_JOB)
+    m_job_available.notify_one();
+}
+
+void ParallelTextureDecoder::Flush()
+{
+  std::unique_lock lk(m_mutex);
+  while (!m_jobs.empty())
+    RunJob(lk);
+  m_jobs_done.wait(lk, [this] { return m_running_jobs == 0; });
+
+  for (const Job& texture : m_queued_textures)
+    TexDecoder_DrawOverlay(texture.dst, texture.width, texture.height, texture.format);
+  m_queued_textures.clear();
+}
+
+void ParallelTextureDecoder::WorkerThread()
+{
+  Common::SetCurrentThreadName("Texture Decoder");
+
+  std::unique_lock lk(m_mutex);
+  while (true)
+  {
+    m_job_available.wait(lk, [this] { return m_shutdown || !m_jobs.empty(); });
+    if (m_shutdown)
+      return;
+
+    RunJob(lk);
+  }
+}
+
+void ParallelTextureDecoder::RunJob(std::unique_lock<std::mutex>& lock)
+{
+  const Job job = m_jobs.front();
+  m_jobs.pop_front();
+  m_running_jobs++;
+  lock.unlock();
+
+  _TexDecoder_DecodeImpl(reinterpret_cast<u32*>(job.dst), job.src, job.width, job.height,
+                         job.format, job.tlut, job.tlut_format);
+
+  lock.lock();
+  m_running_jobs--;
+  if (m_running_jobs == 0 && m_jobs.empty())
+    m_jobs_done.notify_all();
+}
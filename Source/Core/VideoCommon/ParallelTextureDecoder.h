@@ -0,0 +1,69 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/TextureDecoder.h"
+
+// Decodes textures on a pool of worker threads. Large textures are split into bands of block rows,
+// so that a single texture is decoded by several threads, and all textures queued before a call to
+// Flush (e.g. every level of a mip chain) are decoded concurrently. The thread calling Flush helps
+// with the decoding rather than sitting idle.
+class ParallelTextureDecoder
+{
+public:
+  // Textures with fewer texels than this are decoded as a single job.
+  static constexpr u32 MIN_TEXELS_PER_JOB = 256 * 128;
+
+  // Creates the worker threads. With a thread count of zero, all decoding happens in Flush.
+  explicit ParallelTextureDecoder(u32 num_threads = GetDefaultThreadCount());
+  ~ParallelTextureDecoder();
+
+  ParallelTextureDecoder(const ParallelTextureDecoder&) = delete;
+  ParallelTextureDecoder& operator=(const ParallelTextureDecoder&) = delete;
+
+  static u32 GetDefaultThreadCount();
+
+  // Queues a texture to be decoded, with the same parameters as TexDecoder_Decode. The source
+  // data, palette and destination must remain valid until Flush has returned.
+  void Decode(u8* dst, const u8* src, u32 width, u32 height, TextureFormat format, const u8* tlut,
+              TLUTFormat tlut_format);
+
+  // Blocks until every queued texture has been decoded.
+  void Flush();
+
+private:
+  struct Job
+  {
+    u8* dst;
+    const u8* src;
+    const u8* tlut;
+    u32 width;
+    u32 height;
+    TextureFormat format;
+    TLUTFormat tlut_format;
+  };
+
+  void WorkerThread();
+  void RunJob(std::unique_lock<std::mutex>& lock);
+
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_job_available;
+  std::condition_variable m_jobs_done;
+  std::deque<Job> m_jobs;
+  u32 m_running_jobs = 0;
+  bool m_shutdown = false;
+
+  // Whole textures queued since the last flush. The format overlay can only be drawn once every
+  // band of a texture has been decoded.
+  std::vector<Job> m_queued_textures;
+};
@@ -0,0 +1,226 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/ParallelVertexLoader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Common/Thread.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/VertexLoaderBase.h"
+#include "VideoCommon/VertexLoaderManager.h"
+
+// The emulated CPU and the GPU thread (which takes part in converting) already keep two cores busy.
+static constexpr u32 RESERVED_CORES = 2;
+static constexpr u32 MAX_THREADS = 4;
+
+// The vertex loaders can write up to 4 bytes past the last vertex.
+static constexpr u32 VERTEX_LOADER_OVERRUN = 4;
+
+// Number of vertices that the zfreeze positions are stored for.
+static constexpr int ZFREEZE_VERTICES = 3;
+
+static void ConvertVertices(VertexLoaderBase* loader, const u8* src, u8* dst, int count)
+{
+  if (count == 0)
+    return;
+
+  const u32 src_size = count * loader->m_VertexSize;
+  const u32 dst_size = count * loader->m_native_vtx_decl.stride + VERTEX_LOADER_OVERRUN;
+  loader->RunVertices(DataReader(const_cast<u8*>(src), const_cast<u8*>(src) + src_size),
+                      DataReader(dst, dst + dst_size), count);
+}
+
+ParallelVertexLoader::ParallelVertexLoader(u32 num_threads)
+{
+  for (u32 i = 0; i < num_threads; ++i)
+    m_threads.emplace_back(&ParallelVertexLoader::WorkerThread, this);
+}
+
+ParallelVertexLoader::~ParallelVertexLoader()
+{
+  {
+    std::lock_guard lk(m_mutex);
+    m_shutdown = true;
+  }
+  m_job_available.notify_all();
+
+  for (std::thread& thread : m_threads)
+    thread.join();
+}
+
+u32 ParallelVertexLoader::GetDefaultThreadCount()
+{
+  const u32 cores = std::thread::hardware_concurrency();
+  return cores > RESERVED_CORES ? std::min(cores - RESERVED_CORES, MAX_THREADS) : 0;
+}
+
+int ParallelVertexLoader::RunVertices(VertexLoaderBase* loader, DataReader src_reader,
+                                      DataReader dst_reader, int count)
+{
+  const int num_jobs =
+      std::min(count / MIN_VERTICES_PER_JOB, static_cast<int>(m_threads.size()) + 1);
+  if (!m_busy && num_jobs < 2)
+    return loader->RunVertices(src_reader, dst_reader, count);
+
+  // Skipped vertices change the number of vertices in the buffer, which is needed right away.
+  const u8* const src = src_reader.GetPointer();
+  if (!loader->CanRunConcurrently() || loader->HasSkippedVertices(src, count))
+  {
+    WaitForCompletion();
+    return loader->RunVertices(src_reader, dst_reader, count);
+  }
+
+  u8* const dst = dst_reader.GetPointer();
+
+  if (!m_busy)
+  {
+    std::memcpy(m_position_cache, VertexLoaderManager::position_cache, sizeof(m_position_cache));
+    std::memcpy(m_position_matrix_index, VertexLoaderManager::position_matrix_index,
+                sizeof(m_position_matrix_index));
+    m_busy = true;
+  }
+
+  if (num_jobs < 2)
+  {
+    ConvertOnThisThread(loader, src, dst, count, nullptr);
+    return count;
+  }
+
+  // The calling thread converts the last part of the draw, so that the positions for zfreeze
+  // come from it.
+  const u32 src_stride = loader->m_VertexSize;
+  const u32 dst_stride = loader->m_native_vtx_decl.stride;
+  const int vertices_per_job = count / num_jobs;
+  const int local_start = (num_jobs - 1) * vertices_per_job;
+  {
+    std::lock_guard lk(m_mutex);
+    for (int i = 0; i < num_jobs - 1; ++i)
+    {
+      const int start = i * vertices_per_job;
+      u8* const job_dst = dst + start * dst_stride;
+      m_jobs.push_back({loader, src + start * src_stride, job_dst, vertices_per_job,
+                        i == 0 ? nullptr : AddDeferredCopy(job_dst, dst_stride)});
+    }
+  }
+  m_job_available.notify_all();
+
+  u8* const local_dst = dst + local_start * dst_stride;
+  ConvertOnThisThread(loader, src + local_start * src_stride, local_dst, count - local_start,
+                      AddDeferredCopy(local_dst, dst_stride));
+  return count;
+}
+
+void ParallelVertexLoader::SetZFreezePositions(const PortableVertexDeclaration& decl,
+                                               const u8* vertices, int count)
+{
+  // The positions are stored in reverse order, starting with the last vertex.
+  for (int i = 0; i < std::min(count, ZFREEZE_VERTICES); ++i)
+  {
+    const u8* const vertex = vertices + (count - 1 - i) * decl.stride;
+    std::fill(std::begin(m_position_cache[i]), std::end(m_position_cache[i]), 0.0f);
+    std::memcpy(m_position_cache[i], vertex + decl.position.offset,
+                decl.position.components * sizeof(float));
+    if (decl.posmtx.enable)
+      std::memcpy(&m_position_matrix_index[i + 1], vertex + decl.posmtx.offset, sizeof(u32));
+  }
+}
+
+void ParallelVertexLoader::WaitForCompletion()
+{
+  if (!m_busy)
+    return;
+
+  {
+    std::unique_lock lk(m_mutex);
+    while (!m_jobs.empty())
+      RunJob(lk);
+    m_jobs_done.wait(lk, [this] { return m_running_jobs == 0; });
+  }
+
+  for (const DeferredCopy& copy : m_deferred_copies)
+    std::copy(copy.vertex.begin(), copy.vertex.end() - VERTEX_LOADER_OVERRUN, copy.dst);
+  m_deferred_copies.clear();
+
+  std::memcpy(VertexLoaderManager::position_cache, m_position_cache, sizeof(m_position_cache));
+  std::memcpy(VertexLoaderManager::position_matrix_index, m_position_matrix_index,
+              sizeof(m_position_matrix_index));
+  m_busy = false;
+}
+
+void ParallelVertexLoader::WorkerThread()
+{
+  Common::SetCurrentThreadName("Vertex Loader");
+
+  std::unique_lock lk(m_mutex);
+  while (true)
+  {
+    m_job_available.wait(lk, [this] { return m_shutdown || !m_jobs.empty(); });
+    if (m_shutdown)
+      return;
+
+    RunJob(lk);
+  }
+}
+
+void ParallelVertexLoader::RunJob(std::unique_lock<std::mutex>& lock)
+{
+  const Job job = m_jobs.front();
+  m_jobs.pop_front();
+  m_running_jobs++;
+  lock.unlock();
+
+  if (job.first_vertex)
+  {
+    ConvertVertices(job.loader, job.src, job.first_vertex, 1);
+    ConvertVertices(job.loader, job.src + job.loader->m_VertexSize,
+                    job.dst + job.loader->m_native_vtx_decl.stride, job.count - 1);
+  }
+  else
+  {
+    ConvertVertices(job.loader, job.src, job.dst, job.count);
+  }
+
+  lock.lock();
+  m_running_jobs--;
+  if (m_running_jobs == 0 && m_jobs.empty())
+    m_jobs_done.notify_all();
+}
+
+u8* ParallelVertexLoader::AddDeferredCopy(u8* dst, u32 stride)
+{
+  DeferredCopy& copy = m_deferred_copies.emplace_back();
+  copy.dst = dst;
+  copy.vertex.resize(stride + VERTEX_LOADER_OVERRUN);
+  return copy.vertex.data();
+}
+
+void ParallelVertexLoader::ConvertOnThisThread(VertexLoaderBase* loader, const u8* src, u8* dst,
+                                               int count, u8* first_vertex)
+{
+  const u32 src_stride = loader->m_VertexSize;
+  const u32 dst_stride = loader->m_native_vtx_decl.stride;
+
+  int head = 0;
+  if (first_vertex)
+  {
+    ConvertVertices(loader, src, first_vertex, 1);
+    head = 1;
+  }
+
+  // The vertex loader stores the zfreeze positions where the workers can overwrite them. So the
+  // last vertices are converted to a separate buffer, and the positions are taken from there.
+  const int tail = std::min(count - head, ZFREEZE_VERTICES);
+  const int middle = count - head - tail;
+  ConvertVertices(loader, src + head * src_stride, dst + head * dst_stride, middle);
+
+  const int tail_start = head + middle;
+  m_last_vertices.resize(tail * dst_stride + VERTEX_LOADER_OVERRUN);
+  ConvertVertices(loader, src + tail_start * src_stride, m_last_vertices.data(), tail);
+  std::copy_n(m_last_vertices.data(), tail * dst_stride, dst + tail_start * dst_stride);
+
+  SetZFreezePositions(loader->m_native_vtx_decl, m_last_vertices.data(), tail);
+}
@@ -0,0 +1,96 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+class DataReader;
+class VertexLoaderBase;
+struct PortableVertexDeclaration;
+
+// Converts the vertices of large draws on a pool of worker threads, while the GPU thread moves on
+// to the following commands. Space in the vertex buffer and indices are still allocated in order
+// by the GPU thread, only the vertices themselves are written later. Batches must not be submitted
+// before WaitForCompletion has returned, but are the same as if every draw was converted in place.
+//
+// Vertex loaders read the vertex array pointers and strides from the CP state, which must not be
+// changed while vertices are pending. They also store the positions of the last vertices of each
+// call for zfreeze, which the workers would overwrite with the ones of their part of a draw. So
+// while vertices are pending, the positions of the last draw are tracked separately, and restored
+// by WaitForCompletion.
+class ParallelVertexLoader
+{
+public:
+  // Draws with fewer vertices than twice this are converted on the calling thread.
+  static constexpr int MIN_VERTICES_PER_JOB = 1024;
+
+  // Creates the worker threads. With a thread count of zero, all vertices are converted in place.
+  explicit ParallelVertexLoader(u32 num_threads = GetDefaultThreadCount());
+  ~ParallelVertexLoader();
+
+  ParallelVertexLoader(const ParallelVertexLoader&) = delete;
+  ParallelVertexLoader& operator=(const ParallelVertexLoader&) = delete;
+
+  static u32 GetDefaultThreadCount();
+
+  // Converts count vertices from src to dst, with the same result as loader->RunVertices. The
+  // vertices of large draws are only written once WaitForCompletion has returned.
+  int RunVertices(VertexLoaderBase* loader, DataReader src, DataReader dst, int count);
+
+  // Sets the zfreeze positions from the last of the given converted vertices. Used while busy for
+  // vertices that are written to the buffer without running a vertex loader.
+  void SetZFreezePositions(const PortableVertexDeclaration& decl, const u8* vertices, int count);
+
+  // Returns true if there are vertices that haven't been written yet.
+  bool IsBusy() const { return m_busy; }
+
+  // Blocks until every vertex has been written.
+  void WaitForCompletion();
+
+private:
+  struct Job
+  {
+    VertexLoaderBase* loader;
+    const u8* src;
+    u8* dst;
+    int count;
+    // The first vertex of a job is converted to a separate buffer, since the vertex loaders can
+    // write a few bytes past the vertices they convert, i.e. into the part of another job.
+    u8* first_vertex;
+  };
+
+  struct DeferredCopy
+  {
+    u8* dst;
+    std::vector<u8> vertex;
+  };
+
+  void WorkerThread();
+  void RunJob(std::unique_lock<std::mutex>& lock);
+  u8* AddDeferredCopy(u8* dst, u32 stride);
+  void ConvertOnThisThread(VertexLoaderBase* loader, const u8* src, u8* dst, int count,
+                           u8* first_vertex);
+
+  std::vector<std::thread> m_threads;
+  std::mutex m_mutex;
+  std::condition_variable m_job_available;
+  std::condition_variable m_jobs_done;
+  std::deque<Job> m_jobs;
+  u32 m_running_jobs = 0;
+  bool m_shutdown = false;
+
+  // Only accessed by the thread converting the vertices.
+  bool m_busy = false;
+  std::deque<DeferredCopy> m_deferred_copies;
+  std::vector<u8> m_last_vertices;
+  float m_position_cache[3][4];
+  u32 m_position_matrix_index[4];
+};
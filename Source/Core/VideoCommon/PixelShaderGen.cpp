@@ -4,8 +4,13 @@
 
 #include "VideoCommon/PixelShaderGen.h"
 
+#include <array>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
@@ -451,6 +456,8 @@ void WritePixelShaderCommonHeader(ShaderCode& out, APIType ApiType, u32 num_texg
       out.Write("cbuffer VSBlock : register(b1) {\n");
 
     out.Write(s_shader_uniforms);
+    if (host_config.merge_draws)
+      out.Write(s_draw_matrix_uniforms);
     out.Write("};\n");
   }
 
@@ -939,8 +946,73 @@ ShaderCode GeneratePixelShaderCode(APIType ApiType, const ShaderHostConfig& host
   return out;
 }
 
+namespace
+{
+// Everything that the code of a TEV stage depends on.
+struct StageCacheKey
+{
+  std::array<u8, sizeof(pixel_shader_uid_data::stagehash[0])> stage;
+  u8 n;
+  u8 has_texcoord;
+  u8 api_type;
+  u8 stereo;
+  u8 broken_bitwise_op_negation;
+
+  bool operator==(const StageCacheKey& other) const
+  {
+    return std::memcmp(this, &other, sizeof(*this)) == 0;
+  }
+};
+
+struct StageCacheKeyHash
+{
+  size_t operator()(const StageCacheKey& key) const
+  {
+    return std::hash<std::string_view>()(
+        std::string_view(reinterpret_cast<const char*>(&key), sizeof(key)));
+  }
+};
+
+// Entries are small, but games use a lot of different stages over time.
+constexpr size_t MAX_CACHED_STAGES = 1024;
+}  // namespace
+
+static void WriteStageCode(ShaderCode& out, const pixel_shader_uid_data* uid_data, int n,
+                           APIType ApiType, bool stereo);
+
+// Most shaders of a game share the configurations of their TEV stages, so the code of each stage
+// is only generated once per thread, and copied into the shaders that use it afterwards.
 static void WriteStage(ShaderCode& out, const pixel_shader_uid_data* uid_data, int n,
                        APIType ApiType, bool stereo)
+{
+  static thread_local std::unordered_map<StageCacheKey, std::string, StageCacheKeyHash>
+      s_stage_cache;
+
+  StageCacheKey key;
+  std::memcpy(key.stage.data(), &uid_data->stagehash[n], key.stage.size());
+  key.n = static_cast<u8>(n);
+  key.has_texcoord = uid_data->stagehash[n].tevorders_texcoord < uid_data->genMode_numtexgens;
+  key.api_type = static_cast<u8>(ApiType);
+  key.stereo = stereo;
+  key.broken_bitwise_op_negation =
+      DriverDetails::HasBug(DriverDetails::BUG_BROKEN_BITWISE_OP_NEGATION);
+
+  auto iter = s_stage_cache.find(key);
+  if (iter == s_stage_cache.end())
+  {
+    if (s_stage_cache.size() >= MAX_CACHED_STAGES)
+      s_stage_cache.clear();
+
+    ShaderCode stage_code;
+    WriteStageCode(stage_code, uid_data, n, ApiType, stereo);
+    iter = s_stage_cache.emplace(key, stage_code.GetBuffer()).first;
+  }
+
+  out.Append(iter->second);
+}
+
+static void WriteStageCode(ShaderCode& out, const pixel_shader_uid_data* uid_data, int n,
+                           APIType ApiType, bool stereo)
 {
   auto& stage = uid_data->stagehash[n];
   out.Write("\n\t// TEV stage %d\n", n);
@@ -45,6 +45,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/Host.h"
@@ -86,6 +87,13 @@
 
 std::unique_ptr<Renderer> g_renderer;
 
+// The texture cache and the display list cache skip rehashing memory that write tracking says
+// hasn't been written to.
+static bool UsesWriteTracking(const VideoConfig& config)
+{
+  return config.bWriteTrackedTextureCache || config.bDisplayListCache;
+}
+
 static float AspectToWidescreen(float aspect)
 {
   return aspect * ((16.0f / 9.0f) / (4.0f / 3.0f));
@@ -116,6 +124,7 @@ bool Renderer::Initialize()
   if (!m_post_processor->Initialize(m_backbuffer_format))
     return false;
 
+  Memory::SetWriteTrackingRequested(UsesWriteTracking(g_ActiveConfig));
   return true;
 }
 
@@ -129,6 +138,7 @@ void Renderer::Shutdown()
   ShutdownFrameDumping();
   ShutdownImGui();
   m_post_processor.reset();
+  Memory::SetWriteTrackingRequested(false);
 }
 
 void Renderer::BeginUtilityDrawing()
@@ -408,6 +418,7 @@ void Renderer::CheckForConfigChanges()
 
   // Update texture cache settings with any changed options.
   g_texture_cache->OnConfigChanged(g_ActiveConfig);
+  Memory::SetWriteTrackingRequested(UsesWriteTracking(g_ActiveConfig));
 
   // EFB tile cache doesn't need to notify the backend.
   if (old_efb_access_tile_size != g_ActiveConfig.iEFBAccessTileSize)
@@ -472,6 +483,14 @@ void Renderer::CheckForConfigChanges()
     g_shader_cache->SetHostConfig(new_host_config);
     g_shader_cache->Reload();
     g_framebuffer_manager->RecompileShaders();
+
+    // Vertex loaders with draw matrix indices are only used with draw merging. Cached display
+    // lists hold vertices converted by the old loaders, so they have to be recorded again.
+    if (old_shader_host_config.merge_draws != new_host_config.merge_draws)
+    {
+      VertexLoaderManager::MarkAllDirty();
+      OpcodeDecoder::ClearDisplayListCache();
+    }
   }
 
   // Viewport and scissor rect have to be reset since they will be scaled differently.
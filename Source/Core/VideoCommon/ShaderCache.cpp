@@ -4,6 +4,10 @@
 
 #include "VideoCommon/ShaderCache.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
@@ -22,6 +26,8 @@ std::unique_ptr<VideoCommon::ShaderCache> g_shader_cache;
 
 namespace VideoCommon
 {
+constexpr u32 PIPELINE_USAGE_FILE_MAGIC = 0x45535550;  // PUSE
+
 ShaderCache::ShaderCache() = default;
 ShaderCache::~ShaderCache()
 {
@@ -56,9 +62,9 @@ void ShaderCache::InitializeShaderCache()
     QueueUberShaderPipelines();
 
   // Compile all known UIDs.
-  CompileMissingPipelines();
+  QueueMissingPipelines();
   if (g_ActiveConfig.bWaitForShadersBeforeStarting)
-    WaitForAsyncCompiler();
+    WaitForPrecompiledPipelines();
 
   // Switch to the runtime shader compiler thread configuration.
   m_async_shader_compiler->ResizeWorkerThreads(g_ActiveConfig.GetShaderCompilerThreads());
@@ -67,7 +73,9 @@ void ShaderCache::InitializeShaderCache()
 void ShaderCache::Reload()
 {
   WaitForAsyncCompiler();
-  ClosePipelineUIDCache();
+
+  // The UID cache and the pipeline usage are kept open, so that the usage is only loaded and
+  // halved when the session starts, and only written when it ends.
   ClearCaches();
 
   if (!CompileSharedPipelines())
@@ -82,15 +90,17 @@ void ShaderCache::Reload()
   // We don't need to explicitly recompile the individual ubershaders here, as the pipelines
   // UIDs are still be in the map. Therefore, when these are rebuilt, the shaders will also
   // be recompiled.
-  CompileMissingPipelines();
+  QueueMissingPipelines();
   if (g_ActiveConfig.bWaitForShadersBeforeStarting)
-    WaitForAsyncCompiler();
+    WaitForPrecompiledPipelines();
   m_async_shader_compiler->ResizeWorkerThreads(g_ActiveConfig.GetShaderCompilerThreads());
 }
 
 void ShaderCache::RetrieveAsyncShaders()
 {
   m_async_shader_compiler->RetrieveWorkItems();
+  QueuePrecompiledPipelines();
+  m_frame_count++;
 }
 
 void ShaderCache::Shutdown()
@@ -105,33 +115,32 @@ void ShaderCache::Shutdown()
 
 const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
 {
-  auto it = m_gx_pipeline_cache.find(uid);
-  if (it != m_gx_pipeline_cache.end() && !it->second.second)
-    return it->second.first.get();
+  const auto [it, inserted] = m_gx_pipeline_cache.try_emplace(uid);
+  RecordPipelineUsage(it->second.usage);
+  if (!inserted && !it->second.pending && !it->second.precompile)
+    return it->second.pipeline.get();
 
-  const bool exists_in_cache = it != m_gx_pipeline_cache.end();
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXPipelineConfig(uid);
   if (pipeline_config)
-    pipeline = g_renderer->CreatePipeline(*pipeline_config);
-  if (g_ActiveConfig.bShaderCache && !exists_in_cache)
+    pipeline = CreateGXPipeline(m_gx_pipeline_disk_cache, uid, *pipeline_config);
+  if (g_ActiveConfig.bShaderCache && inserted)
     AppendGXPipelineUID(uid);
   return InsertGXPipeline(uid, std::move(pipeline));
 }
 
 std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const GXPipelineUid& uid)
 {
-  auto it = m_gx_pipeline_cache.find(uid);
-  if (it != m_gx_pipeline_cache.end())
-  {
-    // .second is the pending flag, i.e. compiling in the background.
-    if (!it->second.second)
-      return it->second.first.get();
-    else
-      return {};
-  }
+  const auto [it, inserted] = m_gx_pipeline_cache.try_emplace(uid);
+  RecordPipelineUsage(it->second.usage);
+  if (it->second.pending)
+    return {};
+  if (!inserted && !it->second.precompile)
+    return it->second.pipeline.get();
 
-  AppendGXPipelineUID(uid);
+  // Pipelines from the UID cache that are needed before their turn skip the rest of the queue.
+  if (inserted)
+    AppendGXPipelineUID(uid);
   QueuePipelineCompile(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
   return {};
 }
@@ -139,44 +148,100 @@ std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const
 const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineUid& uid)
 {
   auto it = m_gx_uber_pipeline_cache.find(uid);
-  if (it != m_gx_uber_pipeline_cache.end() && !it->second.second)
-    return it->second.first.get();
+  if (it != m_gx_uber_pipeline_cache.end() && !it->second.pending)
+    return it->second.pipeline.get();
 
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXPipelineConfig(uid);
   if (pipeline_config)
-    pipeline = g_renderer->CreatePipeline(*pipeline_config);
+    pipeline = CreateGXPipeline(m_gx_uber_pipeline_disk_cache, uid, *pipeline_config);
   return InsertGXUberPipeline(uid, std::move(pipeline));
 }
 
+static void DrawCompileProgress(size_t completed, size_t total)
+{
+  g_renderer->BeginUIFrame();
+
+  const float scale = ImGui::GetIO().DisplayFramebufferScale.x;
+
+  ImGui::SetNextWindowSize(ImVec2(400.0f * scale, 50.0f * scale), ImGuiCond_Always);
+  ImGui::SetNextWindowPosCenter(ImGuiCond_Always);
+  if (ImGui::Begin(Common::GetStringT("Compiling Shaders").c_str(), nullptr,
+                   ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoInputs |
+                       ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings |
+                       ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoNav |
+                       ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing))
+  {
+    ImGui::Text("Compiling shaders: %zu/%zu", completed, total);
+    ImGui::ProgressBar(static_cast<float>(completed) /
+                           static_cast<float>(std::max(total, static_cast<size_t>(1))),
+                       ImVec2(-1.0f, 0.0f), "");
+  }
+  ImGui::End();
+
+  g_renderer->EndUIFrame();
+}
+
 void ShaderCache::WaitForAsyncCompiler()
 {
   while (m_async_shader_compiler->HasPendingWork() || m_async_shader_compiler->HasCompletedWork())
   {
-    m_async_shader_compiler->WaitUntilCompletion([](size_t completed, size_t total) {
-      g_renderer->BeginUIFrame();
-
-      const float scale = ImGui::GetIO().DisplayFramebufferScale.x;
-
-      ImGui::SetNextWindowSize(ImVec2(400.0f * scale, 50.0f * scale), ImGuiCond_Always);
-      ImGui::SetNextWindowPosCenter(ImGuiCond_Always);
-      if (ImGui::Begin(Common::GetStringT("Compiling Shaders").c_str(), nullptr,
-                       ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoInputs |
-                           ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoSavedSettings |
-                           ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoNav |
-                           ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing))
-      {
-        ImGui::Text("Compiling shaders: %zu/%zu", completed, total);
-        ImGui::ProgressBar(static_cast<float>(completed) /
-                               static_cast<float>(std::max(total, static_cast<size_t>(1))),
-                           ImVec2(-1.0f, 0.0f), "");
-      }
-      ImGui::End();
+    m_async_shader_compiler->WaitUntilCompletion(DrawCompileProgress);
+    m_async_shader_compiler->RetrieveWorkItems();
+  }
+}
 
-      g_renderer->EndUIFrame();
-    });
+void ShaderCache::WaitForPrecompiledPipelines()
+{
+  // The pipelines are compiled in the order of the queue, so the ones that cover the configured
+  // share of the recorded uses are at the front of it.
+  const int coverage = std::clamp(g_ActiveConfig.iShaderPrecompileCoverage, 0, 100);
+  const u64 required_uses = m_precompile_total_uses * coverage / 100;
+  size_t required_pipelines = 0;
+  for (u64 uses = 0; uses < required_uses && required_pipelines < m_precompile_queue.size();
+       required_pipelines++)
+  {
+    uses += m_gx_pipeline_cache[m_precompile_queue[required_pipelines]].usage.use_count + 1;
+  }
+
+  // Like WaitUntilCompletion, only show the progress after a second, so that it doesn't flash up
+  // when the pipelines are in the disk cache. The completed pipelines are retrieved as soon as
+  // they are ready, so that the next ones can be queued.
+  constexpr auto CHECK_INTERVAL = std::chrono::milliseconds(1000 / 30);
+  auto next_progress_time = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  for (;;)
+  {
     m_async_shader_compiler->RetrieveWorkItems();
+    QueuePrecompiledPipelines();
+    if (!m_async_shader_compiler->HasPendingWork() && !m_async_shader_compiler->HasCompletedWork())
+      break;
+
+    // The ubershaders are always waited for, as they are used for everything else.
+    const size_t pending_uber_pipelines =
+        std::count_if(m_gx_uber_pipeline_cache.begin(), m_gx_uber_pipeline_cache.end(),
+                      [](const auto& it) { return it.second.pending; });
+    if (pending_uber_pipelines == 0 && m_precompiled_uses >= required_uses)
+      break;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= next_progress_time)
+    {
+      const size_t total = m_gx_uber_pipeline_cache.size() + required_pipelines;
+      const size_t completed = total - pending_uber_pipelines -
+                               (required_pipelines - std::min(m_precompiled_pipelines,
+                                                              required_pipelines));
+      DrawCompileProgress(completed, total);
+      next_progress_time = now + CHECK_INTERVAL;
+    }
+
+    m_async_shader_compiler->WaitForCompletedWork(
+        std::chrono::duration_cast<std::chrono::milliseconds>(next_progress_time - now));
   }
+
+  INFO_LOG(VIDEO, "Precompiled %zu of %zu pipelines before starting, covering %" PRIu64
+                  " of %" PRIu64 " recorded uses",
+           m_precompiled_pipelines, m_precompile_queue.size(), m_precompiled_uses,
+           m_precompile_total_uses);
 }
 
 template <typename SerializedUidType, typename UidType>
@@ -205,127 +270,61 @@ static void UnserializePipelineUid(const SerializedUidType& uid, UidType& real_u
   real_uid.blending_state.hex = uid.blending_state_bits;
 }
 
+template <typename K>
+void ShaderCache::OpenDiskCache(Common::IndexedDiskCache<K>& disk_cache, APIType api_type,
+                                const char* type, bool include_gameid)
+{
+  // Only the keys are read here, the shaders and pipelines are created when they are first used.
+  const std::string filename =
+      GetDiskShaderCacheFileName(api_type, type, include_gameid, true, true, ".icache");
+  if (!disk_cache.Open(filename))
+    return;
+
+  // Move the entries of the cache files of older versions over.
+  const std::string linear_filename =
+      GetDiskShaderCacheFileName(api_type, type, include_gameid, true);
+  const u32 imported = disk_cache.ImportLinearDiskCache(linear_filename);
+  if (imported != 0)
+    INFO_LOG(VIDEO, "Imported %u entries from %s", imported, linear_filename.c_str());
+
+  INFO_LOG(VIDEO, "Opened %s with %zu entries", filename.c_str(), disk_cache.GetEntryCount());
+}
+
 template <ShaderStage stage, typename K, typename T>
-void ShaderCache::LoadShaderCache(T& cache, APIType api_type, const char* type, bool include_gameid)
+std::unique_ptr<AbstractShader> ShaderCache::LoadShaderFromDiskCache(T& cache, const K& uid)
 {
-  class CacheReader : public LinearDiskCacheReader<K, u8>
-  {
-  public:
-    CacheReader(T& cache_) : cache(cache_) {}
-    void Read(const K& key, const u8* value, u32 value_size)
-    {
-      auto shader = g_renderer->CreateShaderFromBinary(stage, value, value_size);
-      if (shader)
-      {
-        auto& entry = cache.shader_map[key];
-        entry.shader = std::move(shader);
-        entry.pending = false;
+  std::vector<u8> binary;
+  if (!cache.disk_cache.Lookup(uid, &binary))
+    return nullptr;
 
-        switch (stage)
-        {
-        case ShaderStage::Vertex:
-          INCSTAT(g_stats.num_vertex_shaders_created);
-          INCSTAT(g_stats.num_vertex_shaders_alive);
-          break;
-        case ShaderStage::Pixel:
-          INCSTAT(g_stats.num_pixel_shaders_created);
-          INCSTAT(g_stats.num_pixel_shaders_alive);
-          break;
-        default:
-          break;
-        }
-      }
-    }
+  std::unique_ptr<AbstractShader> shader =
+      g_renderer->CreateShaderFromBinary(stage, binary.data(), binary.size());
 
-  private:
-    T& cache;
-  };
+  // Let the shader that is compiled instead replace the binary.
+  if (!shader)
+    cache.disk_cache.Remove(uid);
 
-  std::string filename = GetDiskShaderCacheFileName(api_type, type, include_gameid, true);
-  CacheReader reader(cache);
-  u32 count = cache.disk_cache.OpenAndRead(filename, reader);
-  INFO_LOG(VIDEO, "Loaded %u cached shaders from %s", count, filename.c_str());
+  return shader;
 }
 
 template <typename T>
 void ShaderCache::ClearShaderCache(T& cache)
 {
-  cache.disk_cache.Sync();
   cache.disk_cache.Close();
   cache.shader_map.clear();
 }
 
-template <typename KeyType, typename DiskKeyType, typename T>
-void ShaderCache::LoadPipelineCache(T& cache, LinearDiskCache<DiskKeyType, u8>& disk_cache,
-                                    APIType api_type, const char* type, bool include_gameid)
-{
-  class CacheReader : public LinearDiskCacheReader<DiskKeyType, u8>
-  {
-  public:
-    CacheReader(ShaderCache* this_ptr_, T& cache_) : this_ptr(this_ptr_), cache(cache_) {}
-    bool AnyFailed() const { return failed; }
-    void Read(const DiskKeyType& key, const u8* value, u32 value_size)
-    {
-      KeyType real_uid;
-      UnserializePipelineUid(key, real_uid);
-
-      // Skip those which are already compiled.
-      if (failed || cache.find(real_uid) != cache.end())
-        return;
-
-      auto config = this_ptr->GetGXPipelineConfig(real_uid);
-      if (!config)
-        return;
-
-      auto pipeline = g_renderer->CreatePipeline(*config, value, value_size);
-      if (!pipeline)
-      {
-        // If any of the pipelines fail to create, consider the cache stale.
-        failed = true;
-        return;
-      }
-
-      auto& entry = cache[real_uid];
-      entry.first = std::move(pipeline);
-      entry.second = false;
-    }
-
-  private:
-    ShaderCache* this_ptr;
-    T& cache;
-    bool failed = false;
-  };
-
-  std::string filename = GetDiskShaderCacheFileName(api_type, type, include_gameid, true);
-  CacheReader reader(this, cache);
-  u32 count = disk_cache.OpenAndRead(filename, reader);
-  INFO_LOG(VIDEO, "Loaded %u cached pipelines from %s", count, filename.c_str());
-
-  // If any of the pipelines in the cache failed to create, it's likely because of a change of
-  // driver version, or system configuration. In this case, when the UID cache picks up the pipeline
-  // later on, we'll write a duplicate entry to the pipeline cache. There's also no point in keeping
-  // the old cache data around, so discard and recreate the disk cache.
-  if (reader.AnyFailed())
-  {
-    WARN_LOG(VIDEO, "Failed to load one or more pipelines from cache '%s'. Discarding.",
-             filename.c_str());
-    disk_cache.Close();
-    File::Delete(filename);
-    disk_cache.OpenAndRead(filename, reader);
-  }
-}
-
 template <typename T, typename Y>
 void ShaderCache::ClearPipelineCache(T& cache, Y& disk_cache)
 {
-  disk_cache.Sync();
   disk_cache.Close();
 
-  // Set the pending flag to false, and destroy the pipeline.
+  // Set the pending flag to false, and destroy the pipeline. The usage is kept.
   for (auto& it : cache)
   {
-    it.second.first.reset();
-    it.second.second = false;
+    it.second.pipeline.reset();
+    it.second.pending = false;
+    it.second.precompile = false;
   }
 }
 
@@ -334,30 +333,22 @@ void ShaderCache::LoadCaches()
   // Ubershader caches, if present.
   if (g_ActiveConfig.backend_info.bSupportsShaderBinaries)
   {
-    LoadShaderCache<ShaderStage::Vertex, UberShader::VertexShaderUid>(m_uber_vs_cache, m_api_type,
-                                                                      "uber-vs", false);
-    LoadShaderCache<ShaderStage::Pixel, UberShader::PixelShaderUid>(m_uber_ps_cache, m_api_type,
-                                                                    "uber-ps", false);
+    OpenDiskCache(m_uber_vs_cache.disk_cache, m_api_type, "uber-vs", false);
+    OpenDiskCache(m_uber_ps_cache.disk_cache, m_api_type, "uber-ps", false);
 
     // We also share geometry shaders, as there aren't many variants.
     if (m_host_config.backend_geometry_shaders)
-      LoadShaderCache<ShaderStage::Geometry, GeometryShaderUid>(m_gs_cache, m_api_type, "gs",
-                                                                false);
+      OpenDiskCache(m_gs_cache.disk_cache, m_api_type, "gs", false);
 
     // Specialized shaders, gameid-specific.
-    LoadShaderCache<ShaderStage::Vertex, VertexShaderUid>(m_vs_cache, m_api_type, "specialized-vs",
-                                                          true);
-    LoadShaderCache<ShaderStage::Pixel, PixelShaderUid>(m_ps_cache, m_api_type, "specialized-ps",
-                                                        true);
+    OpenDiskCache(m_vs_cache.disk_cache, m_api_type, "specialized-vs", true);
+    OpenDiskCache(m_ps_cache.disk_cache, m_api_type, "specialized-ps", true);
   }
 
   if (g_ActiveConfig.backend_info.bSupportsPipelineCacheData)
   {
-    LoadPipelineCache<GXPipelineUid, SerializedGXPipelineUid>(
-        m_gx_pipeline_cache, m_gx_pipeline_disk_cache, m_api_type, "specialized-pipeline", true);
-    LoadPipelineCache<GXUberPipelineUid, SerializedGXUberPipelineUid>(
-        m_gx_uber_pipeline_cache, m_gx_uber_pipeline_disk_cache, m_api_type, "uber-pipeline",
-        false);
+    OpenDiskCache(m_gx_pipeline_disk_cache, m_api_type, "specialized-pipeline", true);
+    OpenDiskCache(m_gx_uber_pipeline_disk_cache, m_api_type, "uber-pipeline", false);
   }
 }
 
@@ -395,46 +386,107 @@ void ShaderCache::ClearCaches()
   SETSTAT(g_stats.num_vertex_shaders_alive, 0);
 }
 
-void ShaderCache::CompileMissingPipelines()
+void ShaderCache::QueueMissingPipelines()
 {
-  // Queue all uids with a null pipeline for compilation.
+  // Rank all uids with a null pipeline. The pipelines that were needed earliest after starting
+  // are compiled first, and the most used ones among those that were first needed together.
+  std::vector<std::pair<PipelineUsage, GXPipelineUid>> missing_pipelines;
+  m_precompile_total_uses = 0;
   for (auto& it : m_gx_pipeline_cache)
   {
-    if (!it.second.first)
-      QueuePipelineCompile(it.first, COMPILE_PRIORITY_SHADERCACHE_PIPELINE);
+    if (it.second.pipeline || it.second.pending)
+      continue;
+
+    it.second.precompile = true;
+    missing_pipelines.emplace_back(it.second.usage, it.first);
+    m_precompile_total_uses += it.second.usage.use_count + 1;
   }
+  std::sort(missing_pipelines.begin(), missing_pipelines.end(),
+            [](const auto& a, const auto& b) {
+              if (a.first.first_frame != b.first.first_frame)
+                return a.first.first_frame < b.first.first_frame;
+              return a.first.use_count > b.first.use_count;
+            });
+
+  m_precompile_queue.clear();
+  m_precompile_queue.reserve(missing_pipelines.size());
+  for (const auto& it : missing_pipelines)
+    m_precompile_queue.push_back(it.second);
+  m_next_precompile = 0;
+  m_queued_precompiles = 0;
+  m_precompiled_pipelines = 0;
+  m_precompiled_uses = 0;
+
   for (auto& it : m_gx_uber_pipeline_cache)
   {
-    if (!it.second.first)
+    if (!it.second.pipeline)
       QueueUberPipelineCompile(it.first, COMPILE_PRIORITY_UBERSHADER_PIPELINE);
   }
+
+  QueuePrecompiledPipelines();
 }
 
-std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexShaderUid& uid) const
+void ShaderCache::QueuePrecompiledPipelines()
 {
+  // Without worker threads, the pipelines are compiled as soon as they are queued. They all were
+  // before they were ranked, so keep it that way, rather than spreading them over the frames.
+  const size_t max_queued = m_async_shader_compiler->HasWorkerThreads() ?
+                                MAX_QUEUED_PRECOMPILED_PIPELINES :
+                                m_precompile_queue.size();
+  while (m_queued_precompiles < max_queued && m_next_precompile < m_precompile_queue.size())
+  {
+    // The position in the queue is part of the priority, so that pipelines which are re-queued
+    // while their shaders are compiling don't fall behind the ones ranked after them.
+    const u32 rank = static_cast<u32>(m_next_precompile);
+    const GXPipelineUid& uid = m_precompile_queue[m_next_precompile++];
+
+    // Skip the pipelines that were compiled on demand in the meantime.
+    const PipelineCacheEntry& entry = m_gx_pipeline_cache[uid];
+    if (!entry.precompile || entry.pending)
+      continue;
+
+    QueuePipelineCompile(uid, COMPILE_PRIORITY_SHADERCACHE_PIPELINE + rank);
+    m_queued_precompiles++;
+  }
+}
+
+std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexShaderUid& uid)
+{
+  if (auto shader = LoadShaderFromDiskCache<ShaderStage::Vertex>(m_vs_cache, uid))
+    return shader;
+
   const ShaderCode source_code =
       GenerateVertexShaderCode(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer());
 }
 
 std::unique_ptr<AbstractShader>
-ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid) const
+ShaderCache::CompileVertexUberShader(const UberShader::VertexShaderUid& uid)
 {
+  if (auto shader = LoadShaderFromDiskCache<ShaderStage::Vertex>(m_uber_vs_cache, uid))
+    return shader;
+
   const ShaderCode source_code =
       UberShader::GenVertexShader(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Vertex, source_code.GetBuffer());
 }
 
-std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShaderUid& uid) const
+std::unique_ptr<AbstractShader> ShaderCache::CompilePixelShader(const PixelShaderUid& uid)
 {
+  if (auto shader = LoadShaderFromDiskCache<ShaderStage::Pixel>(m_ps_cache, uid))
+    return shader;
+
   const ShaderCode source_code =
       GeneratePixelShaderCode(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer());
 }
 
 std::unique_ptr<AbstractShader>
-ShaderCache::CompilePixelUberShader(const UberShader::PixelShaderUid& uid) const
+ShaderCache::CompilePixelUberShader(const UberShader::PixelShaderUid& uid)
 {
+  if (auto shader = LoadShaderFromDiskCache<ShaderStage::Pixel>(m_uber_ps_cache, uid))
+    return shader;
+
   const ShaderCode source_code =
       UberShader::GenPixelShader(m_api_type, m_host_config, uid.GetUidData());
   return g_renderer->CreateShaderFromSource(ShaderStage::Pixel, source_code.GetBuffer());
@@ -448,7 +500,8 @@ const AbstractShader* ShaderCache::InsertVertexShader(const VertexShaderUid& uid
 
   if (shader && !entry.shader)
   {
-    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries)
+    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries &&
+        !m_vs_cache.disk_cache.Contains(uid))
     {
       auto binary = shader->GetBinary();
       if (!binary.empty())
@@ -470,7 +523,8 @@ const AbstractShader* ShaderCache::InsertVertexUberShader(const UberShader::Vert
 
   if (shader && !entry.shader)
   {
-    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries)
+    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries &&
+        !m_uber_vs_cache.disk_cache.Contains(uid))
     {
       auto binary = shader->GetBinary();
       if (!binary.empty())
@@ -492,7 +546,8 @@ const AbstractShader* ShaderCache::InsertPixelShader(const PixelShaderUid& uid,
 
   if (shader && !entry.shader)
   {
-    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries)
+    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries &&
+        !m_ps_cache.disk_cache.Contains(uid))
     {
       auto binary = shader->GetBinary();
       if (!binary.empty())
@@ -514,7 +569,8 @@ const AbstractShader* ShaderCache::InsertPixelUberShader(const UberShader::Pixel
 
   if (shader && !entry.shader)
   {
-    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries)
+    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries &&
+        !m_uber_ps_cache.disk_cache.Contains(uid))
     {
       auto binary = shader->GetBinary();
       if (!binary.empty())
@@ -530,17 +586,22 @@ const AbstractShader* ShaderCache::InsertPixelUberShader(const UberShader::Pixel
 
 const AbstractShader* ShaderCache::CreateGeometryShader(const GeometryShaderUid& uid)
 {
-  const ShaderCode source_code =
-      GenerateGeometryShaderCode(m_api_type, m_host_config, uid.GetUidData());
   std::unique_ptr<AbstractShader> shader =
-      g_renderer->CreateShaderFromSource(ShaderStage::Geometry, source_code.GetBuffer());
+      LoadShaderFromDiskCache<ShaderStage::Geometry>(m_gs_cache, uid);
+  if (!shader)
+  {
+    const ShaderCode source_code =
+        GenerateGeometryShaderCode(m_api_type, m_host_config, uid.GetUidData());
+    shader = g_renderer->CreateShaderFromSource(ShaderStage::Geometry, source_code.GetBuffer());
+  }
 
   auto& entry = m_gs_cache.shader_map[uid];
   entry.pending = false;
 
   if (shader && !entry.shader)
   {
-    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries)
+    if (g_ActiveConfig.bShaderCache && g_ActiveConfig.backend_info.bSupportsShaderBinaries &&
+        !m_gs_cache.disk_cache.Contains(uid))
     {
       auto binary = shader->GetBinary();
       if (!binary.empty())
@@ -665,29 +726,62 @@ ShaderCache::GetGXPipelineConfig(const GXUberPipelineUid& config)
                              config.depth_state, config.blending_state);
 }
 
+template <typename DiskKeyType, typename UidType>
+std::unique_ptr<AbstractPipeline>
+ShaderCache::CreateGXPipeline(Common::IndexedDiskCache<DiskKeyType>& disk_cache,
+                              const UidType& uid, const AbstractPipelineConfig& config)
+{
+  std::vector<u8> cache_data;
+  if (disk_cache.IsOpen())
+  {
+    DiskKeyType disk_uid;
+    SerializePipelineUid(uid, disk_uid);
+    if (disk_cache.Lookup(disk_uid, &cache_data))
+    {
+      auto pipeline = g_renderer->CreatePipeline(config, cache_data.data(), cache_data.size());
+      if (pipeline)
+        return pipeline;
+
+      // This is likely because of a change of driver version, or system configuration. The cache
+      // data of the pipeline that is created instead replaces it.
+      WARN_LOG(VIDEO, "Failed to create pipeline from cache data, discarding it.");
+      disk_cache.Remove(disk_uid);
+    }
+  }
+
+  return g_renderer->CreatePipeline(config);
+}
+
 const AbstractPipeline* ShaderCache::InsertGXPipeline(const GXPipelineUid& config,
                                                       std::unique_ptr<AbstractPipeline> pipeline)
 {
   auto& entry = m_gx_pipeline_cache[config];
-  entry.second = false;
-  if (!entry.first && pipeline)
+  entry.pending = false;
+  if (entry.precompile)
+  {
+    entry.precompile = false;
+    m_precompiled_pipelines++;
+    m_precompiled_uses += entry.usage.use_count + 1;
+  }
+
+  if (!entry.pipeline && pipeline)
   {
-    entry.first = std::move(pipeline);
+    entry.pipeline = std::move(pipeline);
 
-    if (g_ActiveConfig.bShaderCache)
+    SerializedGXPipelineUid disk_uid;
+    SerializePipelineUid(config, disk_uid);
+    if (g_ActiveConfig.bShaderCache && !m_gx_pipeline_disk_cache.Contains(disk_uid))
     {
-      auto cache_data = entry.first->GetCacheData();
+      auto cache_data = entry.pipeline->GetCacheData();
       if (!cache_data.empty())
       {
-        SerializedGXPipelineUid disk_uid;
-        SerializePipelineUid(config, disk_uid);
         m_gx_pipeline_disk_cache.Append(disk_uid, cache_data.data(),
                                         static_cast<u32>(cache_data.size()));
       }
     }
   }
 
-  return entry.first.get();
+  return entry.pipeline.get();
 }
 
 const AbstractPipeline*
@@ -695,25 +789,25 @@ ShaderCache::InsertGXUberPipeline(const GXUberPipelineUid& config,
                                   std::unique_ptr<AbstractPipeline> pipeline)
 {
   auto& entry = m_gx_uber_pipeline_cache[config];
-  entry.second = false;
-  if (!entry.first && pipeline)
+  entry.pending = false;
+  if (!entry.pipeline && pipeline)
   {
-    entry.first = std::move(pipeline);
+    entry.pipeline = std::move(pipeline);
 
-    if (g_ActiveConfig.bShaderCache)
+    SerializedGXUberPipelineUid disk_uid;
+    SerializePipelineUid(config, disk_uid);
+    if (g_ActiveConfig.bShaderCache && !m_gx_uber_pipeline_disk_cache.Contains(disk_uid))
     {
-      auto cache_data = entry.first->GetCacheData();
+      auto cache_data = entry.pipeline->GetCacheData();
       if (!cache_data.empty())
       {
-        SerializedGXUberPipelineUid disk_uid;
-        SerializePipelineUid(config, disk_uid);
         m_gx_uber_pipeline_disk_cache.Append(disk_uid, cache_data.data(),
                                              static_cast<u32>(cache_data.size()));
       }
     }
   }
 
-  return entry.first.get();
+  return entry.pipeline.get();
 }
 
 void ShaderCache::LoadPipelineUIDCache()
@@ -788,12 +882,88 @@ void ShaderCache::LoadPipelineUIDCache()
 
   INFO_LOG(VIDEO, "Read %u pipeline UIDs from %s",
            static_cast<unsigned>(m_gx_pipeline_cache.size()), filename.c_str());
+
+  m_gx_pipeline_usage_filename =
+      File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".uidusage";
+  LoadPipelineUsage(m_gx_pipeline_usage_filename);
+}
+
+void ShaderCache::LoadPipelineUsage(const std::string& filename)
+{
+  File::IOFile file(filename, "rb");
+  u32 magic;
+  u32 version;
+  u32 count;
+  if (!file.ReadBytes(&magic, sizeof(magic)) || !file.ReadBytes(&version, sizeof(version)) ||
+      !file.ReadBytes(&count, sizeof(count)) || magic != PIPELINE_USAGE_FILE_MAGIC ||
+      version != GX_PIPELINE_UID_VERSION)
+  {
+    return;
+  }
+
+  u32 num_applied = 0;
+  for (u32 i = 0; i < count; i++)
+  {
+    SerializedGXPipelineUid serialized_uid;
+    PipelineUsage usage;
+    if (!file.ReadBytes(&serialized_uid, sizeof(serialized_uid)) ||
+        !file.ReadBytes(&usage.first_frame, sizeof(usage.first_frame)) ||
+        !file.ReadBytes(&usage.use_count, sizeof(usage.use_count)))
+    {
+      break;
+    }
+
+    // The usage of pipelines that are no longer in the UID cache is dropped.
+    GXPipelineUid uid;
+    UnserializePipelineUid(serialized_uid, uid);
+    auto iter = m_gx_pipeline_cache.find(uid);
+    if (iter == m_gx_pipeline_cache.end())
+      continue;
+
+    // Older sessions count for less, so that the ranking follows changes in what the game uses.
+    // This is only loaded when the UID cache is opened, so the counts are halved once a session.
+    usage.use_count /= 2;
+    iter->second.usage = usage;
+    num_applied++;
+  }
+
+  INFO_LOG(VIDEO, "Read the usage of %u pipelines from %s", num_applied, filename.c_str());
 }
 
 void ShaderCache::ClosePipelineUIDCache()
 {
-  // This is left as a method in case we need to append extra data to the file in the future.
+  if (!m_gx_pipeline_uid_cache_file.IsOpen())
+    return;
   m_gx_pipeline_uid_cache_file.Close();
+
+  // The usage file is replaced, so that a crash while writing it doesn't lose the previous one.
+  const u32 count = static_cast<u32>(std::count_if(
+      m_gx_pipeline_cache.begin(), m_gx_pipeline_cache.end(),
+      [](const auto& it) { return it.second.usage.first_frame != UINT32_MAX; }));
+  const std::string temp_filename =
+      File::GetTempFilenameForAtomicWrite(m_gx_pipeline_usage_filename);
+  File::IOFile file(temp_filename, "wb");
+  bool success = file.WriteBytes(&PIPELINE_USAGE_FILE_MAGIC, sizeof(PIPELINE_USAGE_FILE_MAGIC)) &&
+                 file.WriteBytes(&GX_PIPELINE_UID_VERSION, sizeof(GX_PIPELINE_UID_VERSION)) &&
+                 file.WriteBytes(&count, sizeof(count));
+  for (const auto& it : m_gx_pipeline_cache)
+  {
+    const PipelineUsage& usage = it.second.usage;
+    if (!success || usage.first_frame == UINT32_MAX)
+      continue;
+
+    SerializedGXPipelineUid serialized_uid;
+    SerializePipelineUid(it.first, serialized_uid);
+    success = file.WriteBytes(&serialized_uid, sizeof(serialized_uid)) &&
+              file.WriteBytes(&usage.first_frame, sizeof(usage.first_frame)) &&
+              file.WriteBytes(&usage.use_count, sizeof(usage.use_count));
+  }
+
+  if (!success || !file.Close() || !File::Rename(temp_filename, m_gx_pipeline_usage_filename))
+  {
+    WARN_LOG(VIDEO, "Failed to write pipeline usage to %s", m_gx_pipeline_usage_filename.c_str());
+    File::Delete(temp_filename);
+  }
 }
 
 void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
@@ -801,13 +971,8 @@ void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
   GXPipelineUid real_uid;
   UnserializePipelineUid(uid, real_uid);
 
-  auto iter = m_gx_pipeline_cache.find(real_uid);
-  if (iter != m_gx_pipeline_cache.end())
-    return;
-
-  // Flag it as empty with a null pipeline object, for later compilation.
-  auto& entry = m_gx_pipeline_cache[real_uid];
-  entry.second = false;
+  // Add it with a null pipeline object, for later compilation.
+  m_gx_pipeline_cache.try_emplace(real_uid);
 }
 
 void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
@@ -977,7 +1142,8 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
     bool Compile() override
     {
       if (config)
-        pipeline = g_renderer->CreatePipeline(*config);
+        pipeline = shader_cache->CreateGXPipeline(shader_cache->m_gx_pipeline_disk_cache, uid,
+                                                  *config);
       return true;
     }
 
@@ -985,6 +1151,8 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
     {
       if (stages_ready)
       {
+        if (priority >= COMPILE_PRIORITY_SHADERCACHE_PIPELINE)
+          shader_cache->m_queued_precompiles--;
         shader_cache->InsertGXPipeline(uid, std::move(pipeline));
       }
       else
@@ -1007,7 +1175,7 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
 
   auto wi = m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(this, uid, priority);
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
-  m_gx_pipeline_cache[uid].second = true;
+  m_gx_pipeline_cache[uid].pending = true;
 }
 
 void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority)
@@ -1050,7 +1218,8 @@ void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 pri
     bool Compile() override
     {
       if (config)
-        UberPipeline = g_renderer->CreatePipeline(*config);
+        UberPipeline = shader_cache->CreateGXPipeline(
+            shader_cache->m_gx_uber_pipeline_disk_cache, uid, *config);
       return true;
     }
 
@@ -1080,7 +1249,7 @@ void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 pri
 
   auto wi = m_async_shader_compiler->CreateWorkItem<UberPipelineWorkItem>(this, uid, priority);
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
-  m_gx_uber_pipeline_cache[uid].second = true;
+  m_gx_uber_pipeline_cache[uid].pending = true;
 }
 
 void ShaderCache::QueueUberShaderPipelines()
@@ -1113,12 +1282,7 @@ void ShaderCache::QueueUberShaderPipelines()
       config.blending_state.logicmode = BlendMode::AND;
     }
 
-    auto iter = m_gx_uber_pipeline_cache.find(config);
-    if (iter != m_gx_uber_pipeline_cache.end())
-      return;
-
-    auto& entry = m_gx_uber_pipeline_cache[config];
-    entry.second = false;
+    m_gx_uber_pipeline_cache.try_emplace(config);
   };
 
   // Populate the pipeline configs with empty entries, these will be compiled afterwards.
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstring>
@@ -13,10 +14,11 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
-#include "Common/LinearDiskCache.h"
+#include "Common/IndexedDiskCache.h"
 
 #include "VideoCommon/AbstractPipeline.h"
 #include "VideoCommon/AbstractShader.h"
@@ -58,7 +60,7 @@ public:
   // Reloads/recreates all shaders and pipelines.
   void Reload();
 
-  // Retrieves all pending shaders/pipelines from the async compiler.
+  // Retrieves all pending shaders/pipelines from the async compiler. Called once per frame.
   void RetrieveAsyncShaders();
 
   // Accesses ShaderGen shader caches
@@ -116,21 +118,22 @@ private:
   static constexpr size_t NUM_PALETTE_CONVERSION_SHADERS = 3;
 
   void WaitForAsyncCompiler();
+  void WaitForPrecompiledPipelines();
   void LoadCaches();
   void ClearCaches();
   void LoadPipelineUIDCache();
+  void LoadPipelineUsage(const std::string& filename);
   void ClosePipelineUIDCache();
-  void CompileMissingPipelines();
+  void QueueMissingPipelines();
+  void QueuePrecompiledPipelines();
   void QueueUberShaderPipelines();
   bool CompileSharedPipelines();
 
-  // GX shader compiler methods
-  std::unique_ptr<AbstractShader> CompileVertexShader(const VertexShaderUid& uid) const;
-  std::unique_ptr<AbstractShader>
-  CompileVertexUberShader(const UberShader::VertexShaderUid& uid) const;
-  std::unique_ptr<AbstractShader> CompilePixelShader(const PixelShaderUid& uid) const;
-  std::unique_ptr<AbstractShader>
-  CompilePixelUberShader(const UberShader::PixelShaderUid& uid) const;
+  // GX shader compiler methods. These use the binaries from the disk cache if there are any.
+  std::unique_ptr<AbstractShader> CompileVertexShader(const VertexShaderUid& uid);
+  std::unique_ptr<AbstractShader> CompileVertexUberShader(const UberShader::VertexShaderUid& uid);
+  std::unique_ptr<AbstractShader> CompilePixelShader(const PixelShaderUid& uid);
+  std::unique_ptr<AbstractShader> CompilePixelUberShader(const UberShader::PixelShaderUid& uid);
   const AbstractShader* InsertVertexShader(const VertexShaderUid& uid,
                                            std::unique_ptr<AbstractShader> shader);
   const AbstractShader* InsertVertexUberShader(const UberShader::VertexShaderUid& uid,
@@ -153,6 +156,10 @@ private:
                       const BlendingState& blending_state);
   std::optional<AbstractPipelineConfig> GetGXPipelineConfig(const GXPipelineUid& uid);
   std::optional<AbstractPipelineConfig> GetGXPipelineConfig(const GXUberPipelineUid& uid);
+  template <typename DiskKeyType, typename UidType>
+  std::unique_ptr<AbstractPipeline>
+  CreateGXPipeline(Common::IndexedDiskCache<DiskKeyType>& disk_cache, const UidType& uid,
+                   const AbstractPipelineConfig& config);
   const AbstractPipeline* InsertGXPipeline(const GXPipelineUid& config,
                                            std::unique_ptr<AbstractPipeline> pipeline);
   const AbstractPipeline* InsertGXUberPipeline(const GXUberPipelineUid& config,
@@ -169,13 +176,13 @@ private:
   void QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority);
 
   // Populating various caches.
+  template <typename K>
+  void OpenDiskCache(Common::IndexedDiskCache<K>& disk_cache, APIType api_type, const char* type,
+                     bool include_gameid);
   template <ShaderStage stage, typename K, typename T>
-  void LoadShaderCache(T& cache, APIType api_type, const char* type, bool include_gameid);
+  std::unique_ptr<AbstractShader> LoadShaderFromDiskCache(T& cache, const K& uid);
   template <typename T>
   void ClearShaderCache(T& cache);
-  template <typename KeyType, typename DiskKeyType, typename T>
-  void LoadPipelineCache(T& cache, LinearDiskCache<DiskKeyType, u8>& disk_cache, APIType api_type,
-                         const char* type, bool include_gameid);
   template <typename T, typename Y>
   void ClearPipelineCache(T& cache, Y& disk_cache);
 
@@ -190,6 +197,37 @@ private:
     COMPILE_PRIORITY_SHADERCACHE_PIPELINE = 300
   };
 
+  // Maximum number of pipelines from the UID cache that are queued in the async compiler at once.
+  // The rest are queued as these complete, so that pipelines which are used before their turn
+  // can still be compiled on demand.
+  static constexpr size_t MAX_QUEUED_PRECOMPILED_PIPELINES = 256;
+
+  // Recorded usage of a pipeline, over all the sessions in the UID usage file.
+  struct PipelineUsage
+  {
+    // Frame on which the pipeline was first used, the earliest of all the sessions.
+    u32 first_frame = UINT32_MAX;
+    // Number of times the pipeline was looked up. Halved at the start of each session.
+    u32 use_count = 0;
+  };
+
+  struct PipelineCacheEntry
+  {
+    std::unique_ptr<AbstractPipeline> pipeline;
+    // Compiling in the background.
+    bool pending = false;
+    // From the UID cache, and not compiled yet. Counts towards the precompilation progress.
+    bool precompile = false;
+    PipelineUsage usage;
+  };
+
+  void RecordPipelineUsage(PipelineUsage& usage) const
+  {
+    usage.first_frame = std::min(usage.first_frame, m_frame_count);
+    if (usage.use_count != UINT32_MAX)
+      usage.use_count++;
+  }
+
   // Configuration bits.
   APIType m_api_type = APIType::Nothing;
   ShaderHostConfig m_host_config = {};
@@ -214,7 +252,7 @@ private:
       bool pending;
     };
     std::map<Uid, Shader> shader_map;
-    LinearDiskCache<Uid, u8> disk_cache;
+    Common::IndexedDiskCache<Uid> disk_cache;
   };
   ShaderModuleCache<VertexShaderUid> m_vs_cache;
   ShaderModuleCache<GeometryShaderUid> m_gs_cache;
@@ -222,13 +260,23 @@ private:
   ShaderModuleCache<UberShader::VertexShaderUid> m_uber_vs_cache;
   ShaderModuleCache<UberShader::PixelShaderUid> m_uber_ps_cache;
 
-  // GX Pipeline Caches - .first - pipeline, .second - pending
-  std::map<GXPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>> m_gx_pipeline_cache;
-  std::map<GXUberPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>>
-      m_gx_uber_pipeline_cache;
+  // GX Pipeline Caches
+  std::map<GXPipelineUid, PipelineCacheEntry> m_gx_pipeline_cache;
+  std::map<GXUberPipelineUid, PipelineCacheEntry> m_gx_uber_pipeline_cache;
   File::IOFile m_gx_pipeline_uid_cache_file;
-  LinearDiskCache<SerializedGXPipelineUid, u8> m_gx_pipeline_disk_cache;
-  LinearDiskCache<SerializedGXUberPipelineUid, u8> m_gx_uber_pipeline_disk_cache;
+  std::string m_gx_pipeline_usage_filename;
+  Common::IndexedDiskCache<SerializedGXPipelineUid> m_gx_pipeline_disk_cache;
+  Common::IndexedDiskCache<SerializedGXUberPipelineUid> m_gx_uber_pipeline_disk_cache;
+
+  // Pipelines that are compiled in the background, most likely to be needed soonest first.
+  std::vector<GXPipelineUid> m_precompile_queue;
+  size_t m_next_precompile = 0;
+  size_t m_queued_precompiles = 0;
+  size_t m_precompiled_pipelines = 0;
+  // Sums of the use counts of the pipelines in the queue, and of those that are compiled.
+  u64 m_precompile_total_uses = 0;
+  u64 m_precompiled_uses = 0;
+  u32 m_frame_count = 0;
 
   // EFB copy to VRAM/RAM pipelines
   std::map<TextureConversionShaderGen::TCShaderUid, std::unique_ptr<AbstractPipeline>>
@@ -4,11 +4,31 @@
 
 #include "VideoCommon/ShaderGenCommon.h"
 
+#include <cstdarg>
+
 #include <fmt/format.h>
 
 #include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
 #include "Core/ConfigManager.h"
 
+void ShaderCode::Write(const char* fmt, ...)
+{
+  // Nearly every line of a shader fits on the stack, which saves allocating and copying a
+  // temporary string for each of the thousands of Write calls of a shader.
+  char buffer[1024];
+  va_list arglist;
+  va_start(arglist, fmt);
+  va_list arglist_copy;
+  va_copy(arglist_copy, arglist);
+  if (CharArrayFromFormatV(buffer, sizeof(buffer), fmt, arglist_copy))
+    m_buffer += buffer;
+  else
+    m_buffer += StringFromFormatV(fmt, arglist);
+  va_end(arglist_copy);
+  va_end(arglist);
+}
+
 ShaderHostConfig ShaderHostConfig::GetCurrent()
 {
   ShaderHostConfig bits = {};
@@ -37,11 +57,13 @@ ShaderHostConfig ShaderHostConfig::GetCurrent()
   bits.backend_shader_framebuffer_fetch = g_ActiveConfig.backend_info.bSupportsFramebufferFetch;
   bits.backend_logic_op = g_ActiveConfig.backend_info.bSupportsLogicOp;
   bits.backend_palette_conversion = g_ActiveConfig.backend_info.bSupportsPaletteConversion;
+  bits.merge_draws = g_ActiveConfig.UseDrawMerging();
   return bits;
 }
 
 std::string GetDiskShaderCacheFileName(APIType api_type, const char* type, bool include_gameid,
-                                       bool include_host_config, bool include_api)
+                                       bool include_host_config, bool include_api,
+                                       const char* extension)
 {
   if (!File::Exists(File::GetUserPath(D_SHADERCACHE_IDX)))
     File::CreateDir(File::GetUserPath(D_SHADERCACHE_IDX));
@@ -81,6 +103,6 @@ std::string GetDiskShaderCacheFileName(APIType api_type, const char* type, bool
     filename += fmt::format("-{:06X}", host_config.bits);
   }
 
-  filename += ".cache";
+  filename += extension;
   return filename;
 }
@@ -9,6 +9,7 @@
 #include <iterator>
 #include <map>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -60,7 +61,7 @@ public:
  * Unless performance is not an issue, uid_data should be tightly packed to reduce memory footprint.
  * Shader generators will write to specific uid_data fields; ShaderUid methods will only read raw
  * u32 values from a union.
- * NOTE: Because LinearDiskCache reads and writes the storage associated with a ShaderUid instance,
+ * NOTE: Because the disk caches read and write the storage associated with a ShaderUid instance,
  * ShaderUid must be trivially copyable.
  */
 template <class uid_data>
@@ -110,12 +111,10 @@ public:
 #ifdef __GNUC__
       __attribute__((format(printf, 2, 3)))
 #endif
-  {
-    va_list arglist;
-    va_start(arglist, fmt);
-    m_buffer += StringFromFormatV(fmt, arglist);
-    va_end(arglist);
-  }
+      ;
+
+  // Appends a piece of code that was already generated, e.g. by another ShaderCode.
+  void Append(std::string_view code) { m_buffer += code; }
 
   // Writes format strings using fmtlib format strings.
   template <typename... Args>
@@ -183,7 +182,8 @@ union ShaderHostConfig
     u32 backend_shader_framebuffer_fetch : 1;
     u32 backend_logic_op : 1;
     u32 backend_palette_conversion : 1;
-    u32 pad : 9;
+    u32 merge_draws : 1;
+    u32 pad : 8;
   };
 
   static ShaderHostConfig GetCurrent();
@@ -191,7 +191,8 @@ union ShaderHostConfig
 
 // Gets the filename of the specified type of cache object (e.g. vertex shader, pipeline).
 std::string GetDiskShaderCacheFileName(APIType api_type, const char* type, bool include_gameid,
-                                       bool include_host_config, bool include_api = true);
+                                       bool include_host_config, bool include_api = true,
+                                       const char* extension = ".cache");
 
 template <class T>
 inline void DefineOutputMember(T& object, APIType api_type, const char* qualifier, const char* type,
@@ -327,6 +328,7 @@ inline const char* GetInterpolationQualifier(bool msaa, bool ssaa,
 #define I_POSTTRANSFORMMATRICES "cpostmtx"
 #define I_PIXELCENTERCORRECTION "cpixelcenter"
 #define I_VIEWPORT_SIZE "cviewport"
+#define I_DRAWMATRICES "cdrawmtx"
 
 #define I_STEREOPARAMS "cstereo"
 #define I_LINEPTPARAMS "clinept"
@@ -350,3 +352,7 @@ static const char s_shader_uniforms[] = "\tuint    components;\n"
                                         "\t#define xfmem_postMtxInfo(i) (xfmem_pack1[(i)].y)\n"
                                         "\t#define xfmem_color(i) (xfmem_pack1[(i)].z)\n"
                                         "\t#define xfmem_alpha(i) (xfmem_pack1[(i)].w)\n";
+
+// Follows s_shader_uniforms when draw merging is enabled. Six rows per draw, see
+// VertexShaderConstants::drawmatrices.
+static const char s_draw_matrix_uniforms[] = "\tfloat4 " I_DRAWMATRICES "[192];\n";
@@ -0,0 +1,220 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/StateWriteQueue.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "Common/Swap.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexManagerBase.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace StateWriteQueue
+{
+namespace
+{
+// The queued writes are applied once there are this many, which bounds the cost of diffing them.
+constexpr size_t MAX_QUEUED_WRITES = 64;
+
+constexpr u32 XF_ADDRESS_SPACE_SIZE = sizeof(XFMemory) / sizeof(u32);
+
+enum class WriteType
+{
+  BP,
+  XF,
+  IndexedXF,
+};
+
+struct QueuedWrite
+{
+  WriteType type;
+  // BP command, XF base address or indexed XF load.
+  u32 value;
+  u32 size;
+  // Offset of the big-endian XF data in s_xf_data.
+  u32 data_offset;
+};
+
+struct XFWord
+{
+  u32 address;
+  u32 value;
+};
+
+std::vector<QueuedWrite> s_writes;
+std::vector<u32> s_xf_data;
+// Scratch space for HasChanges.
+std::vector<XFWord> s_xf_words;
+
+bool ShouldQueue()
+{
+  // Without any vertices in the current batch, there is nothing to keep from being flushed.
+  return !s_writes.empty() || !g_vertex_manager->IsFlushed();
+}
+
+void AddXFWords(u32 address, u32 size, u32 data_offset)
+{
+  for (u32 i = 0; i < size && address + i < XF_ADDRESS_SPACE_SIZE; ++i)
+    s_xf_words.push_back({address + i, Common::swap32(s_xf_data[data_offset + i])});
+}
+
+bool HasChanges()
+{
+  std::array<u32, 0x100> bp_regs;
+  static_assert(sizeof(bp_regs) == sizeof(BPMemory));
+  std::memcpy(bp_regs.data(), &bpmem, sizeof(bp_regs));
+  s_xf_words.clear();
+
+  for (const QueuedWrite& write : s_writes)
+  {
+    switch (write.type)
+    {
+    case WriteType::BP:
+    {
+      // Same as LoadBPReg, including the handling of the mask register.
+      const u32 address = write.value >> 24;
+      const u32 mask = bp_regs[BPMEM_BP_MASK];
+      if (address != BPMEM_BP_MASK)
+        bp_regs[BPMEM_BP_MASK] = 0xFFFFFF;
+      bp_regs[address] = (bp_regs[address] & ~mask) | (write.value & mask);
+    }
+    break;
+
+    case WriteType::XF:
+      AddXFWords(write.value, write.size, write.data_offset);
+      break;
+
+    case WriteType::IndexedXF:
+      AddXFWords(write.value & 0xFFF, write.size, write.data_offset);
+      break;
+    }
+  }
+
+  if (std::memcmp(bp_regs.data(), &bpmem, sizeof(bp_regs)) != 0)
+    return true;
+
+  // Only the last write to each address counts.
+  std::stable_sort(s_xf_words.begin(), s_xf_words.end(),
+                   [](const XFWord& a, const XFWord& b) { return a.address < b.address; });
+  const u32* const xf_regs = reinterpret_cast<const u32*>(&xfmem);
+  for (auto it = s_xf_words.begin(); it != s_xf_words.end(); ++it)
+  {
+    // The matrix indices are compared against the CP registers, not XF memory.
+    if (it->address == XFMEM_SETMATRIXINDA || it->address == XFMEM_SETMATRIXINDB)
+      return true;
+
+    const auto next = it + 1;
+    if ((next == s_xf_words.end() || next->address != it->address) &&
+        xf_regs[it->address] != it->value)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void Replay()
+{
+  for (const QueuedWrite& write : s_writes)
+  {
+    switch (write.type)
+    {
+    case WriteType::BP:
+      LoadBPReg(write.value);
+      break;
+
+    case WriteType::XF:
+    {
+      u8* const data = reinterpret_cast<u8*>(&s_xf_data[write.data_offset]);
+      LoadXFReg(write.size, write.value, DataReader(data, data + write.size * sizeof(u32)));
+    }
+    break;
+
+    case WriteType::IndexedXF:
+      WriteIndexedXF(write.value, &s_xf_data[write.data_offset]);
+      break;
+    }
+  }
+}
+
+void PushXFData(WriteType type, u32 value, u32 size, const u8* data)
+{
+  if (s_writes.size() >= MAX_QUEUED_WRITES)
+    Apply();
+
+  const u32 data_offset = static_cast<u32>(s_xf_data.size());
+  s_writes.push_back({type, value, size, data_offset});
+  s_xf_data.resize(data_offset + size);
+  std::memcpy(&s_xf_data[data_offset], data, size * sizeof(u32));
+}
+}  // Anonymous namespace
+
+void Init()
+{
+  s_writes.clear();
+  s_xf_data.clear();
+}
+
+void PushBP(u32 value)
+{
+  // Pixel format changes convert the EFB contents, so they aren't just state either.
+  const u32 address = value >> 24;
+  if (!ShouldQueue() || BPWriteHasSideEffects(address) || address == BPMEM_ZCOMPARE)
+  {
+    Apply();
+    LoadBPReg(value);
+    return;
+  }
+
+  if (s_writes.size() >= MAX_QUEUED_WRITES)
+    Apply();
+
+  s_writes.push_back({WriteType::BP, value, 0, 0});
+}
+
+void PushXF(u32 transfer_size, u32 address, DataReader src)
+{
+  if (!ShouldQueue())
+  {
+    LoadXFReg(transfer_size, address, src);
+    return;
+  }
+
+  PushXFData(WriteType::XF, address, transfer_size, src.GetPointer());
+}
+
+void PushIndexedXF(u32 val, int refarray)
+{
+  const u32* const data = ReadIndexedXFData(val, refarray);
+  if (!ShouldQueue())
+  {
+    WriteIndexedXF(val, data);
+    return;
+  }
+
+  const u32 size = ((val >> 12) & 0xF) + 1;
+  PushXFData(WriteType::IndexedXF, val, size, reinterpret_cast<const u8*>(data));
+}
+
+void Apply()
+{
+  if (s_writes.empty())
+    return;
+
+  if (HasChanges())
+    Replay();
+  else
+    ADDSTAT(g_stats.this_frame.num_state_writes_skipped, static_cast<int>(s_writes.size()));
+
+  s_writes.clear();
+  s_xf_data.clear();
+}
+}  // namespace StateWriteQueue
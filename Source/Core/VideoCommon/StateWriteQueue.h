@@ -0,0 +1,28 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+class DataReader;
+
+// Holds back BP and XF register writes until the state is used, e.g. by the next draw. Every write
+// that changes the state flushes the current batch, but games often write the same values again,
+// or switch to a different state and back without drawing anything in between. Writes whose net
+// effect leaves every register unchanged are dropped, so that the draws around them still end up
+// in the same batch. Otherwise, the writes are applied in order, as if they had never been queued.
+namespace StateWriteQueue
+{
+void Init();
+
+void PushBP(u32 value);
+// The XF data is read from src right away.
+void PushXF(u32 transfer_size, u32 address, DataReader src);
+void PushIndexedXF(u32 val, int refarray);
+
+// Applies the queued writes. Must be called before anything reads the BP/XF state, and before
+// other commands are processed, so that everything happens in FIFO order.
+void Apply();
+}  // namespace StateWriteQueue
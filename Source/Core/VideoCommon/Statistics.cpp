@@ -4,6 +4,7 @@
 
 #include "VideoCommon/Statistics.h"
 
+#include <algorithm>
 #include <utility>
 
 #include <imgui.h>
@@ -70,8 +71,13 @@ void Statistics::Display() const
   draw_statistic("vshaders alive", "%d", num_vertex_shaders_alive);
   draw_statistic("shaders changes", "%d", this_frame.num_shader_changes);
   draw_statistic("dlists called", "%d", this_frame.num_dlists_called);
+  draw_statistic("dlists replayed", "%d", this_frame.num_dlists_replayed);
   draw_statistic("Primitive joins", "%d", this_frame.num_primitive_joins);
   draw_statistic("Draw calls", "%d", this_frame.num_draw_calls);
+  draw_statistic("Joins per draw call", "%.2f",
+                 static_cast<float>(this_frame.num_primitive_joins) /
+                     std::max(this_frame.num_draw_calls, 1));
+  draw_statistic("State writes skipped", "%d", this_frame.num_state_writes_skipped);
   draw_statistic("Primitives", "%d", this_frame.num_prims);
   draw_statistic("Primitives (DL)", "%d", this_frame.num_dl_prims);
   draw_statistic("XF loads", "%d", this_frame.num_xf_loads);
@@ -86,6 +92,8 @@ void Statistics::Display() const
   draw_statistic("Vertex Loaders", "%d", num_vertex_loaders);
   draw_statistic("EFB peeks:", "%d", this_frame.num_efb_peeks);
   draw_statistic("EFB pokes:", "%d", this_frame.num_efb_pokes);
+  draw_statistic("Texture overlap lookups", "%d", this_frame.num_texture_overlap_lookups);
+  draw_statistic("Texture overlap candidates", "%d", this_frame.num_texture_overlap_candidates);
 
   ImGui::Columns(1);
 
@@ -39,8 +39,10 @@ struct Statistics
 
     int num_primitive_joins;
     int num_draw_calls;
+    int num_state_writes_skipped;
 
     int num_dlists_called;
+    int num_dlists_replayed;
 
     int bytes_vertex_streamed;
     int bytes_index_streamed;
@@ -59,6 +61,9 @@ struct Statistics
 
     int num_efb_peeks;
     int num_efb_pokes;
+
+    int num_texture_overlap_lookups;
+    int num_texture_overlap_candidates;
   };
   ThisFrame this_frame;
   void ResetFrame();
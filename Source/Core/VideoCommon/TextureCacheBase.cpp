@@ -9,6 +9,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 #if defined(_M_X86) || defined(_M_X86_64)
@@ -37,6 +38,7 @@
 #include "VideoCommon/AbstractStagingTexture.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/FramebufferManager.h"
+#include "VideoCommon/GPUThreadProfiler.h"
 #include "VideoCommon/HiresTextures.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/PixelShaderManager.h"
@@ -55,6 +57,8 @@ static const u64 TEXHASH_INVALID = 0;
 // Sonic the Fighters (inside Sonic Gems Collection) loops a 64 frames animation
 static const int TEXTURE_KILL_THRESHOLD = 64;
 static const int TEXTURE_POOL_KILL_THRESHOLD = 3;
+// Upper bound for the number of memory ranges with remembered hashes
+static const size_t MAX_TRACKED_MEMORY_HASHES = 0x4000;
 
 std::unique_ptr<TextureCacheBase> g_texture_cache;
 
@@ -133,6 +137,8 @@ void TextureCacheBase::Invalidate()
   }
   textures_by_address.clear();
   textures_by_hash.clear();
+  textures_by_page.clear();
+  m_tracked_memory_hashes.clear();
 
   texture_pool.clear();
 }
@@ -140,7 +146,8 @@ void TextureCacheBase::Invalidate()
 void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
 {
   if (config.bHiresTextures != backup_config.hires_textures ||
-      config.bCacheHiresTextures != backup_config.cache_hires_textures)
+      config.bCacheHiresTextures != backup_config.cache_hires_textures ||
+      config.iHiresTexturesMemoryBudget != backup_config.hires_textures_memory_budget)
   {
     HiresTexture::Update();
   }
@@ -185,7 +192,7 @@ void TextureCacheBase::Cleanup(int _frameCount)
         // host GPU are unrecoverable. Perform this check only every TEXTURE_KILL_THRESHOLD for
         // performance reasons
         if ((_frameCount - iter->second->frameCount) % TEXTURE_KILL_THRESHOLD == 1 &&
-            iter->second->hash != iter->second->CalculateHash())
+            !iter->second->HashMatchesMemory())
         {
           iter = InvalidateTexture(iter);
         }
@@ -242,6 +249,7 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   backup_config.texfmt_overlay_center = config.bTexFmtOverlayCenter;
   backup_config.hires_textures = config.bHiresTextures;
   backup_config.cache_hires_textures = config.bCacheHiresTextures;
+  backup_config.hires_textures_memory_budget = config.iHiresTexturesMemoryBudget;
   backup_config.stereo_3d = config.stereo_mode != StereoMode::Off;
   backup_config.efb_mono_depth = config.bStereoEFBMonoDepth;
   backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
@@ -314,7 +322,7 @@ TextureCacheBase::ApplyPaletteToEntry(TCacheEntry* entry, u8* palette, TLUTForma
     g_renderer->EndUtilityDrawing();
   }
 
-  textures_by_address.emplace(decoded_entry->addr, decoded_entry);
+  AddToAddressCache(decoded_entry);
 
   return decoded_entry;
 }
@@ -361,7 +369,7 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::ReinterpretEntry(const TCacheEn
   g_renderer->EndUtilityDrawing();
   reinterpreted_entry->texture->FinishedRendering();
 
-  textures_by_address.emplace(reinterpreted_entry->addr, reinterpreted_entry);
+  AddToAddressCache(reinterpreted_entry);
 
   return reinterpreted_entry;
 }
@@ -685,7 +693,7 @@ void TextureCacheBase::DoLoadState(PointerWrap& p)
 
     TCacheEntry* entry = GetEntry(id);
     if (entry)
-      textures_by_address.emplace(addr, entry);
+      AddToAddressCache(entry);
   }
 
   // Fill in hash map.
@@ -761,7 +769,7 @@ TextureCacheBase::DoPartialTextureUpdates(TCacheEntry* entry_to_update, u8* pale
         entry->OverlapsMemoryRange(entry_to_update->addr, entry_to_update->size_in_bytes) &&
         entry->memory_stride == numBlocksX * block_size)
     {
-      if (entry->hash == entry->CalculateHash())
+      if (entry->HashMatchesMemory())
       {
         // If the texture formats are not compatible or convertible, skip it.
         if (!IsCompatibleTextureFormat(entry_to_update->format.texfmt, entry->format.texfmt))
@@ -930,6 +938,46 @@ void TextureCacheBase::DumpTexture(TCacheEntry* entry, std::string basename, uns
   entry->texture->Save(filename, level);
 }
 
+static std::optional<u64> TrackWritesIfEnabled(u32 address, u32 size)
+{
+  if (!g_ActiveConfig.bWriteTrackedTextureCache)
+    return std::nullopt;
+
+  return Memory::TrackWrites(address, size);
+}
+
+u64 TextureCacheBase::GetMemoryHash(u32 address, const u8* src_data, u32 size, int sample_size)
+{
+  if (!g_ActiveConfig.bWriteTrackedTextureCache || !Memory::IsWriteTrackingEnabled())
+    return Common::GetHash64(src_data, size, sample_size);
+
+  const u64 key = (static_cast<u64>(address) << 32) | size;
+  auto iter = m_tracked_memory_hashes.find(key);
+  if (iter != m_tracked_memory_hashes.end() && iter->second.sample_size == sample_size &&
+      Memory::IsUnmodifiedSince(address, size, iter->second.write_stamp))
+  {
+    return iter->second.hash;
+  }
+
+  // Start tracking before hashing, so that a write which races with the hashing is seen next time.
+  const std::optional<u64> write_stamp = Memory::TrackWrites(address, size);
+  const u64 hash = Common::GetHash64(src_data, size, sample_size);
+  if (!write_stamp)
+  {
+    if (iter != m_tracked_memory_hashes.end())
+      m_tracked_memory_hashes.erase(iter);
+    return hash;
+  }
+
+  if (iter == m_tracked_memory_hashes.end() &&
+      m_tracked_memory_hashes.size() >= MAX_TRACKED_MEMORY_HASHES)
+  {
+    m_tracked_memory_hashes.clear();
+  }
+  m_tracked_memory_hashes[key] = {hash, sample_size, *write_stamp};
+  return hash;
+}
+
 static u32 CalculateLevelSize(u32 level_0_size, u32 level)
 {
   return std::max(level_0_size >> level, 1u);
@@ -1158,6 +1206,8 @@ private:
 
 TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
 {
+  GPUThreadProfiler::ScopedSection profile_section(GPUThreadProfiler::Section::TextureLoading);
+
   // if this stage was not invalidated by changes to texture registers, keep the current texture
   if (IsValidBindPoint(stage) && bound_textures[stage])
   {
@@ -1269,7 +1319,10 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
   // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
   // from the low tmem bank than it should)
-  base_hash = Common::GetHash64(src_data, texture_size, textureCacheSafetyColorSampleSize);
+  if (from_tmem)
+    base_hash = Common::GetHash64(src_data, texture_size, textureCacheSafetyColorSampleSize);
+  else
+    base_hash = GetMemoryHash(address, src_data, texture_size, textureCacheSafetyColorSampleSize);
   u32 palette_size = 0;
   if (isPaletteTexture)
   {
@@ -1413,6 +1466,14 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
           entry->native_levels >= tex_levels && entry->native_width == nativeW &&
           entry->native_height == nativeH)
       {
+        // Create the entry again with the custom texture once it has been loaded.
+        if (!entry->loading_custom_tex.empty() &&
+            !HiresTexture::IsLoading(entry->loading_custom_tex))
+        {
+          iter = InvalidateTexture(iter);
+          continue;
+        }
+
         entry = DoPartialTextureUpdates(iter->second, &texMem[tlutaddr], tlutfmt);
         entry->texture->FinishedRendering();
         return entry;
@@ -1474,7 +1535,8 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       TCacheEntry* entry = hash_iter->second;
       // All parameters, except the address, need to match here
       if (entry->format == full_format && entry->native_levels >= tex_levels &&
-          entry->native_width == nativeW && entry->native_height == nativeH)
+          entry->native_width == nativeW && entry->native_height == nativeH &&
+          (entry->loading_custom_tex.empty() || HiresTexture::IsLoading(entry->loading_custom_tex)))
       {
         entry = DoPartialTextureUpdates(hash_iter->second, &texMem[tlutaddr], tlutfmt);
         entry->texture->FinishedRendering();
@@ -1491,11 +1553,13 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
     InvalidateTexture(oldest_entry);
   }
 
+  // While the custom texture is loading, the game texture is used.
   std::shared_ptr<HiresTexture> hires_tex;
+  std::string loading_custom_tex;
   if (g_ActiveConfig.bHiresTextures)
   {
     hires_tex = HiresTexture::Search(src_data, texture_size, &texMem[tlutaddr], palette_size, width,
-                                     height, texformat, use_mipmaps);
+                                     height, texformat, use_mipmaps, &loading_custom_tex);
 
     if (hires_tex)
     {
@@ -1530,98 +1594,90 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
   ArbitraryMipmapDetector arbitrary_mip_detector;
   const u8* tlut = &texMem[tlutaddr];
-  if (hires_tex)
-  {
-    const auto& level = hires_tex->m_levels[0];
-    entry->texture->Load(0, level.width, level.height, level.row_length, level.data.data(),
-                         level.data.size());
-  }
 
   // Initialized to null because only software loading uses this buffer
   u8* dst_buffer = nullptr;
 
-  if (!hires_tex)
+  if (hires_tex)
   {
-    if (!decode_on_gpu ||
-        !DecodeTextureOnGPU(entry, 0, src_data, texture_size, texformat, width, height,
-                            expandedWidth, expandedHeight, bytes_per_block * (expandedWidth / bsw),
-                            tlut, tlutfmt))
+    for (u32 level_index = 0; level_index != texLevels; ++level_index)
     {
-      size_t decoded_texture_size = expandedWidth * sizeof(u32) * expandedHeight;
+      const auto& level = hires_tex->m_levels[level_index];
+      entry->texture->Load(level_index, level.width, level.height, level.row_length,
+                           level.data.data(), level.data.size());
+    }
+  }
+  else
+  {
+    // Levels which aren't decoded on the GPU are queued to the parallel decoder, so that large
+    // textures and the levels of a mip chain are decoded concurrently. They are uploaded once all
+    // of them have been decoded.
+    struct DecodedLevel
+    {
+      u32 level;
+      u32 width;
+      u32 height;
+      u32 row_length;
+      u8* data;
+      u32 size;
+    };
+    std::vector<DecodedLevel> decoded_levels;
+    decoded_levels.reserve(texLevels);
 
-      // Allocate memory for all levels at once
-      size_t total_texture_size = decoded_texture_size;
+    const auto allocate_level = [&](u32 level, u32 level_width, u32 level_height,
+                                    u32 expanded_level_width, u32 expanded_level_height) {
+      if (!dst_buffer)
+      {
+        size_t decoded_texture_size = expandedWidth * sizeof(u32) * expandedHeight;
 
-      // For the downsample, we need 2 buffers; 1 is 1/4 of the original texture, the other 1/16
-      size_t mip_downsample_buffer_size = decoded_texture_size * 5 / 16;
+        // Allocate memory for all levels at once
+        size_t total_texture_size = decoded_texture_size;
 
-      size_t prev_level_size = decoded_texture_size;
-      for (u32 i = 1; i < tex_levels; ++i)
-      {
-        prev_level_size /= 4;
-        total_texture_size += prev_level_size;
+        // For the downsample, we need 2 buffers; 1 is 1/4 of the original texture, the other 1/16
+        size_t mip_downsample_buffer_size = decoded_texture_size * 5 / 16;
+
+        size_t prev_level_size = decoded_texture_size;
+        for (u32 i = 1; i < tex_levels; ++i)
+        {
+          prev_level_size /= 4;
+          total_texture_size += prev_level_size;
+        }
+
+        // Add space for the downsampling at the end
+        total_texture_size += mip_downsample_buffer_size;
+
+        CheckTempSize(total_texture_size);
+        dst_buffer = temp;
       }
 
-      // Add space for the downsampling at the end
-      total_texture_size += mip_downsample_buffer_size;
+      const u32 decoded_level_size = expanded_level_width * sizeof(u32) * expanded_level_height;
+      decoded_levels.push_back(
+          {level, level_width, level_height, expanded_level_width, dst_buffer, decoded_level_size});
+      dst_buffer += decoded_level_size;
+      return decoded_levels.back().data;
+    };
 
-      CheckTempSize(total_texture_size);
-      dst_buffer = temp;
+    if (!decode_on_gpu ||
+        !DecodeTextureOnGPU(entry, 0, src_data, texture_size, texformat, width, height,
+                            expandedWidth, expandedHeight, bytes_per_block * (expandedWidth / bsw),
+                            tlut, tlutfmt))
+    {
+      u8* level_buffer = allocate_level(0, width, height, expandedWidth, expandedHeight);
       if (!(texformat == TextureFormat::RGBA8 && from_tmem))
       {
-        TexDecoder_Decode(dst_buffer, src_data, expandedWidth, expandedHeight, texformat, tlut,
-                          tlutfmt);
+        m_parallel_decoder.Decode(level_buffer, src_data, expandedWidth, expandedHeight,
+                                  texformat, tlut, tlutfmt);
       }
       else
       {
         u8* src_data_gb = &texMem[tmem_address_odd];
-        TexDecoder_DecodeRGBA8FromTmem(dst_buffer, src_data, src_data_gb, expandedWidth,
+        TexDecoder_DecodeRGBA8FromTmem(level_buffer, src_data, src_data_gb, expandedWidth,
                                        expandedHeight);
       }
-
-      entry->texture->Load(0, width, height, expandedWidth, dst_buffer, decoded_texture_size);
-
-      arbitrary_mip_detector.AddLevel(width, height, expandedWidth, dst_buffer);
-
-      dst_buffer += decoded_texture_size;
     }
-  }
-
-  iter = textures_by_address.emplace(address, entry);
-  if (textureCacheSafetyColorSampleSize == 0 ||
-      std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
-  {
-    entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
-  }
-
-  entry->SetGeneralParameters(address, texture_size, full_format, false);
-  entry->SetDimensions(nativeW, nativeH, tex_levels);
-  entry->SetHashes(base_hash, full_hash);
-  entry->is_custom_tex = hires_tex != nullptr;
-  entry->memory_stride = entry->BytesPerRow();
-  entry->SetNotCopy();
-
-  std::string basename;
-  if (g_ActiveConfig.bDumpTextures && !hires_tex)
-  {
-    basename = HiresTexture::GenBaseName(src_data, texture_size, &texMem[tlutaddr], palette_size,
-                                         width, height, texformat, use_mipmaps, true);
-  }
 
-  if (hires_tex)
-  {
-    for (u32 level_index = 1; level_index != texLevels; ++level_index)
-    {
-      const auto& level = hires_tex->m_levels[level_index];
-      entry->texture->Load(level_index, level.width, level.height, level.row_length,
-                           level.data.data(), level.data.size());
-    }
-  }
-  else
-  {
     // load mips - TODO: Loading mipmaps from tmem is untested!
-    src_data += texture_size;
-
+    const u8* ptr_mips = src_data + texture_size;
     const u8* ptr_even = nullptr;
     const u8* ptr_odd = nullptr;
     if (from_tmem)
@@ -1637,7 +1693,7 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       const u32 expanded_mip_width = Common::AlignUp(mip_width, bsw);
       const u32 expanded_mip_height = Common::AlignUp(mip_height, bsh);
 
-      const u8*& mip_src_data = from_tmem ? ((level % 2) ? ptr_odd : ptr_even) : src_data;
+      const u8*& mip_src_data = from_tmem ? ((level % 2) ? ptr_odd : ptr_even) : ptr_mips;
       const u32 mip_size =
           TexDecoder_GetTextureSizeInBytes(expanded_mip_width, expanded_mip_height, texformat);
 
@@ -1646,20 +1702,45 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
                               mip_height, expanded_mip_width, expanded_mip_height,
                               bytes_per_block * (expanded_mip_width / bsw), tlut, tlutfmt))
       {
-        // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
-        const u32 decoded_mip_size = expanded_mip_width * sizeof(u32) * expanded_mip_height;
-        TexDecoder_Decode(dst_buffer, mip_src_data, expanded_mip_width, expanded_mip_height,
-                          texformat, tlut, tlutfmt);
-        entry->texture->Load(level, mip_width, mip_height, expanded_mip_width, dst_buffer,
-                             decoded_mip_size);
-
-        arbitrary_mip_detector.AddLevel(mip_width, mip_height, expanded_mip_width, dst_buffer);
-
-        dst_buffer += decoded_mip_size;
+        u8* level_buffer = allocate_level(level, mip_width, mip_height, expanded_mip_width,
+                                          expanded_mip_height);
+        m_parallel_decoder.Decode(level_buffer, mip_src_data, expanded_mip_width,
+                                  expanded_mip_height, texformat, tlut, tlutfmt);
       }
 
       mip_src_data += mip_size;
     }
+
+    m_parallel_decoder.Flush();
+
+    for (const DecodedLevel& level : decoded_levels)
+    {
+      entry->texture->Load(level.level, level.width, level.height, level.row_length, level.data,
+                           level.size);
+      arbitrary_mip_detector.AddLevel(level.width, level.height, level.row_length, level.data);
+    }
+  }
+
+  entry->SetGeneralParameters(address, texture_size, full_format, false);
+  entry->SetDimensions(nativeW, nativeH, tex_levels);
+  entry->SetHashes(base_hash, full_hash);
+  entry->is_custom_tex = hires_tex != nullptr;
+  entry->loading_custom_tex = std::move(loading_custom_tex);
+  entry->memory_stride = entry->BytesPerRow();
+  entry->SetNotCopy();
+
+  iter = AddToAddressCache(entry);
+  if (textureCacheSafetyColorSampleSize == 0 ||
+      std::max(texture_size, palette_size) <= (u32)textureCacheSafetyColorSampleSize * 8)
+  {
+    entry->textures_by_hash_iter = textures_by_hash.emplace(full_hash, entry);
+  }
+
+  std::string basename;
+  if (g_ActiveConfig.bDumpTextures && !hires_tex)
+  {
+    basename = HiresTexture::GenBaseName(src_data, texture_size, &texMem[tlutaddr], palette_size,
+                                         width, height, texformat, use_mipmaps, true);
   }
 
   entry->has_arbitrary_mips = hires_tex ? hires_tex->HasArbitraryMipmaps() :
@@ -1749,7 +1830,7 @@ TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, u32 stride,
   entry->texture->FinishedRendering();
 
   // Insert into the texture cache so we can re-use it next frame, if needed.
-  textures_by_address.emplace(entry->addr, entry);
+  AddToAddressCache(entry);
   SETSTAT(g_stats.num_textures_alive, static_cast<int>(textures_by_address.size()));
   INCSTAT(g_stats.num_textures_uploaded);
 
@@ -1832,7 +1913,7 @@ void TextureCacheBase::StitchXFBCopy(TCacheEntry* stitched_entry)
         entry->OverlapsMemoryRange(stitched_entry->addr, stitched_entry->size_in_bytes) &&
         entry->memory_stride == stitched_entry->memory_stride)
     {
-      if (entry->hash == entry->CalculateHash())
+      if (entry->HashMatchesMemory())
       {
         // Can't check the height here because of Y scaling.
         if (entry->native_width != entry->GetWidth())
@@ -2313,9 +2394,8 @@ void TextureCacheBase::CopyRenderTargetToTexture(
   // in a subsequent draw before it is flushed, it will have the same hash.
   if (entry)
   {
-    const u64 hash = entry->CalculateHash();
-    entry->SetHashes(hash, hash);
-    textures_by_address.emplace(dstAddr, entry);
+    entry->UpdateHashesFromMemory();
+    AddToAddressCache(entry);
   }
 }
 
@@ -2355,8 +2435,7 @@ void TextureCacheBase::FlushEFBCopy(TCacheEntry* entry)
 
   // Re-hash the texture now that the guest memory is populated.
   // This should be safe because we'll catch any writes before the game can modify it.
-  const u64 hash = entry->CalculateHash();
-  entry->SetHashes(hash, hash);
+  entry->UpdateHashesFromMemory();
 
   // Check for any overlapping XFB copies which now need the hash recomputed.
   // See the comment above regarding Rogue Squadron 2.
@@ -2524,20 +2603,59 @@ TextureCacheBase::GetTexCacheIter(TextureCacheBase::TCacheEntry* entry)
 std::pair<TextureCacheBase::TexAddrCache::iterator, TextureCacheBase::TexAddrCache::iterator>
 TextureCacheBase::FindOverlappingTextures(u32 addr, u32 size_in_bytes)
 {
-  // We index by the starting address only, so there is no way to query all textures
-  // which end after the given addr. But the GC textures have a limited size, so we
-  // look for all textures which have a start address bigger than addr minus the maximal
-  // texture size. But this yields false-positives which must be checked later on.
+  // textures_by_address is sorted by start address, so all textures starting inside the range are
+  // contiguous. Any texture starting before the range that overlaps it must cover addr, and thus
+  // the page addr is in, so the page index tells us how far back the range needs to start.
+  // Textures which start there but end before addr are false positives, checked by the caller.
+  u32 lower_addr = addr;
+  const auto page = textures_by_page.find(addr >> ADDRESS_INDEX_PAGE_SHIFT);
+  if (page != textures_by_page.end() && !page->second.empty())
+    lower_addr = std::min(lower_addr, *page->second.begin());
 
-  // 1024 x 1024 texel times 8 nibbles per texel
-  constexpr u32 max_texture_size = 1024 * 1024 * 4;
-  u32 lower_addr = addr > max_texture_size ? addr - max_texture_size : 0;
   auto begin = textures_by_address.lower_bound(lower_addr);
   auto end = textures_by_address.upper_bound(addr + size_in_bytes);
 
+  INCSTAT(g_stats.this_frame.num_texture_overlap_lookups);
+  ADDSTAT(g_stats.this_frame.num_texture_overlap_candidates, std::distance(begin, end));
+
   return std::make_pair(begin, end);
 }
 
+// Returns the range of pages in the page index covered by a texture.
+static std::pair<u32, u32> GetIndexedPages(u32 addr, u32 size_in_bytes, u32 page_shift)
+{
+  const u64 end = u64(addr) + std::max(size_in_bytes, 1u);
+  return {addr >> page_shift, static_cast<u32>((end - 1) >> page_shift)};
+}
+
+TextureCacheBase::TexAddrCache::iterator TextureCacheBase::AddToAddressCache(TCacheEntry* entry)
+{
+  std::tie(entry->first_indexed_page, entry->last_indexed_page) =
+      GetIndexedPages(entry->addr, entry->size_in_bytes, ADDRESS_INDEX_PAGE_SHIFT);
+  for (u32 page = entry->first_indexed_page; page <= entry->last_indexed_page; ++page)
+    textures_by_page[page].insert(entry->addr);
+
+  return textures_by_address.emplace(entry->addr, entry);
+}
+
+TextureCacheBase::TexAddrCache::iterator
+TextureCacheBase::RemoveFromAddressCache(TexAddrCache::iterator iter)
+{
+  const TCacheEntry* entry = iter->second;
+  for (u32 page = entry->first_indexed_page; page <= entry->last_indexed_page; ++page)
+  {
+    auto page_iter = textures_by_page.find(page);
+    ASSERT(page_iter != textures_by_page.end());
+    auto addr_iter = page_iter->second.find(iter->first);
+    ASSERT(addr_iter != page_iter->second.end());
+    page_iter->second.erase(addr_iter);
+    if (page_iter->second.empty())
+      textures_by_page.erase(page_iter);
+  }
+
+  return textures_by_address.erase(iter);
+}
+
 TextureCacheBase::TexAddrCache::iterator
 TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pending_efb_copy)
 {
@@ -2598,7 +2716,7 @@ TextureCacheBase::InvalidateTexture(TexAddrCache::iterator iter, bool discard_pe
   if (!entry->pending_efb_copy)
     delete entry;
 
-  return textures_by_address.erase(iter);
+  return RemoveFromAddressCache(iter);
 }
 
 bool TextureCacheBase::CreateUtilityTextures()
@@ -2927,6 +3045,30 @@ u64 TextureCacheBase::TCacheEntry::CalculateHash() const
   }
 }
 
+void TextureCacheBase::TCacheEntry::UpdateHashesFromMemory()
+{
+  const std::optional<u64> write_stamp = TrackWritesIfEnabled(addr, size_in_bytes);
+  const u64 new_hash = CalculateHash();
+  SetHashes(new_hash, new_hash);
+  hash_write_stamp = write_stamp;
+}
+
+bool TextureCacheBase::TCacheEntry::HashMatchesMemory()
+{
+  if (hash_write_stamp && g_ActiveConfig.bWriteTrackedTextureCache &&
+      Memory::IsUnmodifiedSince(addr, size_in_bytes, *hash_write_stamp))
+  {
+    return true;
+  }
+
+  hash_write_stamp = TrackWritesIfEnabled(addr, size_in_bytes);
+  if (hash == CalculateHash())
+    return true;
+
+  hash_write_stamp.reset();
+  return false;
+}
+
 TextureCacheBase::TexPoolEntry::TexPoolEntry(std::unique_ptr<AbstractTexture> tex,
                                              std::unique_ptr<AbstractFramebuffer> fb)
     : texture(std::move(tex)), framebuffer(std::move(fb))
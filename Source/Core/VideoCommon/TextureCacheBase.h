@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -19,6 +20,7 @@
 #include "Common/MathUtil.h"
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/ParallelTextureDecoder.h"
 #include "VideoCommon/TextureConfig.h"
 #include "VideoCommon/TextureDecoder.h"
 
@@ -97,6 +99,8 @@ public:
     u32 memory_stride;
     bool is_efb_copy;
     bool is_custom_tex;
+    // The custom texture that was still loading when the entry was created
+    std::string loading_custom_tex;
     bool may_have_overlapping_textures = true;
     bool tmem_only = false;           // indicates that this texture only exists in the tmem cache
     bool has_arbitrary_mips = false;  // indicates that the mips in this texture are arbitrary
@@ -119,6 +123,11 @@ public:
     // removing the cache entry
     std::multimap<u64, TCacheEntry*>::iterator textures_by_hash_iter;
 
+    // The pages of textures_by_page that the entry was added to, which don't change if its size
+    // does while it is in the address cache
+    u32 first_indexed_page = 0;
+    u32 last_indexed_page = 0;
+
     // This is used to keep track of both:
     //   * efb copies used by this partially updated texture
     //   * partially updated textures which refer to this efb copy
@@ -130,6 +139,9 @@ public:
     u32 pending_efb_copy_height = 0;
     bool pending_efb_copy_invalidated = false;
 
+    // Write tracking stamp (see Memory::TrackWrites) of the memory the hash was calculated from.
+    std::optional<u64> hash_write_stamp;
+
     explicit TCacheEntry(std::unique_ptr<AbstractTexture> tex,
                          std::unique_ptr<AbstractFramebuffer> fb);
 
@@ -157,6 +169,7 @@ public:
     {
       base_hash = _base_hash;
       hash = _hash;
+      hash_write_stamp.reset();
     }
 
     // This texture entry is used by the other entry as a sub-texture
@@ -179,6 +192,11 @@ public:
     u32 BytesPerRow() const;
 
     u64 CalculateHash() const;
+    // Sets both hashes to CalculateHash(), and tracks writes to the hashed memory if enabled.
+    void UpdateHashesFromMemory();
+    // Equivalent to hash == CalculateHash(), but skips hashing if write tracking shows that the
+    // memory hasn't been written to since the hash was calculated.
+    bool HashMatchesMemory();
 
     int HashSampleSize() const;
     u32 GetWidth() const { return texture->GetConfig().width; }
@@ -285,6 +303,8 @@ private:
 
   TCacheEntry* GetXFBFromCache(u32 address, u32 width, u32 height, u32 stride, u64 hash);
 
+  u64 GetMemoryHash(u32 address, const u8* src_data, u32 size, int sample_size);
+
   TCacheEntry* ApplyPaletteToEntry(TCacheEntry* entry, u8* palette, TLUTFormat tlutfmt);
 
   TCacheEntry* ReinterpretEntry(const TCacheEntry* existing_entry, TextureFormat new_format);
@@ -301,8 +321,12 @@ private:
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
   TexAddrCache::iterator GetTexCacheIter(TCacheEntry* entry);
 
-  // Return all possible overlapping textures. As addr+size of the textures is not
-  // indexed, this may return false positives.
+  // Adds the entry to textures_by_address and the page index, once its address and size are set.
+  TexAddrCache::iterator AddToAddressCache(TCacheEntry* entry);
+  TexAddrCache::iterator RemoveFromAddressCache(TexAddrCache::iterator iter);
+
+  // Return all possible overlapping textures. The range starts at the lowest address of any
+  // texture overlapping addr, so this may return false positives.
   std::pair<TexAddrCache::iterator, TexAddrCache::iterator>
   FindOverlappingTextures(u32 addr, u32 size_in_bytes);
 
@@ -335,6 +359,11 @@ private:
 
   TexAddrCache textures_by_address;
   TexHashCache textures_by_hash;
+
+  // Start addresses of the textures in textures_by_address that overlap each page of memory.
+  // FindOverlappingTextures uses this to find where the textures overlapping an address begin.
+  static constexpr u32 ADDRESS_INDEX_PAGE_SHIFT = 16;
+  std::unordered_map<u32, std::multiset<u32>> textures_by_page;
   TexPool texture_pool;
   u64 last_entry_id = 0;
 
@@ -346,6 +375,7 @@ private:
     bool texfmt_overlay_center;
     bool hires_textures;
     bool cache_hires_textures;
+    int hires_textures_memory_budget;
     bool copy_cache_enable;
     bool stereo_3d;
     bool efb_mono_depth;
@@ -355,6 +385,16 @@ private:
   };
   BackupConfig backup_config = {};
 
+  // Hashes of texture data in guest memory, keyed by address and size. They are reused for as
+  // long as write tracking shows that the memory hasn't been written to.
+  struct TrackedMemoryHash
+  {
+    u64 hash;
+    int sample_size;
+    u64 write_stamp;
+  };
+  std::unordered_map<u64, TrackedMemoryHash> m_tracked_memory_hashes;
+
   // Encoding texture used for EFB copies to RAM.
   std::unique_ptr<AbstractTexture> m_efb_encoding_texture;
   std::unique_ptr<AbstractFramebuffer> m_efb_encoding_framebuffer;
@@ -362,6 +402,9 @@ private:
   // Decoding texture used for GPU texture decoding.
   std::unique_ptr<AbstractTexture> m_decoding_texture;
 
+  // Worker threads used for CPU texture decoding.
+  ParallelTextureDecoder m_parallel_decoder;
+
   // Pool of readback textures used for deferred EFB copies.
   std::vector<std::unique_ptr<AbstractStagingTexture>> m_efb_copy_staging_texture_pool;
 
@@ -161,6 +161,33 @@ static inline void DecodeBytes_IA4(u32* dst, const u8* src)
   }
 }
 
+// Decodes the first count entries of a palette to RGBA8. Returns false for invalid TLUT formats,
+// which the decoders leave the texture untouched for.
+static bool DecodePalette(u32* palette, const u8* tlut_, TLUTFormat tlutfmt, int count)
+{
+  const u16* tlut = (const u16*)tlut_;
+  switch (tlutfmt)
+  {
+  case TLUTFormat::IA8:
+    for (int i = 0; i < count; i++)
+      palette[i] = DecodePixel_IA8(tlut[i]);
+    return true;
+
+  case TLUTFormat::RGB565:
+    for (int i = 0; i < count; i++)
+      palette[i] = DecodePixel_RGB565(Common::swap16(tlut[i]));
+    return true;
+
+  case TLUTFormat::RGB5A3:
+    for (int i = 0; i < count; i++)
+      palette[i] = DecodePixel_RGB5A3(Common::swap16(tlut[i]));
+    return true;
+
+  default:
+    return false;
+  }
+}
+
 #ifdef CHECK
 static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 {
@@ -250,6 +277,47 @@ static void TexDecoder_DecodeImpl_C4(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C4_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // The 16 palette entries are decoded once and kept in two registers, so that each row of 8
+  // texels is looked up with two permutes.
+  alignas(32) u32 palette[16];
+  if (!DecodePalette(palette, tlut, tlutfmt, 16))
+    return;
+
+  const __m256i palette_lo = _mm256_load_si256((const __m256i*)palette);
+  const __m256i palette_hi = _mm256_load_si256((const __m256i*)(palette + 8));
+  // The high nibble of each byte is the left texel.
+  const __m256i nibble_shifts = _mm256_set_epi32(0, 4, 0, 4, 0, 4, 0, 4);
+  const __m256i kMask_x0f = _mm256_set1_epi32(0xf);
+  const __m256i kSeven = _mm256_set1_epi32(7);
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 8 * yStep; iy < 8; iy++, xStep++)
+      {
+        u32 row;
+        std::memcpy(&row, src + 4 * xStep, sizeof(row));
+        // (0000 0000 0000 dcba) -> (ddcc bbaa) with each byte in its own 32-bit word
+        const __m128i bytes = _mm_cvtsi32_si128(row);
+        const __m256i doubled = _mm256_cvtepu8_epi32(_mm_unpacklo_epi8(bytes, bytes));
+        const __m256i index =
+            _mm256_and_si256(_mm256_srlv_epi32(doubled, nibble_shifts), kMask_x0f);
+
+        // The permutes only look at the low 3 bits of the index.
+        const __m256i lo = _mm256_permutevar8x32_epi32(palette_lo, index);
+        const __m256i hi = _mm256_permutevar8x32_epi32(palette_hi, index);
+        const __m256i texels = _mm256_blendv_epi8(lo, hi, _mm256_cmpgt_epi32(index, kSeven));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), texels);
+      }
+    }
+  }
+}
+
 FUNCTION_TARGET_SSSE3
 static void TexDecoder_DecodeImpl_I4_SSSE3(u32* dst, const u8* src, int width, int height,
                                            TextureFormat texformat, const u8* tlut,
@@ -559,6 +627,31 @@ static void TexDecoder_DecodeImpl_C8(u32* dst, const u8* src, int width, int hei
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Decoding all 256 palette entries up front turns every texel into a single gathered load.
+  alignas(32) u32 palette[256];
+  if (!DecodePalette(palette, tlut, tlutfmt, 256))
+    return;
+
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int iy = 0, xStep = 4 * yStep; iy < 4; iy++, xStep++)
+      {
+        const __m256i index =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + 8 * xStep)));
+        const __m256i texels = _mm256_i32gather_epi32((const int*)palette, index, 4);
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), texels);
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_IA4(u32* dst, const u8* src, int width, int height,
                                       TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                       int Wsteps4, int Wsteps8)
@@ -600,6 +693,32 @@ static void TexDecoder_DecodeImpl_IA8_SSSE3(u32* dst, const u8* src, int width,
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Like the SSSE3 version, but for two rows of a block at a time.
+  const __m256i mask = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(12, 13, 13, 13, 8, 9, 9, 9, 4, 5, 5, 5, 0, 1, 1, 1));
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0; iy < 4; iy += 2)
+      {
+        // Widen 8x 16-bit IA8 samples from two rows to (00hg 00fe 00dc 00ba) in each lane, then
+        // shuffle to (ghhh efff cddd abbb).
+        const __m128i r0 = _mm_loadu_si128((const __m128i*)(src + 32 * yStep + 8 * iy));
+        const __m256i r1 = _mm256_shuffle_epi8(_mm256_cvtepu16_epi32(r0), mask);
+        _mm_storeu_si128((__m128i*)(dst + (y + iy) * width + x), _mm256_castsi256_si128(r1));
+        _mm_storeu_si128((__m128i*)(dst + (y + iy + 1) * width + x),
+                         _mm256_extracti128_si256(r1, 1));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_IA8(u32* dst, const u8* src, int width, int height,
                                       TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                       int Wsteps4, int Wsteps8)
@@ -877,6 +996,69 @@ static void TexDecoder_DecodeImpl_RGB5A3_SSSE3(u32* dst, const u8* src, int widt
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB5A3_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m128i kByteSwap = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+  const __m256i kMask_x1f = _mm256_set1_epi32(0x1f);
+  const __m256i kMask_x0f = _mm256_set1_epi32(0xf);
+  const __m256i kMask_x07 = _mm256_set1_epi32(0x7);
+  const __m256i kAlpha = _mm256_set1_epi32(0xFF000000);
+
+  // Unlike the SSSE3 version, both encodings are always decoded and the right one is selected
+  // per texel, so there is no scalar fallback for blocks that mix them.
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      for (int iy = 0; iy < 4; iy += 2)
+      {
+        // 8x 16-bit texels from two rows, byte swapped and widened to 32 bits.
+        const __m256i val = _mm256_cvtepu16_epi32(_mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i*)(src + 32 * yStep + 8 * iy)), kByteSwap));
+
+        // RGB555: swizzle bits 00012345 -> 12345123
+        const __m256i tmpr5 = _mm256_and_si256(_mm256_srli_epi32(val, 10), kMask_x1f);
+        const __m256i tmpg5 = _mm256_and_si256(_mm256_srli_epi32(val, 5), kMask_x1f);
+        const __m256i tmpb5 = _mm256_and_si256(val, kMask_x1f);
+        const __m256i r5 =
+            _mm256_or_si256(_mm256_slli_epi32(tmpr5, 3), _mm256_srli_epi32(tmpr5, 2));
+        const __m256i g5 =
+            _mm256_or_si256(_mm256_slli_epi32(tmpg5, 3), _mm256_srli_epi32(tmpg5, 2));
+        const __m256i b5 =
+            _mm256_or_si256(_mm256_slli_epi32(tmpb5, 3), _mm256_srli_epi32(tmpb5, 2));
+        const __m256i rgb555 =
+            _mm256_or_si256(_mm256_or_si256(r5, _mm256_slli_epi32(g5, 8)),
+                            _mm256_or_si256(_mm256_slli_epi32(b5, 16), kAlpha));
+
+        // RGBA4443: swizzle bits 00001234 -> 12341234 and 00000123 -> 12312312
+        const __m256i tmpr4 = _mm256_and_si256(_mm256_srli_epi32(val, 8), kMask_x0f);
+        const __m256i tmpg4 = _mm256_and_si256(_mm256_srli_epi32(val, 4), kMask_x0f);
+        const __m256i tmpb4 = _mm256_and_si256(val, kMask_x0f);
+        const __m256i tmpa3 = _mm256_and_si256(_mm256_srli_epi32(val, 12), kMask_x07);
+        const __m256i r4 = _mm256_or_si256(_mm256_slli_epi32(tmpr4, 4), tmpr4);
+        const __m256i g4 = _mm256_or_si256(_mm256_slli_epi32(tmpg4, 4), tmpg4);
+        const __m256i b4 = _mm256_or_si256(_mm256_slli_epi32(tmpb4, 4), tmpb4);
+        const __m256i a3 = _mm256_or_si256(
+            _mm256_slli_epi32(tmpa3, 5),
+            _mm256_or_si256(_mm256_slli_epi32(tmpa3, 2), _mm256_srli_epi32(tmpa3, 1)));
+        const __m256i rgba4443 =
+            _mm256_or_si256(_mm256_or_si256(r4, _mm256_slli_epi32(g4, 8)),
+                            _mm256_or_si256(_mm256_slli_epi32(b4, 16), _mm256_slli_epi32(a3, 24)));
+
+        // The top bit of each texel selects the encoding.
+        const __m256i is_rgb555 = _mm256_srai_epi32(_mm256_slli_epi32(val, 16), 31);
+        const __m256i texels = _mm256_blendv_epi8(rgba4443, rgb555, is_rgb555);
+        _mm_storeu_si128((__m128i*)(dst + (y + iy) * width + x), _mm256_castsi256_si128(texels));
+        _mm_storeu_si128((__m128i*)(dst + (y + iy + 1) * width + x),
+                         _mm256_extracti128_si256(texels, 1));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_RGB5A3(u32* dst, const u8* src, int width, int height,
                                          TextureFormat texformat, const u8* tlut,
                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
@@ -1032,6 +1214,60 @@ static void TexDecoder_DecodeImpl_RGBA8_SSSE3(u32* dst, const u8* src, int width
   }
 }
 
+// Decodes the 4x4 RGBA8 block. even_rows receives rows 0 and 2, odd_rows rows 1 and 3.
+FUNCTION_TARGET_AVX2
+static inline void DecodeRGBA8Block_AVX2(const u8* block, __m256i* even_rows, __m256i* odd_rows)
+{
+  const __m256i mask0312 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(12, 15, 13, 14, 8, 11, 9, 10, 4, 7, 5, 6, 0, 3, 1, 2));
+  const __m256i ar = _mm256_loadu_si256((const __m256i*)block);
+  const __m256i gb = _mm256_loadu_si256((const __m256i*)block + 1);
+  *even_rows = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar, gb), mask0312);
+  *odd_rows = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar, gb), mask0312);
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGBA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Same as the SSSE3 version, but with both halves of the AR and GB components in one register
+  // each: the low lane makes up rows 0 and 1 of the block, the high lane rows 2 and 3. Two blocks
+  // are decoded at a time, so that whole rows of 8 texels can be written at once.
+  for (int y = 0; y < height; y += 4)
+  {
+    int x = 0;
+    int yStep = (y / 4) * Wsteps4;
+    for (; x + 8 <= width; x += 8, yStep += 2)
+    {
+      __m256i even0, odd0, even1, odd1;
+      DecodeRGBA8Block_AVX2(src + 64 * yStep, &even0, &odd0);
+      DecodeRGBA8Block_AVX2(src + 64 * (yStep + 1), &even1, &odd1);
+
+      _mm256_storeu_si256((__m256i*)(dst + (y + 0) * width + x),
+                          _mm256_permute2x128_si256(even0, even1, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst + (y + 1) * width + x),
+                          _mm256_permute2x128_si256(odd0, odd1, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst + (y + 2) * width + x),
+                          _mm256_permute2x128_si256(even0, even1, 0x31));
+      _mm256_storeu_si256((__m256i*)(dst + (y + 3) * width + x),
+                          _mm256_permute2x128_si256(odd0, odd1, 0x31));
+    }
+
+    // Textures that are an odd number of blocks wide have one block left over.
+    if (x < width)
+    {
+      __m256i even, odd;
+      DecodeRGBA8Block_AVX2(src + 64 * yStep, &even, &odd);
+
+      _mm_storeu_si128((__m128i*)(dst + (y + 0) * width + x), _mm256_castsi256_si128(even));
+      _mm_storeu_si128((__m128i*)(dst + (y + 1) * width + x), _mm256_castsi256_si128(odd));
+      _mm_storeu_si128((__m128i*)(dst + (y + 2) * width + x), _mm256_extracti128_si256(even, 1));
+      _mm_storeu_si128((__m128i*)(dst + (y + 3) * width + x), _mm256_extracti128_si256(odd, 1));
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_RGBA8(u32* dst, const u8* src, int width, int height,
                                         TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                         int Wsteps4, int Wsteps8)
@@ -1153,6 +1389,159 @@ static void TexDecoder_DecodeImpl_RGBA8(u32* dst, const u8* src, int width, int
   }
 }
 
+// Computes the four colors of each of the two DXT blocks in dxt, in the order they are indexed.
+static inline void DecodeDXTBlockPairColors(__m128i dxt, __m128i* colors0, __m128i* colors1)
+{
+  // JSD NOTE: You may see many strange patterns of behavior in the below code, but they
+  // are for performance reasons. Sometimes, calculating what should be obvious hard-coded
+  // constants is faster than loading their values from memory. Unfortunately, there is no
+  // way to inline 128-bit constants from opcodes so they must be loaded from memory. This
+  // seems a little ridiculous to me in that you can't even generate a constant value of 1
+  // without having to load it from memory. So, I stored the minimal constant I could,
+  // 128-bits worth of 1s :). Then I use sequences of shifts to squash it to the appropriate
+  // size and bitpositions that I need.
+  const __m128i allFFs128 = _mm_cmpeq_epi32(_mm_setzero_si128(), _mm_setzero_si128());
+
+  __m128i argb888x4;
+  __m128i c1 = _mm_unpackhi_epi16(dxt, dxt);
+  c1 = _mm_slli_si128(c1, 8);
+  const __m128i c0 =
+      _mm_or_si128(c1, _mm_srli_si128(_mm_slli_si128(_mm_unpacklo_epi16(dxt, dxt), 8), 8));
+
+  // Compare rgb0 to rgb1:
+  // Each 32-bit word will contain either 0xFFFFFFFF or 0x00000000 for true/false.
+  const __m128i c0cmp = _mm_srli_epi32(_mm_slli_epi32(_mm_srli_epi64(c0, 8), 16), 16);
+  const __m128i c0shr = _mm_srli_epi64(c0cmp, 32);
+  const __m128i cmprgb0rgb1 = _mm_cmpgt_epi32(c0cmp, c0shr);
+
+  int cmp0 = _mm_extract_epi16(cmprgb0rgb1, 0);
+  int cmp1 = _mm_extract_epi16(cmprgb0rgb1, 4);
+
+  // green:
+  // NOTE: We start with the larger number of bits (6) firts for G and shift the mask down
+  // 1 bit to get a 5-bit mask later for R and B components.
+  // low6mask == _mm_set_epi32(0x0000FC00, 0x0000FC00, 0x0000FC00, 0x0000FC00)
+  const __m128i low6mask = _mm_slli_epi32(_mm_srli_epi32(allFFs128, 24 + 2), 8 + 2);
+  const __m128i gtmp = _mm_srli_epi32(c0, 3);
+  const __m128i g0 = _mm_and_si128(gtmp, low6mask);
+  // low3mask == _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300)
+  const __m128i g1 = _mm_and_si128(
+      _mm_srli_epi32(gtmp, 6), _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300));
+  argb888x4 = _mm_or_si128(g0, g1);
+  // red:
+  // low5mask == _mm_set_epi32(0x000000F8, 0x000000F8, 0x000000F8, 0x000000F8)
+  const __m128i low5mask = _mm_slli_epi32(_mm_srli_epi32(low6mask, 8 + 3), 3);
+  const __m128i r0 = _mm_and_si128(c0, low5mask);
+  const __m128i r1 = _mm_srli_epi32(r0, 5);
+  argb888x4 = _mm_or_si128(argb888x4, _mm_or_si128(r0, r1));
+  // blue:
+  // _mm_slli_epi32(low5mask, 16) == _mm_set_epi32(0x00F80000, 0x00F80000, 0x00F80000,
+  // 0x00F80000)
+  const __m128i b0 = _mm_and_si128(_mm_srli_epi32(c0, 5), _mm_slli_epi32(low5mask, 16));
+  const __m128i b1 = _mm_srli_epi16(b0, 5);
+  // OR in the fixed alpha component
+  // _mm_slli_epi32( allFFs128, 24 ) == _mm_set_epi32(0xFF000000, 0xFF000000, 0xFF000000,
+  // 0xFF000000)
+  argb888x4 = _mm_or_si128(_mm_or_si128(argb888x4, _mm_slli_epi32(allFFs128, 24)),
+                           _mm_or_si128(b0, b1));
+  // calculate RGB2 and RGB3:
+  const __m128i rgb0 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(2, 2, 0, 0));
+  const __m128i rgb1 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(3, 3, 1, 1));
+  const __m128i rrggbb0 =
+      _mm_and_si128(_mm_unpacklo_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb1 =
+      _mm_and_si128(_mm_unpacklo_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb01 =
+      _mm_and_si128(_mm_unpackhi_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
+  const __m128i rrggbb11 =
+      _mm_and_si128(_mm_unpackhi_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
+
+  __m128i rgb2, rgb3;
+
+  // if (rgb0 > rgb1):
+  if (cmp0 != 0)
+  {
+    // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
+    // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
+    const __m128i rrggbbsum = _mm_add_epi16(rrggbb0, rrggbb1);
+
+    const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb0, 1);
+    const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb0, 2);
+
+    const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb1, 1);
+    const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb1, 2);
+
+    const __m128i rrggbb2 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
+    const __m128i rrggbb3 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
+
+    const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
+    const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
+
+    rgb2 = _mm_and_si128(rgb2dup, _mm_srli_si128(allFFs128, 8));
+    rgb3 = _mm_and_si128(rgb3dup, _mm_srli_si128(allFFs128, 8));
+  }
+  else
+  {
+    // RGB2b = avg(RGB0, RGB1)
+    const __m128i rrggbb21 = _mm_srai_epi16(_mm_add_epi16(rrggbb0, rrggbb1), 1);
+    const __m128i rgb210 = _mm_srli_si128(_mm_packus_epi16(rrggbb21, rrggbb21), 8);
+    rgb2 = rgb210;
+    rgb3 = _mm_and_si128(rgb210, _mm_srli_epi32(allFFs128, 8));
+  }
+
+  // if (rgb0 > rgb1):
+  if (cmp1 != 0)
+  {
+    // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
+    // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
+    const __m128i rrggbbsum = _mm_add_epi16(rrggbb01, rrggbb11);
+
+    const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb01, 1);
+    const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb01, 2);
+
+    const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb11, 1);
+    const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb11, 2);
+
+    const __m128i rrggbb2 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
+    const __m128i rrggbb3 =
+        _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
+
+    const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
+    const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
+
+    rgb2 = _mm_or_si128(rgb2, _mm_and_si128(rgb2dup, _mm_slli_si128(allFFs128, 8)));
+    rgb3 = _mm_or_si128(rgb3, _mm_and_si128(rgb3dup, _mm_slli_si128(allFFs128, 8)));
+  }
+  else
+  {
+    // RGB2b = avg(RGB0, RGB1)
+    const __m128i rrggbb211 = _mm_srai_epi16(_mm_add_epi16(rrggbb01, rrggbb11), 1);
+    const __m128i rgb211 = _mm_slli_si128(_mm_packus_epi16(rrggbb211, rrggbb211), 8);
+    rgb2 = _mm_or_si128(rgb2, rgb211);
+
+    // _mm_srli_epi32( allFFs128, 8 ) == _mm_set_epi32(0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF,
+    // 0x00FFFFFF)
+    // Make this color fully transparent:
+    rgb3 = _mm_or_si128(rgb3, _mm_and_si128(_mm_and_si128(rgb2, _mm_srli_epi32(allFFs128, 8)),
+                                            _mm_slli_si128(allFFs128, 8)));
+  }
+
+  // Create an array for color lookups for DXT0 so we can use the 2-bit indices:
+  *colors0 = _mm_or_si128(
+      _mm_or_si128(_mm_srli_si128(_mm_slli_si128(argb888x4, 8), 8),
+                   _mm_slli_si128(_mm_srli_si128(_mm_slli_si128(rgb2, 8), 8 + 4), 8)),
+      _mm_slli_si128(_mm_srli_si128(rgb3, 4), 8 + 4));
+
+  // Create an array for color lookups for DXT1 so we can use the 2-bit indices:
+  *colors1 =
+      _mm_or_si128(_mm_or_si128(_mm_srli_si128(argb888x4, 8),
+                                _mm_slli_si128(_mm_srli_si128(rgb2, 8 + 4), 8)),
+                   _mm_slli_si128(_mm_srli_si128(rgb3, 8 + 4), 8 + 4));
+}
+
 static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int height,
                                        TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                        int Wsteps4, int Wsteps8)
@@ -1172,16 +1561,6 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
       // parallelizable at this level, so we do.
       for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
       {
-        // JSD NOTE: You may see many strange patterns of behavior in the below code, but they
-        // are for performance reasons. Sometimes, calculating what should be obvious hard-coded
-        // constants is faster than loading their values from memory. Unfortunately, there is no
-        // way to inline 128-bit constants from opcodes so they must be loaded from memory. This
-        // seems a little ridiculous to me in that you can't even generate a constant value of 1
-        // without having to load it from memory. So, I stored the minimal constant I could,
-        // 128-bits worth of 1s :). Then I use sequences of shifts to squash it to the appropriate
-        // size and bitpositions that I need.
-        const __m128i allFFs128 = _mm_cmpeq_epi32(_mm_setzero_si128(), _mm_setzero_si128());
-
         // Load 128 bits, i.e. two DXTBlocks (64-bits each)
         const __m128i dxt = _mm_loadu_si128((__m128i*)(src + sizeof(struct DXTBlock) * 2 * xStep));
 
@@ -1192,144 +1571,8 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
         u32 dxt0sel = dxttmp[1];
         u32 dxt1sel = dxttmp[3];
 
-        __m128i argb888x4;
-        __m128i c1 = _mm_unpackhi_epi16(dxt, dxt);
-        c1 = _mm_slli_si128(c1, 8);
-        const __m128i c0 =
-            _mm_or_si128(c1, _mm_srli_si128(_mm_slli_si128(_mm_unpacklo_epi16(dxt, dxt), 8), 8));
-
-        // Compare rgb0 to rgb1:
-        // Each 32-bit word will contain either 0xFFFFFFFF or 0x00000000 for true/false.
-        const __m128i c0cmp = _mm_srli_epi32(_mm_slli_epi32(_mm_srli_epi64(c0, 8), 16), 16);
-        const __m128i c0shr = _mm_srli_epi64(c0cmp, 32);
-        const __m128i cmprgb0rgb1 = _mm_cmpgt_epi32(c0cmp, c0shr);
-
-        int cmp0 = _mm_extract_epi16(cmprgb0rgb1, 0);
-        int cmp1 = _mm_extract_epi16(cmprgb0rgb1, 4);
-
-        // green:
-        // NOTE: We start with the larger number of bits (6) firts for G and shift the mask down
-        // 1 bit to get a 5-bit mask later for R and B components.
-        // low6mask == _mm_set_epi32(0x0000FC00, 0x0000FC00, 0x0000FC00, 0x0000FC00)
-        const __m128i low6mask = _mm_slli_epi32(_mm_srli_epi32(allFFs128, 24 + 2), 8 + 2);
-        const __m128i gtmp = _mm_srli_epi32(c0, 3);
-        const __m128i g0 = _mm_and_si128(gtmp, low6mask);
-        // low3mask == _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300)
-        const __m128i g1 = _mm_and_si128(
-            _mm_srli_epi32(gtmp, 6), _mm_set_epi32(0x00000300, 0x00000300, 0x00000300, 0x00000300));
-        argb888x4 = _mm_or_si128(g0, g1);
-        // red:
-        // low5mask == _mm_set_epi32(0x000000F8, 0x000000F8, 0x000000F8, 0x000000F8)
-        const __m128i low5mask = _mm_slli_epi32(_mm_srli_epi32(low6mask, 8 + 3), 3);
-        const __m128i r0 = _mm_and_si128(c0, low5mask);
-        const __m128i r1 = _mm_srli_epi32(r0, 5);
-        argb888x4 = _mm_or_si128(argb888x4, _mm_or_si128(r0, r1));
-        // blue:
-        // _mm_slli_epi32(low5mask, 16) == _mm_set_epi32(0x00F80000, 0x00F80000, 0x00F80000,
-        // 0x00F80000)
-        const __m128i b0 = _mm_and_si128(_mm_srli_epi32(c0, 5), _mm_slli_epi32(low5mask, 16));
-        const __m128i b1 = _mm_srli_epi16(b0, 5);
-        // OR in the fixed alpha component
-        // _mm_slli_epi32( allFFs128, 24 ) == _mm_set_epi32(0xFF000000, 0xFF000000, 0xFF000000,
-        // 0xFF000000)
-        argb888x4 = _mm_or_si128(_mm_or_si128(argb888x4, _mm_slli_epi32(allFFs128, 24)),
-                                 _mm_or_si128(b0, b1));
-        // calculate RGB2 and RGB3:
-        const __m128i rgb0 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(2, 2, 0, 0));
-        const __m128i rgb1 = _mm_shuffle_epi32(argb888x4, _MM_SHUFFLE(3, 3, 1, 1));
-        const __m128i rrggbb0 =
-            _mm_and_si128(_mm_unpacklo_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb1 =
-            _mm_and_si128(_mm_unpacklo_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb01 =
-            _mm_and_si128(_mm_unpackhi_epi8(rgb0, rgb0), _mm_srli_epi16(allFFs128, 8));
-        const __m128i rrggbb11 =
-            _mm_and_si128(_mm_unpackhi_epi8(rgb1, rgb1), _mm_srli_epi16(allFFs128, 8));
-
-        __m128i rgb2, rgb3;
-
-        // if (rgb0 > rgb1):
-        if (cmp0 != 0)
-        {
-          // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
-          // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
-          const __m128i rrggbbsum = _mm_add_epi16(rrggbb0, rrggbb1);
-
-          const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb0, 1);
-          const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb0, 2);
-
-          const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb1, 1);
-          const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb1, 2);
-
-          const __m128i rrggbb2 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
-          const __m128i rrggbb3 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
-
-          const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
-          const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
-
-          rgb2 = _mm_and_si128(rgb2dup, _mm_srli_si128(allFFs128, 8));
-          rgb3 = _mm_and_si128(rgb3dup, _mm_srli_si128(allFFs128, 8));
-        }
-        else
-        {
-          // RGB2b = avg(RGB0, RGB1)
-          const __m128i rrggbb21 = _mm_srai_epi16(_mm_add_epi16(rrggbb0, rrggbb1), 1);
-          const __m128i rgb210 = _mm_srli_si128(_mm_packus_epi16(rrggbb21, rrggbb21), 8);
-          rgb2 = rgb210;
-          rgb3 = _mm_and_si128(rgb210, _mm_srli_epi32(allFFs128, 8));
-        }
-
-        // if (rgb0 > rgb1):
-        if (cmp1 != 0)
-        {
-          // RGB2 = (RGB0 * 5 + RGB1 * 3) / 8 = (RGB0 << 2 + RGB1 << 1 + (RGB0 + RGB1)) >> 3
-          // RGB3 = (RGB0 * 3 + RGB1 * 5) / 8 = (RGB0 << 1 + RGB1 << 2 + (RGB0 + RGB1)) >> 3
-          const __m128i rrggbbsum = _mm_add_epi16(rrggbb01, rrggbb11);
-
-          const __m128i rrggbb0shl1 = _mm_slli_epi16(rrggbb01, 1);
-          const __m128i rrggbb0shl2 = _mm_slli_epi16(rrggbb01, 2);
-
-          const __m128i rrggbb1shl1 = _mm_slli_epi16(rrggbb11, 1);
-          const __m128i rrggbb1shl2 = _mm_slli_epi16(rrggbb11, 2);
-
-          const __m128i rrggbb2 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl2, rrggbb1shl1), rrggbbsum), 3);
-          const __m128i rrggbb3 =
-              _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rrggbb0shl1, rrggbb1shl2), rrggbbsum), 3);
-
-          const __m128i rgb2dup = _mm_packus_epi16(rrggbb2, rrggbb2);
-          const __m128i rgb3dup = _mm_packus_epi16(rrggbb3, rrggbb3);
-
-          rgb2 = _mm_or_si128(rgb2, _mm_and_si128(rgb2dup, _mm_slli_si128(allFFs128, 8)));
-          rgb3 = _mm_or_si128(rgb3, _mm_and_si128(rgb3dup, _mm_slli_si128(allFFs128, 8)));
-        }
-        else
-        {
-          // RGB2b = avg(RGB0, RGB1)
-          const __m128i rrggbb211 = _mm_srai_epi16(_mm_add_epi16(rrggbb01, rrggbb11), 1);
-          const __m128i rgb211 = _mm_slli_si128(_mm_packus_epi16(rrggbb211, rrggbb211), 8);
-          rgb2 = _mm_or_si128(rgb2, rgb211);
-
-          // _mm_srli_epi32( allFFs128, 8 ) == _mm_set_epi32(0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF,
-          // 0x00FFFFFF)
-          // Make this color fully transparent:
-          rgb3 = _mm_or_si128(rgb3, _mm_and_si128(_mm_and_si128(rgb2, _mm_srli_epi32(allFFs128, 8)),
-                                                  _mm_slli_si128(allFFs128, 8)));
-        }
-
-        // Create an array for color lookups for DXT0 so we can use the 2-bit indices:
-        const __m128i mmcolors0 = _mm_or_si128(
-            _mm_or_si128(_mm_srli_si128(_mm_slli_si128(argb888x4, 8), 8),
-                         _mm_slli_si128(_mm_srli_si128(_mm_slli_si128(rgb2, 8), 8 + 4), 8)),
-            _mm_slli_si128(_mm_srli_si128(rgb3, 4), 8 + 4));
-
-        // Create an array for color lookups for DXT1 so we can use the 2-bit indices:
-        const __m128i mmcolors1 =
-            _mm_or_si128(_mm_or_si128(_mm_srli_si128(argb888x4, 8),
-                                      _mm_slli_si128(_mm_srli_si128(rgb2, 8 + 4), 8)),
-                         _mm_slli_si128(_mm_srli_si128(rgb3, 8 + 4), 8 + 4));
+        __m128i mmcolors0, mmcolors1;
+        DecodeDXTBlockPairColors(dxt, &mmcolors0, &mmcolors1);
 
 // The #ifdef CHECKs here and below are to compare correctness of output against the reference code.
 // Don't use them in a normal build.
@@ -1409,6 +1652,52 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_CMPR_AVX2(u32* dst, const u8* src, int width, int height,
+                                            TextureFormat texformat, const u8* tlut,
+                                            TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // The colors are computed like in the SSE2 version. The colors of both DXT blocks then fit in
+  // a single register, so that each row of 8 texels is looked up with one permute instead of 8
+  // scalar loads and stores.
+
+  // The 2-bit index of the leftmost texel is in the top bits of each row's byte.
+  const __m256i index_shifts = _mm256_set_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  // Texels of the second block index its colors in the upper half of the register.
+  const __m256i block_offsets = _mm256_set_epi32(4, 4, 4, 4, 0, 0, 0, 0);
+  const __m256i kMask_x03 = _mm256_set1_epi32(3);
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0, yStep = (y / 8) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      for (int z = 0, xStep = 2 * yStep; z < 2; ++z, xStep++)
+      {
+        const u8* block_pair = src + sizeof(struct DXTBlock) * 2 * xStep;
+        const __m128i dxt = _mm_loadu_si128((const __m128i*)block_pair);
+
+        __m128i colors0, colors1;
+        DecodeDXTBlockPairColors(dxt, &colors0, &colors1);
+        const __m256i colors = _mm256_inserti128_si256(_mm256_castsi128_si256(colors0), colors1, 1);
+
+        // The indices of both blocks, with one row per byte: (sel1 sel1 sel1 sel1 sel0 sel0 ...)
+        const __m256i sel = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(dxt),
+                                                        _mm256_set_epi32(3, 3, 3, 3, 1, 1, 1, 1));
+
+        u32* dst32 = dst + (y + z * 4) * width + x;
+        for (int row = 0; row < 4; row++)
+        {
+          const __m256i row_sel = _mm256_srli_epi32(sel, row * 8);
+          const __m256i index = _mm256_or_si256(
+              _mm256_and_si256(_mm256_srlv_epi32(row_sel, index_shifts), kMask_x03),
+              block_offsets);
+          _mm256_storeu_si256((__m256i*)(dst32 + width * row),
+                              _mm256_permutevar8x32_epi32(colors, index));
+        }
+      }
+    }
+  }
+}
+
 void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
                             const u8* tlut, TLUTFormat tlutfmt)
 {
@@ -1418,7 +1707,11 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
   switch (texformat)
   {
   case TextureFormat::C4:
-    TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::I4:
@@ -1438,7 +1731,11 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C8:
-    TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::IA4:
@@ -1446,7 +1743,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::IA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_IA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                       Wsteps8);
     else
@@ -1465,7 +1765,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGB5A3:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB5A3_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGB5A3_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                          Wsteps8);
     else
@@ -1474,7 +1777,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGBA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGBA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGBA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                         Wsteps8);
     else
@@ -1483,7 +1789,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::CMPR:
-    TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_CMPR_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                      Wsteps8);
+    else
+      TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                 Wsteps8);
     break;
 
   case TextureFormat::XFB:
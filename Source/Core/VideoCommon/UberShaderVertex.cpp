@@ -43,6 +43,8 @@ ShaderCode GenVertexShader(APIType ApiType, const ShaderHostConfig& host_config,
   else
     out.Write("cbuffer VSBlock {\n");
   out.Write(s_shader_uniforms);
+  if (host_config.merge_draws)
+    out.Write(s_draw_matrix_uniforms);
   out.Write("};\n");
 
   out.Write("struct VS_OUTPUT {\n");
@@ -141,8 +143,21 @@ ShaderCode GenVertexShader(APIType ApiType, const ShaderHostConfig& host_config,
             "  int normidx = posidx >= 32 ? (posidx - 32) : posidx;\n"
             "  N0 = " I_NORMALMATRICES "[normidx].xyz;\n"
             "  N1 = " I_NORMALMATRICES "[normidx+1].xyz;\n"
-            "  N2 = " I_NORMALMATRICES "[normidx+2].xyz;\n"
-            "} else {\n"
+            "  N2 = " I_NORMALMATRICES "[normidx+2].xyz;\n");
+  if (host_config.merge_draws)
+  {
+    out.Write("} else if ((components & %uu) != 0u) { // VB_HAS_DRAWMTXIDX\n"
+              "  // The matrices of the draw that the vertex belongs to\n"
+              "  int drawidx = int(posmtx.r) * 6;\n"
+              "  P0 = " I_DRAWMATRICES "[drawidx];\n"
+              "  P1 = " I_DRAWMATRICES "[drawidx+1];\n"
+              "  P2 = " I_DRAWMATRICES "[drawidx+2];\n"
+              "  N0 = " I_DRAWMATRICES "[drawidx+3].xyz;\n"
+              "  N1 = " I_DRAWMATRICES "[drawidx+4].xyz;\n"
+              "  N2 = " I_DRAWMATRICES "[drawidx+5].xyz;\n",
+              VB_HAS_DRAWMTXIDX);
+  }
+  out.Write("} else {\n"
             "  // One shared matrix\n"
             "  P0 = " I_POSNORMALMATRIX "[0];\n"
             "  P1 = " I_POSNORMALMATRIX "[1];\n"
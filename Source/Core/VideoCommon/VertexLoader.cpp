@@ -28,6 +28,12 @@ static void PosMtx_ReadDirect_UByte(VertexLoader* loader)
   PRIM_LOG("posmtx: %d, ", posmtx);
 }
 
+static void DrawMtx_Skip(VertexLoader* loader)
+{
+  // Filled in by VertexLoaderManager.
+  DataWrite<u32>(0);
+}
+
 static void TexMtx_ReadDirect_UByte(VertexLoader* loader)
 {
   loader->m_curtexmtx[loader->m_texmtxread] = DataRead<u8>() & 0x3f;
@@ -65,8 +71,9 @@ static void SkipVertex(VertexLoader* loader)
   }
 }
 
-VertexLoader::VertexLoader(const TVtxDesc& vtx_desc, const VAT& vtx_attr)
-    : VertexLoaderBase(vtx_desc, vtx_attr)
+VertexLoader::VertexLoader(const TVtxDesc& vtx_desc, const VAT& vtx_attr,
+                           bool draw_matrix_index)
+    : VertexLoaderBase(vtx_desc, vtx_attr, draw_matrix_index)
 {
   CompileVertexTranslator();
 
@@ -109,6 +116,17 @@ void VertexLoader::CompileVertexTranslator()
     nat_offset += 4;
     m_VertexSize += 1;
   }
+  else if (m_draw_matrix_index)
+  {
+    WriteCall(DrawMtx_Skip);
+    components |= VB_HAS_DRAWMTXIDX;
+    m_native_vtx_decl.posmtx.components = 4;
+    m_native_vtx_decl.posmtx.enable = true;
+    m_native_vtx_decl.posmtx.offset = nat_offset;
+    m_native_vtx_decl.posmtx.type = VAR_UNSIGNED_BYTE;
+    m_native_vtx_decl.posmtx.integer = true;
+    nat_offset += 4;
+  }
 
   if (m_VtxDesc.Tex0MatIdx)
   {
@@ -19,7 +19,7 @@ typedef void (*TPipelineFunction)(VertexLoader* loader);
 class VertexLoader : public VertexLoaderBase
 {
 public:
-  VertexLoader(const TVtxDesc& vtx_desc, const VAT& vtx_attr);
+  VertexLoader(const TVtxDesc& vtx_desc, const VAT& vtx_attr, bool draw_matrix_index);
 
   int RunVertices(DataReader src, DataReader dst, int count) override;
   std::string GetName() const override { return "OldLoader"; }
@@ -33,8 +33,9 @@ alignas(16) static const float scale_factors[] = {
     1.0 / (1ULL << 28), 1.0 / (1ULL << 29), 1.0 / (1ULL << 30), 1.0 / (1ULL << 31),
 };
 
-VertexLoaderARM64::VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_att)
-    : VertexLoaderBase(vtx_desc, vtx_att), m_float_emit(this)
+VertexLoaderARM64::VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_att,
+                                     bool draw_matrix_index)
+    : VertexLoaderBase(vtx_desc, vtx_att, draw_matrix_index), m_float_emit(this)
 {
   if (!IsInitialized())
     return;
@@ -421,6 +422,19 @@ void VertexLoaderARM64::GenerateVertexLoader()
     m_src_ofs += sizeof(u8);
     m_dst_ofs += sizeof(u32);
   }
+  else if (m_draw_matrix_index)
+  {
+    // Filled in by VertexLoaderManager.
+    STR(INDEX_UNSIGNED, WZR, dst_reg, m_dst_ofs);
+
+    m_native_components |= VB_HAS_DRAWMTXIDX;
+    m_native_vtx_decl.posmtx.components = 4;
+    m_native_vtx_decl.posmtx.enable = true;
+    m_native_vtx_decl.posmtx.offset = m_dst_ofs;
+    m_native_vtx_decl.posmtx.type = VAR_UNSIGNED_BYTE;
+    m_native_vtx_decl.posmtx.integer = true;
+    m_dst_ofs += sizeof(u32);
+  }
 
   u32 texmatidx_ofs[8];
   const u64 tm[8] = {
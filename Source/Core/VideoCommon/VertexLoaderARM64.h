@@ -13,11 +13,12 @@ class DataReader;
 class VertexLoaderARM64 : public VertexLoaderBase, public Arm64Gen::ARM64CodeBlock
 {
 public:
-  VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_att);
+  VertexLoaderARM64(const TVtxDesc& vtx_desc, const VAT& vtx_att, bool draw_matrix_index);
 
 protected:
   std::string GetName() const override { return "VertexLoaderARM64"; }
   bool IsInitialized() override { return true; }
+  bool CanRunConcurrently() const override { return true; }
   int RunVertices(DataReader src, DataReader dst, int count) override;
 
 private:
@@ -13,6 +13,7 @@
 
 #include <fmt/format.h>
 
+#include "Common/BitSet.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
@@ -26,8 +27,9 @@
 #include "VideoCommon/VertexLoaderARM64.h"
 #endif
 
-VertexLoaderBase::VertexLoaderBase(const TVtxDesc& vtx_desc, const VAT& vtx_attr)
-    : m_VtxDesc{vtx_desc}, m_vat{vtx_attr}
+VertexLoaderBase::VertexLoaderBase(const TVtxDesc& vtx_desc, const VAT& vtx_attr,
+                                   bool draw_matrix_index)
+    : m_VtxDesc{vtx_desc}, m_vat{vtx_attr}, m_draw_matrix_index{draw_matrix_index}
 {
   SetVAT(vtx_attr);
 }
@@ -140,17 +142,34 @@ std::string VertexLoaderBase::ToString() const
     dest += fmt::format("T{}: {} {}-{} ", i, tex_coord.Elements, pos_mode[tex_mode[i]],
                         pos_formats[tex_coord.Format]);
   }
-  dest += fmt::format(" - {} v", m_numLoadedVertices);
+  dest += fmt::format(" - {} v", m_numLoadedVertices.load());
   return dest;
 }
 
+bool VertexLoaderBase::HasSkippedVertices(const u8* src, int count) const
+{
+  if (!(m_VtxDesc.Position & MASK_INDEXED))
+    return false;
+
+  // The position index follows the matrix indices, which take a byte each.
+  const u32 index_offset = Common::CountSetBits(static_cast<u32>(m_VtxDesc.Hex & 0x1FF));
+  const bool is_16_bit = m_VtxDesc.Position == INDEX16;
+  for (int i = 0; i < count; i++)
+  {
+    const u8* const index = src + i * m_VertexSize + index_offset;
+    if (index[0] == 0xFF && (!is_16_bit || index[1] == 0xFF))
+      return true;
+  }
+  return false;
+}
+
 // a hacky implementation to compare two vertex loaders
 class VertexLoaderTester : public VertexLoaderBase
 {
 public:
   VertexLoaderTester(std::unique_ptr<VertexLoaderBase> a_, std::unique_ptr<VertexLoaderBase> b_,
-                     const TVtxDesc& vtx_desc, const VAT& vtx_attr)
-      : VertexLoaderBase(vtx_desc, vtx_attr), a(std::move(a_)), b(std::move(b_))
+                     const TVtxDesc& vtx_desc, const VAT& vtx_attr, bool draw_matrix_index)
+      : VertexLoaderBase(vtx_desc, vtx_attr, draw_matrix_index), a(std::move(a_)), b(std::move(b_))
   {
     m_initialized = a && b && a->IsInitialized() && b->IsInitialized();
 
@@ -217,7 +236,8 @@ private:
 };
 
 std::unique_ptr<VertexLoaderBase> VertexLoaderBase::CreateVertexLoader(const TVtxDesc& vtx_desc,
-                                                                       const VAT& vtx_attr)
+                                                                       const VAT& vtx_attr,
+                                                                       bool draw_matrix_index)
 {
   std::unique_ptr<VertexLoaderBase> loader;
 
@@ -226,23 +246,25 @@ std::unique_ptr<VertexLoaderBase> VertexLoaderBase::CreateVertexLoader(const TVt
 #if defined(COMPARE_VERTEXLOADERS) && defined(_M_X86_64)
   // first try: Any new VertexLoader vs the old one
   loader = std::make_unique<VertexLoaderTester>(
-      std::make_unique<VertexLoader>(vtx_desc, vtx_attr),     // the software one
-      std::make_unique<VertexLoaderX64>(vtx_desc, vtx_attr),  // the new one to compare
-      vtx_desc, vtx_attr);
+      // the software one
+      std::make_unique<VertexLoader>(vtx_desc, vtx_attr, draw_matrix_index),
+      // the new one to compare
+      std::make_unique<VertexLoaderX64>(vtx_desc, vtx_attr, draw_matrix_index),
+      vtx_desc, vtx_attr, draw_matrix_index);
   if (loader->IsInitialized())
     return loader;
 #elif defined(_M_X86_64)
-  loader = std::make_unique<VertexLoaderX64>(vtx_desc, vtx_attr);
+  loader = std::make_unique<VertexLoaderX64>(vtx_desc, vtx_attr, draw_matrix_index);
   if (loader->IsInitialized())
     return loader;
 #elif defined(_M_ARM_64)
-  loader = std::make_unique<VertexLoaderARM64>(vtx_desc, vtx_attr);
+  loader = std::make_unique<VertexLoaderARM64>(vtx_desc, vtx_attr, draw_matrix_index);
   if (loader->IsInitialized())
     return loader;
 #endif
 
   // last try: The old VertexLoader
-  loader = std::make_unique<VertexLoader>(vtx_desc, vtx_attr);
+  loader = std::make_unique<VertexLoader>(vtx_desc, vtx_attr, draw_matrix_index);
   if (loader->IsInitialized())
     return loader;
 
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -16,18 +17,19 @@ class DataReader;
 
 class VertexLoaderUID
 {
-  std::array<u32, 5> vid;
+  std::array<u32, 6> vid;
   size_t hash;
 
 public:
   VertexLoaderUID() {}
-  VertexLoaderUID(const TVtxDesc& vtx_desc, const VAT& vat)
+  VertexLoaderUID(const TVtxDesc& vtx_desc, const VAT& vat, bool draw_matrix_index = false)
   {
     vid[0] = vtx_desc.Hex & 0xFFFFFFFF;
     vid[1] = vtx_desc.Hex >> 32;
     vid[2] = vat.g0.Hex;
     vid[3] = vat.g1.Hex;
     vid[4] = vat.g2.Hex;
+    vid[5] = draw_matrix_index;
     hash = CalculateHash();
   }
 
@@ -60,13 +62,21 @@ struct hash<VertexLoaderUID>
 class VertexLoaderBase
 {
 public:
-  static std::unique_ptr<VertexLoaderBase> CreateVertexLoader(const TVtxDesc& vtx_desc,
-                                                              const VAT& vtx_attr);
+  // With draw_matrix_index, the vertices get a slot for the draw matrix index instead of a position
+  // matrix index, which is left zero by the loader. Only for formats without any matrix indices.
+  static std::unique_ptr<VertexLoaderBase>
+  CreateVertexLoader(const TVtxDesc& vtx_desc, const VAT& vtx_attr, bool draw_matrix_index = false);
   virtual ~VertexLoaderBase() {}
   virtual int RunVertices(DataReader src, DataReader dst, int count) = 0;
 
   virtual bool IsInitialized() = 0;
 
+  // Whether RunVertices can be called from several threads at once, for different vertices.
+  virtual bool CanRunConcurrently() const { return false; }
+
+  // Returns true if any of the vertices would be skipped for having a position index of -1.
+  bool HasSkippedVertices(const u8* src, int count) const;
+
   // For debugging / profiling
   std::string ToString() const;
 
@@ -79,14 +89,15 @@ public:
 
   // used by VertexLoaderManager
   NativeVertexFormat* m_native_vertex_format = nullptr;
-  int m_numLoadedVertices = 0;
+  std::atomic<int> m_numLoadedVertices = 0;
 
 protected:
-  VertexLoaderBase(const TVtxDesc& vtx_desc, const VAT& vtx_attr);
+  VertexLoaderBase(const TVtxDesc& vtx_desc, const VAT& vtx_attr, bool draw_matrix_index);
   void SetVAT(const VAT& vat);
 
   // GC vertex format
   TVtxAttr m_VtxAttr;  // VAT decoded into easy format
   TVtxDesc m_VtxDesc;  // Not really used currently - or well it is, but could be easily avoided.
   VAT m_vat;
+  bool m_draw_matrix_index;
 };
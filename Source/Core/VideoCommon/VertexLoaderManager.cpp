@@ -5,6 +5,7 @@
 #include "VideoCommon/VertexLoaderManager.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -20,13 +21,16 @@
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/GPUThreadProfiler.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/ParallelVertexLoader.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
+#include "VideoCommon/VideoConfig.h"
 
 namespace VertexLoaderManager
 {
@@ -45,10 +49,24 @@ static std::mutex s_vertex_loader_map_lock;
 static VertexLoaderMap s_vertex_loader_map;
 // TODO - change into array of pointers. Keep a map of all seen so far.
 
+static std::unique_ptr<ParallelVertexLoader> s_parallel_loader;
+
+// Draw matrix indices of draws whose vertices are still being converted.
+struct PendingDrawMatrixIndex
+{
+  u8* vertices;
+  int count;
+  u32 stride;
+  u32 offset;
+  u32 index;
+};
+static std::vector<PendingDrawMatrixIndex> s_pending_draw_matrix_indices;
+
 u8* cached_arraybases[12];
 
 void Init()
 {
+  s_parallel_loader = std::make_unique<ParallelVertexLoader>();
   MarkAllDirty();
   for (auto& map_entry : g_main_cp_state.vertex_loaders)
     map_entry = nullptr;
@@ -59,6 +77,9 @@ void Init()
 
 void Clear()
 {
+  WaitForPendingVertices();
+  s_parallel_loader.reset();
+
   std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
   s_vertex_loader_map.clear();
   s_native_vertex_map.clear();
@@ -70,6 +91,8 @@ void UpdateVertexArrayPointers()
   if (!g_main_cp_state.bases_dirty)
     return;
 
+  WaitForPendingVertices();
+
   // Some games such as Burnout 2 can put invalid addresses into
   // the array base registers. (see issue 8591)
   // But the vertex arrays with invalid addresses aren't actually enabled.
@@ -198,6 +221,9 @@ NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl)
   return GetOrCreateMatchingFormat(new_decl);
 }
 
+// PosMatIdx and Tex0MatIdx - Tex7MatIdx of TVtxDesc.
+static constexpr u64 MATRIX_INDEX_ATTRIBUTES_MASK = 0x1FF;
+
 static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = false)
 {
   CPState* state = preprocess ? &g_preprocess_cp_state : &g_main_cp_state;
@@ -210,7 +236,10 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
     // thread
     bool check_for_native_format = !preprocess;
 
-    VertexLoaderUID uid(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
+    // Vertices with matrix indices select matrices that are only valid until they are written to.
+    const bool draw_matrix_index = g_ActiveConfig.UseDrawMerging() &&
+                                   (state->vtx_desc.Hex & MATRIX_INDEX_ATTRIBUTES_MASK) == 0;
+    VertexLoaderUID uid(state->vtx_desc, state->vtx_attr[vtx_attr_group], draw_matrix_index);
     std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
     VertexLoaderMap::iterator iter = s_vertex_loader_map.find(uid);
     if (iter != s_vertex_loader_map.end())
@@ -221,7 +250,8 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
     else
     {
       s_vertex_loader_map[uid] =
-          VertexLoaderBase::CreateVertexLoader(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
+          VertexLoaderBase::CreateVertexLoader(state->vtx_desc, state->vtx_attr[vtx_attr_group],
+                                               draw_matrix_index);
       loader = s_vertex_loader_map[uid].get();
       INCSTAT(g_stats.num_vertex_loaders);
     }
@@ -249,7 +279,63 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
   return loader;
 }
 
-int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess)
+static void SetVertexFormat(VertexLoaderBase* loader)
+{
+  // If the native vertex format changed, force a flush.
+  if (loader->m_native_vertex_format != s_current_vtx_fmt ||
+      loader->m_native_components != g_current_components)
+  {
+    g_vertex_manager->Flush();
+  }
+  s_current_vtx_fmt = loader->m_native_vertex_format;
+  g_current_components = loader->m_native_components;
+  VertexShaderManager::SetVertexFormat(loader->m_native_components);
+}
+
+static bool HasIndexedAttributes(TVtxDesc vtx_desc)
+{
+  for (int i = 0; i < 12; i++)
+  {
+    if (vtx_desc.GetVertexArrayStatus(i) & MASK_INDEXED)
+      return true;
+  }
+  return false;
+}
+
+static void StoreVertices(CachedVertices* cache, const u8* vertices, int count,
+                          const PortableVertexDeclaration& vtx_decl)
+{
+  cache->data.assign(vertices, vertices + count * vtx_decl.stride);
+  cache->count = count;
+  cache->vtx_decl = vtx_decl;
+  std::copy_n(&position_cache[0][0], 3 * 4, &cache->position_cache[0][0]);
+  std::copy_n(position_matrix_index, 4, cache->position_matrix_index);
+}
+
+static void WriteDrawMatrixIndex(const PendingDrawMatrixIndex& draw)
+{
+  for (int i = 0; i < draw.count; ++i)
+    std::memcpy(draw.vertices + i * draw.stride + draw.offset, &draw.index, sizeof(u32));
+}
+
+// Sets the draw matrix index of count vertices at dst, if the loader left a slot for it.
+static void SetDrawMatrixIndex(const VertexLoaderBase* loader, u8* dst, int count)
+{
+  if (!(loader->m_native_components & VB_HAS_DRAWMTXIDX))
+    return;
+
+  const PortableVertexDeclaration& decl = loader->m_native_vtx_decl;
+  const PendingDrawMatrixIndex draw{dst, count, static_cast<u32>(decl.stride),
+                                    static_cast<u32>(decl.posmtx.offset),
+                                    VertexShaderManager::GetDrawMatrixIndex()};
+  if (s_parallel_loader->IsBusy())
+    s_pending_draw_matrix_indices.push_back(draw);
+  else
+    WriteDrawMatrixIndex(draw);
+}
+
+int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess,
+                CachedVertices* cache)
 {
   if (!count)
     return 0;
@@ -263,15 +349,10 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   if (is_preprocess)
     return size;
 
-  // If the native vertex format changed, force a flush.
-  if (loader->m_native_vertex_format != s_current_vtx_fmt ||
-      loader->m_native_components != g_current_components)
-  {
-    g_vertex_manager->Flush();
-  }
-  s_current_vtx_fmt = loader->m_native_vertex_format;
-  g_current_components = loader->m_native_components;
-  VertexShaderManager::SetVertexFormat(loader->m_native_components);
+  GPUThreadProfiler::ScopedSection profile_section(GPUThreadProfiler::Section::VertexLoading);
+  SetVertexFormat(loader);
+  if (loader->m_native_components & VB_HAS_DRAWMTXIDX)
+    VertexShaderManager::ReserveDrawMatrix();
 
   // if cull mode is CULL_ALL, tell VertexManager to skip triangles and quads.
   // They still need to go through vertex loading, because we need to calculate a zfreeze refrence
@@ -281,7 +362,19 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   DataReader dst = g_vertex_manager->PrepareForAdditionalData(
       primitive, count, loader->m_native_vtx_decl.stride, cullall);
 
-  count = loader->RunVertices(src, dst, count);
+  if (cache)
+  {
+    // The converted vertices are needed right away.
+    WaitForPendingVertices();
+    count = loader->RunVertices(src, dst, count);
+    if (!HasIndexedAttributes(g_main_cp_state.vtx_desc))
+      StoreVertices(cache, dst.GetPointer(), count, loader->m_native_vtx_decl);
+  }
+  else
+  {
+    count = s_parallel_loader->RunVertices(loader, src, dst, count);
+  }
+  SetDrawMatrixIndex(loader, dst.GetPointer(), count);
 
   g_vertex_manager->AddIndices(primitive, count);
   g_vertex_manager->FlushData(count, loader->m_native_vtx_decl.stride);
@@ -291,6 +384,58 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   return size;
 }
 
+bool RunCachedVertices(int vtx_attr_group, int primitive, const CachedVertices& cache)
+{
+  GPUThreadProfiler::ScopedSection profile_section(GPUThreadProfiler::Section::VertexLoading);
+  VertexLoaderBase* loader = RefreshLoader(vtx_attr_group);
+  if (!(loader->m_native_vtx_decl == cache.vtx_decl))
+    return false;
+
+  SetVertexFormat(loader);
+  if (loader->m_native_components & VB_HAS_DRAWMTXIDX)
+    VertexShaderManager::ReserveDrawMatrix();
+
+  const bool cullall = bpmem.genMode.cullmode == GenMode::CULL_ALL && primitive < 5;
+  const u32 stride = loader->m_native_vtx_decl.stride;
+  DataReader dst =
+      g_vertex_manager->PrepareForAdditionalData(primitive, cache.count, stride, cullall);
+  std::copy(cache.data.begin(), cache.data.end(), dst.GetPointer());
+  SetDrawMatrixIndex(loader, dst.GetPointer(), cache.count);
+
+  // The vertex loader writes the zfreeze positions of the last three vertices only.
+  if (s_parallel_loader->IsBusy())
+  {
+    s_parallel_loader->SetZFreezePositions(loader->m_native_vtx_decl, cache.data.data(),
+                                           cache.count);
+  }
+  else
+  {
+    const int zfreeze_vertices = std::min(cache.count, 3);
+    std::copy_n(&cache.position_cache[0][0], zfreeze_vertices * 4, &position_cache[0][0]);
+    if (g_main_cp_state.vtx_desc.PosMatIdx)
+      std::copy_n(&cache.position_matrix_index[1], zfreeze_vertices, &position_matrix_index[1]);
+  }
+
+  g_vertex_manager->AddIndices(primitive, cache.count);
+  g_vertex_manager->FlushData(cache.count, stride);
+
+  ADDSTAT(g_stats.this_frame.num_prims, cache.count);
+  INCSTAT(g_stats.this_frame.num_primitive_joins);
+  return true;
+}
+
+void WaitForPendingVertices()
+{
+  if (!s_parallel_loader)
+    return;
+
+  s_parallel_loader->WaitForCompletion();
+
+  for (const PendingDrawMatrixIndex& draw : s_pending_draw_matrix_indices)
+    WriteDrawMatrixIndex(draw);
+  s_pending_draw_matrix_indices.clear();
+}
+
 NativeVertexFormat* GetCurrentVertexFormat()
 {
   return s_current_vtx_fmt;
@@ -353,6 +498,8 @@ void LoadCPReg(u32 sub_cmd, u32 value, bool is_preprocess)
     break;
 
   case 0xB0:
+    if (update_global_state)
+      VertexLoaderManager::WaitForPendingVertices();
     state->array_strides[sub_cmd & 0xF] = value & 0xFF;
     break;
   }
@@ -7,12 +7,12 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "VideoCommon/NativeVertexFormat.h"
 
 class DataReader;
-class NativeVertexFormat;
-struct PortableVertexDeclaration;
 
 namespace VertexLoaderManager
 {
@@ -34,8 +34,33 @@ NativeVertexFormat* GetOrCreateMatchingFormat(const PortableVertexDeclaration& d
 // offsets set to the unused attributes.
 NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl);
 
-// Returns -1 if buf_size is insufficient, else the amount of bytes consumed
-int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess);
+// Converted vertices of a draw, which can be drawn again without running the vertex loader.
+struct CachedVertices
+{
+  std::vector<u8> data;
+  int count = 0;
+  // The native format the vertices were converted to. Settings like draw merging change it.
+  PortableVertexDeclaration vtx_decl{};
+  // The zfreeze positions written by the vertex loader.
+  float position_cache[3][4];
+  u32 position_matrix_index[4];
+};
+
+// Returns -1 if buf_size is insufficient, else the amount of bytes consumed.
+// If cache is given and the converted vertices only depend on src (i.e. no attribute is indexed),
+// they are stored in it. Otherwise it is left empty.
+int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bool is_preprocess,
+                CachedVertices* cache = nullptr);
+
+// Draws vertices stored by RunVertices. The vertex format must be the same as when they were
+// converted. Returns false without drawing if the vertex loader converts to a different native
+// format now, in which case the vertices have to be converted again.
+bool RunCachedVertices(int vtx_attr_group, int primitive, const CachedVertices& cache);
+
+// The vertices of large draws are converted on worker threads. This blocks until all of them have
+// been written to the vertex buffer, and must be called before the buffer is submitted, the vertex
+// array state is changed, or the source data goes away.
+void WaitForPendingVertices();
 
 // For debugging
 std::string VertexLoadersToString();
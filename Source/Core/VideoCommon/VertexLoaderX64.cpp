@@ -40,8 +40,9 @@ static OpArg MPIC(const void* ptr)
   return MDisp(base_reg, PtrOffset(ptr, memory_base_ptr));
 }
 
-VertexLoaderX64::VertexLoaderX64(const TVtxDesc& vtx_desc, const VAT& vtx_att)
-    : VertexLoaderBase(vtx_desc, vtx_att)
+VertexLoaderX64::VertexLoaderX64(const TVtxDesc& vtx_desc, const VAT& vtx_att,
+                                 bool draw_matrix_index)
+    : VertexLoaderBase(vtx_desc, vtx_att, draw_matrix_index)
 {
   if (!IsInitialized())
     return;
@@ -427,6 +428,19 @@ void VertexLoaderX64::GenerateVertexLoader()
     m_src_ofs += sizeof(u8);
     m_dst_ofs += sizeof(u32);
   }
+  else if (m_draw_matrix_index)
+  {
+    // Filled in by VertexLoaderManager.
+    MOV(32, MDisp(dst_reg, m_dst_ofs), Imm32(0));
+
+    m_native_components |= VB_HAS_DRAWMTXIDX;
+    m_native_vtx_decl.posmtx.components = 4;
+    m_native_vtx_decl.posmtx.enable = true;
+    m_native_vtx_decl.posmtx.offset = m_dst_ofs;
+    m_native_vtx_decl.posmtx.type = VAR_UNSIGNED_BYTE;
+    m_native_vtx_decl.posmtx.integer = true;
+    m_dst_ofs += sizeof(u32);
+  }
 
   u32 texmatidx_ofs[8];
   const u64 tm[8] = {
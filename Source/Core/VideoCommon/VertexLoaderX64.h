@@ -11,11 +11,12 @@
 class VertexLoaderX64 : public VertexLoaderBase, public Gen::X64CodeBlock
 {
 public:
-  VertexLoaderX64(const TVtxDesc& vtx_desc, const VAT& vtx_att);
+  VertexLoaderX64(const TVtxDesc& vtx_desc, const VAT& vtx_att, bool draw_matrix_index);
 
 protected:
   std::string GetName() const override { return "VertexLoaderX64"; }
   bool IsInitialized() override { return true; }
+  bool CanRunConcurrently() const override { return true; }
   int RunVertices(DataReader src, DataReader dst, int count) override;
 
 private:
@@ -20,6 +20,7 @@
 #include "VideoCommon/BoundingBox.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/FramebufferManager.h"
+#include "VideoCommon/GPUThreadProfiler.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
@@ -88,7 +89,7 @@ VertexManagerBase::~VertexManagerBase() = default;
 
 bool VertexManagerBase::Initialize()
 {
-  m_index_generator.Init();
+  m_index_generator.Init(g_Config.backend_info.bSupportsPrimitiveRestart);
   return true;
 }
 
@@ -343,6 +344,13 @@ void VertexManagerBase::Flush()
     return;
 
   m_is_flushed = true;
+  GPUThreadProfiler::ScopedSection profile_section(GPUThreadProfiler::Section::Flush);
+
+  // The vertices of the batch may still be being converted.
+  {
+    GPUThreadProfiler::ScopedSection wait_section(GPUThreadProfiler::Section::VertexLoading);
+    VertexLoaderManager::WaitForPendingVertices();
+  }
 
 #if defined(_DEBUG) || defined(DEBUGFAST)
   PRIM_LOG("frame%d:\n texgen=%u, numchan=%u, dualtex=%u, ztex=%u, cole=%u, alpe=%u, ze=%u",
@@ -457,6 +465,8 @@ void VertexManagerBase::Flush()
     }
   }
 
+  VertexShaderManager::ResetDrawMatrices();
+
   if (xfmem.numTexGen.numTexGens != bpmem.genMode.numtexgens)
   {
     ERROR_LOG(VIDEO,
@@ -505,15 +515,23 @@ void VertexManagerBase::CalculateZSlope(NativeVertexFormat* format)
   // is enabled in the following flush.
   for (unsigned int i = 0; i < 3; ++i)
   {
-    // If this vertex format has per-vertex position matrix IDs, look it up.
-    if (vert_decl.posmtx.enable)
-      mtxIdx = VertexLoaderManager::position_matrix_index[3 - i];
-
     if (vert_decl.position.components == 2)
       VertexLoaderManager::position_cache[2 - i][2] = 0;
 
-    VertexShaderManager::TransformToClipSpace(&VertexLoaderManager::position_cache[2 - i][0],
-                                              &out[i * 4], mtxIdx);
+    if (VertexLoaderManager::g_current_components & VB_HAS_DRAWMTXIDX)
+    {
+      VertexShaderManager::TransformToClipSpaceWithDrawMatrix(
+          &VertexLoaderManager::position_cache[2 - i][0], &out[i * 4]);
+    }
+    else
+    {
+      // If this vertex format has per-vertex position matrix IDs, look it up.
+      if (vert_decl.posmtx.enable)
+        mtxIdx = VertexLoaderManager::position_matrix_index[3 - i];
+
+      VertexShaderManager::TransformToClipSpace(&VertexLoaderManager::position_cache[2 - i][0],
+                                                &out[i * 4], mtxIdx);
+    }
 
     // Transform to Screenspace
     float inv_w = 1.0f / out[3 + i * 4];
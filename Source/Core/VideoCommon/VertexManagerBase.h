@@ -71,6 +71,8 @@ public:
   void FlushData(u32 count, u32 stride);
 
   void Flush();
+  // Returns true if there are no vertices waiting to be drawn.
+  bool IsFlushed() const { return m_is_flushed; }
 
   void DoState(PointerWrap& p);
 
@@ -92,16 +92,23 @@ ShaderCode GenerateVertexShaderCode(APIType api_type, const ShaderHostConfig& ho
     out.Write("cbuffer VSBlock {\n");
 
   out.Write(s_shader_uniforms);
+  if (host_config.merge_draws)
+    out.Write(s_draw_matrix_uniforms);
   out.Write("};\n");
 
   out.Write("struct VS_OUTPUT {\n");
   GenerateVSOutputMembers(out, api_type, uid_data->numTexGens, host_config, "");
   out.Write("};\n");
 
+  // Shaders for draw matrix indices can still be requested after draw merging has been disabled.
+  const bool has_draw_matrix_index =
+      host_config.merge_draws && (uid_data->components & VB_HAS_DRAWMTXIDX);
+  const bool has_matrix_index = (uid_data->components & VB_HAS_POSMTXIDX) || has_draw_matrix_index;
+
   if (api_type == APIType::OpenGL || api_type == APIType::Vulkan)
   {
     out.Write("ATTRIBUTE_LOCATION(%d) in float4 rawpos;\n", SHADER_POSITION_ATTRIB);
-    if (uid_data->components & VB_HAS_POSMTXIDX)
+    if (has_matrix_index)
       out.Write("ATTRIBUTE_LOCATION(%d) in uint4 posmtx;\n", SHADER_POSMTX_ATTRIB);
     if (uid_data->components & VB_HAS_NRM0)
       out.Write("ATTRIBUTE_LOCATION(%d) in float3 rawnorm0;\n", SHADER_NORM0_ATTRIB);
@@ -180,7 +187,7 @@ ShaderCode GenerateVertexShaderCode(APIType api_type, const ShaderHostConfig& ho
       if ((uid_data->components & (VB_HAS_UV0 << i)) || hastexmtx)
         out.Write("  float%d rawtex%d : TEXCOORD%d,\n", hastexmtx ? 3 : 2, i, i);
     }
-    if (uid_data->components & VB_HAS_POSMTXIDX)
+    if (has_matrix_index)
       out.Write("  uint4 posmtx : BLENDINDICES,\n");
     out.Write("  float4 rawpos : POSITION) {\n");
   }
@@ -212,6 +219,27 @@ ShaderCode GenerateVertexShaderCode(APIType api_type, const ShaderHostConfig& ho
       out.Write(
           "float3 _norm2 = float3(dot(N0, rawnorm2), dot(N1, rawnorm2), dot(N2, rawnorm2));\n");
   }
+  else if (has_draw_matrix_index)
+  {
+    out.Write("int drawidx = int(posmtx.r) * 6;\n");
+    out.Write("float4 pos = float4(dot(" I_DRAWMATRICES "[drawidx], rawpos), dot(" I_DRAWMATRICES
+              "[drawidx+1], rawpos), dot(" I_DRAWMATRICES "[drawidx+2], rawpos), 1.0);\n");
+    if (uid_data->components & VB_HAS_NRMALL)
+    {
+      out.Write("float3 N0 = " I_DRAWMATRICES "[drawidx+3].xyz, N1 = " I_DRAWMATRICES
+                "[drawidx+4].xyz, N2 = " I_DRAWMATRICES "[drawidx+5].xyz;\n");
+    }
+
+    if (uid_data->components & VB_HAS_NRM0)
+      out.Write("float3 _norm0 = normalize(float3(dot(N0, rawnorm0), dot(N1, rawnorm0), dot(N2, "
+                "rawnorm0)));\n");
+    if (uid_data->components & VB_HAS_NRM1)
+      out.Write(
+          "float3 _norm1 = float3(dot(N0, rawnorm1), dot(N1, rawnorm1), dot(N2, rawnorm1));\n");
+    if (uid_data->components & VB_HAS_NRM2)
+      out.Write(
+          "float3 _norm2 = float3(dot(N0, rawnorm2), dot(N1, rawnorm2), dot(N2, rawnorm2));\n");
+  }
   else
   {
     out.Write("float4 pos = float4(dot(" I_POSNORMALMATRIX "[0], rawpos), dot(" I_POSNORMALMATRIX
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstring>
 #include <iterator>
 
@@ -19,8 +20,10 @@
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/CPMemory.h"
+#include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
@@ -41,6 +44,11 @@ static std::array<int, 2> nNormalMatricesChanged;         // min,max
 static std::array<int, 2> nPostTransformMatricesChanged;  // min,max
 static std::array<int, 2> nLightsChanged;                 // min,max
 
+// Number of draw matrices used by the current batch.
+static u32 s_num_draw_matrices;
+// Whether the last draw matrix still matches the current position and normal matrices.
+static bool s_draw_matrix_valid;
+
 static Common::Matrix44 s_viewportCorrection;
 static Common::Matrix44 s_freelook_matrix;
 
@@ -110,6 +118,7 @@ void VertexShaderManager::Init()
   bViewportChanged = false;
   bTexMtxInfoChanged = false;
   bLightingConfigChanged = false;
+  ResetDrawMatrices();
 
   std::memset(static_cast<void*>(&xfmem), 0, sizeof(xfmem));
   constants = {};
@@ -447,8 +456,80 @@ void VertexShaderManager::SetConstants()
   }
 }
 
+void VertexShaderManager::ReserveDrawMatrix()
+{
+  if (!s_draw_matrix_valid && s_num_draw_matrices == NUM_DRAW_MATRICES)
+    g_vertex_manager->Flush();
+}
+
+u32 VertexShaderManager::GetDrawMatrixIndex()
+{
+  if (s_draw_matrix_valid)
+    return s_num_draw_matrices - 1;
+
+  const u32 index = s_num_draw_matrices++;
+  float4* const matrix = &constants.drawmatrices[index * 6];
+  const u32 mtx_idx = g_main_cp_state.matrix_index_a.PosNormalMtxIdx;
+  const float* pos = &xfmem.posMatrices[mtx_idx * 4];
+  const float* norm = &xfmem.normalMatrices[3 * (mtx_idx & 31)];
+  memcpy(matrix[0].data(), pos, 3 * sizeof(float4));
+  for (int i = 0; i < 3; ++i)
+    matrix[3 + i] = {norm[i * 3], norm[i * 3 + 1], norm[i * 3 + 2], 0.0f};
+
+  s_draw_matrix_valid = true;
+  dirty = true;
+  return index;
+}
+
+void VertexShaderManager::ResetDrawMatrices()
+{
+  s_num_draw_matrices = 0;
+  s_draw_matrix_valid = false;
+}
+
+bool VertexShaderManager::CanWriteMatricesWithoutFlush(u32 start, u32 end)
+{
+  // Other vertex formats read the matrices directly, so this is only possible if the current batch
+  // uses draw matrices. Which it does for the rest of it, as any other format would flush.
+  if (!(VertexLoaderManager::g_current_components & VB_HAS_DRAWMTXIDX))
+    return false;
+
+  const bool is_position_matrix = end <= XFMEM_POSMATRICES_END;
+  const bool is_normal_matrix = start >= XFMEM_NORMALMATRICES && end <= XFMEM_NORMALMATRICES_END;
+  if (!is_position_matrix && !is_normal_matrix)
+    return false;
+
+  // The texture matrices are still read from the position matrix memory, but only the ones that
+  // the matrix indices currently point to.
+  const TMatrixIndexA& index_a = g_main_cp_state.matrix_index_a;
+  const TMatrixIndexB& index_b = g_main_cp_state.matrix_index_b;
+  const std::array<u32, 8> tex_matrices{
+      index_a.Tex0MtxIdx, index_a.Tex1MtxIdx, index_a.Tex2MtxIdx, index_a.Tex3MtxIdx,
+      index_b.Tex4MtxIdx, index_b.Tex5MtxIdx, index_b.Tex6MtxIdx, index_b.Tex7MtxIdx,
+  };
+  for (u32 tex_matrix : tex_matrices)
+  {
+    if (start < tex_matrix * 4 + 12 && end > tex_matrix * 4)
+      return false;
+  }
+
+  return true;
+}
+
+u32 VertexShaderManager::GetConstantsSize()
+{
+  return static_cast<u32>(offsetof(VertexShaderConstants, drawmatrices) +
+                          s_num_draw_matrices * 6 * sizeof(float4));
+}
+
 void VertexShaderManager::InvalidateXFRange(int start, int end)
 {
+  if (start < XFMEM_POSMATRICES_END ||
+      (start < XFMEM_NORMALMATRICES_END && end > XFMEM_NORMALMATRICES))
+  {
+    s_draw_matrix_valid = false;
+  }
+
   if (((u32)start >= (u32)g_main_cp_state.matrix_index_a.PosNormalMtxIdx * 4 &&
        (u32)start < (u32)g_main_cp_state.matrix_index_a.PosNormalMtxIdx * 4 + 12) ||
       ((u32)start >=
@@ -567,9 +648,18 @@ void VertexShaderManager::SetTexMatrixChangedA(u32 Value)
 {
   if (g_main_cp_state.matrix_index_a.Hex != Value)
   {
-    g_vertex_manager->Flush();
+    // Draw matrices are taken from the position matrix index of each draw.
+    const bool only_position_matrix = ((g_main_cp_state.matrix_index_a.Hex ^ Value) & ~0x3f) == 0;
+    if (!only_position_matrix ||
+        !(VertexLoaderManager::g_current_components & VB_HAS_DRAWMTXIDX))
+    {
+      g_vertex_manager->Flush();
+    }
     if (g_main_cp_state.matrix_index_a.PosNormalMtxIdx != (Value & 0x3f))
+    {
       bPosNormalMatrixChanged = true;
+      s_draw_matrix_valid = false;
+    }
     bTexMatricesChanged[0] = true;
     g_main_cp_state.matrix_index_a.Hex = Value;
   }
@@ -646,10 +736,9 @@ void VertexShaderManager::SetLightingConfigChanged()
   bLightingConfigChanged = true;
 }
 
-void VertexShaderManager::TransformToClipSpace(const float* data, float* out, u32 MtxIdx)
+static void TransformToClipSpaceWithMatrix(const float* data, float* out,
+                                           const float* world_matrix)
 {
-  const float* world_matrix = &xfmem.posMatrices[(MtxIdx & 0x3f) * 4];
-
   // We use the projection matrix calculated by VertexShaderManager, because it
   // includes any free look transformations.
   // Make sure VertexShaderManager::SetConstants() has been called first.
@@ -669,6 +758,17 @@ void VertexShaderManager::TransformToClipSpace(const float* data, float* out, u3
       t[0] * proj_matrix[12] + t[1] * proj_matrix[13] + t[2] * proj_matrix[14] + proj_matrix[15];
 }
 
+void VertexShaderManager::TransformToClipSpace(const float* data, float* out, u32 MtxIdx)
+{
+  TransformToClipSpaceWithMatrix(data, out, &xfmem.posMatrices[(MtxIdx & 0x3f) * 4]);
+}
+
+void VertexShaderManager::TransformToClipSpaceWithDrawMatrix(const float* data, float* out)
+{
+  TransformToClipSpaceWithMatrix(data, out,
+                                 constants.drawmatrices[(s_num_draw_matrices - 1) * 6].data());
+}
+
 void VertexShaderManager::DoState(PointerWrap& p)
 {
   p.DoArray(g_fProjectionMatrix);
@@ -33,6 +33,21 @@ public:
   static void RotateView(float x, float y, float z);
   static void ResetView();
 
+  // Draw merging: Vertex formats without matrix indices get the index of a copy of the position
+  // and normal matrices of their draw instead. So these matrices can change between the draws of a
+  // batch, as long as there are draw matrices left.
+  // Flushes if the next draw needs a new draw matrix, but there is no space left for one.
+  static void ReserveDrawMatrix();
+  // Returns the index of the draw matrix with the current position and normal matrices.
+  static u32 GetDrawMatrixIndex();
+  // Called after a batch has been drawn.
+  static void ResetDrawMatrices();
+  // Returns true if the XF memory in [start, end) can be written without flushing.
+  static bool CanWriteMatricesWithoutFlush(u32 start, u32 end);
+
+  // Size of the constants that the shaders can use. Excludes unused draw matrices.
+  static u32 GetConstantsSize();
+
   static void SetVertexFormat(u32 components);
   static void SetTexMatrixInfoChanged(int index);
   static void SetLightingConfigChanged();
@@ -42,6 +57,8 @@ public:
   // NOTE: g_fProjectionMatrix must be up to date when this is called
   //       (i.e. VertexShaderManager::SetConstants needs to be called before using this!)
   static void TransformToClipSpace(const float* data, float* out, u32 mtxIdx);
+  // Same, with the position matrix of the last draw that got a draw matrix.
+  static void TransformToClipSpaceWithDrawMatrix(const float* data, float* out);
 
   static VertexShaderConstants constants;
   static bool dirty;
@@ -87,6 +87,7 @@ void VideoConfig::Refresh()
   bDumpTextures = Config::Get(Config::GFX_DUMP_TEXTURES);
   bHiresTextures = Config::Get(Config::GFX_HIRES_TEXTURES);
   bCacheHiresTextures = Config::Get(Config::GFX_CACHE_HIRES_TEXTURES);
+  iHiresTexturesMemoryBudget = Config::Get(Config::GFX_HIRES_TEXTURES_MEMORY_BUDGET);
   bDumpEFBTarget = Config::Get(Config::GFX_DUMP_EFB_TARGET);
   bDumpXFBTarget = Config::Get(Config::GFX_DUMP_XFB_TARGET);
   bDumpFramesAsImages = Config::Get(Config::GFX_DUMP_FRAMES_AS_IMAGES);
@@ -117,6 +118,7 @@ void VideoConfig::Refresh()
   iShaderCompilationMode = Config::Get(Config::GFX_SHADER_COMPILATION_MODE);
   iShaderCompilerThreads = Config::Get(Config::GFX_SHADER_COMPILER_THREADS);
   iShaderPrecompilerThreads = Config::Get(Config::GFX_SHADER_PRECOMPILER_THREADS);
+  iShaderPrecompileCoverage = Config::Get(Config::GFX_SHADER_PRECOMPILE_COVERAGE);
 
   bZComploc = Config::Get(Config::GFX_SW_ZCOMPLOC);
   bZFreeze = Config::Get(Config::GFX_SW_ZFREEZE);
@@ -125,6 +127,7 @@ void VideoConfig::Refresh()
   bDumpTevTextureFetches = Config::Get(Config::GFX_SW_DUMP_TEV_TEX_FETCHES);
   drawStart = Config::Get(Config::GFX_SW_DRAW_START);
   drawEnd = Config::Get(Config::GFX_SW_DRAW_END);
+  iSWRasterizerThreads = Config::Get(Config::GFX_SW_RASTERIZER_THREADS);
 
   bForceFiltering = Config::Get(Config::GFX_ENHANCE_FORCE_FILTERING);
   iMaxAnisotropy = Config::Get(Config::GFX_ENHANCE_MAX_ANISOTROPY);
@@ -156,6 +159,9 @@ void VideoConfig::Refresh()
   bCopyEFBScaled = Config::Get(Config::GFX_HACK_COPY_EFB_SCALED);
   bEFBEmulateFormatChanges = Config::Get(Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES);
   bVertexRounding = Config::Get(Config::GFX_HACK_VERTEX_ROUDING);
+  bWriteTrackedTextureCache = Config::Get(Config::GFX_HACK_WRITE_TRACKED_TEXTURE_CACHE);
+  bDisplayListCache = Config::Get(Config::GFX_HACK_DISPLAY_LIST_CACHE);
+  bMergeDraws = Config::Get(Config::GFX_HACK_MERGE_DRAWS);
   iEFBAccessTileSize = Config::Get(Config::GFX_HACK_EFB_ACCESS_TILE_SIZE);
 
   bPerfQueriesEnable = Config::Get(Config::GFX_PERF_QUERIES_ENABLE);
@@ -191,6 +197,12 @@ bool VideoConfig::UsingUberShaders() const
          iShaderCompilationMode == ShaderCompilationMode::AsynchronousUberShaders;
 }
 
+bool VideoConfig::UseDrawMerging() const
+{
+  // The software renderer reads the matrix indices of the vertices itself.
+  return bMergeDraws && backend_info.api_type != APIType::Nothing;
+}
+
 static u32 GetNumAutoShaderCompilerThreads()
 {
   // Automatic number. We use clamp(cpus - 3, 1, 4).
@@ -208,6 +220,15 @@ u32 VideoConfig::GetShaderCompilerThreads() const
     return GetNumAutoShaderCompilerThreads();
 }
 
+u32 VideoConfig::GetSWRasterizerThreads() const
+{
+  if (iSWRasterizerThreads >= 0)
+    return static_cast<u32>(iSWRasterizerThreads);
+
+  // The GPU thread draws too, and the CPU thread is busy already.
+  return static_cast<u32>(std::max(cpu_info.num_cores - 2, 0));
+}
+
 u32 VideoConfig::GetShaderPrecompilerThreads() const
 {
   // When using background compilation, always keep the same thread count.
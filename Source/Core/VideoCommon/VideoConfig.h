@@ -97,6 +97,7 @@ struct VideoConfig final
   bool bDumpTextures;
   bool bHiresTextures;
   bool bCacheHiresTextures;
+  int iHiresTexturesMemoryBudget;  // in MiB, 0 for automatic
   bool bDumpEFBTarget;
   bool bDumpXFBTarget;
   bool bDumpFramesAsImages;
@@ -126,6 +127,9 @@ struct VideoConfig final
   bool bImmediateXFB;
   bool bSkipPresentingDuplicateXFBs;
   bool bCopyEFBScaled;
+  bool bWriteTrackedTextureCache;
+  bool bDisplayListCache;
+  bool bMergeDraws;
   int iSafeTextureCache_ColorSamples;
   float fAspectRatioHackW, fAspectRatioHackH;
   bool bEnablePixelLighting;
@@ -156,6 +160,9 @@ struct VideoConfig final
   bool bDumpTevStages;
   bool bDumpTevTextureFetches;
 
+  // Threads that the software renderer draws with besides the GPU thread, -1 for automatic.
+  int iSWRasterizerThreads;
+
   // Enable API validation layers, currently only supported with Vulkan.
   bool bEnableValidationLayer;
 
@@ -176,6 +183,10 @@ struct VideoConfig final
   int iShaderCompilerThreads;
   int iShaderPrecompilerThreads;
 
+  // When waiting for shaders before starting, the percentage of the recorded pipeline uses that
+  // must be covered by compiled pipelines. The rest are compiled in the background.
+  int iShaderPrecompileCoverage;
+
   // Static config per API
   // TODO: Move this out of VideoConfig
   struct
@@ -236,9 +247,11 @@ struct VideoConfig final
     return backend_info.bSupportsGPUTextureDecoding && bEnableGPUTextureDecoding;
   }
   bool UseVertexRounding() const { return bVertexRounding && iEFBScale != 1; }
+  bool UseDrawMerging() const;
   bool UsingUberShaders() const;
   u32 GetShaderCompilerThreads() const;
   u32 GetShaderPrecompilerThreads() const;
+  u32 GetSWRasterizerThreads() const;
 };
 
 extern VideoConfig g_Config;
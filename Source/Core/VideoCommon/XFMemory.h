@@ -298,4 +298,8 @@ extern XFMemory xfmem;
 
 void LoadXFReg(u32 transferSize, u32 address, DataReader src);
 void LoadIndexedXF(u32 val, int array);
+// The two halves of LoadIndexedXF. The data has to be read in FIFO order, but can be written
+// later, and is big-endian.
+const u32* ReadIndexedXFData(u32 val, int refarray);
+void WriteIndexedXF(u32 val, const u32* data);
 void PreprocessIndexedXF(u32 val, int refarray);
@@ -19,7 +19,8 @@
 
 static void XFMemWritten(u32 transferSize, u32 baseAddress)
 {
-  g_vertex_manager->Flush();
+  if (!VertexShaderManager::CanWriteMatricesWithoutFlush(baseAddress, baseAddress + transferSize))
+    g_vertex_manager->Flush();
   VertexShaderManager::InvalidateXFRange(baseAddress, baseAddress + transferSize);
 }
 
@@ -253,25 +254,31 @@ void LoadXFReg(u32 transferSize, u32 baseAddress, DataReader src)
   }
 }
 
-// TODO - verify that it is correct. Seems to work, though.
 void LoadIndexedXF(u32 val, int refarray)
+{
+  WriteIndexedXF(val, ReadIndexedXFData(val, refarray));
+}
+
+const u32* ReadIndexedXFData(u32 val, int refarray)
 {
   int index = val >> 16;
+  int size = ((val >> 12) & 0xF) + 1;
+
+  if (Fifo::UseDeterministicGPUThread())
+    return (u32*)Fifo::PopFifoAuxBuffer(size * sizeof(u32));
+
+  return (u32*)Memory::GetPointer(g_main_cp_state.array_bases[refarray] +
+                                  g_main_cp_state.array_strides[refarray] * index);
+}
+
+// TODO - verify that it is correct. Seems to work, though.
+void WriteIndexedXF(u32 val, const u32* newData)
+{
   int address = val & 0xFFF;  // check mask
   int size = ((val >> 12) & 0xF) + 1;
   // load stuff from array to address in xf mem
 
   u32* currData = (u32*)(&xfmem) + address;
-  u32* newData;
-  if (Fifo::UseDeterministicGPUThread())
-  {
-    newData = (u32*)Fifo::PopFifoAuxBuffer(size * sizeof(u32));
-  }
-  else
-  {
-    newData = (u32*)Memory::GetPointer(g_main_cp_state.array_bases[refarray] +
-                                       g_main_cp_state.array_strides[refarray] * index);
-  }
   bool changed = false;
   for (int i = 0; i < size; ++i)
   {
@@ -0,0 +1,132 @@
+// Copyright 2019 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+
+#include "../RandomData.h"
+
+namespace
+{
+constexpr u64 BYTES_PER_MEASUREMENT = 64 * 1024 * 1024;
+}  // namespace
+
+TEST(Hash, FullHashCoversEveryByte)
+{
+  Common::SetHash64Function();
+
+  for (u32 size : {1u, 7u, 8u, 63u, 64u, 65u, 200u, 1024u, 1100u, 4096u})
+  {
+    std::vector<u8> data = GetRandomData(size);
+    const u64 hash = Common::GetFullHash64(data.data(), size);
+    for (u32 i = 0; i < size; ++i)
+    {
+      data[i] ^= 0x10;
+      EXPECT_NE(hash, Common::GetFullHash64(data.data(), size)) << "size " << size << " byte " << i;
+      data[i] ^= 0x10;
+    }
+  }
+}
+
+TEST(Hash, FullHashDependsOnLengthAndOrder)
+{
+  Common::SetHash64Function();
+
+  // Trailing zeroes must not be ignored.
+  const std::vector<u8> zeroes(256);
+  for (u32 size = 1; size < zeroes.size(); ++size)
+    EXPECT_NE(Common::GetFullHash64(zeroes.data(), size - 1),
+              Common::GetFullHash64(zeroes.data(), size));
+
+  // Swapping two stripes or two blocks of stripes must change the hash.
+  std::vector<u8> data = GetRandomData(0x1000);
+  const u64 hash = Common::GetFullHash64(data.data(), static_cast<u32>(data.size()));
+  std::swap_ranges(data.begin(), data.begin() + 64, data.begin() + 64);
+  EXPECT_NE(hash, Common::GetFullHash64(data.data(), static_cast<u32>(data.size())));
+  std::swap_ranges(data.begin(), data.begin() + 64, data.begin() + 64);
+  std::swap_ranges(data.begin(), data.begin() + 0x400, data.begin() + 0x400);
+  EXPECT_NE(hash, Common::GetFullHash64(data.data(), static_cast<u32>(data.size())));
+}
+
+TEST(Hash, FullHashImplementationsMatch)
+{
+  // Random lengths at random offsets, so that the stripes and the tail aren't aligned.
+  const std::vector<u8> data = GetRandomData(0x3000);
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<u32> offset_distribution(0, 63);
+  std::uniform_int_distribution<u32> size_distribution(0, 0x2000);
+  for (u32 i = 0; i < 1000; ++i)
+  {
+    const u8* src = data.data() + offset_distribution(generator);
+    const u32 size = i < 200 ? i : size_distribution(generator);
+    const u64 expected = Common::GetFullHashGeneric(src, size);
+#ifdef _M_X86
+    EXPECT_EQ(expected, Common::GetFullHashSSE2(src, size)) << "size " << size;
+    if (cpu_info.bAVX2)
+      EXPECT_EQ(expected, Common::GetFullHashAVX2(src, size)) << "size " << size;
+#endif
+  }
+}
+
+TEST(Hash, GetHash64UsesFullHashWhenNotSampling)
+{
+  Common::SetHash64Function();
+
+  const std::vector<u8> data = GetRandomData(0x2000);
+  const u32 size = static_cast<u32>(data.size());
+  EXPECT_EQ(Common::GetFullHash64(data.data(), size), Common::GetHash64(data.data(), size, 0));
+  EXPECT_EQ(Common::GetFullHash64(data.data(), size),
+            Common::GetHash64(data.data(), size, size / 8));
+}
+
+// Not really a test: prints the throughput of the texture cache hashes for the texture sizes that
+// the different texture formats produce. Disabled so that it only runs when asked for with
+// --gtest_also_run_disabled_tests.
+TEST(Hash, DISABLED_Throughput)
+{
+  Common::SetHash64Function();
+
+  struct TextureSize
+  {
+    const char* name;
+    u32 size;
+  };
+  static const TextureSize sizes[] = {
+      {"64x64 4bpp (I4/C4/CMPR)", 64 * 64 / 2},
+      {"64x64 32bpp (RGBA8)", 64 * 64 * 4},
+      {"256x256 4bpp (I4/C4/CMPR)", 256 * 256 / 2},
+      {"256x256 8bpp (I8/IA4/C8)", 256 * 256},
+      {"256x256 16bpp (RGB565/IA8)", 256 * 256 * 2},
+      {"256x256 32bpp (RGBA8)", 256 * 256 * 4},
+      {"1024x1024 16bpp (RGB5A3)", 1024 * 1024 * 2},
+      {"1024x1024 32bpp (RGBA8)", 1024 * 1024 * 4},
+  };
+
+  const std::vector<u8> data = GetRandomData(1024 * 1024 * 4);
+  const auto measure = [&data](u32 size, u32 samples) {
+    const u64 iterations = std::max<u64>(BYTES_PER_MEASUREMENT / size, 1);
+    u64 result = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (u64 i = 0; i < iterations; ++i)
+      result += Common::GetHash64(data.data(), size, samples);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_NE(result, 0u);
+    return iterations * size / elapsed.count() / (1024 * 1024 * 1024);
+  };
+
+  for (const TextureSize& texture : sizes)
+  {
+    std::printf("%-30s full: %6.2f GiB/s, 128 samples: %6.2f GiB/s\n", texture.name,
+                measure(texture.size, 0), measure(texture.size, 128));
+  }
+}
@@ -0,0 +1,255 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/IndexedDiskCache.h"
+#include "Common/LinearDiskCache.h"
+
+namespace
+{
+struct Key
+{
+  u32 a;
+  u32 b;
+};
+
+std::vector<u8> MakeValue(u32 seed, u32 size)
+{
+  std::vector<u8> value(size);
+  for (u32 i = 0; i < size; ++i)
+    value[i] = static_cast<u8>(seed * 31 + i);
+  return value;
+}
+
+class IndexedDiskCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = File::CreateTempDir();
+    ASSERT_FALSE(m_dir.empty());
+    m_filename = m_dir + "/test.icache";
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_dir); }
+
+  void AppendEntries(Common::IndexedDiskCache<Key>& cache, u32 first, u32 count)
+  {
+    for (u32 i = first; i < first + count; ++i)
+    {
+      const std::vector<u8> value = MakeValue(i, 16 + i % 64);
+      cache.Append({i, ~i}, value.data(), static_cast<u32>(value.size()));
+    }
+  }
+
+  void ExpectEntries(Common::IndexedDiskCache<Key>& cache, u32 first, u32 count)
+  {
+    for (u32 i = first; i < first + count; ++i)
+    {
+      std::vector<u8> value;
+      EXPECT_TRUE(cache.Lookup({i, ~i}, &value)) << "entry " << i;
+      EXPECT_EQ(MakeValue(i, 16 + i % 64), value) << "entry " << i;
+    }
+  }
+
+  std::string m_dir;
+  std::string m_filename;
+};
+}  // namespace
+
+TEST_F(IndexedDiskCacheTest, RoundTrip)
+{
+  Common::IndexedDiskCache<Key> cache;
+  ASSERT_TRUE(cache.Open(m_filename));
+  EXPECT_EQ(0u, cache.GetEntryCount());
+
+  AppendEntries(cache, 0, 100);
+  EXPECT_EQ(100u, cache.GetEntryCount());
+  ExpectEntries(cache, 0, 100);
+
+  std::vector<u8> value;
+  EXPECT_FALSE(cache.Contains({100, ~100u}));
+  EXPECT_FALSE(cache.Lookup({100, ~100u}, &value));
+}
+
+TEST_F(IndexedDiskCacheTest, Reopen)
+{
+  {
+    Common::IndexedDiskCache<Key> cache;
+    ASSERT_TRUE(cache.Open(m_filename));
+    AppendEntries(cache, 0, 100);
+    cache.Close();
+  }
+  EXPECT_TRUE(File::Exists(m_filename + ".idx"));
+
+  Common::IndexedDiskCache<Key> cache;
+  ASSERT_TRUE(cache.Open(m_filename));
+  EXPECT_EQ(100u, cache.GetEntryCount());
+  ExpectEntries(cache, 0, 100);
+
+  // Entries appended after reopening are read past the mapped part of the file.
+  AppendEntries(cache, 100, 10);
+  ExpectEntries(cache, 0, 110);
+}
+
+TEST_F(IndexedDiskCacheTest, RecoverWithoutIndex)
+{
+  {
+    Common::IndexedDiskCache<Key> cache;
+    ASSERT_TRUE(cache.Open(m_filename));
+    AppendEntries(cache, 0, 50);
+    cache.Close();
+
+    // Simulate a crash after more entries were appended.
+    ASSERT_TRUE(cache.Open(m_filename));
+    AppendEntries(cache, 50, 50);
+  }
+  // The destructor closed the cache, so drop the new index to get back to the crashed state.
+  ASSERT_TRUE(File::Delete(m_filename + ".idx"));
+
+  Common::IndexedDiskCache<Key> cache;
+  ASSERT_TRUE(cache.Open(m_filename));
+  EXPECT_EQ(100u, cache.GetEntryCount());
+  ExpectEntries(cache, 0, 100);
+}
+
+TEST_F(IndexedDiskCacheTest, DiscardTornRecord)
+{
+  {
+    Common::IndexedDiskCache<Key> cache;
+    ASSERT_TRUE(cache.Open(m_filename));
+    AppendEntries(cache, 0, 10);
+    cache.Close();
+  }
+  ASSERT_TRUE(File::Delete(m_filename + ".idx"));
+
+  // Cut the last record in half.
+  u64 size = File::GetSize(m_filename);
+  {
+    File::IOFile file(m_filename, "rb+");
+    ASSERT_TRUE(file.Resize(size - 20));
+  }
+
+  Common::IndexedDiskCache<Key> cache;
+  ASSERT_TRUE(cache.Open(m_filename));
+  EXPECT_EQ(9u, cache.GetEntryCount());
+  ExpectEntries(cache, 0, 9);
+  EXPECT_FALSE(cache.Contains({9, ~9u}));
+
+  // New records go where the torn one was.
+  AppendEntries(cache, 9, 1);
+  cache.Close();
+  ASSERT_TRUE(cache.Open(m_filename));
+  EXPECT_EQ(10u, cache.GetEntryCount());
+  ExpectEntries(cache, 0, 10);
+}
+
+TEST_F(IndexedDiskCacheTest, ReplaceRemoveAndCompact)
+{
+  Common::IndexedDiskCache<Key> cache;
+  ASSERT_TRUE(cache.Open(m_filename));
+  AppendEntries(cache, 0, 100);
+
+  const std::vector<u8> replacement = MakeValue(1000, 8);
+  cache.Append({0, ~0u}, replacement.data(), static_cast<u32>(replacement.size()));
+  for (u32 i = 50; i < 100; ++i)
+    cache.Remove({i, ~i});
+  EXPECT_EQ(50u, cache.GetEntryCount());
+  cache.Close();
+
+  // More than a quarter of the file was unused, so closing compacted it.
+  const u64 compacted_size = File::GetSize(m_filename);
+  ASSERT_TRUE(cache.Open(m_filename));
+  EXPECT_EQ(50u, cache.GetEntryCount());
+  std::vector<u8> value;
+  EXPECT_TRUE(cache.Lookup({0, ~0u}, &value));
+  EXPECT_EQ(replacement, value);
+  ExpectEntries(cache, 1, 49);
+  EXPECT_FALSE(cache.Contains({50, ~50u}));
+  cache.Close();
+  EXPECT_EQ(compacted_size, File::GetSize(m_filename));
+
+  ASSERT_TRUE(cache.Open(m_filename));
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetEntryCount());
+  cache.Close();
+  ASSERT_TRUE(cache.Open(m_filename));
+  EXPECT_EQ(0u, cache.GetEntryCount());
+}
+
+TEST_F(IndexedDiskCacheTest, CompactDropsCorruptedRecord)
+{
+  {
+    Common::IndexedDiskCache<Key> cache;
+    ASSERT_TRUE(cache.Open(m_filename));
+    AppendEntries(cache, 0, 100);
+    cache.Close();
+  }
+
+  // Flip the last byte of the value of the last record.
+  const u64 size = File::GetSize(m_filename);
+  {
+    File::IOFile file(m_filename, "rb+");
+    u8 byte;
+    ASSERT_TRUE(file.Seek(size - 1, SEEK_SET) && file.ReadBytes(&byte, 1));
+    byte = ~byte;
+    ASSERT_TRUE(file.Seek(size - 1, SEEK_SET) && file.WriteBytes(&byte, 1));
+  }
+
+  Common::IndexedDiskCache<Key> cache;
+  ASSERT_TRUE(cache.Open(m_filename));
+  for (u32 i = 0; i < 50; ++i)
+    cache.Remove({i, ~i});
+  cache.Close();
+
+  // The other records are kept when the file is compacted.
+  EXPECT_LT(File::GetSize(m_filename), size);
+  ASSERT_TRUE(cache.Open(m_filename));
+  EXPECT_EQ(49u, cache.GetEntryCount());
+  ExpectEntries(cache, 50, 49);
+  EXPECT_FALSE(cache.Contains({99, ~99u}));
+}
+
+TEST_F(IndexedDiskCacheTest, ImportLinearDiskCache)
+{
+  const std::string linear_filename = m_dir + "/test.cache";
+  {
+    class NullReader : public LinearDiskCacheReader<Key, u8>
+    {
+    public:
+      void Read(const Key&, const u8*, u32) override {}
+    };
+
+    NullReader reader;
+    LinearDiskCache<Key, u8> linear_cache;
+    linear_cache.OpenAndRead(linear_filename, reader);
+    for (u32 i = 0; i < 20; ++i)
+    {
+      const std::vector<u8> value = MakeValue(i, 16 + i % 64);
+      linear_cache.Append({i, ~i}, value.data(), static_cast<u32>(value.size()));
+    }
+    linear_cache.Close();
+  }
+
+  Common::IndexedDiskCache<Key> cache;
+  ASSERT_TRUE(cache.Open(m_filename));
+  // Entries that are already in the cache are kept.
+  const std::vector<u8> existing = MakeValue(1000, 8);
+  cache.Append({0, ~0u}, existing.data(), static_cast<u32>(existing.size()));
+
+  EXPECT_EQ(20u, cache.ImportLinearDiskCache(linear_filename));
+  EXPECT_FALSE(File::Exists(linear_filename));
+  EXPECT_EQ(20u, cache.GetEntryCount());
+  std::vector<u8> value;
+  EXPECT_TRUE(cache.Lookup({0, ~0u}, &value));
+  EXPECT_EQ(existing, value);
+  ExpectEntries(cache, 1, 19);
+}
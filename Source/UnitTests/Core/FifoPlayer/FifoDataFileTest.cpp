@@ -0,0 +1,160 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/FifoPlayer/FifoDataFile.h"
+
+namespace
+{
+constexpr u32 NUM_FRAMES = 100;
+constexpr u32 TEXTURE_SIZE = 256 * 1024;
+
+std::vector<u8> MakeData(u32 seed, u32 size)
+{
+  std::vector<u8> data(size);
+  for (u32 i = 0; i < size; ++i)
+    data[i] = static_cast<u8>(seed * 31 + i * 7 + (i >> 8));
+  return data;
+}
+
+// Every frame uploads the same texture, and vertices that differ between frames.
+FifoFrameInfo MakeFrame(u32 frame)
+{
+  FifoFrameInfo info;
+  info.fifoData = MakeData(frame, 1000 + frame);
+  info.fifoStart = 0x1000 * frame;
+  info.fifoEnd = 0x1000 * frame + 0x800;
+
+  MemoryUpdate texture;
+  texture.fifoPosition = 10;
+  texture.address = 0x00100000;
+  texture.data = MakeData(12345, TEXTURE_SIZE);
+  texture.type = MemoryUpdate::TEXTURE_MAP;
+  info.memoryUpdates.push_back(std::move(texture));
+
+  MemoryUpdate vertices;
+  vertices.fifoPosition = 500;
+  vertices.address = 0x00200000 + frame;
+  vertices.data = MakeData(frame, 64 + frame);
+  vertices.type = MemoryUpdate::VERTEX_STREAM;
+  info.memoryUpdates.push_back(std::move(vertices));
+  return info;
+}
+
+void ExpectFrame(const FifoFrameInfo& expected, const FifoFrameInfo& actual)
+{
+  EXPECT_EQ(expected.fifoData, actual.fifoData);
+  EXPECT_EQ(expected.fifoStart, actual.fifoStart);
+  EXPECT_EQ(expected.fifoEnd, actual.fifoEnd);
+  ASSERT_EQ(expected.memoryUpdates.size(), actual.memoryUpdates.size());
+  for (size_t i = 0; i < expected.memoryUpdates.size(); ++i)
+  {
+    EXPECT_EQ(expected.memoryUpdates[i].fifoPosition, actual.memoryUpdates[i].fifoPosition);
+    EXPECT_EQ(expected.memoryUpdates[i].address, actual.memoryUpdates[i].address);
+    EXPECT_EQ(expected.memoryUpdates[i].data, actual.memoryUpdates[i].data);
+    EXPECT_EQ(expected.memoryUpdates[i].type, actual.memoryUpdates[i].type);
+  }
+}
+
+class FifoDataFileTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_dir = File::CreateTempDir();
+    ASSERT_FALSE(m_dir.empty());
+    m_filename = m_dir + "/test.dff";
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_dir); }
+
+  void SaveFile(const std::string& filename)
+  {
+    FifoDataFile file;
+    file.SetIsWii(true);
+    std::fill_n(file.GetBPMem(), FifoDataFile::BP_MEM_SIZE, 0x61);
+    std::fill_n(file.GetCPMem(), FifoDataFile::CP_MEM_SIZE, 0x62);
+    std::fill_n(file.GetXFMem(), FifoDataFile::XF_MEM_SIZE, 0x63);
+    std::fill_n(file.GetXFRegs(), FifoDataFile::XF_REGS_SIZE, 0x64);
+    std::fill_n(file.GetTexMem(), FifoDataFile::TEX_MEM_SIZE, 0x65);
+    for (u32 i = 0; i < NUM_FRAMES; ++i)
+      file.AddFrame(MakeFrame(i));
+    ASSERT_TRUE(file.Save(filename));
+  }
+
+  void ExpectFile(const std::string& filename)
+  {
+    std::unique_ptr<FifoDataFile> file = FifoDataFile::Load(filename, false);
+    ASSERT_TRUE(file);
+    EXPECT_TRUE(file->GetIsWii());
+    EXPECT_EQ(0x61u, file->GetBPMem()[FifoDataFile::BP_MEM_SIZE - 1]);
+    EXPECT_EQ(0x64u, file->GetXFRegs()[FifoDataFile::XF_REGS_SIZE - 1]);
+    EXPECT_EQ(0x65u, file->GetTexMem()[FifoDataFile::TEX_MEM_SIZE - 1]);
+    ASSERT_EQ(NUM_FRAMES, file->GetFrameCount());
+
+    // The frame sizes are known before any frame is read.
+    for (u32 i = 0; i < NUM_FRAMES; ++i)
+    {
+      EXPECT_EQ(1000 + i, file->GetFrameSize(i).fifoBytes) << "frame " << i;
+      EXPECT_EQ(TEXTURE_SIZE + 64 + i, file->GetFrameSize(i).memoryBytes) << "frame " << i;
+    }
+
+    // Frames can be read in any order, and their FIFO data on its own.
+    for (u32 i = NUM_FRAMES; i-- > 0;)
+    {
+      const FifoFrameInfo expected = MakeFrame(i);
+      EXPECT_EQ(expected.fifoData, file->GetFrameFifoData(i)) << "frame " << i;
+      const std::shared_ptr<const FifoFrameInfo> frame = file->GetFrame(i);
+      ASSERT_TRUE(frame) << "frame " << i;
+      ExpectFrame(expected, *frame);
+    }
+  }
+
+  std::string m_dir;
+  std::string m_filename;
+};
+}  // namespace
+
+TEST_F(FifoDataFileTest, RoundTrip)
+{
+  SaveFile(m_filename);
+  ExpectFile(m_filename);
+
+  // The texture that every frame uploads is only stored once.
+  EXPECT_LT(File::GetSize(m_filename), u64{FifoDataFile::TEX_MEM_SIZE + 2 * TEXTURE_SIZE});
+}
+
+TEST_F(FifoDataFileTest, SaveLoadedFile)
+{
+  SaveFile(m_filename);
+
+  // The frames that were never read are read from the original file while saving.
+  const std::string copy_filename = m_dir + "/copy.dff";
+  {
+    std::unique_ptr<FifoDataFile> file = FifoDataFile::Load(m_filename, false);
+    ASSERT_TRUE(file);
+    ASSERT_TRUE(file->GetFrame(NUM_FRAMES / 2));
+    ASSERT_TRUE(file->Save(copy_filename));
+  }
+  ExpectFile(copy_filename);
+}
+
+TEST_F(FifoDataFileTest, FlagsOnly)
+{
+  SaveFile(m_filename);
+  std::unique_ptr<FifoDataFile> file = FifoDataFile::Load(m_filename, true);
+  ASSERT_TRUE(file);
+  EXPECT_TRUE(file->GetIsWii());
+  EXPECT_EQ(0u, file->GetFrameCount());
+
+  EXPECT_FALSE(FifoDataFile::Load(m_dir + "/missing.dff", true));
+}
@@ -0,0 +1,22 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Returns random bytes that are the same for every run with the same size.
+inline std::vector<u8> GetRandomData(size_t size)
+{
+  std::mt19937 generator(static_cast<u32>(size));
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(distribution(generator));
+  return data;
+}
@@ -0,0 +1,210 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "VideoCommon/AsyncShaderCompiler.h"
+
+using VideoCommon::AsyncShaderCompiler;
+
+namespace
+{
+class TestWorkItem final : public AsyncShaderCompiler::WorkItem
+{
+public:
+  TestWorkItem(std::function<void()> compile, std::function<void()> retrieve)
+      : m_compile(std::move(compile)), m_retrieve(std::move(retrieve))
+  {
+  }
+
+  bool Compile() override
+  {
+    m_compile();
+    return true;
+  }
+
+  void Retrieve() override { m_retrieve(); }
+
+private:
+  std::function<void()> m_compile;
+  std::function<void()> m_retrieve;
+};
+
+void QueueItem(AsyncShaderCompiler& compiler, u32 priority, std::function<void()> compile,
+               std::function<void()> retrieve = [] {})
+{
+  compiler.QueueWorkItem(
+      AsyncShaderCompiler::CreateWorkItem<TestWorkItem>(std::move(compile), std::move(retrieve)),
+      priority);
+}
+}  // namespace
+
+TEST(AsyncShaderCompiler, CompilesAllItems)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(4));
+
+  constexpr u32 NUM_ITEMS = 1000;
+  std::atomic<u32> compiled{0};
+  u32 retrieved = 0;
+  for (u32 i = 0; i < NUM_ITEMS; i++)
+    QueueItem(compiler, i % 7, [&] { compiled++; }, [&] { retrieved++; });
+
+  compiler.WaitUntilCompletion();
+  EXPECT_FALSE(compiler.HasPendingWork());
+  EXPECT_EQ(NUM_ITEMS, compiled.load());
+
+  compiler.RetrieveWorkItems();
+  EXPECT_EQ(NUM_ITEMS, retrieved);
+  EXPECT_FALSE(compiler.HasCompletedWork());
+
+  compiler.StopWorkerThreads();
+}
+
+TEST(AsyncShaderCompiler, CompilesInPriorityOrder)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(1));
+
+  // Keep the worker busy while the items are queued.
+  Common::Event started;
+  Common::Event release;
+  QueueItem(compiler, 0, [&] {
+    started.Set();
+    release.Wait();
+  });
+  started.Wait();
+
+  std::mutex order_lock;
+  std::vector<u32> order;
+  for (u32 priority : {500u, 100u, 300u, 200u, 400u})
+  {
+    QueueItem(compiler, priority, [&, priority] {
+      std::lock_guard<std::mutex> guard(order_lock);
+      order.push_back(priority);
+    });
+  }
+
+  release.Set();
+  compiler.WaitUntilCompletion();
+  EXPECT_EQ((std::vector<u32>{100, 200, 300, 400, 500}), order);
+
+  compiler.StopWorkerThreads();
+}
+
+TEST(AsyncShaderCompiler, IdleWorkerStealsQueuedItems)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(2));
+
+  // Keep one worker busy, so that the items queued to it can only be compiled by the other one.
+  Common::Event started;
+  Common::Event release;
+  QueueItem(compiler, 0, [&] {
+    started.Set();
+    release.Wait();
+  });
+  started.Wait();
+
+  constexpr u32 NUM_ITEMS = 10;
+  std::atomic<u32> compiled{0};
+  Common::Event all_compiled;
+  for (u32 i = 0; i < NUM_ITEMS; i++)
+  {
+    QueueItem(compiler, i, [&] {
+      if (++compiled == NUM_ITEMS)
+        all_compiled.Set();
+    });
+  }
+
+  EXPECT_TRUE(all_compiled.WaitFor(std::chrono::seconds(60)));
+  release.Set();
+  compiler.WaitUntilCompletion();
+  EXPECT_EQ(NUM_ITEMS, compiled.load());
+
+  compiler.StopWorkerThreads();
+}
+
+TEST(AsyncShaderCompiler, WaitReturnsWhenComplete)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(2));
+
+  // Nothing is queued, so the waits shouldn't block or report progress.
+  compiler.WaitUntilCompletion([](size_t, size_t) { FAIL() << "No progress expected"; });
+  EXPECT_FALSE(compiler.WaitForCompletedWork(std::chrono::milliseconds(1000)));
+
+  Common::Event started;
+  Common::Event release;
+  std::atomic<bool> compiled{false};
+  QueueItem(compiler, 0, [&] {
+    started.Set();
+    release.Wait();
+    compiled.store(true);
+  });
+  started.Wait();
+  EXPECT_FALSE(compiler.WaitForCompletedWork(std::chrono::milliseconds(0)));
+
+  // The wait can only end once the item has been compiled.
+  std::atomic<bool> waited{false};
+  std::thread waiter([&] {
+    compiler.WaitUntilCompletion(
+        [](size_t completed, size_t total) { EXPECT_LT(completed, total); });
+    EXPECT_TRUE(compiled.load());
+    waited.store(true);
+  });
+  EXPECT_FALSE(waited.load());
+
+  release.Set();
+  EXPECT_TRUE(compiler.WaitForCompletedWork(std::chrono::seconds(60)));
+  waiter.join();
+  EXPECT_TRUE(waited.load());
+  EXPECT_FALSE(compiler.HasPendingWork());
+  EXPECT_TRUE(compiler.HasCompletedWork());
+
+  compiler.StopWorkerThreads();
+}
+
+TEST(AsyncShaderCompiler, KeepsQueuedItemsWhenResized)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(1));
+
+  Common::Event started;
+  Common::Event release;
+  QueueItem(compiler, 0, [&] {
+    started.Set();
+    release.Wait();
+  });
+  started.Wait();
+
+  constexpr u32 NUM_ITEMS = 100;
+  std::atomic<u32> compiled{0};
+  for (u32 i = 0; i < NUM_ITEMS; i++)
+    QueueItem(compiler, i, [&] { compiled++; });
+
+  // Stopping waits for the item that is compiling, and leaves the rest queued.
+  std::thread releaser([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    release.Set();
+  });
+  compiler.StopWorkerThreads();
+  releaser.join();
+  EXPECT_TRUE(compiler.HasPendingWork());
+
+  ASSERT_TRUE(compiler.StartWorkerThreads(3));
+  compiler.WaitUntilCompletion();
+  EXPECT_EQ(NUM_ITEMS, compiled.load());
+
+  compiler.StopWorkerThreads();
+}
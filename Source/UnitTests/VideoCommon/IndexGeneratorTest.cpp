@@ -0,0 +1,237 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+
+namespace
+{
+constexpr u16 PRIMITIVE_RESTART = UINT16_MAX;
+
+// Each primitive of the tests starts after this many vertices of the same type, so that the
+// indices don't start at zero.
+constexpr u32 BASE_VERTICES = 7;
+
+constexpr u32 BENCHMARK_VERTICES = 60000;
+constexpr u32 BENCHMARK_ITERATIONS = 2000;
+
+struct PrimitiveInfo
+{
+  int primitive;
+  const char* name;
+};
+
+constexpr PrimitiveInfo PRIMITIVES[] = {
+    {OpcodeDecoder::GX_DRAW_QUADS, "Quads"},
+    {OpcodeDecoder::GX_DRAW_TRIANGLES, "Triangles"},
+    {OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP, "TriangleStrip"},
+    {OpcodeDecoder::GX_DRAW_TRIANGLE_FAN, "TriangleFan"},
+    {OpcodeDecoder::GX_DRAW_LINES, "Lines"},
+    {OpcodeDecoder::GX_DRAW_LINE_STRIP, "LineStrip"},
+    {OpcodeDecoder::GX_DRAW_POINTS, "Points"},
+};
+
+using Triangle = std::array<u32, 3>;
+
+// Rotates a triangle so that it starts with its lowest index, which keeps the winding.
+Triangle Normalize(Triangle triangle)
+{
+  std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()),
+              triangle.end());
+  return triangle;
+}
+
+bool IsTrianglePrimitive(int primitive)
+{
+  return primitive < OpcodeDecoder::GX_DRAW_LINES;
+}
+
+// Returns the indices of a primitive that follows BASE_VERTICES vertices of the same type.
+std::vector<u16> Generate(int primitive, u32 num_vertices, bool primitive_restart)
+{
+  // Large enough for the worst case of a triangle per vertex.
+  std::vector<u16> indices((BASE_VERTICES + num_vertices) * 3);
+  IndexGenerator generator;
+  generator.Init(primitive_restart);
+  generator.Start(indices.data());
+  generator.AddIndices(primitive, BASE_VERTICES);
+  const u32 base_indices = generator.GetIndexLen();
+  generator.AddIndices(primitive, num_vertices);
+  return std::vector<u16>(indices.begin() + base_indices,
+                          indices.begin() + generator.GetIndexLen());
+}
+
+// Returns the triangles that the backend draws from the indices, as a triangle list or as triangle
+// strips separated by primitive restart indices.
+std::vector<Triangle> GetDrawnTriangles(const std::vector<u16>& indices, bool primitive_restart)
+{
+  std::vector<Triangle> triangles;
+  if (!primitive_restart)
+  {
+    EXPECT_EQ(0u, indices.size() % 3);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+      triangles.push_back(Normalize({indices[i], indices[i + 1], indices[i + 2]}));
+    return triangles;
+  }
+
+  auto strip_start = indices.begin();
+  while (strip_start != indices.end())
+  {
+    const auto strip_end = std::find(strip_start, indices.end(), PRIMITIVE_RESTART);
+    for (auto it = strip_start; it + 2 < strip_end; ++it)
+    {
+      if ((it - strip_start) % 2 == 0)
+        triangles.push_back(Normalize({it[0], it[1], it[2]}));
+      else
+        triangles.push_back(Normalize({it[1], it[0], it[2]}));
+    }
+    strip_start = strip_end == indices.end() ? strip_end : strip_end + 1;
+  }
+  return triangles;
+}
+
+// The triangles of a primitive as the GameCube draws them.
+std::vector<Triangle> GetExpectedTriangles(int primitive, u32 first, u32 num_vertices)
+{
+  std::vector<Triangle> triangles;
+  switch (primitive)
+  {
+  case OpcodeDecoder::GX_DRAW_QUADS:
+    for (u32 i = 0; i + 4 <= num_vertices; i += 4)
+    {
+      triangles.push_back({first + i, first + i + 1, first + i + 2});
+      triangles.push_back({first + i, first + i + 2, first + i + 3});
+    }
+    // A single triangle is drawn for three remaining vertices.
+    if (num_vertices % 4 == 3)
+    {
+      const u32 last = first + num_vertices - 1;
+      triangles.push_back({last - 2, last - 1, last});
+    }
+    break;
+
+  case OpcodeDecoder::GX_DRAW_TRIANGLES:
+    for (u32 i = 0; i + 3 <= num_vertices; i += 3)
+      triangles.push_back({first + i, first + i + 1, first + i + 2});
+    break;
+
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP:
+    for (u32 i = 2; i < num_vertices; ++i)
+    {
+      if (i % 2 == 0)
+        triangles.push_back({first + i - 2, first + i - 1, first + i});
+      else
+        triangles.push_back({first + i - 2, first + i, first + i - 1});
+    }
+    break;
+
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_FAN:
+    for (u32 i = 2; i < num_vertices; ++i)
+      triangles.push_back({first, first + i - 1, first + i});
+    break;
+  }
+
+  for (Triangle& triangle : triangles)
+    triangle = Normalize(triangle);
+  return triangles;
+}
+
+std::vector<u16> GetExpectedIndices(int primitive, u32 first, u32 num_vertices)
+{
+  std::vector<u16> indices;
+  switch (primitive)
+  {
+  case OpcodeDecoder::GX_DRAW_LINES:
+    for (u32 i = 0; i + 2 <= num_vertices; i += 2)
+    {
+      indices.push_back(first + i);
+      indices.push_back(first + i + 1);
+    }
+    break;
+
+  case OpcodeDecoder::GX_DRAW_LINE_STRIP:
+    for (u32 i = 1; i < num_vertices; ++i)
+    {
+      indices.push_back(first + i - 1);
+      indices.push_back(first + i);
+    }
+    break;
+
+  case OpcodeDecoder::GX_DRAW_POINTS:
+    for (u32 i = 0; i < num_vertices; ++i)
+      indices.push_back(first + i);
+    break;
+  }
+  return indices;
+}
+
+void ExpectMatchesPrimitive(int primitive, u32 num_vertices, bool primitive_restart)
+{
+  SCOPED_TRACE(testing::Message() << "primitive " << primitive << ", " << num_vertices
+                                  << " vertices, primitive restart " << primitive_restart);
+
+  const std::vector<u16> indices = Generate(primitive, num_vertices, primitive_restart);
+  if (IsTrianglePrimitive(primitive))
+  {
+    EXPECT_EQ(GetExpectedTriangles(primitive, BASE_VERTICES, num_vertices),
+              GetDrawnTriangles(indices, primitive_restart));
+  }
+  else
+  {
+    EXPECT_EQ(GetExpectedIndices(primitive, BASE_VERTICES, num_vertices), indices);
+  }
+}
+}  // namespace
+
+TEST(IndexGenerator, AllPrimitives)
+{
+  for (const bool primitive_restart : {false, true})
+  {
+    for (const PrimitiveInfo& info : PRIMITIVES)
+    {
+      for (u32 num_vertices = 0; num_vertices <= 200; ++num_vertices)
+        ExpectMatchesPrimitive(info.primitive, num_vertices, primitive_restart);
+      ExpectMatchesPrimitive(info.primitive, 4099, primitive_restart);
+    }
+  }
+}
+
+// Not really a test: prints the index generation throughput for every primitive type. Disabled so
+// that it only runs when asked for with --gtest_also_run_disabled_tests.
+TEST(IndexGenerator, DISABLED_Benchmark)
+{
+  std::vector<u16> indices(BENCHMARK_VERTICES * 3);
+
+  for (const bool primitive_restart : {false, true})
+  {
+    std::printf("Primitive restart: %s\n", primitive_restart ? "yes" : "no");
+    for (const PrimitiveInfo& info : PRIMITIVES)
+    {
+      IndexGenerator generator;
+      generator.Init(primitive_restart);
+
+      const auto start = std::chrono::steady_clock::now();
+      u32 num_indices = 0;
+      for (u32 i = 0; i < BENCHMARK_ITERATIONS; ++i)
+      {
+        generator.Start(indices.data());
+        generator.AddIndices(info.primitive, BENCHMARK_VERTICES);
+        num_indices += generator.GetIndexLen();
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      const double vertices = double(BENCHMARK_VERTICES) * BENCHMARK_ITERATIONS;
+      std::printf("%-14s %8.1f MVertex/s, %8.1f MIndex/s\n", info.name,
+                  vertices / elapsed.count() / 1e6, num_indices / elapsed.count() / 1e6);
+    }
+  }
+}
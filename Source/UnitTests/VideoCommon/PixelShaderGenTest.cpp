@@ -0,0 +1,122 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/VideoCommon.h"
+
+namespace
+{
+constexpr u32 BENCHMARK_UIDS = 10000;
+constexpr u32 BENCHMARK_STAGE_CONFIGS = 64;
+
+// Returns the UIDs of random BP register states.
+std::vector<PixelShaderUid> GetRandomUids(u32 count)
+{
+  std::mt19937 generator(count);
+  std::vector<PixelShaderUid> uids;
+  uids.reserve(count);
+  for (u32 i = 0; i < count; ++i)
+  {
+    u32* const registers = reinterpret_cast<u32*>(&bpmem);
+    for (size_t j = 0; j < sizeof(bpmem) / sizeof(u32); ++j)
+      registers[j] = generator();
+
+    // The generator asserts on the matrix IDs that don't exist, and indexes a table with the
+    // wrapping factor.
+    for (TevStageIndirect& tevind : bpmem.tevind)
+    {
+      if (tevind.mid == 4 || tevind.mid == 8 || tevind.mid >= 12)
+        tevind.mid = 0;
+      if (tevind.sw == 7)
+        tevind.sw = ITW_OFF;
+      if (tevind.tw == 7)
+        tevind.tw = ITW_OFF;
+    }
+
+    PixelShaderUid uid = GetPixelShaderUid();
+    ClearUnusedPixelShaderUidBits(APIType::OpenGL, ShaderHostConfig{}, &uid);
+    uids.push_back(uid);
+  }
+  return uids;
+}
+
+std::string Generate(const PixelShaderUid& uid)
+{
+  return GeneratePixelShaderCode(APIType::OpenGL, ShaderHostConfig{}, uid.GetUidData())
+      .GetBuffer();
+}
+
+// The generator keeps the code of the TEV stages per thread, so a new thread starts without it.
+template <typename Function>
+void RunInNewThread(Function function)
+{
+  std::thread thread(function);
+  thread.join();
+}
+}  // namespace
+
+TEST(PixelShaderGen, CachedStagesMatch)
+{
+  const std::vector<PixelShaderUid> uids = GetRandomUids(200);
+
+  // Each shader on its own never uses the code of a stage that another shader generated.
+  std::vector<std::string> expected;
+  for (const PixelShaderUid& uid : uids)
+    RunInNewThread([&] { expected.push_back(Generate(uid)); });
+
+  RunInNewThread([&] {
+    for (size_t i = 0; i < uids.size(); ++i)
+      EXPECT_EQ(expected[i], Generate(uids[i])) << "uid " << i;
+    // The second time, every stage comes from the cache.
+    for (size_t i = uids.size(); i-- > 0;)
+      EXPECT_EQ(expected[i], Generate(uids[i])) << "uid " << i;
+  });
+}
+
+// Not really a test: prints how fast pixel shaders are generated for 10000 random UIDs. Disabled
+// so that it only runs when asked for with --gtest_also_run_disabled_tests.
+TEST(PixelShaderGen, DISABLED_Benchmark)
+{
+  std::vector<PixelShaderUid> uids = GetRandomUids(BENCHMARK_UIDS);
+  const auto run = [&uids](const char* name) {
+    RunInNewThread([&] {
+      const auto start = std::chrono::steady_clock::now();
+      size_t size = 0;
+      for (const PixelShaderUid& uid : uids)
+        size += Generate(uid).size();
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      std::printf("%-18s %u shaders in %.3f s, %8.1f shaders/s, %6.1f MB/s\n", name,
+                  BENCHMARK_UIDS, elapsed.count(), BENCHMARK_UIDS / elapsed.count(),
+                  size / elapsed.count() / 1e6);
+    });
+  };
+
+  run("Random stages:");
+
+  // Games combine a much smaller number of stage configurations into their shaders.
+  const std::vector<PixelShaderUid> configs(uids.begin(), uids.begin() + BENCHMARK_STAGE_CONFIGS);
+  std::mt19937 generator(BENCHMARK_STAGE_CONFIGS);
+  for (PixelShaderUid& uid : uids)
+  {
+    for (size_t i = 0; i < std::size(uid.GetUidData()->stagehash); ++i)
+    {
+      const PixelShaderUid& config = configs[generator() % BENCHMARK_STAGE_CONFIGS];
+      uid.GetUidData()->stagehash[i] = config.GetUidData()->stagehash[i];
+    }
+  }
+  run("Shared stages:");
+}
@@ -0,0 +1,209 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cfenv>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/NativeVertexFormat.h"
+#include "VideoBackends/Software/Rasterizer.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PerfQueryBase.h"
+#include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace
+{
+constexpr u32 NUM_BATCHES = 50;
+constexpr u32 TRIANGLES_PER_BATCH = 200;
+constexpr u32 TEXTURE_SIZE = 64;
+
+// Two TEV stages, the first without a texture, so that it reads the texture color before the pixel
+// sampled any texture. The second one samples an I8 texture from TMEM.
+void SetState()
+{
+  std::memset(&bpmem, 0, sizeof(bpmem));
+  std::memset(&xfmem, 0, sizeof(xfmem));
+  std::memset(&PixelShaderManager::constants, 0, sizeof(PixelShaderManager::constants));
+
+  bpmem.genMode.numcolchans = 1;
+  bpmem.genMode.numtexgens = 1;
+  bpmem.genMode.numtevstages = 1;
+
+  bpmem.scissorOffset.x = 342 / 2;
+  bpmem.scissorOffset.y = 342 / 2;
+  bpmem.scissorTL.x = 342;
+  bpmem.scissorTL.y = 342;
+  bpmem.scissorBR.x = 342 + EFB_WIDTH - 1;
+  bpmem.scissorBR.y = 342 + EFB_HEIGHT - 1;
+
+  bpmem.tevorders[0].colorchan0 = 0;
+  bpmem.tevorders[0].enable1 = 1;
+  bpmem.tevorders[0].colorchan1 = 0;
+  bpmem.tevksel[0].swap1 = 0;
+  bpmem.tevksel[0].swap2 = 1;
+  bpmem.tevksel[1].swap1 = 2;
+  bpmem.tevksel[1].swap2 = 3;
+
+  // prev = tex, then prev = lerp(prev, tex, ras)
+  bpmem.combiners[0].colorC.a = TEVCOLORARG_ZERO;
+  bpmem.combiners[0].colorC.b = TEVCOLORARG_ZERO;
+  bpmem.combiners[0].colorC.c = TEVCOLORARG_ZERO;
+  bpmem.combiners[0].colorC.d = TEVCOLORARG_TEXC;
+  bpmem.combiners[0].alphaC.a = TEVALPHAARG_ZERO;
+  bpmem.combiners[0].alphaC.b = TEVALPHAARG_ZERO;
+  bpmem.combiners[0].alphaC.c = TEVALPHAARG_ZERO;
+  bpmem.combiners[0].alphaC.d = TEVALPHAARG_RASA;
+  bpmem.combiners[1].colorC.a = TEVCOLORARG_CPREV;
+  bpmem.combiners[1].colorC.b = TEVCOLORARG_TEXC;
+  bpmem.combiners[1].colorC.c = TEVCOLORARG_RASC;
+  bpmem.combiners[1].colorC.d = TEVCOLORARG_ZERO;
+  bpmem.combiners[1].alphaC.a = TEVALPHAARG_ZERO;
+  bpmem.combiners[1].alphaC.b = TEVALPHAARG_ZERO;
+  bpmem.combiners[1].alphaC.c = TEVALPHAARG_ZERO;
+  bpmem.combiners[1].alphaC.d = TEVALPHAARG_APREV;
+
+  // Wrap the texture coordinates
+  bpmem.tex[0].texMode0[0].wrap_s = 1;
+  bpmem.tex[0].texMode0[0].wrap_t = 1;
+  bpmem.tex[0].texImage0[0].width = TEXTURE_SIZE - 1;
+  bpmem.tex[0].texImage0[0].height = TEXTURE_SIZE - 1;
+  bpmem.tex[0].texImage0[0].format = static_cast<u32>(TextureFormat::I8);
+  bpmem.tex[0].texImage1[0].image_type = 1;
+
+  bpmem.alpha_test.comp0 = AlphaTest::ALWAYS;
+  bpmem.alpha_test.comp1 = AlphaTest::ALWAYS;
+  bpmem.zmode.testenable = 1;
+  bpmem.zmode.updateenable = 1;
+  bpmem.blendmode.blendenable = 1;
+  bpmem.blendmode.srcfactor = BlendMode::SRCALPHA;
+  bpmem.blendmode.dstfactor = BlendMode::INVSRCALPHA;
+  bpmem.blendmode.colorupdate = 1;
+  bpmem.blendmode.alphaupdate = 1;
+  bpmem.zcontrol.pixel_format = PEControl::RGBA6_Z24;
+}
+
+struct RenderResult
+{
+  std::vector<u32> efb;
+  std::array<u32, PQ_NUM_MEMBERS> perf_counters;
+};
+
+// Draws the same random triangles with the given number of worker threads, and returns the color
+// and depth of every pixel of the EFB and the perf counters.
+RenderResult Render(u32 threads)
+{
+  g_ActiveConfig.iSWRasterizerThreads = static_cast<int>(threads);
+  g_ActiveConfig.bZComploc = true;
+  g_ActiveConfig.bZFreeze = true;
+  SetState();
+
+  std::mt19937 generator(NUM_BATCHES);
+  for (u32 i = 0; i < TEXTURE_SIZE * TEXTURE_SIZE; ++i)
+    texMem[i] = static_cast<u8>(generator());
+
+  u8 clear_color[4] = {};
+  for (u16 y = 0; y < EFB_HEIGHT; ++y)
+  {
+    for (u16 x = 0; x < EFB_WIDTH; ++x)
+    {
+      EfbInterface::SetColor(x, y, clear_color);
+      EfbInterface::SetDepth(x, y, 0xffffff);
+    }
+  }
+  EfbInterface::ResetPerfQuery();
+
+  Rasterizer::Init();
+
+  // Set after the worker threads were started, like the GPU thread does when a game changes it.
+  const int rounding_mode = std::fegetround();
+  std::fesetround(FE_TOWARDZERO);
+
+  std::uniform_real_distribution<float> center_x(-20.0f, EFB_WIDTH + 20.0f);
+  std::uniform_real_distribution<float> center_y(-20.0f, EFB_HEIGHT + 20.0f);
+  std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+  std::uniform_real_distribution<float> depth(0.0f, 16777215.0f);
+  std::uniform_real_distribution<float> w(1.0f, 3.0f);
+  std::uniform_real_distribution<float> texcoord(-4.0f, 4.0f);
+  for (u32 batch = 0; batch < NUM_BATCHES; ++batch)
+  {
+    bpmem.zmode.func = batch % 3 ? ZMode::LEQUAL : ZMode::ALWAYS;
+    for (u32 i = 0; i < TRIANGLES_PER_BATCH; ++i)
+    {
+      OutputVertexData vertices[3];
+      const float x = center_x(generator);
+      const float y = center_y(generator);
+      const float size = generator() % 4 == 0 ? 120.0f : 30.0f;
+      for (OutputVertexData& vertex : vertices)
+      {
+        vertex.screenPosition = Vec3(x + offset(generator) * size, y + offset(generator) * size,
+                                     depth(generator));
+        vertex.projectedPosition.w = w(generator);
+        for (u8& comp : vertex.color[0])
+          comp = static_cast<u8>(generator());
+        vertex.texCoords[0] = Vec3(texcoord(generator), texcoord(generator), 1.0f);
+      }
+
+      // Only one of the windings covers any pixels.
+      Rasterizer::DrawTriangleFrontFace(&vertices[0], &vertices[1], &vertices[2]);
+      Rasterizer::DrawTriangleFrontFace(&vertices[2], &vertices[1], &vertices[0]);
+    }
+    Rasterizer::Flush();
+  }
+
+  std::fesetround(rounding_mode);
+  Rasterizer::Shutdown();
+
+  RenderResult result;
+  result.efb.reserve(EFB_WIDTH * EFB_HEIGHT * 2);
+  for (u16 y = 0; y < EFB_HEIGHT; ++y)
+  {
+    for (u16 x = 0; x < EFB_WIDTH; ++x)
+    {
+      result.efb.push_back(EfbInterface::GetColor(x, y));
+      result.efb.push_back(EfbInterface::GetDepth(x, y));
+    }
+  }
+  for (u32 i = 0; i < PQ_NUM_MEMBERS; ++i)
+    result.perf_counters[i] = EfbInterface::GetPerfQueryResult(static_cast<PerfQueryType>(i));
+  return result;
+}
+}  // namespace
+
+// The tiles that the worker threads draw must give exactly the same result as one thread.
+TEST(SoftwareRasterizer, ThreadsMatchSerialDrawing)
+{
+  const RenderResult expected = Render(0);
+  for (const u32 threads : {1, 3, 7})
+  {
+    const RenderResult actual = Render(threads);
+    ASSERT_EQ(expected.efb.size(), actual.efb.size());
+    for (size_t i = 0; i < expected.efb.size(); ++i)
+    {
+      if (expected.efb[i] != actual.efb[i])
+      {
+        ADD_FAILURE() << threads << " threads: pixel " << i / 2 << (i % 2 ? " depth" : " color")
+                      << ": expected " << std::hex << expected.efb[i] << ", got " << actual.efb[i];
+        break;
+      }
+    }
+
+    // Only every third pixel is counted, and that count goes on across resets, so the counters can
+    // be one apart depending on how many pixels were drawn before.
+    for (u32 i = 0; i < PQ_NUM_MEMBERS; ++i)
+    {
+      EXPECT_NEAR(expected.perf_counters[i], actual.perf_counters[i], 1)
+          << threads << " threads: perf counter " << i;
+    }
+  }
+}
@@ -0,0 +1,227 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/Tev.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/VideoCommon.h"
+
+#ifdef _M_X86
+// gtest's TEST macro conflicts with the TEST method of the x64Emitter, so the test case is
+// declared with GTEST_TEST instead.
+#undef TEST
+#include "VideoBackends/Software/TevX64.h"
+#endif
+
+namespace
+{
+constexpr u32 NUM_CONFIGS = 2000;
+constexpr u32 QUADS_PER_CONFIG = 8;
+
+// Sets random TEV stages, alpha test, depth test and blending. Textures, indirect textures, fog
+// and z textures would read memory that isn't set up.
+void SetRandomState(std::mt19937& generator, const std::array<Tev*, 3>& tevs)
+{
+  u32* const registers = reinterpret_cast<u32*>(&bpmem);
+  for (size_t i = 0; i < sizeof(bpmem) / sizeof(u32); ++i)
+    registers[i] = generator();
+
+  bpmem.genMode.numindstages = 0;
+  for (TevStageIndirect& tevind : bpmem.tevind)
+    tevind.hex = 0;
+  for (TwoTevStageOrders& order : bpmem.tevorders)
+  {
+    order.enable0 = 0;
+    order.enable1 = 0;
+  }
+  // There are no alpha konst values for these selections.
+  for (TevKSel& ksel : bpmem.tevksel)
+  {
+    if (ksel.kasel0 >= 12 && ksel.kasel0 < 16)
+      ksel.kasel0 = 0;
+    if (ksel.kasel1 >= 12 && ksel.kasel1 < 16)
+      ksel.kasel1 = 0;
+  }
+  // Without compare modes, the combiners of every stage can be compiled.
+  if (generator() & 1)
+  {
+    for (TevStageCombiner& combiner : bpmem.combiners)
+    {
+      if (combiner.colorC.bias == TEVBIAS_COMPARE)
+        combiner.colorC.bias = TEVBIAS_ZERO;
+      if (combiner.alphaC.bias == TEVBIAS_COMPARE)
+        combiner.alphaC.bias = TEVBIAS_ZERO;
+    }
+  }
+  bpmem.fog.c_proj_fsel.fsel = 0;
+  bpmem.ztex2.op = ZTEXTURE_DISABLE;
+
+  for (auto& color : PixelShaderManager::constants.colors)
+  {
+    for (int& comp : color)
+      comp = static_cast<int>(generator() % 2048) - 1024;
+  }
+  for (int reg = 0; reg < 4; ++reg)
+  {
+    for (int comp = 0; comp < 4; ++comp)
+    {
+      const s16 color = static_cast<s16>(generator() % 2048) - 1024;
+      for (Tev* tev : tevs)
+        tev->SetRegColor(reg, comp, color);
+    }
+  }
+}
+
+struct Pixel
+{
+  s32 position[3];
+  u8 color[2][4];
+  s32 uv[8][2];
+};
+
+void SetInputs(Tev& tev, const Pixel& pixel)
+{
+  std::memcpy(tev.Position, pixel.position, sizeof(tev.Position));
+  std::memcpy(tev.Color, pixel.color, sizeof(tev.Color));
+  for (int i = 0; i < 8; ++i)
+  {
+    tev.Uv[i].s = pixel.uv[i][0];
+    tev.Uv[i].t = pixel.uv[i][1];
+  }
+}
+
+// The color and depth of the pixels of a quad in the EFB.
+using QuadEfb = std::array<u8, Tev::QUAD_LANES * 6>;
+
+QuadEfb ReadEfb(const std::array<Pixel, Tev::QUAD_LANES>& pixels)
+{
+  QuadEfb efb;
+  for (int i = 0; i < Tev::QUAD_LANES; ++i)
+  {
+    const u16 x = pixels[i].position[0];
+    const u16 y = pixels[i].position[1];
+    std::memcpy(&efb[i * 6], EfbInterface::GetPixelPointer(x, y, false), 3);
+    std::memcpy(&efb[i * 6 + 3], EfbInterface::GetPixelPointer(x, y, true), 3);
+  }
+  return efb;
+}
+
+void WriteEfb(const std::array<Pixel, Tev::QUAD_LANES>& pixels, const QuadEfb& efb)
+{
+  for (int i = 0; i < Tev::QUAD_LANES; ++i)
+  {
+    const u16 x = pixels[i].position[0];
+    const u16 y = pixels[i].position[1];
+    std::memcpy(EfbInterface::GetPixelPointer(x, y, false), &efb[i * 6], 3);
+    std::memcpy(EfbInterface::GetPixelPointer(x, y, true), &efb[i * 6 + 3], 3);
+  }
+}
+}  // namespace
+
+GTEST_TEST(SoftwareTev, QuadsMatchPixels)
+{
+  std::mt19937 generator(NUM_CONFIGS);
+  const auto scalar = std::make_unique<Tev>();
+  const auto quad = std::make_unique<Tev>();
+  const auto compiled = std::make_unique<Tev>();
+  scalar->Init();
+  quad->Init();
+  compiled->Init();
+#ifdef _M_X86
+  TevX64 compiler;
+  u32 compiled_configs = 0;
+#endif
+
+  for (u32 config = 0; config < NUM_CONFIGS; ++config)
+  {
+    SetRandomState(generator, {scalar.get(), quad.get(), compiled.get()});
+#ifdef _M_X86
+    const Tev::CombineQuadFunction function = compiler.GetCombineQuadFunction(*compiled);
+    compiled->SetCombineQuadFunction(function);
+    if (function)
+      ++compiled_configs;
+#endif
+
+    for (u32 i = 0; i < QUADS_PER_CONFIG; ++i)
+    {
+      const s32 x = generator() % (EFB_WIDTH / 2) * 2;
+      const s32 y = generator() % (EFB_HEIGHT / 2) * 2;
+      std::array<Pixel, Tev::QUAD_LANES> pixels;
+      for (int lane = 0; lane < Tev::QUAD_LANES; ++lane)
+      {
+        Pixel& pixel = pixels[lane];
+        pixel.position[0] = x + (lane & 1);
+        pixel.position[1] = y + (lane >> 1);
+        pixel.position[2] = generator() & 0xffffff;
+        for (auto& color : pixel.color)
+        {
+          for (u8& comp : color)
+            comp = static_cast<u8>(generator());
+        }
+        for (auto& uv : pixel.uv)
+        {
+          uv[0] = static_cast<s32>(generator() % 0x1000000) - 0x800000;
+          uv[1] = static_cast<s32>(generator() % 0x1000000) - 0x800000;
+        }
+      }
+
+      QuadEfb initial;
+      for (u8& value : initial)
+        value = static_cast<u8>(generator());
+
+      // Partially covered quads only draw some of the pixels.
+      const u32 covered = generator() % 15 + 1;
+
+      WriteEfb(pixels, initial);
+      for (int lane = 0; lane < Tev::QUAD_LANES; ++lane)
+      {
+        if (covered & (1 << lane))
+        {
+          SetInputs(*scalar, pixels[lane]);
+          scalar->Draw();
+        }
+      }
+      const QuadEfb expected = ReadEfb(pixels);
+
+      WriteEfb(pixels, initial);
+      for (int lane = 0; lane < Tev::QUAD_LANES; ++lane)
+      {
+        if (covered & (1 << lane))
+        {
+          SetInputs(*quad, pixels[lane]);
+          quad->AddQuadPixel();
+        }
+      }
+      quad->DrawQuad();
+      EXPECT_EQ(expected, ReadEfb(pixels)) << "config " << config << ", quad " << i;
+
+      // The same quad, combined by the compiled function if there is one
+      WriteEfb(pixels, initial);
+      for (int lane = 0; lane < Tev::QUAD_LANES; ++lane)
+      {
+        if (covered & (1 << lane))
+        {
+          SetInputs(*compiled, pixels[lane]);
+          compiled->AddQuadPixel();
+        }
+      }
+      compiled->DrawQuad();
+      EXPECT_EQ(expected, ReadEfb(pixels)) << "compiled config " << config << ", quad " << i;
+    }
+  }
+
+#ifdef _M_X86
+  EXPECT_GE(compiled_configs, NUM_CONFIGS / 4);
+#endif
+}
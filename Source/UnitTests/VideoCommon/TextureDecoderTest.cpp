@@ -0,0 +1,347 @@
+// Copyright 2020 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "VideoCommon/ParallelTextureDecoder.h"
+#include "VideoCommon/TextureDecoder.h"
+
+#include "../RandomData.h"
+
+namespace
+{
+constexpr u32 TEST_THREADS = 3;
+constexpr u32 BENCHMARK_SIZE = 1024;
+constexpr u32 BENCHMARK_ITERATIONS = 16;
+constexpr u32 THROUGHPUT_SIZE = 512;
+constexpr u32 THROUGHPUT_ITERATIONS = 64;
+
+// Large enough for a C14X2 palette.
+constexpr u32 TLUT_SIZE = 0x4000 * 2;
+
+struct FormatInfo
+{
+  TextureFormat format;
+  const char* name;
+};
+
+constexpr TLUTFormat TLUT_FORMATS[] = {TLUTFormat::IA8, TLUTFormat::RGB565, TLUTFormat::RGB5A3};
+
+constexpr FormatInfo FORMATS[] = {
+    {TextureFormat::I4, "I4"},         {TextureFormat::I8, "I8"},
+    {TextureFormat::IA4, "IA4"},       {TextureFormat::IA8, "IA8"},
+    {TextureFormat::RGB565, "RGB565"}, {TextureFormat::RGB5A3, "RGB5A3"},
+    {TextureFormat::RGBA8, "RGBA8"},   {TextureFormat::C4, "C4"},
+    {TextureFormat::C8, "C8"},         {TextureFormat::C14X2, "C14X2"},
+    {TextureFormat::CMPR, "CMPR"},     {TextureFormat::XFB, "XFB"},
+};
+
+// Writes a big-endian 16-bit value, like the textures and palettes in guest memory.
+void Write16(u8* dst, u16 value)
+{
+  const u16 swapped = Common::swap16(value);
+  std::memcpy(dst, &swapped, sizeof(swapped));
+}
+
+// Decodes a texture with the per-texel decoder, which the software renderer uses and which doesn't
+// share any code with the vectorized decoders.
+std::vector<u32> DecodeReference(const std::vector<u8>& src, u32 width, u32 height,
+                                 TextureFormat format, const u8* tlut, TLUTFormat tlut_format)
+{
+  std::vector<u32> result(width * height);
+  for (u32 y = 0; y < height; ++y)
+  {
+    for (u32 x = 0; x < width; ++x)
+    {
+      TexDecoder_DecodeTexel(reinterpret_cast<u8*>(&result[y * width + x]), src.data(), x, y,
+                             width - 1, format, tlut, tlut_format);
+    }
+  }
+  return result;
+}
+
+std::vector<u32> Decode(const std::vector<u8>& src, u32 width, u32 height, TextureFormat format,
+                        const u8* tlut, TLUTFormat tlut_format)
+{
+  std::vector<u32> result(width * height);
+  TexDecoder_Decode(reinterpret_cast<u8*>(result.data()), src.data(), width, height, format, tlut,
+                    tlut_format);
+  return result;
+}
+
+// Runs a function once for each of the x64 decoder kernels that this CPU supports.
+template <typename F>
+void ForEachKernel(F function)
+{
+  const CPUInfo detected = cpu_info;
+
+  if (cpu_info.bAVX2)
+    function("AVX2");
+  cpu_info.bAVX2 = false;
+  if (cpu_info.bSSSE3)
+    function("SSSE3");
+  cpu_info.bSSSE3 = false;
+  function("SSE2");
+
+  cpu_info = detected;
+}
+
+void ExpectMatchesReference(const std::vector<u8>& src, u32 width, u32 height,
+                            TextureFormat format, const u8* tlut = nullptr,
+                            TLUTFormat tlut_format = TLUTFormat::IA8)
+{
+  const std::vector<u32> expected = DecodeReference(src, width, height, format, tlut, tlut_format);
+  ForEachKernel([&](const char* kernel) {
+    const std::vector<u32> actual = Decode(src, width, height, format, tlut, tlut_format);
+    for (u32 i = 0; i < expected.size(); ++i)
+    {
+      if (expected[i] != actual[i])
+      {
+        ADD_FAILURE() << kernel << ": format " << static_cast<int>(format) << ", TLUT format "
+                      << static_cast<int>(tlut_format) << ", texel " << i << ": expected "
+                      << std::hex << expected[i] << ", got " << actual[i];
+        return;
+      }
+    }
+  });
+}
+
+u32 GetLevelSize(u32 size, u32 level)
+{
+  return std::max(size >> level, 1u);
+}
+
+// Sizes of the source and decoded data of a texture and its mip chain, down to 1x1.
+struct MipChain
+{
+  MipChain(TextureFormat format, u32 width, u32 height)
+  {
+    const u32 block_width = TexDecoder_GetBlockWidthInTexels(format);
+    const u32 block_height = TexDecoder_GetBlockHeightInTexels(format);
+    for (u32 level = 0;; ++level)
+    {
+      const u32 level_width = GetLevelSize(width, level);
+      const u32 level_height = GetLevelSize(height, level);
+      const u32 expanded_width = (level_width + block_width - 1) / block_width * block_width;
+      const u32 expanded_height = (level_height + block_height - 1) / block_height * block_height;
+      levels.push_back({expanded_width, expanded_height, src_size, dst_size});
+      src_size += TexDecoder_GetTextureSizeInBytes(expanded_width, expanded_height, format);
+      dst_size += expanded_width * expanded_height * sizeof(u32);
+
+      if (level_width == 1 && level_height == 1)
+        break;
+    }
+  }
+
+  struct Level
+  {
+    u32 width;
+    u32 height;
+    u32 src_offset;
+    u32 dst_offset;
+  };
+  std::vector<Level> levels;
+  u32 src_size = 0;
+  u32 dst_size = 0;
+};
+}  // namespace
+
+TEST(TextureDecoder, AllFormatsMatchReference)
+{
+  const std::vector<u8> tlut = GetRandomData(TLUT_SIZE);
+  for (const FormatInfo& info : FORMATS)
+  {
+    // XFB has no per-texel decoder.
+    if (info.format == TextureFormat::XFB)
+      continue;
+
+    // Also try an odd number of blocks, which some kernels handle separately.
+    const u32 width = TexDecoder_GetBlockWidthInTexels(info.format) * 9;
+    const u32 height = TexDecoder_GetBlockHeightInTexels(info.format) * 3;
+    for (const auto& [w, h] : {std::pair<u32, u32>(64, 64), std::pair<u32, u32>(width, height)})
+    {
+      const std::vector<u8> src =
+          GetRandomData(TexDecoder_GetTextureSizeInBytes(w, h, info.format));
+      for (TLUTFormat tlut_format : TLUT_FORMATS)
+        ExpectMatchesReference(src, w, h, info.format, tlut.data(), tlut_format);
+    }
+  }
+}
+
+TEST(TextureDecoder, AllTexelValues16Bit)
+{
+  // Every possible texel value, in a 256x256 texture.
+  std::vector<u8> src(256 * 256 * 2);
+  for (u32 i = 0; i < 0x10000; ++i)
+    Write16(&src[i * 2], static_cast<u16>(i));
+
+  for (TextureFormat format : {TextureFormat::IA8, TextureFormat::RGB565, TextureFormat::RGB5A3})
+    ExpectMatchesReference(src, 256, 256, format);
+}
+
+TEST(TextureDecoder, AllPaletteEntries)
+{
+  // Every index, in an 8x32 C4 texture and a 16x16 C8 texture.
+  std::vector<u8> src(256);
+  for (u32 i = 0; i < src.size(); ++i)
+    src[i] = static_cast<u8>(i);
+
+  // Palettes that cover every possible entry value between them.
+  std::vector<u8> tlut(256 * 2);
+  for (TLUTFormat tlut_format : TLUT_FORMATS)
+  {
+    for (u32 first_entry = 0; first_entry < 0x10000; first_entry += 256)
+    {
+      for (u32 i = 0; i < 256; ++i)
+        Write16(&tlut[i * 2], static_cast<u16>(first_entry + i));
+
+      ExpectMatchesReference(src, 16, 16, TextureFormat::C8, tlut.data(), tlut_format);
+      // C4 only uses the first 16 entries, so move each group of 16 to the front in turn.
+      for (u32 group = 0; group < 16; ++group)
+      {
+        std::rotate(tlut.begin(), tlut.begin() + 32, tlut.end());
+        ExpectMatchesReference(src, 8, 64, TextureFormat::C4, tlut.data(), tlut_format);
+      }
+    }
+  }
+}
+
+TEST(TextureDecoder, CMPRBlocks)
+{
+  // One block for every value of the first color, with the second color random, equal to the
+  // first one, or just above or below it, so that both the opaque and the transparent modes and
+  // the rounding of the interpolated colors are covered.
+  std::vector<u8> src = GetRandomData(0x10000 * 8);
+  for (u32 i = 0; i < 0x10000; ++i)
+  {
+    u8* block = &src[i * 8];
+    Write16(block, static_cast<u16>(i));
+    switch (i % 4)
+    {
+    case 1:
+      Write16(block + 2, static_cast<u16>(i));
+      break;
+    case 2:
+      Write16(block + 2, static_cast<u16>(i + 1));
+      break;
+    case 3:
+      Write16(block + 2, static_cast<u16>(i - 1));
+      break;
+    }
+  }
+
+  ExpectMatchesReference(src, 1024, 1024, TextureFormat::CMPR);
+}
+
+TEST(ParallelTextureDecoder, MatchesSerialDecoding)
+{
+  ParallelTextureDecoder decoder(TEST_THREADS);
+  const std::vector<u8> tlut = GetRandomData(TLUT_SIZE);
+
+  for (const FormatInfo& info : FORMATS)
+  {
+    // Sizes that do and don't split into bands evenly, with their mip chains.
+    for (u32 size : {8u, 256u, 520u, 1024u})
+    {
+      const MipChain chain(info.format, size, size);
+      const std::vector<u8> src = GetRandomData(chain.src_size);
+      std::vector<u8> expected(chain.dst_size);
+      std::vector<u8> actual(chain.dst_size);
+
+      for (const MipChain::Level& level : chain.levels)
+      {
+        TexDecoder_Decode(&expected[level.dst_offset], &src[level.src_offset], level.width,
+                          level.height, info.format, tlut.data(), TLUTFormat::RGB5A3);
+        decoder.Decode(&actual[level.dst_offset], &src[level.src_offset], level.width,
+                       level.height, info.format, tlut.data(), TLUTFormat::RGB5A3);
+      }
+      decoder.Flush();
+
+      EXPECT_EQ(expected, actual) << info.name << " " << size << "x" << size;
+    }
+  }
+}
+
+// Not really a test: prints how long it takes to decode a full mip chain of a large texture in
+// every format, serially and on the parallel decoder. Disabled so that it only runs when asked for
+// with --gtest_also_run_disabled_tests.
+TEST(ParallelTextureDecoder, DISABLED_Benchmark)
+{
+  ParallelTextureDecoder decoder;
+  const std::vector<u8> tlut = GetRandomData(TLUT_SIZE);
+
+  std::printf("Decoding %ux%u mip chains with %u worker threads\n", BENCHMARK_SIZE,
+              BENCHMARK_SIZE, ParallelTextureDecoder::GetDefaultThreadCount());
+  for (const FormatInfo& info : FORMATS)
+  {
+    const MipChain chain(info.format, BENCHMARK_SIZE, BENCHMARK_SIZE);
+    const std::vector<u8> src = GetRandomData(chain.src_size);
+    std::vector<u8> dst(chain.dst_size);
+
+    const auto measure = [&](auto decode_chain) {
+      const auto start = std::chrono::steady_clock::now();
+      for (u32 i = 0; i < BENCHMARK_ITERATIONS; ++i)
+        decode_chain();
+      const std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - start;
+      return elapsed.count() / BENCHMARK_ITERATIONS;
+    };
+
+    const double serial = measure([&] {
+      for (const MipChain::Level& level : chain.levels)
+      {
+        TexDecoder_Decode(&dst[level.dst_offset], &src[level.src_offset], level.width,
+                          level.height, info.format, tlut.data(), TLUTFormat::RGB5A3);
+      }
+    });
+    const double parallel = measure([&] {
+      for (const MipChain::Level& level : chain.levels)
+      {
+        decoder.Decode(&dst[level.dst_offset], &src[level.src_offset], level.width,
+                       level.height, info.format, tlut.data(), TLUTFormat::RGB5A3);
+      }
+      decoder.Flush();
+    });
+
+    std::printf("%-7s serial: %7.3f ms, parallel: %7.3f ms\n", info.name, serial, parallel);
+  }
+}
+
+// Not really a test: prints the throughput of each decoder kernel for every texture format.
+// Disabled like the benchmark above.
+TEST(TextureDecoder, DISABLED_Throughput)
+{
+  const std::vector<u8> tlut = GetRandomData(TLUT_SIZE);
+  std::vector<u32> dst(THROUGHPUT_SIZE * THROUGHPUT_SIZE);
+
+  for (const FormatInfo& info : FORMATS)
+  {
+    const std::vector<u8> src = GetRandomData(
+        TexDecoder_GetTextureSizeInBytes(THROUGHPUT_SIZE, THROUGHPUT_SIZE, info.format));
+
+    std::printf("%-7s", info.name);
+    ForEachKernel([&](const char* kernel) {
+      const auto start = std::chrono::steady_clock::now();
+      for (u32 i = 0; i < THROUGHPUT_ITERATIONS; ++i)
+      {
+        TexDecoder_Decode(reinterpret_cast<u8*>(dst.data()), src.data(), THROUGHPUT_SIZE,
+                          THROUGHPUT_SIZE, info.format, tlut.data(), TLUTFormat::RGB5A3);
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      const double texels = double(THROUGHPUT_SIZE) * THROUGHPUT_SIZE * THROUGHPUT_ITERATIONS;
+      std::printf(" %s: %8.1f MTexel/s", kernel, texels / elapsed.count() / 1e6);
+    });
+    std::printf("\n");
+  }
+}
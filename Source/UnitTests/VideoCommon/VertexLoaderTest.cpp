@@ -2,11 +2,14 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <limits>
 #include <memory>
+#include <random>
 #include <tuple>
 #include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest.h>  // NOLINT
 
@@ -15,6 +18,7 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/ParallelVertexLoader.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 
@@ -354,3 +358,117 @@ TEST_F(VertexLoaderTest, LargeFloatVertexSpeed)
   for (int i = 0; i < 100; ++i)
     RunVertices(100000);
 }
+
+TEST_F(VertexLoaderTest, SkippedVertices)
+{
+  m_vtx_desc.PosMatIdx = 1;
+  m_vtx_desc.Position = INDEX16;
+  m_vtx_attr.g0.PosElements = 1;  // XYZ
+  m_vtx_attr.g0.PosFormat = FORMAT_FLOAT;
+  CreateAndCheckSizes(3, 16);
+
+  Input<u8>(0);
+  Input<u16>(0);
+  Input<u8>(0);
+  Input<u16>(0xFFFE);
+  Input<u8>(0xFF);
+  Input<u16>(0xFFFF);
+  EXPECT_FALSE(m_loader->HasSkippedVertices(input_memory, 2));
+  EXPECT_TRUE(m_loader->HasSkippedVertices(input_memory, 3));
+}
+
+TEST_F(VertexLoaderTest, DrawMatrixIndex)
+{
+  m_vtx_desc.Position = DIRECT;
+  m_vtx_attr.g0.PosElements = 1;  // XYZ
+  m_vtx_attr.g0.PosFormat = FORMAT_FLOAT;
+  m_loader = VertexLoaderBase::CreateVertexLoader(m_vtx_desc, m_vtx_attr, true);
+  ASSERT_EQ(12, m_loader->m_VertexSize);
+  ASSERT_EQ(16, m_loader->m_native_vtx_decl.stride);
+  EXPECT_EQ(u32(VB_HAS_DRAWMTXIDX), m_loader->m_native_components & VB_HAS_DRAWMTXIDX);
+  EXPECT_TRUE(m_loader->m_native_vtx_decl.posmtx.enable);
+  EXPECT_EQ(0, m_loader->m_native_vtx_decl.posmtx.offset);
+
+  for (int i = 0; i < 6; ++i)
+    Input<float>(i + 1.0f);
+  RunVertices(2);
+  for (int i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ(0u, m_dst.Read<u32>());
+    ExpectOut(i * 3 + 1.0f);
+    ExpectOut(i * 3 + 2.0f);
+    ExpectOut(i * 3 + 3.0f);
+  }
+}
+
+TEST_F(VertexLoaderTest, ParallelMatchesSerial)
+{
+  m_vtx_desc.PosMatIdx = 1;
+  m_vtx_desc.Position = DIRECT;
+  m_vtx_desc.Color0 = DIRECT;
+  m_vtx_desc.Tex0Coord = INDEX16;
+  m_vtx_attr.g0.PosElements = 1;  // XYZ
+  m_vtx_attr.g0.PosFormat = FORMAT_SHORT;
+  m_vtx_attr.g0.PosFrac = 4;
+  m_vtx_attr.g0.ByteDequant = true;
+  m_vtx_attr.g0.Color0Elements = 1;  // Has Alpha
+  m_vtx_attr.g0.Color0Comp = FORMAT_32B_8888;
+  m_vtx_attr.g0.Tex0CoordElements = 1;  // ST
+  m_vtx_attr.g0.Tex0CoordFormat = FORMAT_FLOAT;
+  CreateAndCheckSizes(13, 28);
+
+  std::mt19937 generator(0);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::generate(input_memory, input_memory + sizeof(input_memory),
+                [&] { return static_cast<u8>(distribution(generator)); });
+  VertexLoaderManager::cached_arraybases[ARRAY_TEXCOORD0] = input_memory;
+  g_main_cp_state.array_strides[ARRAY_TEXCOORD0] = 8;
+
+  // Large draws are split between the threads, the small ones in between are converted in place.
+  const std::vector<int> draws = {5000, 2, 9000, 1, 3000};
+  int total_count = 0;
+  for (int count : draws)
+    total_count += count;
+  std::vector<u8> serial(total_count * 28 + 4);
+  std::vector<u8> parallel(serial.size());
+
+  const auto run_draws = [&](std::vector<u8>& dst, auto run) {
+    int offset = 0;
+    for (int count : draws)
+    {
+      run(DataReader(input_memory + offset * 13, input_memory + sizeof(input_memory)),
+          DataReader(dst.data() + offset * 28, dst.data() + dst.size()), count);
+      offset += count;
+    }
+  };
+
+  std::fill(&VertexLoaderManager::position_cache[0][0],
+            &VertexLoaderManager::position_cache[0][0] + 3 * 4, 0.0f);
+  std::fill(VertexLoaderManager::position_matrix_index,
+            VertexLoaderManager::position_matrix_index + 4, 0u);
+  run_draws(serial, [this](DataReader src, DataReader dst, int count) {
+    EXPECT_EQ(count, m_loader->RunVertices(src, dst, count));
+  });
+  float serial_positions[3][4];
+  u32 serial_matrix_indices[4];
+  std::copy_n(&VertexLoaderManager::position_cache[0][0], 3 * 4, &serial_positions[0][0]);
+  std::copy_n(VertexLoaderManager::position_matrix_index, 4, serial_matrix_indices);
+
+  std::fill(&VertexLoaderManager::position_cache[0][0],
+            &VertexLoaderManager::position_cache[0][0] + 3 * 4, 0.0f);
+  std::fill(VertexLoaderManager::position_matrix_index,
+            VertexLoaderManager::position_matrix_index + 4, 0u);
+  ParallelVertexLoader parallel_loader(3);
+  run_draws(parallel, [&](DataReader src, DataReader dst, int count) {
+    EXPECT_EQ(count, parallel_loader.RunVertices(m_loader.get(), src, dst, count));
+  });
+  parallel_loader.WaitForCompletion();
+
+  EXPECT_TRUE(std::equal(serial.begin(), serial.end() - 4, parallel.begin()));
+  for (int i = 0; i < 3; i++)
+  {
+    for (int j = 0; j < 3; j++)
+      EXPECT_EQ(serial_positions[i][j], VertexLoaderManager::position_cache[i][j]);
+    EXPECT_EQ(serial_matrix_indices[i + 1], VertexLoaderManager::position_matrix_index[i + 1]);
+  }
+}